@@ -171,6 +171,37 @@ AC_DEFUN([QL_CHECK_BOOST_TEST_STREAM],
     ])
 ])
 
+# QL_CHECK_BOOST_THREAD
+# ---------------------
+# Check whether the Boost.Thread library is available and add it
+# (and Boost.System, if needed) to the libraries to link with
+AC_DEFUN([QL_CHECK_BOOST_THREAD],
+[AC_MSG_CHECKING([for Boost.Thread library])
+ AC_REQUIRE([AC_PROG_CC])
+ ql_original_LIBS=$LIBS
+ boost_thread_found=no
+ for boost_lib in boost_thread boost_thread-mt ; do
+     for boost_system_lib in "" -lboost_system -lboost_system-mt ; do
+         LIBS="$ql_original_LIBS -l$boost_lib $boost_system_lib"
+         AC_LINK_IFELSE([AC_LANG_PROGRAM(
+             [[@%:@include <boost/thread/recursive_mutex.hpp>]],
+             [[boost::recursive_mutex m;
+               boost::recursive_mutex::scoped_lock lock(m);]])],
+             [boost_thread_found=$boost_lib
+              break 2],
+             [])
+     done
+ done
+ if test "$boost_thread_found" = no ; then
+     LIBS="$ql_original_LIBS"
+     AC_MSG_RESULT([no])
+     AC_MSG_ERROR([Boost.Thread library not found.
+     It is required by the thread-safe observer pattern.])
+ else
+     AC_MSG_RESULT([yes])
+ fi
+])
+
 # QL_CHECK_BOOST
 # ------------------------
 # Boost-related tests
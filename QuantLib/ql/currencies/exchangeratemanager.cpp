@@ -42,6 +42,12 @@ namespace QuantLib {
         addKnownRates();
     }
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    void ExchangeRateManager::forkFrom(const ExchangeRateManager& manager) {
+        data_ = manager.data_;
+    }
+    #endif
+
     void ExchangeRateManager::add(const ExchangeRate& rate,
                                   const Date& startDate,
                                   const Date& endDate) {
@@ -41,6 +41,9 @@ namespace QuantLib {
         friend class Singleton<ExchangeRateManager>;
       private:
         ExchangeRateManager();
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        void forkFrom(const ExchangeRateManager&);
+        #endif
       public:
         //! Add an exchange rate.
         /*! The given rate is valid between the given dates.
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2004 StatPro Italia srl
+ Copyright (C) 2004, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -22,6 +22,20 @@
 
 namespace QuantLib {
 
+    void Lattice::rollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+        for (Size i=0; i<assets.size(); ++i)
+            rollback(*assets[i], to);
+    }
+
+    void Lattice::partialRollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+        for (Size i=0; i<assets.size(); ++i)
+            partialRollback(*assets[i], to);
+    }
+
     void DiscretizedOption::postAdjustValuesImpl() {
         /* In the real world, with time flowing forward, first
            any payment is settled and only after options can be
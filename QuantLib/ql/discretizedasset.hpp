@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2004, 2005, 2006 StatPro Italia srl
+ Copyright (C) 2004, 2005, 2006, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -167,6 +167,9 @@ namespace QuantLib {
           exerciseTimes_(exerciseTimes) {}
         void reset(Size size);
         std::vector<Time> mandatoryTimes() const;
+        const boost::shared_ptr<DiscretizedAsset>& underlying() const {
+            return underlying_;
+        }
       protected:
         void postAdjustValuesImpl();
         void applyExerciseCondition();
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2005, 2006 Theo Boafo
- Copyright (C) 2006 StatPro Italia srl
+ Copyright (C) 2006, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -55,6 +55,13 @@ namespace QuantLib {
                       Array& newSpreadAdjustedRate) const;
         void rollback(DiscretizedAsset&, Time to) const;
         void partialRollback(DiscretizedAsset&, Time to) const;
+        // the assets are rolled back separately
+        void rollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
+        void partialRollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
 
       private:
         Spread creditSpread_;
@@ -119,6 +126,19 @@ namespace QuantLib {
         asset.adjustValues();
     }
 
+    template <class T>
+    void TsiveriotisFernandesLattice<T>::rollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+        Lattice::rollback(assets,to);
+    }
+
+    template <class T>
+    void TsiveriotisFernandesLattice<T>::partialRollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+        Lattice::partialRollback(assets,to);
+    }
 
     template <class T>
     void TsiveriotisFernandesLattice<T>::partialRollback(DiscretizedAsset& asset,
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2009 Andrea Odetti
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -17,9 +18,10 @@
  FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
-#include <ql/math/generallinearleastsquares.hpp>
 #include <ql/experimental/mcbasket/longstaffschwartzmultipathpricer.hpp>
+#include <ql/methods/montecarlo/lsmregression.hpp>
 #include <ql/utilities/tracing.hpp>
+#include <numeric>
 
 namespace QuantLib {
 
@@ -48,6 +50,8 @@ namespace QuantLib {
       timePositions_(timePositions),
       forwardTermStructures_(forwardTermStructures),
       dF_        (discounts),
+      polynomOrder_(polynomOrder),
+      polynomType_(polynomType),
       v_         (LsmBasisSystem::multiPathBasisSystem(payoff->basisSystemDimension(),
                                                        polynomOrder,
                                                        polynomType)) {
@@ -215,8 +219,17 @@ namespace QuantLib {
                 }
             }
 
+            // the basis functions are evaluated on all the regression
+            // paths at once and reused for the exercise decision
+            Matrix basisValues(x.size(), v_.size());
             if (v_.size() <=  x.size()) {
-                coeff_[i] = GeneralLinearLeastSquares(x, y, v_).coefficients();
+                LsmBasisSystem::multiPathBasisValues(basisDimension,
+                                                     polynomOrder_,
+                                                     polynomType_,
+                                                     x, basisValues);
+                LsmRegression regression(v_.size());
+                regression.add(basisValues, y);
+                coeff_[i] = regression.coefficients(basisValues, y);
             }
             else {
             // if number of itm paths is smaller then the number of
@@ -242,11 +255,11 @@ namespace QuantLib {
                 if (canExercise) {
                     sumAlwaysExercise += exercise[j];
                     if (!coeff_[i].empty() && exercise[j] > lowerBounds_[i + 1]) {
-                        Real continuationValue = 0.0;
-                        for (Size l = 0; l < v_.size(); ++l) {
-                            continuationValue += coeff_[i][l] * v_[l](x[k]);
-                        }
-                        
+                        const Real continuationValue =
+                            std::inner_product(basisValues.row_begin(k),
+                                               basisValues.row_end(k),
+                                               coeff_[i].begin(), 0.0);
+
                         if (continuationValue < exercise[j]) {
                             lsExercise[j] = true;
                         }
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2009 Andrea Odetti
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -80,6 +81,8 @@ namespace QuantLib {
         const std::vector<Size> timePositions_;
         const std::vector<Handle<YieldTermStructure> > forwardTermStructures_;
         const Array dF_;
+        const Size polynomOrder_;
+        const LsmBasisSystem::PolynomType polynomType_;
 
         mutable std::vector<PathInfo> paths_;
         const   std::vector<boost::function1<Real, Array> > v_;
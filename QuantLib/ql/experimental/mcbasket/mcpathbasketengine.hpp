@@ -57,7 +57,8 @@ namespace QuantLib {
                            Size requiredSamples,
                            Real requiredTolerance,
                            Size maxSamples,
-                           BigNatural seed);
+                           BigNatural seed,
+                           Size threads = Null<Size>());
 
         void calculate() const {
             McSimulation<MultiVariate,RNG,S>::calculate(requiredTolerance_,
@@ -116,8 +117,10 @@ namespace QuantLib {
              Size requiredSamples,
              Real requiredTolerance,
              Size maxSamples,
-             BigNatural seed)
-    : McSimulation<MultiVariate,RNG,S>(antitheticVariate, controlVariate),
+             BigNatural seed,
+             Size threads)
+    : McSimulation<MultiVariate,RNG,S>(antitheticVariate, controlVariate,
+                                       threads),
       process_(process), timeSteps_(timeSteps), timeStepsPerYear_(timeStepsPerYear),
       requiredSamples_(requiredSamples), maxSamples_(maxSamples),
       requiredTolerance_(requiredTolerance),
@@ -233,6 +236,7 @@ namespace QuantLib {
         MakeMCPathBasketEngine& withSeed(BigNatural seed);
         MakeMCPathBasketEngine& withAntitheticVariate(bool b = true);
         MakeMCPathBasketEngine& withControlVariate(bool b = true);
+        MakeMCPathBasketEngine& withThreads(Size threads);
         // conversion to pricing engine
         operator boost::shared_ptr<PricingEngine>() const;
       private:
@@ -242,6 +246,7 @@ namespace QuantLib {
         Real tolerance_;
         bool brownianBridge_;
         BigNatural seed_;
+        Size threads_;
     };
 
     template <class RNG, class S>
@@ -251,7 +256,8 @@ namespace QuantLib {
       antithetic_(false), controlVariate_(false),
       steps_(Null<Size>()), stepsPerYear_(Null<Size>()),
       samples_(Null<Size>()), maxSamples_(Null<Size>()),
-      tolerance_(Null<Real>()), brownianBridge_(false), seed_(0) {}
+      tolerance_(Null<Real>()), brownianBridge_(false), seed_(0),
+      threads_(Null<Size>()) {}
 
     template <class RNG, class S>
     inline MakeMCPathBasketEngine<RNG,S>&
@@ -323,6 +329,13 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S>
+    inline MakeMCPathBasketEngine<RNG,S>&
+    MakeMCPathBasketEngine<RNG,S>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
     template <class RNG, class S>
     inline
     MakeMCPathBasketEngine<RNG,S>::operator boost::shared_ptr<PricingEngine>()
@@ -337,7 +350,8 @@ namespace QuantLib {
                                       samples_,
                                       tolerance_,
                                       maxSamples_,
-                                      seed_));
+                                      seed_,
+                                      threads_));
     }
 
 }
@@ -300,12 +300,14 @@ namespace QuantLib {
             OptimizationMethod &method, const EndCriteria &endCriteria,
             const Constraint &constraint = Constraint(),
             const std::vector<Real> &weights = std::vector<Real>(),
-            const std::vector<bool> &fixParameters = std::vector<bool>()) {
+            const std::vector<bool> &fixParameters = std::vector<bool>(),
+            Size threads = Null<Size>()) {
 
             CalibratedModel::calibrate(helper, method, endCriteria, constraint,
                                        weights, fixParameters.size() == 0
                                                     ? FixedFirstVolatility()
-                                                    : fixParameters);
+                                                    : fixParameters,
+                                       threads);
         }
 
       protected:
@@ -90,4 +90,11 @@ namespace QuantLib {
         }
     }
 
+    void ExtendedBlackScholesMertonProcess::evolve(Time t0, const Array& x0,
+                                                   Time dt, const Array& dw,
+                                                   Array& x) const {
+        // the chosen scheme is applied to each path in turn
+        StochasticProcess1D::evolve(t0, x0, dt, dw, x);
+    }
+
 }
@@ -107,4 +107,12 @@ namespace QuantLib {
         }
     }
 
+    void VegaStressedBlackScholesProcess::evolve(Time t0, const Array& x0,
+                                                 Time dt, const Array& dw,
+                                                 Array& x) const {
+        // the stressed volatility depends on the underlying value, so
+        // each path must be evolved separately
+        StochasticProcess1D::evolve(t0, x0, dt, dw, x);
+    }
+
 }
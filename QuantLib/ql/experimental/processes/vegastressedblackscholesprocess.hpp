@@ -47,6 +47,9 @@ namespace QuantLib {
         //! \name StochasticProcess1D interface
         //@{
         Real diffusion(Time t, Real x) const;
+        using GeneralizedBlackScholesProcess::evolve;
+        void evolve(Time t0, const Array& x0,
+                    Time dt, const Array& dw, Array& x) const;
         //@}
         //! \name interface for vega stress test
         //@{
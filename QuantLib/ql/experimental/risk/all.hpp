@@ -1,5 +1,6 @@
 /* This file is automatically generated; do not edit.     */
 /* Add the files to be included into Makefile.am instead. */
 
+#include <ql/experimental/risk/portfoliovaluation.hpp>
 #include <ql/experimental/risk/sensitivityanalysis.hpp>
 
@@ -0,0 +1,190 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/experimental/risk/portfoliovaluation.hpp>
+#include <ql/instrument.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <algorithm>
+
+using std::vector;
+using std::string;
+using boost::shared_ptr;
+
+namespace QuantLib {
+
+    namespace {
+
+        void price(const Instrument& instrument,
+                   Size i, PortfolioResults& results,
+                   bool additionalResults) {
+            results.NPVs[i] = instrument.NPV();
+            if (additionalResults)
+                results.additionalResults[i] =
+                    instrument.additionalResults();
+        }
+
+        // same as above, but on the passed engine; the instrument
+        // is not modified.
+        void price(const Instrument& instrument, PricingEngine& engine,
+                   Size i, PortfolioResults& results,
+                   bool additionalResults) {
+            if (instrument.isExpired()) {
+                results.NPVs[i] = 0.0;
+                return;
+            }
+            engine.reset();
+            instrument.setupArguments(engine.getArguments());
+            engine.getArguments()->validate();
+            engine.calculate();
+            const Instrument::results* r =
+                dynamic_cast<const Instrument::results*>(engine.getResults());
+            QL_ENSURE(r != 0, "no results returned from pricing engine");
+            QL_REQUIRE(r->value != Null<Real>(), "NPV not provided");
+            results.NPVs[i] = r->value;
+            if (additionalResults)
+                results.additionalResults[i] = r->additionalResults;
+        }
+
+    }
+
+    PortfolioResults
+    valuePortfolio(const vector<shared_ptr<Instrument> >& instruments,
+                   Size threads,
+                   bool additionalResults,
+                   const EngineCopier& copy) {
+        QL_REQUIRE(threads != 0, "null number of threads");
+
+        Size n = instruments.size();
+        PortfolioResults results;
+        results.NPVs.resize(n);
+        if (additionalResults)
+            results.additionalResults.resize(n);
+
+        if (threads == Null<Size>()) {
+            for (Size i=0; i<n; ++i)
+                price(*instruments[i], i, results, additionalResults);
+            return results;
+        }
+
+        // Instruments are grouped by engine, in order of appearance.
+        // Those without an engine are priced right away.
+        std::map<PricingEngine*, Size> indexes;
+        vector<shared_ptr<PricingEngine> > engines;
+        vector<vector<Size> > groups;
+        for (Size i=0; i<n; ++i) {
+            const shared_ptr<PricingEngine>& engine =
+                instruments[i]->pricingEngine();
+            if (!engine) {
+                price(*instruments[i], i, results, additionalResults);
+                continue;
+            }
+            std::map<PricingEngine*, Size>::const_iterator k =
+                indexes.find(engine.get());
+            if (k == indexes.end()) {
+                indexes[engine.get()] = groups.size();
+                engines.push_back(engine);
+                groups.push_back(vector<Size>(1, i));
+            } else {
+                groups[k->second].push_back(i);
+            }
+        }
+
+        // the first instrument of each group triggers the calculation
+        // of the term structures used by its engine.
+        for (Size g=0; g<groups.size(); ++g) {
+            Size i = groups[g].front();
+            price(*instruments[i], i, results, additionalResults);
+        }
+
+        // the rest of the work is split in tasks, each run by a
+        // single thread: either a whole group, or a single
+        // instrument when engine copies are available.
+        vector<std::pair<Size,Size> > tasks; // (group, instrument)
+        for (Size g=0; g<groups.size(); ++g) {
+            if (copy.empty()) {
+                if (groups[g].size() > 1)
+                    tasks.push_back(std::make_pair(g, Null<Size>()));
+            } else {
+                for (Size k=1; k<groups[g].size(); ++k)
+                    tasks.push_back(std::make_pair(g, groups[g][k]));
+            }
+        }
+        if (tasks.empty())
+            return results;
+
+        threads = std::min(threads, tasks.size());
+
+        vector<vector<shared_ptr<PricingEngine> > > copies;
+        if (!copy.empty()) {
+            copies.resize(threads,
+                          vector<shared_ptr<PricingEngine> >(groups.size()));
+            for (Size t=0; t<threads; ++t) {
+                for (Size g=0; g<groups.size(); ++g) {
+                    copies[t][g] = copy(engines[g]);
+                    QL_REQUIRE(copies[t][g], "null engine copy returned");
+                }
+            }
+        }
+
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        // a context can't be current in two threads; each thread
+        // gets its own fork of the current one.
+        vector<SingletonContext> contexts;
+        contexts.reserve(threads);
+        for (Size t=0; t<threads; ++t)
+            contexts.push_back(SingletonContext::current().fork());
+        #endif
+
+        // each thread takes the next available task until none is left
+        boost::detail::atomic_count next(0);
+        vector<string> errors(threads);
+
+        #pragma omp parallel for num_threads(threads) schedule(static,1)
+        for (long t=0; t<long(threads); ++t) {
+            #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+            SingletonContextGuard guard(contexts[t]);
+            #endif
+            try {
+                for (Size k = ++next - 1; k < tasks.size(); k = ++next - 1) {
+                    Size g = tasks[k].first, i = tasks[k].second;
+                    if (i == Null<Size>()) {
+                        for (Size j=1; j<groups[g].size(); ++j)
+                            price(*instruments[groups[g][j]],
+                                  groups[g][j], results, additionalResults);
+                    } else {
+                        price(*instruments[i], *copies[t][g],
+                              i, results, additionalResults);
+                    }
+                }
+            } catch (std::exception& e) {
+                errors[t] = e.what();
+            } catch (...) {
+                errors[t] = "unknown error";
+            }
+        }
+
+        for (Size t=0; t<threads; ++t)
+            QL_REQUIRE(errors[t].empty(), errors[t]);
+
+        return results;
+    }
+
+}
+
@@ -0,0 +1,105 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file portfoliovaluation.hpp
+    \brief multi-threaded valuation of a set of instruments
+*/
+
+#ifndef quantlib_portfolio_valuation_hpp
+#define quantlib_portfolio_valuation_hpp
+
+#include <ql/types.hpp>
+#include <ql/utilities/null.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/any.hpp>
+#include <boost/function.hpp>
+#include <vector>
+#include <map>
+#include <string>
+
+namespace QuantLib {
+
+    class Instrument;
+    class PricingEngine;
+
+    //! results of a portfolio valuation
+    /*! Results are stored in the same order as the instruments. */
+    struct PortfolioResults {
+        std::vector<Real> NPVs;
+        //! empty unless requested
+        std::vector<std::map<std::string,boost::any> > additionalResults;
+    };
+
+    //! function returning a copy of the passed engine
+    typedef boost::function<boost::shared_ptr<PricingEngine>(
+                     const boost::shared_ptr<PricingEngine>&)> EngineCopier;
+
+    //! values a set of instruments, possibly on several threads
+    /*! Since pricing engines store their arguments and results,
+        an engine can't be used by two threads at the same time.
+        Therefore, instruments are grouped by pricing engine and
+        each group is priced by a single thread; groups are handed
+        to the threads dynamically as the latter become free, so
+        that a few large groups don't leave the other threads idle.
+        Term structures, quotes and other market data are shared
+        between the threads and must only be read during the
+        valuation.
+
+        Lazy objects (e.g., bootstrapped curves) are not safe to
+        calculate from several threads. For this reason, the first
+        instrument of each group is priced before the threads are
+        started, which triggers the calculation of the term
+        structures referenced by its engine. Curves used only by
+        the arguments of some instruments (e.g., forecast curves of
+        floating-rate coupons) should be calculated in advance.
+
+        If singleton contexts are enabled, each thread uses its own
+        fork of the context current in the calling thread; the forks
+        are made before the threads are started.
+
+        When most instruments share the same engine, grouping
+        leaves little room for parallelism. In this case, a function
+        can be passed that returns a copy of a given engine (e.g.,
+        by calling the copy constructor of its actual class); each
+        thread then prices any instrument on its own copies, and the
+        engines set to the instruments are only used for the first
+        instrument of each group as above. Copies are made before
+        the threads are started. When engine copies are used, the
+        results are not stored in the instruments, whose NPV()
+        method will recalculate them if called.
+
+        If no number of threads is passed, the instruments are
+        priced sequentially in the calling thread.
+
+        \warning Instruments without an engine (e.g., composite
+                 instruments) are priced sequentially before the
+                 threads are started; their components can share
+                 engines with other instruments. Coupon pricers,
+                 instead, should not be shared between different
+                 instruments.
+    */
+    PortfolioResults
+    valuePortfolio(const std::vector<boost::shared_ptr<Instrument> >&,
+                   Size threads = Null<Size>(),
+                   bool additionalResults = false,
+                   const EngineCopier& copy = EngineCopier());
+
+}
+
+#endif
@@ -20,6 +20,9 @@
 #include <ql/experimental/risk/sensitivityanalysis.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/instrument.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <algorithm>
 
 using std::vector;
 using std::pair;
@@ -40,18 +43,23 @@ namespace QuantLib {
     }
 
     Real aggregateNPV(const vector<shared_ptr<Instrument> >& instruments,
-                      const vector<Real>& quant) {
+                      const vector<Real>& quant,
+                      Size threads,
+                      const EngineCopier& copy) {
         Size n = instruments.size();
+        bool unit = quant.empty() || (quant.size()==1 && quant[0]==1.0);
+        QL_REQUIRE(unit || quant.size()==n,
+                   "dimension mismatch between instruments (" << n <<
+                   ") and quantities (" << quant.size() << ")");
+
+        vector<Real> npvs;
+        if (threads != Null<Size>())
+            npvs = valuePortfolio(instruments, threads, false, copy).NPVs;
+
         Real npv = 0.0;
-        if (quant.empty() || (quant.size()==1 && quant[0]==1.0)) {
-            for (Size k=0; k<n; ++k)
-                npv += instruments[k]->NPV();
-        } else {
-            QL_REQUIRE(quant.size()==n,
-                       "dimension mismatch between instruments (" << n <<
-                       ") and quantities (" << quant.size() << ")");
-            for (Size k=0; k<n; ++k)
-                npv += quant[k] * instruments[k]->NPV();
+        for (Size k=0; k<n; ++k) {
+            Real value = npvs.empty() ? instruments[k]->NPV() : npvs[k];
+            npv += unit ? value : quant[k] * value;
         }
         return npv;
     }
@@ -351,4 +359,196 @@ namespace QuantLib {
         return result;
     }
 
+
+    namespace {
+
+        // shift applied to a single quote, or to all of them if the
+        // index is null
+        typedef pair<Size, Real> Scenario;
+
+        void reprice(const PortfolioCopy& portfolio,
+                     const Scenario& scenario,
+                     vector<Real>& npvs) {
+            const vector<shared_ptr<SimpleQuote> >& quotes =
+                portfolio.quotes;
+            Size first = scenario.first, last = scenario.first+1;
+            if (scenario.first == Null<Size>()) {
+                first = 0;
+                last = quotes.size();
+            }
+
+            vector<Real> values(last-first, Null<Real>());
+            try {
+                for (Size i=first; i<last; ++i) {
+                    if (quotes[i]->isValid()) {
+                        values[i-first] = quotes[i]->value();
+                        quotes[i]->setValue(values[i-first]+scenario.second);
+                    }
+                }
+                npvs.resize(portfolio.instruments.size());
+                for (Size j=0; j<npvs.size(); ++j)
+                    npvs[j] = portfolio.instruments[j]->NPV();
+            } catch (...) {
+                for (Size i=first; i<last; ++i)
+                    if (values[i-first] != Null<Real>())
+                        quotes[i]->setValue(values[i-first]);
+                throw;
+            }
+            for (Size i=first; i<last; ++i)
+                if (values[i-first] != Null<Real>())
+                    quotes[i]->setValue(values[i-first]);
+        }
+
+        // The reference values are calculated on a first copy of the
+        // portfolio, which is then reused by the first thread. Among
+        // other things, this triggers any lazy initialization of
+        // singleton data (such as index fixings) before the threads
+        // are started.
+        PortfolioCopy referenceCopy(const PortfolioFactory& factory,
+                                    vector<Real>& npvs) {
+            PortfolioCopy portfolio = factory();
+            reprice(portfolio, Scenario(Null<Size>(), 0.0), npvs);
+            return portfolio;
+        }
+
+        // returns the NPVs of the instruments for each scenario
+        vector<vector<Real> > reprice(const PortfolioFactory& factory,
+                                      const PortfolioCopy& reference,
+                                      Size threads,
+                                      const vector<Scenario>& scenarios) {
+            vector<vector<Real> > npvs(scenarios.size());
+            if (scenarios.empty())
+                return npvs;
+
+            threads = std::min(threads, scenarios.size());
+            vector<PortfolioCopy> copies(1, reference);
+            for (Size t=1; t<threads; ++t) {
+                copies.push_back(factory());
+                QL_REQUIRE(copies[t].quotes.size() ==
+                                                  reference.quotes.size() &&
+                           copies[t].instruments.size() ==
+                                             reference.instruments.size(),
+                           "inconsistent portfolio copies returned");
+            }
+
+            #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+            // a context can't be current in two threads; each thread
+            // gets its own fork of the current one.
+            vector<SingletonContext> contexts;
+            contexts.reserve(threads);
+            for (Size t=0; t<threads; ++t)
+                contexts.push_back(SingletonContext::current().fork());
+            #endif
+
+            // each thread takes the next scenario until none is left
+            boost::detail::atomic_count next(0);
+            vector<std::string> errors(threads);
+
+            #pragma omp parallel for num_threads(threads) schedule(static,1)
+            for (long t=0; t<long(threads); ++t) {
+                #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+                SingletonContextGuard guard(contexts[t]);
+                #endif
+                try {
+                    for (Size k = ++next - 1; k < scenarios.size();
+                         k = ++next - 1)
+                        reprice(copies[t], scenarios[k], npvs[k]);
+                } catch (std::exception& e) {
+                    errors[t] = e.what();
+                } catch (...) {
+                    errors[t] = "unknown error";
+                }
+            }
+
+            for (Size t=0; t<threads; ++t)
+                QL_REQUIRE(errors[t].empty(), errors[t]);
+
+            return npvs;
+        }
+
+    }
+
+
+    pair<vector<Real>, vector<Real> >
+    parallelAnalysis(const PortfolioFactory& factory,
+                     Size threads,
+                     Real shift,
+                     SensitivityAnalysis type) {
+        QL_REQUIRE(threads != 0, "null number of threads");
+        QL_REQUIRE(shift!=0.0, "zero shift not allowed");
+        QL_REQUIRE(type == OneSide || type == Centered,
+                   "unknown SensitivityAnalysis (" << Integer(type) << ")");
+
+        vector<Real> reference;
+        PortfolioCopy portfolio = referenceCopy(factory, reference);
+
+        vector<Scenario> scenarios;
+        scenarios.push_back(Scenario(Null<Size>(), shift));
+        if (type == Centered)
+            scenarios.push_back(Scenario(Null<Size>(), -shift));
+        vector<vector<Real> > npvs =
+            reprice(factory, portfolio, threads, scenarios);
+
+        Size m = reference.size();
+        pair<vector<Real>, vector<Real> > result;
+        result.first.resize(m);
+        result.second.resize(m);
+        for (Size j=0; j<m; ++j) {
+            const vector<Real>& up = npvs[0];
+            if (type == OneSide) {
+                result.first[j] = (up[j]-reference[j])/shift;
+                result.second[j] = Null<Real>();
+            } else {
+                const vector<Real>& down = npvs[1];
+                result.first[j] = (up[j]-down[j])/(2.0*shift);
+                result.second[j] =
+                    (up[j]-2.0*reference[j]+down[j])/(shift*shift);
+            }
+        }
+        return result;
+    }
+
+
+    pair<Matrix, Matrix>
+    bucketAnalysis(const PortfolioFactory& factory,
+                   Size threads,
+                   Real shift,
+                   SensitivityAnalysis type) {
+        QL_REQUIRE(threads != 0, "null number of threads");
+        QL_REQUIRE(shift!=0.0, "zero shift not allowed");
+        QL_REQUIRE(type == OneSide || type == Centered,
+                   "unknown SensitivityAnalysis (" << Integer(type) << ")");
+
+        vector<Real> reference;
+        PortfolioCopy portfolio = referenceCopy(factory, reference);
+        Size n = portfolio.quotes.size(), m = reference.size();
+
+        vector<Scenario> scenarios;
+        for (Size i=0; i<n; ++i) {
+            scenarios.push_back(Scenario(i, shift));
+            if (type == Centered)
+                scenarios.push_back(Scenario(i, -shift));
+        }
+        vector<vector<Real> > npvs =
+            reprice(factory, portfolio, threads, scenarios);
+
+        pair<Matrix, Matrix> result(Matrix(n, m), Matrix(n, m));
+        for (Size i=0; i<n; ++i) {
+            for (Size j=0; j<m; ++j) {
+                if (type == OneSide) {
+                    const vector<Real>& up = npvs[i];
+                    result.first[i][j] = (up[j]-reference[j])/shift;
+                    result.second[i][j] = Null<Real>();
+                } else {
+                    const vector<Real>& up = npvs[2*i];
+                    const vector<Real>& down = npvs[2*i+1];
+                    result.first[i][j] = (up[j]-down[j])/(2.0*shift);
+                    result.second[i][j] =
+                        (up[j]-2.0*reference[j]+down[j])/(shift*shift);
+                }
+            }
+        }
+        return result;
+    }
+
 }
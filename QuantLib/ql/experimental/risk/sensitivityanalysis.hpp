@@ -24,11 +24,8 @@
 #ifndef quantlib_sensitivity_analysis_hpp
 #define quantlib_sensitivity_analysis_hpp
 
-//#include <ql/math/matrix.hpp>
-#include <ql/types.hpp>
-#include <ql/utilities/null.hpp>
-#include <boost/shared_ptr.hpp>
-#include <vector>
+#include <ql/experimental/risk/portfoliovaluation.hpp>
+#include <ql/math/matrix.hpp>
 
 namespace QuantLib {
 
@@ -49,8 +46,14 @@ namespace QuantLib {
                              SensitivityAnalysis);
 
     //! utility fuction for weighted sum of NPVs
+    /*! If a number of threads is passed, the instruments are priced
+        concurrently by means of valuePortfolio(), to which the
+        optional engine-copy function is also passed.
+    */
     Real aggregateNPV(const std::vector<boost::shared_ptr<Instrument> >&,
-                      const std::vector<Real>& quantities);
+                      const std::vector<Real>& quantities,
+                      Size threads = Null<Size>(),
+                      const EngineCopier& copy = EngineCopier());
 
     //! parallel shift PV01 sensitivity analysis for a SimpleQuote vector
     /*! returns a pair of first and second derivative values calculated as
@@ -176,6 +179,62 @@ namespace QuantLib {
                    Real shift = 0.0001,
                    SensitivityAnalysis type = Centered);
 
+
+    //! isolated copy of a set of instruments and of their market data
+    /*! The instruments must depend on the quotes only through
+        objects (e.g., rate helpers, curves and engines) belonging
+        to the same copy; any such object shared with another copy
+        would be modified concurrently.
+    */
+    struct PortfolioCopy {
+        std::vector<boost::shared_ptr<SimpleQuote> > quotes;
+        std::vector<boost::shared_ptr<Instrument> > instruments;
+    };
+
+    //! function building a new copy of a portfolio and its market data
+    typedef boost::function<PortfolioCopy()> PortfolioFactory;
+
+    //! parallel shift sensitivity analysis on several threads
+    /*! returns a pair of first and second derivative vectors, one
+        element for each instrument, calculated as prescribed by
+        SensitivityAnalysis. Second derivatives are not available
+        when using OneSide.
+
+        All SimpleQuotes are tweaked together in a parallel fashion.
+        The factory is called once per thread, sequentially, before
+        the threads are started; each thread then reprices its own
+        copy, so that the up and down shifts run concurrently.
+    */
+    std::pair<std::vector<Real>, std::vector<Real> >
+    parallelAnalysis(const PortfolioFactory&,
+                     Size threads,
+                     Real shift = 0.0001,
+                     SensitivityAnalysis type = Centered);
+
+    //! bucket sensitivity analysis on several threads
+    /*! returns a pair of first and second derivative matrices
+        calculated as prescribed by SensitivityAnalysis; element
+        \f$ (i,j) \f$ is the sensitivity of the \f$ j \f$-th
+        instrument to the \f$ i \f$-th quote. Second derivatives are
+        not available when using OneSide; invalid quotes give zero
+        sensitivities.
+
+        The factory is called once per thread, sequentially, before
+        the threads are started. Each bump is an independent task,
+        run by the first available thread on its own copy; since
+        the copies are made of lazy objects, only the curves and
+        instruments depending on the bumped quote are recalculated.
+
+        \warning Any lazy object shared between copies (e.g., a
+                 curve not depending on the quotes) must be
+                 calculated before calling this function.
+    */
+    std::pair<Matrix, Matrix>
+    bucketAnalysis(const PortfolioFactory&,
+                   Size threads,
+                   Real shift = 0.0001,
+                   SensitivityAnalysis type = Centered);
+
 }
 
 #endif
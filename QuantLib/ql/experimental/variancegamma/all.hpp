@@ -3,6 +3,8 @@
 
 #include <ql/experimental/variancegamma/analyticvariancegammaengine.hpp>
 #include <ql/experimental/variancegamma/fftengine.hpp>
+#include <ql/experimental/variancegamma/ffthestonengine.hpp>
+#include <ql/experimental/variancegamma/fftmerton76engine.hpp>
 #include <ql/experimental/variancegamma/fftvanillaengine.hpp>
 #include <ql/experimental/variancegamma/fftvariancegammaengine.hpp>
 #include <ql/experimental/variancegamma/variancegammamodel.hpp>
@@ -2,6 +2,7 @@
 
 /*
 Copyright (C) 2010 Adrian O' Neill
+Copyright (C) 2014 StatPro Italia srl
 
 This file is part of QuantLib, a free-software/open-source library
 for financial quantitative analysts and developers - http://quantlib.org/
@@ -25,12 +26,69 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 
 namespace QuantLib {
 
+    namespace {
+
+        const Real alpha = 1.25;
+
+    }
+
+    // Everything in the transform that depends only on its size
+    class FFTEngine::Plan {
+      public:
+        Plan(Size log2_n, Real lambda)
+        : fft(log2_n), nodes(fft.output_size()), weights(nodes.size()),
+          strikes(nodes.size()), factors(nodes.size()) {
+            const Size n = nodes.size();
+            std::complex<Real> i1(0, 1);
+
+            // Strike range (equation 19,20)
+            Real b = n * lambda / 2.0;
+
+            // Grid spacing (equation 23)
+            Real eta = 2.0 * M_PI / (lambda * n);
+
+            for (Size i=0; i<n; i++)
+            {
+                Real v_j = eta * i;
+                Real sw = eta * (3.0 + ((i % 2) == 0 ? -1.0 : 1.0) - ((i == 0) ? 1.0 : 0.0)) / 3.0;
+
+                nodes[i] = v_j;
+                weights[i] = std::exp(i1 * b * v_j) * sw
+                    / (alpha*alpha + alpha - v_j*v_j + i1 * (2 * alpha + 1.0) * v_j);
+
+                Real k_u = -b + lambda * i;
+                strikes[i] = std::exp(k_u);
+                factors[i] = std::exp(-alpha * k_u) / M_PI;
+            }
+        }
+        FastFourierTransform fft;
+        std::vector<Real> nodes;
+        std::vector<std::complex<Real> > weights;
+        std::vector<Real> strikes, factors;
+    };
+
+
     FFTEngine::FFTEngine(
         const boost::shared_ptr<StochasticProcess1D>& process, Real logStrikeSpacing)
         : process_(process), lambda_(logStrikeSpacing) {
             registerWith(process_);
     }
 
+    FFTEngine::FFTEngine(Real logStrikeSpacing)
+    : lambda_(logStrikeSpacing) {}
+
+    Real FFTEngine::underlyingValue() const {
+        QL_REQUIRE(process_, "underlying value not provided");
+        return process_->x0();
+    }
+
+    const FFTEngine::Plan& FFTEngine::plan(Size log2_n) const {
+        boost::shared_ptr<Plan>& p = plans_[log2_n];
+        if (!p)
+            p = boost::shared_ptr<Plan>(new Plan(log2_n, lambda_));
+        return *p;
+    }
+
     void FFTEngine::calculate() const
     {
         QL_REQUIRE(arguments_.exercise->type() == Exercise::European,
@@ -72,7 +130,10 @@ namespace QuantLib {
         optionList.push_back(option);
 
         boost::shared_ptr<FFTEngine> tempEngine(clone().release());
+        // share the transforms already set up
+        tempEngine->plans_ = plans_;
         tempEngine->precalculate(optionList);
+        plans_ = tempEngine->plans_;
         option->setPricingEngine(tempEngine);
         results_.value = option->NPV();
     }
@@ -102,7 +163,6 @@ namespace QuantLib {
         }
 
         std::complex<Real> i1(0, 1);
-        Real alpha = 1.25;
 
         for (PayoffMap::const_iterator payIt = payoffMap.begin(); payIt != payoffMap.end(); payIt++)
         {
@@ -119,14 +179,9 @@ namespace QuantLib {
                     maxStrike = payoff->strike();
             }
             Real nR = 2.0 * (std::log(maxStrike) + lambda_) / lambda_;
-      Size log2_n = (static_cast<Size>((std::log(nR) / std::log(2.0))) + 1);
-            Size n = 1 << log2_n;
-
-            // Strike range (equation 19,20)
-            Real b = n * lambda_ / 2.0;
-
-            // Grid spacing (equation 23)
-            Real eta = 2.0 * M_PI / (lambda_ * n);
+            Size log2_n = (static_cast<Size>((std::log(nR) / std::log(2.0))) + 1);
+            const Plan& p = plan(log2_n);
+            Size n = p.nodes.size();
 
             // Discount factor
             Real df = discountFactor(expiryDate);
@@ -141,44 +196,39 @@ namespace QuantLib {
 
             for (Size i=0; i<n; i++)
             {
-                Real v_j = eta * i;
-                Real sw = eta * (3.0 + ((i % 2) == 0 ? -1.0 : 1.0) - ((i == 0) ? 1.0 : 0.0)) / 3.0; 
-
-                std::complex<Real> psi = df * complexFourierTransform(v_j - (alpha + 1)* i1);
-                psi = psi / (alpha*alpha + alpha - v_j*v_j + i1 * (2 * alpha + 1.0) * v_j);
-
-                fti[i] = std::exp(i1 * b * v_j)  * sw * psi;
+                std::complex<Real> psi =
+                    df * complexFourierTransform(p.nodes[i] - (alpha + 1)* i1);
+                fti[i] = p.weights[i] * psi;
             }
 
             // Perform fft
             std::vector<std::complex<Real> > results(n);
-            FastFourierTransform fft(log2_n);
-            fft.transform(fti.begin(), fti.end(), results.begin());
+            p.fft.transform(fti.begin(), fti.end(), results.begin());
 
             // Call prices
-            std::vector<Real> prices, strikes;
+            std::vector<Real> prices;
             prices.resize(n);
-            strikes.resize(n);
             for (Size i=0; i<n; i++)
-            {
-                Real k_u = -b + lambda_ * i;
-                prices[i] = (std::exp(-alpha * k_u) / M_PI) * results[i].real();
-                strikes[i] = std::exp(k_u);
-            }
+                prices[i] = p.factors[i] * results[i].real();
+
+            LinearInterpolation interpolation(p.strikes.begin(),
+                                              p.strikes.end(),
+                                              prices.begin());
+            Real spot = underlyingValue();
 
             for (PayoffList::const_iterator it = payIt->second.begin();
                 it != payIt->second.end(); it++)
             {
                 boost::shared_ptr<StrikedTypePayoff> payoff = *it;
 
-                Real callPrice = LinearInterpolation(strikes.begin(), strikes.end(), prices.begin())(payoff->strike());
+                Real callPrice = interpolation(payoff->strike());
                 switch (payoff->optionType())
                 {
                 case Option::Call:
                     resultMap_[expiryDate][payoff] = callPrice;
                     break;
                 case Option::Put:
-                    resultMap_[expiryDate][payoff] = callPrice - process_->x0() * div + payoff->strike() * df;
+                    resultMap_[expiryDate][payoff] = callPrice - spot * div + payoff->strike() * df;
                     break;
                 default:
                     QL_FAIL("Invalid option type");
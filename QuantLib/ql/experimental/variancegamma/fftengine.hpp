@@ -2,6 +2,7 @@
 
 /*
 Copyright (C) 2010 Adrian O' Neill
+Copyright (C) 2014 StatPro Italia srl
 
 This file is part of QuantLib, a free-software/open-source library
 for financial quantitative analysts and developers - http://quantlib.org/
@@ -42,6 +43,12 @@ namespace QuantLib {
         Carr, P. and D. B. Madan (1998),
         "Option Valuation using the fast Fourier transform,"
         Journal of Computational Finance, 2, 61-73.
+
+        Derived engines only provide the characteristic function of
+        the log of the underlying at a given expiry; the quantities
+        depending only on the size of the transform (e.g., its
+        twiddle factors and the integration weights) are stored and
+        reused across expiries and calls to precalculate.
     */
 
     class FFTEngine :
@@ -56,10 +63,17 @@ namespace QuantLib {
         virtual std::auto_ptr<FFTEngine> clone() const = 0;
 
     protected:
+        //! for engines whose underlying is not a 1-D process
+        /*! Derived classes using this constructor must override
+            underlyingValue().
+        */
+        explicit FFTEngine(Real logStrikeSpacing);
+
         virtual void precalculateExpiry(Date d) = 0;
         virtual std::complex<Real> complexFourierTransform(std::complex<Real> u) const = 0;
         virtual Real discountFactor(Date d) const = 0;
         virtual Real dividendYield(Date d) const = 0;
+        virtual Real underlyingValue() const;
         void calculateUncached(boost::shared_ptr<StrikedTypePayoff> payoff,
             boost::shared_ptr<Exercise> exercise) const;
 
@@ -70,6 +84,11 @@ namespace QuantLib {
         typedef std::map<boost::shared_ptr<StrikedTypePayoff>, Real> PayoffResultMap;
         typedef std::map<Date, PayoffResultMap> ResultMap;
         ResultMap resultMap_;
+
+        class Plan;
+        typedef std::map<Size, boost::shared_ptr<Plan> > PlanMap;
+        const Plan& plan(Size log2_n) const;
+        mutable PlanMap plans_;
     };
 
 }
@@ -0,0 +1,192 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/experimental/variancegamma/ffthestonengine.hpp>
+
+namespace QuantLib {
+
+    FFTHestonEngine::FFTHestonEngine(
+        const boost::shared_ptr<HestonModel>& model, Real logStrikeSpacing)
+    : FFTEngine(logStrikeSpacing), model_(model) {
+        registerWith(model_);
+    }
+
+    std::auto_ptr<FFTEngine> FFTHestonEngine::clone() const {
+        return std::auto_ptr<FFTEngine>(new FFTHestonEngine(model_, lambda_));
+    }
+
+    void FFTHestonEngine::precalculateExpiry(Date d) {
+        dividendDiscount_ = dividendYield(d);
+        riskFreeDiscount_ = discountFactor(d);
+        t_ = model_->process()->time(d);
+
+        kappa_ = model_->kappa();
+        theta_ = model_->theta();
+        sigma_ = model_->sigma();
+        rho_   = model_->rho();
+        v0_    = model_->v0();
+    }
+
+    std::complex<Real> FFTHestonEngine::complexFourierTransform(
+                                                std::complex<Real> u) const {
+        const std::complex<Real> i1(0, 1);
+        const Real sigma2 = sigma_*sigma_;
+        const Real forward =
+            underlyingValue()*dividendDiscount_/riskFreeDiscount_;
+
+        const std::complex<Real> xi = kappa_ - sigma_*rho_*i1*u;
+        const std::complex<Real> d = std::sqrt(xi*xi + sigma2*(u*u + i1*u));
+        const std::complex<Real> g = (xi-d)/(xi+d);
+        const std::complex<Real> ex = std::exp(-d*t_);
+
+        const std::complex<Real> C = kappa_*theta_/sigma2
+            *((xi-d)*t_ - 2.0*std::log((1.0-g*ex)/(1.0-g)));
+        const std::complex<Real> D = (xi-d)/sigma2*(1.0-ex)/(1.0-g*ex);
+
+        return std::exp(i1*u*std::log(forward) + C + D*v0_ + addOnTerm(u));
+    }
+
+    std::complex<Real> FFTHestonEngine::addOnTerm(std::complex<Real>) const {
+        return 0.0;
+    }
+
+    Real FFTHestonEngine::discountFactor(Date d) const {
+        return model_->process()->riskFreeRate()->discount(d);
+    }
+
+    Real FFTHestonEngine::dividendYield(Date d) const {
+        return model_->process()->dividendYield()->discount(d);
+    }
+
+    Real FFTHestonEngine::underlyingValue() const {
+        return model_->process()->s0()->value();
+    }
+
+
+    FFTBatesEngine::FFTBatesEngine(
+        const boost::shared_ptr<BatesModel>& model, Real logStrikeSpacing)
+    : FFTHestonEngine(model, logStrikeSpacing) {}
+
+    std::auto_ptr<FFTEngine> FFTBatesEngine::clone() const {
+        boost::shared_ptr<BatesModel> model =
+            boost::dynamic_pointer_cast<BatesModel>(model_);
+        return std::auto_ptr<FFTEngine>(new FFTBatesEngine(model, lambda_));
+    }
+
+    void FFTBatesEngine::precalculateExpiry(Date d) {
+        FFTHestonEngine::precalculateExpiry(d);
+
+        boost::shared_ptr<BatesModel> model =
+            boost::dynamic_pointer_cast<BatesModel>(model_);
+        nu_            = model->nu();
+        delta_         = model->delta();
+        jumpIntensity_ = model->lambda();
+    }
+
+    std::complex<Real> FFTBatesEngine::addOnTerm(std::complex<Real> u) const {
+        // same as in BatesEngine, with g = iu
+        const std::complex<Real> g = std::complex<Real>(0, 1)*u;
+        const Real delta2 = 0.5*delta_*delta_;
+        return t_*jumpIntensity_*(std::exp(nu_*g + delta2*g*g) - 1.0
+                                  - g*(std::exp(nu_+delta2) - 1.0));
+    }
+
+
+    FFTPTDHestonEngine::FFTPTDHestonEngine(
+        const boost::shared_ptr<PiecewiseTimeDependentHestonModel>& model,
+        Real logStrikeSpacing)
+    : FFTEngine(logStrikeSpacing), model_(model) {
+        registerWith(model_);
+    }
+
+    std::auto_ptr<FFTEngine> FFTPTDHestonEngine::clone() const {
+        return std::auto_ptr<FFTEngine>(
+                                 new FFTPTDHestonEngine(model_, lambda_));
+    }
+
+    void FFTPTDHestonEngine::precalculateExpiry(Date d) {
+        const Handle<YieldTermStructure>& riskFreeRate =
+            model_->riskFreeRate();
+        const Time t = riskFreeRate->dayCounter().yearFraction(
+                                          riskFreeRate->referenceDate(), d);
+        const TimeGrid& timeGrid = model_->timeGrid();
+        QL_REQUIRE(t < timeGrid.back(), "maturity is too large");
+
+        tau_.clear();
+        kappa_.clear(); theta_.clear(); sigma_.clear(); rho_.clear();
+        carry_.clear();
+        // as in AnalyticPTDHestonEngine, from the last step backwards
+        for (Size i=timeGrid.size()-1; i > 0; --i) {
+            const Time begin = timeGrid[i-1];
+            if (begin < t) {
+                const Time end = std::min(t, timeGrid[i]);
+                const Time tm = 0.5*(end+begin);
+                tau_.push_back(end-begin);
+                kappa_.push_back(model_->kappa(tm));
+                theta_.push_back(model_->theta(tm));
+                sigma_.push_back(model_->sigma(tm));
+                rho_.push_back(model_->rho(tm));
+                carry_.push_back(
+                    riskFreeRate->forwardRate(begin, end, Continuous,
+                                              NoFrequency).rate()
+                    - model_->dividendYield()->forwardRate(
+                                  begin, end, Continuous, NoFrequency).rate());
+            }
+        }
+        v0_ = model_->v0();
+    }
+
+    std::complex<Real> FFTPTDHestonEngine::complexFourierTransform(
+                                                std::complex<Real> u) const {
+        const std::complex<Real> i1(0, 1);
+
+        std::complex<Real> D = 0.0;
+        std::complex<Real> C = 0.0;
+        for (Size i=0; i<tau_.size(); ++i) {
+            const Real sigma2 = sigma_[i]*sigma_[i];
+            const std::complex<Real> xi = kappa_[i] - sigma_[i]*rho_[i]*i1*u;
+            const std::complex<Real> d =
+                std::sqrt(xi*xi + sigma2*(u*u + i1*u));
+            const std::complex<Real> g = (xi-d)/(xi+d);
+            const std::complex<Real> gt = (xi-d - D*sigma2)/(xi+d - D*sigma2);
+            const std::complex<Real> ex = std::exp(-d*tau_[i]);
+
+            D = (xi+d)/sigma2*(g-gt*ex)/(1.0-gt*ex);
+            C = kappa_[i]*theta_[i]/sigma2
+                *((xi-d)*tau_[i] - 2.0*std::log((1.0-gt*ex)/(1.0-gt)))
+                + i1*u*carry_[i]*tau_[i] + C;
+        }
+
+        return std::exp(v0_*D + C + i1*u*std::log(underlyingValue()));
+    }
+
+    Real FFTPTDHestonEngine::discountFactor(Date d) const {
+        return model_->riskFreeRate()->discount(d);
+    }
+
+    Real FFTPTDHestonEngine::dividendYield(Date d) const {
+        return model_->dividendYield()->discount(d);
+    }
+
+    Real FFTPTDHestonEngine::underlyingValue() const {
+        return model_->s0();
+    }
+
+}
+
@@ -0,0 +1,125 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file ffthestonengine.hpp
+    \brief FFT engines for vanilla options under Heston-type models
+*/
+
+#ifndef quantlib_fft_heston_engine_hpp
+#define quantlib_fft_heston_engine_hpp
+
+#include <ql/experimental/variancegamma/fftengine.hpp>
+#include <ql/models/equity/batesmodel.hpp>
+#include <ql/models/equity/piecewisetimedependenthestonmodel.hpp>
+
+namespace QuantLib {
+
+    //! FFT engine for vanilla options under the Heston model
+    /*! The characteristic function is written in the form given by
+        Albrecher et al., which avoids the discontinuities of the
+        complex logarithm.
+
+        References:
+        H. Albrecher, P. Mayer, W. Schoutens and J. Tistaert (2007),
+        "The little Heston trap," Wilmott Magazine, January, 83-92.
+
+        \ingroup vanillaengines
+
+        \test the correctness of the returned values is tested by
+        comparison with the analytic Heston engine.
+    */
+    class FFTHestonEngine : public FFTEngine {
+      public:
+        FFTHestonEngine(const boost::shared_ptr<HestonModel>& model,
+                        Real logStrikeSpacing = 0.001);
+        virtual std::auto_ptr<FFTEngine> clone() const;
+
+      protected:
+        virtual void precalculateExpiry(Date d);
+        virtual std::complex<Real> complexFourierTransform(std::complex<Real> u) const;
+        virtual Real discountFactor(Date d) const;
+        virtual Real dividendYield(Date d) const;
+        virtual Real underlyingValue() const;
+        //! additional term in the exponent of the characteristic function
+        virtual std::complex<Real> addOnTerm(std::complex<Real> u) const;
+
+        boost::shared_ptr<HestonModel> model_;
+        Time t_;
+
+      private:
+        DiscountFactor dividendDiscount_;
+        DiscountFactor riskFreeDiscount_;
+        Real kappa_, theta_, sigma_, rho_, v0_;
+    };
+
+
+    //! FFT engine for vanilla options under the Bates model
+    /*! \ingroup vanillaengines
+
+        \test the correctness of the returned values is tested by
+        comparison with the analytic Bates engine.
+    */
+    class FFTBatesEngine : public FFTHestonEngine {
+      public:
+        FFTBatesEngine(const boost::shared_ptr<BatesModel>& model,
+                       Real logStrikeSpacing = 0.001);
+        virtual std::auto_ptr<FFTEngine> clone() const;
+
+      protected:
+        virtual void precalculateExpiry(Date d);
+        virtual std::complex<Real> addOnTerm(std::complex<Real> u) const;
+
+      private:
+        Real nu_, delta_, jumpIntensity_;
+    };
+
+
+    //! FFT engine for the piecewise time-dependent Heston model
+    /*! \ingroup vanillaengines
+
+        \test the correctness of the returned values is tested by
+        comparison with the analytic piecewise time-dependent
+        Heston engine.
+    */
+    class FFTPTDHestonEngine : public FFTEngine {
+      public:
+        FFTPTDHestonEngine(
+            const boost::shared_ptr<PiecewiseTimeDependentHestonModel>& model,
+            Real logStrikeSpacing = 0.001);
+        virtual std::auto_ptr<FFTEngine> clone() const;
+
+      protected:
+        virtual void precalculateExpiry(Date d);
+        virtual std::complex<Real> complexFourierTransform(std::complex<Real> u) const;
+        virtual Real discountFactor(Date d) const;
+        virtual Real dividendYield(Date d) const;
+        virtual Real underlyingValue() const;
+
+      private:
+        boost::shared_ptr<PiecewiseTimeDependentHestonModel> model_;
+        // parameters and carry on each time step up to the expiry
+        std::vector<Time> tau_;
+        std::vector<Real> kappa_, theta_, sigma_, rho_, carry_;
+        Real v0_;
+    };
+
+}
+
+
+#endif
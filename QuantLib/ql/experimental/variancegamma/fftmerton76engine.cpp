@@ -0,0 +1,89 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/experimental/variancegamma/fftmerton76engine.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+
+namespace QuantLib {
+
+    FFTMerton76Engine::FFTMerton76Engine(
+        const boost::shared_ptr<Merton76Process>& process,
+        Real logStrikeSpacing)
+    : FFTEngine(process, logStrikeSpacing) {}
+
+    std::auto_ptr<FFTEngine> FFTMerton76Engine::clone() const {
+        boost::shared_ptr<Merton76Process> process =
+            boost::dynamic_pointer_cast<Merton76Process>(process_);
+        return std::auto_ptr<FFTEngine>(
+                                   new FFTMerton76Engine(process, lambda_));
+    }
+
+    void FFTMerton76Engine::precalculateExpiry(Date d) {
+        boost::shared_ptr<Merton76Process> process =
+            boost::dynamic_pointer_cast<Merton76Process>(process_);
+
+        dividendDiscount_ = process->dividendYield()->discount(d);
+        riskFreeDiscount_ = process->riskFreeRate()->discount(d);
+
+        DayCounter rfdc = process->riskFreeRate()->dayCounter();
+        t_ = rfdc.yearFraction(process->riskFreeRate()->referenceDate(), d);
+
+        boost::shared_ptr<BlackConstantVol> constVol =
+            boost::dynamic_pointer_cast<BlackConstantVol>(
+                                            *(process->blackVolatility()));
+        QL_REQUIRE(constVol, "Constant volatility required");
+        Real vol = constVol->blackVol(0.0, 0.0);
+        var_ = vol*vol;
+
+        jumpIntensity_ = process->jumpIntensity()->value();
+        logMeanJump_ = process->logMeanJump()->value();
+        logJumpVolatility_ = process->logJumpVolatility()->value();
+    }
+
+    std::complex<Real> FFTMerton76Engine::complexFourierTransform(
+                                                std::complex<Real> u) const {
+        const std::complex<Real> i1(0, 1);
+        const Real forward =
+            process_->x0()*dividendDiscount_/riskFreeDiscount_;
+
+        // jumps, compensated so that the forward is unchanged
+        const std::complex<Real> g = i1*u;
+        const Real delta2 = 0.5*logJumpVolatility_*logJumpVolatility_;
+        const std::complex<Real> jumps =
+            t_*jumpIntensity_*(std::exp(logMeanJump_*g + delta2*g*g) - 1.0
+                               - g*(std::exp(logMeanJump_+delta2) - 1.0));
+
+        return std::exp(i1*u*std::log(forward)
+                        - 0.5*var_*t_*(u*u + i1*u) + jumps);
+    }
+
+    Real FFTMerton76Engine::discountFactor(Date d) const {
+        boost::shared_ptr<Merton76Process> process =
+            boost::dynamic_pointer_cast<Merton76Process>(process_);
+        return process->riskFreeRate()->discount(d);
+    }
+
+    Real FFTMerton76Engine::dividendYield(Date d) const {
+        boost::shared_ptr<Merton76Process> process =
+            boost::dynamic_pointer_cast<Merton76Process>(process_);
+        return process->dividendYield()->discount(d);
+    }
+
+}
+
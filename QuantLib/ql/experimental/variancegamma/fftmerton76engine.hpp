@@ -0,0 +1,62 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file fftmerton76engine.hpp
+    \brief FFT engine for vanilla options under a Merton jump-diffusion process
+*/
+
+#ifndef quantlib_fft_merton76_engine_hpp
+#define quantlib_fft_merton76_engine_hpp
+
+#include <ql/experimental/variancegamma/fftengine.hpp>
+#include <ql/processes/merton76process.hpp>
+
+namespace QuantLib {
+
+    //! FFT engine for vanilla options under a Merton jump-diffusion process
+    /*! \ingroup vanillaengines
+
+        \test the correctness of the returned values is tested by
+        comparison with the series expansion of JumpDiffusionEngine.
+    */
+    class FFTMerton76Engine : public FFTEngine {
+      public:
+        FFTMerton76Engine(
+            const boost::shared_ptr<Merton76Process>& process,
+            Real logStrikeSpacing = 0.001);
+        virtual std::auto_ptr<FFTEngine> clone() const;
+
+      protected:
+        virtual void precalculateExpiry(Date d);
+        virtual std::complex<Real> complexFourierTransform(std::complex<Real> u) const;
+        virtual Real discountFactor(Date d) const;
+        virtual Real dividendYield(Date d) const;
+
+      private:
+        DiscountFactor dividendDiscount_;
+        DiscountFactor riskFreeDiscount_;
+        Time t_;
+        Real var_;
+        Real jumpIntensity_, logMeanJump_, logJumpVolatility_;
+    };
+
+}
+
+
+#endif
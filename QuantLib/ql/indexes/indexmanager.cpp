@@ -25,6 +25,13 @@ using std::string;
 
 namespace QuantLib {
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    void IndexManager::forkFrom(const IndexManager& manager) {
+        // the copies get their own notifiers
+        data_ = manager.data_;
+    }
+    #endif
+
     bool IndexManager::hasHistory(const string& name) const {
         return data_.find(to_upper_copy(name)) != data_.end();
     }
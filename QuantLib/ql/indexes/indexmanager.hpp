@@ -53,6 +53,9 @@ namespace QuantLib {
         //! clears all stored fixings
         void clearHistories();
       private:
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        void forkFrom(const IndexManager&);
+        #endif
         typedef std::map<std::string, ObservableValue<TimeSeries<Real> > >
                                                                   history_map;
         mutable history_map data_;
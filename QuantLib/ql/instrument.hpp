@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
- Copyright (C) 2003, 2004, 2005, 2006, 2007 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2005, 2006, 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -62,6 +62,9 @@ namespace QuantLib {
 
         //! returns whether the instrument might have value greater than zero.
         virtual bool isExpired() const = 0;
+
+        //! returns the pricing engine used, if any
+        const boost::shared_ptr<PricingEngine>& pricingEngine() const;
         //@}
         //! \name Modifiers
         //@{
@@ -130,6 +133,11 @@ namespace QuantLib {
     : NPV_(Null<Real>()), errorEstimate_(Null<Real>()),
       valuationDate_(Date()) {}
 
+    inline const boost::shared_ptr<PricingEngine>&
+    Instrument::pricingEngine() const {
+        return engine_;
+    }
+
     inline void Instrument::setPricingEngine(
                                   const boost::shared_ptr<PricingEngine>& e) {
         if (engine_)
@@ -4,6 +4,7 @@
  Copyright (C) 2002, 2003 Ferdinando Ametrano
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
  Copyright (C) 2010 Kakhkhor Abdijalilov
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -136,6 +137,40 @@ namespace QuantLib {
 
             return z;
         }
+        //! values for average=0, sigma=1 on a whole sequence
+        /*! Gives the same results as calling standard_value() on
+            each element. The central approximation is evaluated on
+            all elements first, in a loop without branches that the
+            compiler can vectorize; the few elements falling in the
+            tails are fixed afterwards.
+
+            \pre the input and output sequences must not overlap; if
+                 REFINE_TO_FULL_MACHINE_PRECISION_USING_HALLEYS_METHOD
+                 is defined, the output iterator must also be readable.
+        */
+        template <class InputIterator, class OutputIterator>
+        static void standard_values(InputIterator begin,
+                                    InputIterator end,
+                                    OutputIterator out) {
+            OutputIterator o = out;
+            for (InputIterator x=begin; x!=end; ++x, ++o) {
+                Real z = *x - 0.5;
+                Real r = z*z;
+                *o = (((((a1_*r+a2_)*r+a3_)*r+a4_)*r+a5_)*r+a6_)*z /
+                    (((((b1_*r+b2_)*r+b3_)*r+b4_)*r+b5_)*r+1.0);
+            }
+            for (InputIterator x=begin; x!=end; ++x, ++out) {
+                if (*x < x_low_ || x_high_ < *x)
+                    *out = tail_value(*x);
+                #ifdef REFINE_TO_FULL_MACHINE_PRECISION_USING_HALLEYS_METHOD
+                // same refinement as in standard_value()
+                const Real z = *out;
+                const Real r =
+                    (f_(z) - *x) * M_SQRT2 * M_SQRTPI * exp(0.5 * z*z);
+                *out = z - r/(1+0.5*z*r);
+                #endif
+            }
+        }
       private:
         /* Handling tails moved into a separate method, which should
            make the inlining of operator() and standard_value method
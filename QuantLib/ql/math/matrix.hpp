@@ -4,6 +4,7 @@
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
  Copyright (C) 2003, 2004, 2005, 2006 StatPro Italia srl
  Copyright (C) 2003, 2004 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -527,12 +528,19 @@ namespace QuantLib {
                    m1.rows() << "x" << m1.columns() << ", " <<
                    m2.rows() << "x" << m2.columns() << ") cannot be "
                    "multiplied");
-        Matrix result(m1.rows(),m2.columns());
-        for (Size i=0; i<result.rows(); i++)
-            for (Size j=0; j<result.columns(); j++)
-                result[i][j] =
-                    std::inner_product(m1.row_begin(i), m1.row_end(i),
-                                       m2.column_begin(j), 0.0);
+        Matrix result(m1.rows(),m2.columns(),0.0);
+        // the rows of m2 are accumulated into each row of the result,
+        // so that the innermost loop runs over contiguous memory; the
+        // terms are summed in the same order as in an inner product.
+        for (Size i=0; i<result.rows(); i++) {
+            Matrix::row_iterator r = result.row_begin(i);
+            for (Size k=0; k<m1.columns(); k++) {
+                Real a = m1[i][k];
+                Matrix::const_row_iterator b = m2.row_begin(k);
+                for (Size j=0; j<result.columns(); j++)
+                    r[j] += a*b[j];
+            }
+        }
         return result;
     }
 
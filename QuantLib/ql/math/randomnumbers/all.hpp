@@ -12,6 +12,7 @@
 #include <ql/math/randomnumbers/latticerules.hpp>
 #include <ql/math/randomnumbers/lecuyeruniformrng.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/math/randomnumbers/philoxuniformrng.hpp>
 #include <ql/math/randomnumbers/primitivepolynomials.h>
 #include <ql/math/randomnumbers/randomizedlds.hpp>
 #include <ql/math/randomnumbers/randomsequencegenerator.hpp>
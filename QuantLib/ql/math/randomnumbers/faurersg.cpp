@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2004 Ferdinando Ametrano
  Copyright (C) 2004 Gianni Piolanti
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -106,6 +107,39 @@ namespace QuantLib {
         // std::cout << std::endl;
   }
 
+    void FaureRsg::skipTo(unsigned long n) {
+        // The b-ary counter holds the digits of n...
+        unsigned long m = n;
+        for (Size k=0; k<mbit_; k++) {
+            bary_[k] = m % base_;
+            m /= base_;
+        }
+        QL_REQUIRE(m == 0,
+                   "cannot skip to sample " << n << " of Faure sequence");
+        bary_[mbit_] = 0;
+
+        // ...and the k-th row of the Pascal matrices was added to the
+        // Gray digits once for each draw carrying up to the k-th
+        // digit, i.e., floor(n/b^k) - floor(n/b^{k+1}) times.
+        std::vector<long int> counts(mbit_);
+        m = n;
+        for (Size k=0; k<mbit_; k++) {
+            unsigned long next = m / base_;
+            counts[k] = (m - next) % base_;
+            m = next;
+        }
+        for (Size i=0; i<dimensionality_; i++) {
+            integerSequence_[i] = 0;
+            for (Size j=0; j<mbit_; j++) {
+                long int g = 0;
+                for (Size k=j; k<mbit_; k++)
+                    g = (g + counts[k]*pascal3D[k][i][j]) % base_;
+                gray_[i][j] = g;
+                integerSequence_[i] += g*powBase_[j][base_];
+            }
+        }
+    }
+
     void FaureRsg::generateNextIntSequence() const {
         // sequenceCounter_++;
 
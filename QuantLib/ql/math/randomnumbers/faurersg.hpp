@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2004 Ferdinando Ametrano
  Copyright (C) 2004 Gianni Piolanti
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -47,6 +48,8 @@ namespace QuantLib {
       public:
         typedef Sample<std::vector<Real> > sample_type;
         FaureRsg(Size dimensionality);
+        /*! skip to the n-th sample in the low-discrepancy sequence */
+        void skipTo(unsigned long n);
         const std::vector<long int>& nextIntSequence() const {
             generateNextIntSequence();
             return integerSequence_;
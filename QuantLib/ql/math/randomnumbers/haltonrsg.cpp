@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -54,6 +55,10 @@ namespace QuantLib {
 
     }
 
+    void HaltonRsg::skipTo(unsigned long n) {
+        sequenceCounter_ = n;
+    }
+
     const HaltonRsg::sample_type& HaltonRsg::nextSequence() const {
         ++sequenceCounter_;
         unsigned long b, k;
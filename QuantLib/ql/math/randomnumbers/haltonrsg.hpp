@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -47,6 +48,8 @@ namespace QuantLib {
                   unsigned long seed = 0,
                   bool randomStart = true,
                   bool randomShift = false);
+        /*! skip to the n-th sample in the low-discrepancy sequence */
+        void skipTo(unsigned long n);
         const sample_type& nextSequence() const;
         const sample_type& lastSequence() const {
             return sequence_;
@@ -63,6 +63,10 @@ namespace QuantLib {
         const sample_type& nextSequence() const;
         const sample_type& lastSequence() const { return x_; }
         Size dimension() const { return dimension_; }
+        //! repositions the underlying uniform sequence generator
+        void skipTo(unsigned long n) {
+            uniformSequenceGenerator_.skipTo(n);
+        }
       private:
         USG uniformSequenceGenerator_;
         Size dimension_;
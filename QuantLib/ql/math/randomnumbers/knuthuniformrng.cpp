@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -19,6 +20,7 @@
 
 #include <ql/math/randomnumbers/knuthuniformrng.hpp>
 #include <ql/math/randomnumbers/seedgenerator.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
@@ -75,6 +77,20 @@ namespace QuantLib {
         for (;i<KK;i++,j++) ran_u[i]=mod_sum(aa[j-KK],ran_u[i-LL]);
     }
 
+    void KnuthUniformRng::discard(unsigned long n) {
+        while (n > 0) {
+            if (ranf_arr_ptr == ranf_arr_sentinel) {
+                ranf_arr_cycle();
+                --n;
+            } else {
+                Size k = std::min<unsigned long>(
+                                       n, ranf_arr_sentinel-ranf_arr_ptr);
+                ranf_arr_ptr += k;
+                n -= k;
+            }
+        }
+    }
+
     double KnuthUniformRng::ranf_arr_cycle() const {
         ranf_array(ranf_arr_buf,QUALITY);
         ranf_arr_ptr = 1;
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -83,4 +84,9 @@ namespace QuantLib {
         return sample_type(result,1.0);
     }
 
+    void LecuyerUniformRng::discard(unsigned long n) {
+        for (; n > 0; --n)
+            next();
+    }
+
 }
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -46,6 +47,11 @@ namespace QuantLib {
         /*! returns a sample with weight 1.0 containing a random number
              uniformly chosen from (0.0,1.0) */
         sample_type next() const;
+        /*! skips the next n numbers in the sequence. Because of the
+            shuffle, the skipped numbers must be generated; the cost
+            is linear in n.
+        */
+        void discard(unsigned long n);
       private:
         mutable long temp1, temp2;
         mutable long y;
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2003 Ferdinando Ametrano
  Copyright (C) 2010 Kakhkhor Abdijalilov
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -68,9 +69,132 @@
 
 #include <ql/math/randomnumbers/seedgenerator.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/errors.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
+    namespace {
+
+        // Polynomials over GF(2) are stored as bit arrays, 32 bits
+        // per word, the i-th coefficient being the i-th bit.
+        typedef std::vector<unsigned long> Polynomial;
+
+        const unsigned long wordMask = 0xffffffffUL;
+
+        // degree of the characteristic polynomial of MT19937
+        const Size degree = 19937;
+        const Size polynomialWords = degree/32 + 1;
+
+        // below this size, the numbers are skipped by twisting the state
+        const unsigned long jumpThreshold = 1UL << 24;
+
+        inline bool coefficient(const Polynomial& p, Size i) {
+            return ((p[i >> 5] >> (i & 31)) & 1UL) != 0;
+        }
+
+        // p ^= q * x^shift
+        void addShifted(Polynomial& p, const Polynomial& q, Size shift) {
+            Size offset = shift >> 5, bits = shift & 31;
+            for (Size w=0; w<q.size() && w+offset<p.size(); ++w) {
+                if (q[w] == 0)
+                    continue;
+                p[w+offset] ^= (q[w] << bits) & wordMask;
+                if (bits != 0 && w+offset+1 < p.size())
+                    p[w+offset+1] ^= q[w] >> (32-bits);
+            }
+        }
+
+        /* Exponents of the nonzero terms of the characteristic
+           polynomial of the recurrence.  They were obtained by
+           applying the Berlekamp-Massey algorithm to the lowest bit
+           of the numbers generated from the default seed; since the
+           polynomial is irreducible, it is also the minimal
+           polynomial of any such sequence.
+        */
+        const Size characteristicTerms[] = {
+                0,  1189,  1416,  1585,  1643,  1870,  2493,  2773,  3000,
+             3227,  3454,  3681,  3908,  4135,  4362,  4753,  5661,  6337,
+             6569,  7129,  7477,  7525,  7583,  7752,  7979,  8206,  9505,
+             9901,  9969, 10128, 10693, 10761, 10920, 11089, 11147, 11157,
+            11215, 11321, 11374, 11384, 11485, 11611, 11712, 11717, 11838,
+            11881, 11944, 11997, 12277, 12335, 12393, 12504, 12509, 12620,
+            12673, 12731, 12736, 12789, 12905, 12958, 12963, 13137, 13185,
+            13190, 13243, 13301, 13412, 13528, 13533, 13639, 13697, 13760,
+            13813, 13866, 14093, 14151, 14209, 14320, 14325, 14436, 14547,
+            14552, 14605, 14721, 14774, 14779, 14953, 15001, 15006, 15059,
+            15117, 15228, 15344, 15349, 15455, 15513, 15576, 15629, 15682,
+            15909, 15967, 16025, 16136, 16141, 16252, 16363, 16368, 16421,
+            16537, 16590, 16595, 16817, 16822, 16875, 16933, 17044, 17160,
+            17271, 17329, 17445, 17498, 17725, 17783, 17841, 17952, 18068,
+            18179, 18237, 18406, 18633, 18691, 18860, 19087, 19314, 19937
+        };
+
+        Polynomial characteristicPolynomial() {
+            Polynomial p(polynomialWords, 0UL);
+            const Size n = sizeof(characteristicTerms)/sizeof(Size);
+            for (Size k=0; k<n; ++k) {
+                Size i = characteristicTerms[k];
+                p[i >> 5] |= 1UL << (i & 31);
+            }
+            return p;
+        }
+
+        // x^n modulo the characteristic polynomial
+        Polynomial xPowerModulo(unsigned long n) {
+            const Polynomial p = characteristicPolynomial();
+
+            // the polynomial shifted by 0 to 31 bits, so that the
+            // reduction works on whole words
+            std::vector<Polynomial> shifted(32);
+            for (Size k=0; k<32; ++k) {
+                shifted[k] = Polynomial(polynomialWords+1, 0UL);
+                addShifted(shifted[k], p, k);
+            }
+
+            Polynomial r(polynomialWords, 0UL), square(2*polynomialWords);
+            r[0] = 1UL;
+            Size bit = 8*sizeof(unsigned long);
+            while (bit > 0 && ((n >> (bit-1)) & 1UL) == 0)
+                --bit;
+            for (; bit > 0; --bit) {
+                // squaring only spreads the coefficients over GF(2)...
+                for (Size w=0; w<polynomialWords; ++w) {
+                    unsigned long lo = 0, hi = 0;
+                    for (Size j=0; j<16; ++j) {
+                        lo |= ((r[w] >> j) & 1UL) << (2*j);
+                        hi |= ((r[w] >> (j+16)) & 1UL) << (2*j);
+                    }
+                    square[2*w] = lo;
+                    square[2*w+1] = hi;
+                }
+                // ...the multiplication by x, if required, shifts them...
+                if ((n >> (bit-1)) & 1UL) {
+                    unsigned long carry = 0;
+                    for (Size w=0; w<square.size(); ++w) {
+                        unsigned long next = square[w] >> 31;
+                        square[w] = ((square[w] << 1) | carry) & wordMask;
+                        carry = next;
+                    }
+                }
+                // ...and the result is reduced modulo p.
+                for (Size i=2*degree; i>=degree; --i) {
+                    if (coefficient(square, i)) {
+                        Size shift = i-degree;
+                        const Polynomial& q = shifted[shift & 31];
+                        unsigned long* s = &square[shift >> 5];
+                        for (Size w=0; w<q.size(); ++w)
+                            s[w] ^= q[w];
+                    }
+                }
+                std::copy(square.begin(), square.begin()+polynomialWords,
+                          r.begin());
+            }
+            return r;
+        }
+
+    }
+
     // constant vector a
     const unsigned long MersenneTwisterUniformRng::MATRIX_A = 0x9908b0dfUL;
     // most significant w-r bits
@@ -142,4 +266,61 @@ namespace QuantLib {
         mti = 0;
     }
 
+    void MersenneTwisterUniformRng::discard(unsigned long n) {
+        if (n < jumpThreshold) {
+            while (n > 0) {
+                if (mti == N)
+                    twist();
+                Size k = std::min<unsigned long>(n, N-mti);
+                mti += k;
+                n -= k;
+            }
+            return;
+        }
+
+        /* The state is seen as the window x_k...x_{k+N-1} on the
+           sequence of untempered words, with x_k = mt[0]; each step
+           of the recurrence moves the window by one word. Since the
+           next number is x_{k+mti}, the window must move by mti+n
+           words. The first word of the window affects the next ones
+           only through its upper bit; therefore, after the first
+           step, the window W evolves in the subspace on which the
+           characteristic polynomial p vanishes, and the window after
+           d steps can be written as f(q(f)W), where f is a step of
+           the recurrence and q(x) = x^{d-1} mod p.
+        */
+        unsigned long d = mti + n;
+        QL_REQUIRE(d >= n, "jump size exceeds largest supported value");
+        Polynomial q = xPowerModulo(d-1);
+
+        Size top = degree;
+        while (top > 0 && !coefficient(q, top-1))
+            --top;
+
+        // q(f)W by Horner's rule; the window starts at index i.
+        std::vector<unsigned long> w(N, 0UL);
+        Size i = 0;
+        for (Size j=top; j>0; --j) {
+            // one step of the recurrence...
+            unsigned long y = (w[i]&UPPER_MASK)|(w[(i+1)%N]&LOWER_MASK);
+            w[i] = w[(i+M)%N] ^ (y >> 1) ^ ((y & 0x1UL) ? MATRIX_A : 0UL);
+            i = (i+1)%N;
+            // ...and the addition of W
+            if (coefficient(q, j-1)) {
+                for (Size k=0; k<N-i; ++k)
+                    w[i+k] ^= mt[k];
+                for (Size k=N-i; k<N; ++k)
+                    w[i+k-N] ^= mt[k];
+            }
+        }
+        // the last step
+        unsigned long y = (w[i]&UPPER_MASK)|(w[(i+1)%N]&LOWER_MASK);
+        w[i] = w[(i+M)%N] ^ (y >> 1) ^ ((y & 0x1UL) ? MATRIX_A : 0UL);
+        i = (i+1)%N;
+
+        for (Size k=0; k<N; ++k)
+            mt[k] = w[(i+k)%N];
+        mti = 0;
+    }
+
 }
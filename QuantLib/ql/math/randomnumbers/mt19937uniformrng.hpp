@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2003 Ferdinando Ametrano
  Copyright (C) 2010 Kakhkhor Abdijalilov
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -35,8 +36,17 @@ namespace QuantLib {
 
         For more details see http://www.math.keio.ac.jp/matumoto/emt.html
 
-        \test the correctness of the returned values is tested by
-              checking them against known good results.
+        The generator can jump ahead in its sequence by means of the
+        polynomial method described in H. Haramoto, M. Matsumoto,
+        T. Nishimura, F. Panneton and P. L'Ecuyer, "Efficient jump
+        ahead for F2-linear random number generators", INFORMS
+        Journal on Computing 20(3), 2008.
+
+        \test
+        - the correctness of the returned values is tested by
+          checking them against known good results.
+        - the results of discard() are checked against the ones
+          obtained by drawing the skipped numbers.
     */
     class MersenneTwisterUniformRng {
       private:
@@ -70,6 +80,17 @@ namespace QuantLib {
             y ^= (y >> 18);
             return y;
         }
+        //! skips the next n numbers in the sequence
+        /*! For n of 2^24 or more, the state jumps ahead by means of
+            O(log n) multiplications modulo the characteristic
+            polynomial of the recurrence; the cost is about the same
+            as drawing ten to twenty million numbers.  For smaller n,
+            the state is twisted forward instead.
+
+            \note the characteristic polynomial is stored as the list
+                  of its nonzero terms; no initialization is required.
+        */
+        void discard(unsigned long n);
       private:
         void seedInitialization(unsigned long seed);
         void twist() const;
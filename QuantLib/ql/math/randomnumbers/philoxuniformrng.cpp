@@ -0,0 +1,108 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/math/randomnumbers/philoxuniformrng.hpp>
+#include <ql/math/randomnumbers/seedgenerator.hpp>
+#include <boost/cstdint.hpp>
+
+namespace QuantLib {
+
+    namespace {
+
+        const boost::uint64_t M0 = 0xD2511F53UL;
+        const boost::uint64_t M1 = 0xCD9E8D57UL;
+        const unsigned long W0 = 0x9E3779B9UL;
+        const unsigned long W1 = 0xBB67AE85UL;
+        const unsigned long mask = 0xffffffffUL;
+        const Size rounds = 10;
+
+        boost::uint64_t lowerCounter(const unsigned long counter[4]) {
+            return (boost::uint64_t(counter[1]) << 32) | counter[0];
+        }
+
+        void setLowerCounter(unsigned long counter[4], boost::uint64_t c) {
+            counter[0] = (unsigned long)(c & mask);
+            counter[1] = (unsigned long)(c >> 32);
+        }
+
+    }
+
+    PhiloxUniformRng::PhiloxUniformRng(BigNatural seed, BigNatural stream)
+    : used_(4) {
+        if (seed == 0)
+            seed = SeedGenerator::instance().get();
+        // the double shift avoids undefined behavior when BigNatural
+        // has 32 bits only
+        key_[0] = (unsigned long)(seed & mask);
+        key_[1] = (unsigned long)(((seed >> 16) >> 16) & mask);
+        counter_[0] = counter_[1] = 0;
+        counter_[2] = (unsigned long)(stream & mask);
+        counter_[3] = (unsigned long)(((stream >> 16) >> 16) & mask);
+    }
+
+    void PhiloxUniformRng::generate(const unsigned long counter[4],
+                                    const unsigned long key[2],
+                                    unsigned long result[4]) {
+        unsigned long c0 = counter[0], c1 = counter[1],
+                      c2 = counter[2], c3 = counter[3];
+        unsigned long k0 = key[0], k1 = key[1];
+        for (Size i=0; i<rounds; ++i) {
+            if (i > 0) {
+                k0 = (k0 + W0) & mask;
+                k1 = (k1 + W1) & mask;
+            }
+            boost::uint64_t p0 = M0 * c0, p1 = M1 * c2;
+            unsigned long hi0 = (unsigned long)(p0 >> 32),
+                          lo0 = (unsigned long)(p0 & mask),
+                          hi1 = (unsigned long)(p1 >> 32),
+                          lo1 = (unsigned long)(p1 & mask);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+        }
+        result[0] = c0;
+        result[1] = c1;
+        result[2] = c2;
+        result[3] = c3;
+    }
+
+    void PhiloxUniformRng::nextBlock() const {
+        generate(counter_, key_, block_);
+        setLowerCounter(counter_, lowerCounter(counter_) + 1);
+        used_ = 0;
+    }
+
+    void PhiloxUniformRng::discard(unsigned long n) {
+        // the buffered block (if any) was generated from the counter
+        // preceding the current one; wrap-around takes care of the
+        // initial state, in which the buffer is empty.
+        boost::uint64_t position =
+            (lowerCounter(counter_) - 1) * 4 + used_ + n;
+        setLowerCounter(counter_, position / 4);
+        used_ = 4;
+        Size offset = Size(position % 4);
+        if (offset != 0) {
+            nextBlock();
+            used_ = offset;
+        }
+    }
+
+}
+
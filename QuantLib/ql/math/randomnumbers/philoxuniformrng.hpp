@@ -0,0 +1,91 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file philoxuniformrng.hpp
+    \brief Philox counter-based uniform random number generator
+*/
+
+#ifndef quantlib_philox_uniform_rng_hpp
+#define quantlib_philox_uniform_rng_hpp
+
+#include <ql/methods/montecarlo/sample.hpp>
+
+namespace QuantLib {
+
+    //! Uniform random number generator
+    /*! Philox4x32-10 counter-based random number generator.  Each
+        128-bit counter is mapped to four 32-bit random numbers by
+        ten rounds of a keyed bijection; the generator just walks
+        through consecutive counters.  The state is therefore a few
+        words, and any position in the sequence can be reached in
+        constant time.
+
+        The key is given by the seed; the upper half of the counter
+        can be set to a stream index, e.g., the index of a path, so
+        that each stream can be generated independently of the
+        others.
+
+        For more details see J.K. Salmon, M.A. Moraes, R.O. Dror and
+        D.E. Shaw, "Parallel random numbers: as easy as 1, 2, 3",
+        Proceedings of the International Conference for High
+        Performance Computing, Networking, Storage and Analysis, 2011.
+
+        \test the correctness of the returned values is tested by
+              checking them against known good results.
+    */
+    class PhiloxUniformRng {
+      public:
+        typedef Sample<Real> sample_type;
+        /*! if the given seed is 0, a random seed will be chosen
+            based on clock() */
+        explicit PhiloxUniformRng(BigNatural seed = 0,
+                                  BigNatural stream = 0);
+        /*! returns a sample with weight 1.0 containing a random number
+            in the (0.0, 1.0) interval  */
+        sample_type next() const { return sample_type(nextReal(),1.0); }
+        //! return a random number in the (0.0, 1.0)-interval
+        Real nextReal() const {
+            return (Real(nextInt32()) + 0.5)/4294967296.0;
+        }
+        //! return a random integer in the [0,0xffffffff]-interval
+        unsigned long nextInt32() const {
+            if (used_ == 4)
+                nextBlock();
+            return block_[used_++];
+        }
+        //! skips the next n numbers in the sequence in constant time
+        void discard(unsigned long n);
+        /*! writes in the passed array the four random integers
+            corresponding to the given counter and key.
+        */
+        static void generate(const unsigned long counter[4],
+                             const unsigned long key[2],
+                             unsigned long result[4]);
+      private:
+        void nextBlock() const;
+        unsigned long key_[2];
+        mutable unsigned long counter_[4];
+        mutable unsigned long block_[4];
+        mutable Size used_;
+    };
+
+}
+
+
+#endif
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -25,6 +26,7 @@
 #define quantlib_random_sequence_generator_h
 
 #include <ql/methods/montecarlo/sample.hpp>
+#include <ql/math/randomnumbers/seedgenerator.hpp>
 #include <ql/errors.hpp>
 #include <vector>
 
@@ -44,6 +46,13 @@ namespace QuantLib {
             unsigned long RNG::nextInt32() const;
         \endcode
 
+        To use the skipTo() and discard() methods, class RNG must
+        implement
+        \code
+            void RNG::discard(unsigned long n);
+        \endcode
+        and, for skipTo(), a constructor taking a seed.
+
         \warning do not use with low-discrepancy sequence generator.
     */
     template<class RNG>
@@ -52,7 +61,7 @@ namespace QuantLib {
         typedef Sample<std::vector<Real> > sample_type;
         RandomSequenceGenerator(Size dimensionality,
                                 const RNG& rng)
-        : dimensionality_(dimensionality), rng_(rng),
+        : dimensionality_(dimensionality), seed_(0), rng_(rng),
           sequence_(std::vector<Real> (dimensionality), 1.0),
           int32Sequence_(dimensionality) {
           QL_REQUIRE(dimensionality>0, 
@@ -61,9 +70,14 @@ namespace QuantLib {
 
         RandomSequenceGenerator(Size dimensionality,
                                 BigNatural seed = 0)
-        : dimensionality_(dimensionality), rng_(seed),
+        : dimensionality_(dimensionality),
+          seed_(seed != 0 ? seed : SeedGenerator::instance().get()),
+          rng_(seed_),
           sequence_(std::vector<Real> (dimensionality), 1.0),
-          int32Sequence_(dimensionality) {}
+          int32Sequence_(dimensionality) {
+          QL_REQUIRE(dimensionality>0,
+                     "dimensionality must be greater than 0");
+        }
 
         const sample_type& nextSequence() const {
             sequence_.weight = 1.0;
@@ -84,8 +98,34 @@ namespace QuantLib {
             return sequence_;
         }
         Size dimension() const {return dimensionality_;}
+        /*! repositions the generator at the n-th sequence from the
+            start, regardless of the sequences already drawn; the
+            following draws are the same that would be obtained by
+            drawing n sequences from a new generator.
+
+            \pre the generator must have been built from a seed.
+        */
+        void skipTo(unsigned long n) {
+            QL_REQUIRE(seed_ != 0,
+                       "cannot reposition a generator "
+                       "not built from a seed");
+            rng_ = RNG(seed_);
+            discard(n);
+        }
+        /*! skips the next n sequences, so that the following draws
+            are the same that would be obtained after drawing them;
+            the cost depends on the underlying generator.
+        */
+        void discard(unsigned long n) {
+            QL_REQUIRE(n <= (std::numeric_limits<unsigned long>::max)()/
+                                                           dimensionality_,
+                       "cannot discard " << n << " sequences of " <<
+                       dimensionality_ << " numbers");
+            rng_.discard(n*dimensionality_);
+        }
       private:
         Size dimensionality_;
+        BigNatural seed_;
         RNG rng_;
         mutable sample_type sequence_;
         mutable std::vector<BigNatural> int32Sequence_;
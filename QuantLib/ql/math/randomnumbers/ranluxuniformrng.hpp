@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2009 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -52,6 +53,13 @@ namespace QuantLib {
         sample_type next() const {
             return sample_type(ranlux3_(), 1.0);
         }
+        /*! skips the next n numbers in the sequence. The skipped
+            numbers are generated; the cost is linear in n.
+        */
+        void discard(unsigned long n) {
+            for (; n > 0; --n)
+                ranlux3_();
+        }
 
       private:
         mutable boost::ranlux64_3_01 ranlux3_;
@@ -67,6 +75,13 @@ namespace QuantLib {
         sample_type next() const {
             return sample_type(ranlux4_(), 1.0);
         }
+        /*! skips the next n numbers in the sequence. The skipped
+            numbers are generated; the cost is linear in n.
+        */
+        void discard(unsigned long n) {
+            for (; n > 0; --n)
+                ranlux4_();
+        }
 
       private:
         mutable boost::ranlux64_4_01 ranlux4_;
@@ -4,6 +4,7 @@
  Copyright (C) 2004 Ferdinando Ametrano
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
  Copyright (C) 2004 Walter Penschke
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -48,12 +49,32 @@ namespace QuantLib {
         typedef InverseCumulativeRsg<ursg_type,IC> rsg_type;
         // more traits
         enum { allowsErrorEstimate = 1 };
-        // factory
+        // factories
         static rsg_type make_sequence_generator(Size dimension,
                                                 BigNatural seed) {
             ursg_type g(dimension, seed);
             return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
         }
+        /*! returns a generator for the given substream of the
+            sequence generated from the given seed. Each substream
+            holds the given number of consecutive sequences, so that
+            different substreams don't overlap and, taken in order,
+            reproduce the draws of a single generator.
+        */
+        static rsg_type make_sequence_generator(Size dimension,
+                                                BigNatural seed,
+                                                BigNatural substream,
+                                                BigNatural samples) {
+            QL_REQUIRE(seed != 0,
+                       "a non-null seed is required for substreams");
+            QL_REQUIRE(samples == 0 || substream <=
+                       (std::numeric_limits<BigNatural>::max)()/samples,
+                       "substream " << substream << " of " << samples <<
+                       " samples out of range");
+            ursg_type g(dimension, seed);
+            g.discard(substream*samples);
+            return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
+        }
         // data
         static boost::shared_ptr<IC> icInstance;
     };
@@ -85,12 +106,28 @@ namespace QuantLib {
         typedef InverseCumulativeRsg<ursg_type,IC> rsg_type;
         // more traits
         enum { allowsErrorEstimate = 0 };
-        // factory
+        // factories
         static rsg_type make_sequence_generator(Size dimension,
                                                 BigNatural seed) {
             ursg_type g(dimension, seed);
             return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
         }
+        /*! returns a generator for the given substream of the
+            sequence; each substream holds the given number of
+            consecutive points, as for the pseudo-random traits.
+        */
+        static rsg_type make_sequence_generator(Size dimension,
+                                                BigNatural seed,
+                                                BigNatural substream,
+                                                BigNatural samples) {
+            QL_REQUIRE(samples == 0 || substream <=
+                       (std::numeric_limits<BigNatural>::max)()/samples,
+                       "substream " << substream << " of " << samples <<
+                       " samples out of range");
+            ursg_type g(dimension, seed);
+            g.skipTo(substream*samples);
+            return (icInstance ? rsg_type(g, *icInstance) : rsg_type(g));
+        }
         // data
         static boost::shared_ptr<IC> icInstance;
     };
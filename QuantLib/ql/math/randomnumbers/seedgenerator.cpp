@@ -19,6 +19,9 @@
 
 #include <ql/math/randomnumbers/seedgenerator.hpp>
 #include <ctime>
+#if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+#include <boost/detail/atomic_count.hpp>
+#endif
 #if defined(BOOST_NO_STDC_NAMESPACE)
     namespace std { using ::time; }
 #endif
@@ -34,6 +37,12 @@ namespace QuantLib {
 
         // firstSeed is chosen based on clock() and used for the first rng
         unsigned long firstSeed = (unsigned long)(std::time(0));
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        // each context has its own generator, and several of them
+        // can be created within the same second
+        static boost::detail::atomic_count instances(0);
+        firstSeed ^= (unsigned long)(++instances) * 2654435761UL;
+        #endif
         MersenneTwisterUniformRng first(firstSeed);
 
         // secondSeed is as random as it could be
@@ -56,6 +65,17 @@ namespace QuantLib {
             rng_.nextInt32();
     }
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    void SeedGenerator::forkFrom(SeedGenerator& parent) {
+        // seeded from the parent, so that generators in different
+        // contexts don't return the same seeds when forked together
+        std::vector<unsigned long> init(4);
+        for (Size i=0; i<init.size(); ++i)
+            init[i] = parent.get();
+        rng_ = MersenneTwisterUniformRng(init);
+    }
+    #endif
+
     unsigned long SeedGenerator::get() {
         return rng_.nextInt32();
     }
@@ -42,6 +42,9 @@ namespace QuantLib {
       private:
         SeedGenerator();
         void initialize();
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        void forkFrom(SeedGenerator&);
+        #endif
         MersenneTwisterUniformRng rng_;
     };
 
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2012 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -56,4 +57,16 @@ namespace QuantLib {
     Size SobolBrownianBridgeRsg::dimension() const {
         return dim_;
     }
+
+    void SobolBrownianBridgeRsg::nextBlock(std::vector<Matrix>& draws) const {
+        gen_.nextBlock(draws);
+    }
+
+    void nextSequenceBlock(const SobolBrownianBridgeRsg& generator,
+                           std::vector<Matrix>& draws,
+                           Array& weights) {
+        generator.nextBlock(draws);
+        std::fill(weights.begin(), weights.end(), 1.0);
+    }
+
 }
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2012 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -43,12 +44,25 @@ namespace QuantLib {
         const sample_type& nextSequence() const;
         const sample_type& lastSequence() const;
         Size dimension() const;
+        /*! fills the passed matrices with the next sequences, stored
+            by step: draws[i][k][j] is the \f$ k \f$-th variate at the
+            \f$ i \f$-th step of the \f$ j \f$-th sequence.
+            The last sequence is not updated.
+        */
+        void nextBlock(std::vector<Matrix>& draws) const;
 
       private:
         const Size factors_, steps_, dim_;
         mutable sample_type seq_;
         mutable SobolBrownianGenerator gen_;
     };
+
+    //! block generation for MultiPathGenerator
+    /*! The sequences are written directly into the draws. */
+    void nextSequenceBlock(const SobolBrownianBridgeRsg& generator,
+                           std::vector<Matrix>& draws,
+                           Array& weights);
+
 }
 
 #endif
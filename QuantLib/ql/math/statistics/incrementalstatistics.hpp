@@ -126,6 +126,12 @@ namespace QuantLib {
             for (;begin!=end;++begin,++wbegin)
                 add(*begin, *wbegin);
         }
+        //! adds the data collected by another instance
+        /*! The result is the same as if the data added to the other
+            instance had been added to this one, up to the order of
+            summation.
+        */
+        void merge(const IncrementalStatistics& other);
         //! resets the data to a null set
         void reset();
         //@}
@@ -122,6 +122,37 @@ namespace QuantLib {
         }
     }
 
+    void FdmBlackScholesOp::apply(const Array& u, Array& out) const {
+        mapT_.apply(u, out);
+    }
+
+    void FdmBlackScholesOp::apply_direction(Size direction,
+                                            const Array& r,
+                                            Array& out) const {
+        if (direction == direction_) {
+            mapT_.apply(r, out);
+        } else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::fill(out.begin(), out.end(), 0.0);
+        }
+    }
+
+    void FdmBlackScholesOp::apply_mixed(const Array& r, Array& out) const {
+        if (out.size() != r.size())
+            out = Array(r.size());
+        std::fill(out.begin(), out.end(), 0.0);
+    }
+
+    void FdmBlackScholesOp::solve_splitting(Size direction, const Array& r,
+                                            Real dt, Array& out,
+                                            Array& workspace) const {
+        if (direction == direction_)
+            mapT_.solve_splitting(r, dt, 1.0, out, workspace);
+        else if (&out != &r)
+            out = r;
+    }
+
     Disposable<Array> FdmBlackScholesOp::preconditioner(const Array& r,
                                                         Real dt) const {
         return solve_splitting(direction_, r, dt);
@@ -108,6 +108,47 @@ namespace QuantLib {
         }
     }
 
+    void FdmG2Op::apply(const Array& r, Array& out) const {
+        mapX_.apply(r, out);
+        mapY_.apply_add(r, out);
+        corrMap_.apply_add(r, out);
+    }
+
+    void FdmG2Op::apply_mixed(const Array& r, Array& out) const {
+        corrMap_.apply(r, out);
+    }
+
+    void FdmG2Op::apply_direction(Size direction,
+                                  const Array& r, Array& out) const {
+        if (direction == direction1_) {
+            mapX_.apply(r, out);
+        }
+        else if (direction == direction2_) {
+            mapY_.apply(r, out);
+        }
+        else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::fill(out.begin(), out.end(), 0.0);
+        }
+    }
+
+    void FdmG2Op::solve_splitting(Size direction, const Array& r,
+                                  Real a, Array& out,
+                                  Array& workspace) const {
+        if (direction == direction1_) {
+            mapX_.solve_splitting(r, a, 1.0, out, workspace);
+        }
+        else if (direction == direction2_) {
+            mapY_.solve_splitting(r, a, 1.0, out, workspace);
+        }
+        else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::fill(out.begin(), out.end(), 0.0);
+        }
+    }
+
     Disposable<Array>
     FdmG2Op::preconditioner(const Array& r, Real dt) const {
         return solve_splitting(direction1_, r, dt);
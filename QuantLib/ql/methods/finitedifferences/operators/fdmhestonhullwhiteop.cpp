@@ -151,6 +151,38 @@ namespace QuantLib {
             QL_FAIL("direction too large");
     }
     
+    void FdmHestonHullWhiteOp::apply_direction(Size direction,
+                                               const Array& r,
+                                               Array& out) const {
+        if (direction == 0)
+            dxMap_.getMap().apply(r, out);
+        else if (direction == 1)
+            dyMap_.apply(r, out);
+        else if (direction == 2)
+            hullWhiteOp_.apply(r, out);
+        else
+            QL_FAIL("direction too large");
+    }
+
+    void FdmHestonHullWhiteOp::apply_mixed(const Array& r, Array& out) const {
+        hestonCorrMap_.apply(r, out);
+        equityIrCorrMap_.apply_add(r, out);
+    }
+
+    void FdmHestonHullWhiteOp::solve_splitting(Size direction,
+                                               const Array& r, Real a,
+                                               Array& out,
+                                               Array& workspace) const {
+        if (direction == 0)
+            dxMap_.getMap().solve_splitting(r, a, 1.0, out, workspace);
+        else if (direction == 1)
+            dyMap_.solve_splitting(r, a, 1.0, out, workspace);
+        else if (direction == 2)
+            hullWhiteOp_.solve_splitting(2, r, a, out, workspace);
+        else
+            QL_FAIL("direction too large");
+    }
+
     Disposable<Array> FdmHestonHullWhiteOp::preconditioner(const Array& r, 
                                                            Real dt) const {
         return solve_splitting(0, r, dt);
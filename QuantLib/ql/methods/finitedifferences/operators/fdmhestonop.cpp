@@ -156,6 +156,37 @@ namespace QuantLib {
             QL_FAIL("direction too large");
     }
 
+    void FdmHestonOp::apply(const Array& u, Array& out) const {
+        dyMap_.getMap().apply(u, out);
+        dxMap_.getMap().apply_add(u, out);
+        correlationMap_.apply_add(u, out);
+    }
+
+    void FdmHestonOp::apply_direction(Size direction,
+                                      const Array& r, Array& out) const {
+        if (direction == 0)
+            dxMap_.getMap().apply(r, out);
+        else if (direction == 1)
+            dyMap_.getMap().apply(r, out);
+        else
+            QL_FAIL("direction too large");
+    }
+
+    void FdmHestonOp::apply_mixed(const Array& r, Array& out) const {
+        correlationMap_.apply(r, out);
+    }
+
+    void FdmHestonOp::solve_splitting(Size direction, const Array& r,
+                                      Real a, Array& out,
+                                      Array& workspace) const {
+        if (direction == 0)
+            dxMap_.getMap().solve_splitting(r, a, 1.0, out, workspace);
+        else if (direction == 1)
+            dyMap_.getMap().solve_splitting(r, a, 1.0, out, workspace);
+        else
+            QL_FAIL("direction too large");
+    }
+
     Disposable<Array>
         FdmHestonOp::preconditioner(const Array& r, Real dt) const {
 
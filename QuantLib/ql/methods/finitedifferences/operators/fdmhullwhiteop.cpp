@@ -89,6 +89,39 @@ namespace QuantLib {
         }
     }
 
+    void FdmHullWhiteOp::apply(const Array& r, Array& out) const {
+        mapT_.apply(r, out);
+    }
+
+    void FdmHullWhiteOp::apply_mixed(const Array& r, Array& out) const {
+        if (out.size() != r.size())
+            out = Array(r.size());
+        std::fill(out.begin(), out.end(), 0.0);
+    }
+
+    void FdmHullWhiteOp::apply_direction(Size direction,
+                                         const Array& r, Array& out) const {
+        if (direction == direction_) {
+            mapT_.apply(r, out);
+        } else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::fill(out.begin(), out.end(), 0.0);
+        }
+    }
+
+    void FdmHullWhiteOp::solve_splitting(Size direction, const Array& r,
+                                         Real a, Array& out,
+                                         Array& workspace) const {
+        if (direction == direction_) {
+            mapT_.solve_splitting(r, a, 1.0, out, workspace);
+        } else {
+            if (out.size() != r.size())
+                out = Array(r.size());
+            std::fill(out.begin(), out.end(), 0.0);
+        }
+    }
+
     Disposable<Array>
     FdmHullWhiteOp::preconditioner(const Array& r, Real dt) const {
         return solve_splitting(direction_, r, dt);
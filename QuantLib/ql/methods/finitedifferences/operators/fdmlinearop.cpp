@@ -0,0 +1,61 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/methods/finitedifferences/operators/fdmlinearop.hpp>
+#include <ql/utilities/null.hpp>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace QuantLib {
+
+    namespace {
+
+        // zero if not set in the calling thread; without OpenMP the
+        // operators are always applied serially and the setting is
+        // only informative, so thread-local storage is not required
+        #ifdef _OPENMP
+        QL_THREAD_LOCAL int operatorThreads = 0;
+        #else
+        int operatorThreads = 0;
+        #endif
+
+    }
+
+    FdmOperatorThreads::FdmOperatorThreads(Size threads)
+    : previous_(operatorThreads) {
+        if (threads != Null<Size>())
+            operatorThreads = int(threads);
+    }
+
+    FdmOperatorThreads::~FdmOperatorThreads() {
+        operatorThreads = previous_;
+    }
+
+    int FdmOperatorThreads::current() {
+        if (operatorThreads != 0)
+            return operatorThreads;
+        #ifdef _OPENMP
+        return omp_get_max_threads();
+        #else
+        return 1;
+        #endif
+    }
+
+}
@@ -28,6 +28,7 @@
 
 #include <ql/math/array.hpp>
 #include <ql/math/matrixutilities/sparsematrix.hpp>
+#include <boost/noncopyable.hpp>
 
 namespace QuantLib {
 
@@ -36,11 +37,38 @@ namespace QuantLib {
         typedef Array array_type;
         virtual ~FdmLinearOp() { }
         virtual Disposable<array_type> apply(const array_type& r) const = 0;
+        //! writes the result into the given array
+        /*! Operators can override this method to avoid allocating a
+            new array at each call; \c out is resized if needed and
+            must not be the same array as \c r.
+        */
+        virtual void apply(const array_type& r, array_type& out) const {
+            out = apply(r);
+        }
 
 #if !defined(QL_NO_UBLAS_SUPPORT)
         virtual Disposable<SparseMatrix> toMatrix() const = 0;
 #endif
     };
+
+    //! Number of threads used by the parallel loops of the operators
+    /*! When OpenMP is enabled, the number is kept separately for
+        each calling thread, so that setting it affects neither other
+        threads nor any other OpenMP code; FdmBackwardSolver sets it
+        for the duration of a rollback.  Without OpenMP, the operators
+        run serially and the number is not used.
+    */
+    class FdmOperatorThreads : private boost::noncopyable {
+      public:
+        //! sets the number for the calling thread while alive
+        /*! If Null<Size>() is passed, the OpenMP default is used. */
+        explicit FdmOperatorThreads(Size threads);
+        ~FdmOperatorThreads();
+        //! number for the calling thread, to be passed to num_threads
+        static int current();
+      private:
+        int previous_;
+    };
 }
 
 #endif
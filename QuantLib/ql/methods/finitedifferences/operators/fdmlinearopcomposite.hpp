@@ -51,6 +51,32 @@ namespace QuantLib {
         virtual Disposable<Array> 
             preconditioner(const Array& r, Real s) const = 0;
 
+        /*! \name In-place versions
+            These methods write their result into the passed array,
+            which is resized if needed; for apply_mixed and
+            apply_direction it must be different from \c r, while
+            solve_splitting accepts the same array as input and
+            output and uses the passed workspace, which must be
+            different from both, as scratch space. The default
+            implementations forward to the methods above; operators
+            used in performance-critical rollbacks override them to
+            avoid temporaries.
+        */
+        //@{
+        virtual void apply_mixed(const Array& r, Array& out) const {
+            out = apply_mixed(r);
+        }
+        virtual void apply_direction(Size direction,
+                                     const Array& r, Array& out) const {
+            out = apply_direction(direction, r);
+        }
+        virtual void solve_splitting(Size direction, const Array& r,
+                                     Real s, Array& out,
+                                     Array& /*workspace*/) const {
+            out = solve_splitting(direction, r, s);
+        }
+        //@}
+
 #if !defined(QL_NO_UBLAS_SUPPORT)
         virtual Disposable<std::vector<SparseMatrix> > toMatrixDecomp() const {
             QL_FAIL(" ublas representation is not implemented");
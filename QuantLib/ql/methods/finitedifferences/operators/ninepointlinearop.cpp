@@ -25,6 +25,97 @@
 
 namespace QuantLib {
 
+    namespace {
+
+        // coefficients and neighbour indices of the stencil
+        struct NinePointStencil {
+            const Real *a00, *a01, *a02, *a10, *a11, *a12;
+            const Real *a20, *a21, *a22;
+            const Size *i00, *i01, *i02, *i10, *i12, *i20, *i21, *i22;
+        };
+
+        // out[i] = (or +=) sum of coefficients times neighbours for i
+        // in [from, to). The first version finds the neighbours through
+        // the index arrays; the second, used for the points not lying
+        // on the boundary along either direction, finds them at fixed
+        // distances and can be vectorised.
+        template <bool add>
+        inline void gatherStencil(const NinePointStencil& m,
+                                  const Real* u, Real* out,
+                                  Size from, Size to) {
+            for (Size i=from; i < to; ++i) {
+                const Real v =   m.a00[i]*u[m.i00[i]]
+                               + m.a01[i]*u[m.i01[i]]
+                               + m.a02[i]*u[m.i02[i]]
+                               + m.a10[i]*u[m.i10[i]]
+                               + m.a11[i]*u[i]
+                               + m.a12[i]*u[m.i12[i]]
+                               + m.a20[i]*u[m.i20[i]]
+                               + m.a21[i]*u[m.i21[i]]
+                               + m.a22[i]*u[m.i22[i]];
+                if (add) out[i] += v; else out[i] = v;
+            }
+        }
+
+        template <bool add>
+        inline void stridedStencil(const NinePointStencil& m,
+                                   const Real* u, Real* out,
+                                   Size s0, Size s1, Size from, Size to) {
+            const Real *a00(m.a00), *a01(m.a01), *a02(m.a02);
+            const Real *a10(m.a10), *a11(m.a11), *a12(m.a12);
+            const Real *a20(m.a20), *a21(m.a21), *a22(m.a22);
+            for (Size i=from; i < to; ++i) {
+                const Real v =   a00[i]*u[i-s0-s1]
+                               + a01[i]*u[i-s0]
+                               + a02[i]*u[i-s0+s1]
+                               + a10[i]*u[i-s1]
+                               + a11[i]*u[i]
+                               + a12[i]*u[i+s1]
+                               + a20[i]*u[i+s0-s1]
+                               + a21[i]*u[i+s0]
+                               + a22[i]*u[i+s0+s1];
+                if (add) out[i] += v; else out[i] = v;
+            }
+        }
+
+        template <bool add>
+        void applyStencil(const NinePointStencil& m,
+                          const Real* u, Real* out,
+                          const FdmLinearOpLayout& layout,
+                          Size d0, Size d1) {
+            const Size size = layout.size();
+            const Size s0 = layout.spacing()[d0], s1 = layout.spacing()[d1];
+            // p is the inner direction, q the outer one
+            const Size p = std::min(d0, d1), q = std::max(d0, d1);
+            const Size np = layout.dim()[p], nq = layout.dim()[q];
+            const Size sp = layout.spacing()[p], sq = layout.spacing()[q];
+
+            if (np < 3 || nq < 3) {
+                gatherStencil<add>(m, u, out, 0, size);
+                return;
+            }
+
+            // Each segment spans a whole line along p, and therefore
+            // has constant coordinate along q; its inner points are
+            // contiguous.
+            const Size length = np*sp, segments = size/length;
+            #pragma omp parallel for num_threads(FdmOperatorThreads::current())
+            for (Size k=0; k < segments; ++k) {
+                const Size first = k*length, last = first+length;
+                const Size c = (first/sq) % nq;
+                if (c == 0 || c == nq-1) {
+                    gatherStencil<add>(m, u, out, first, last);
+                } else {
+                    gatherStencil<add>(m, u, out, first, first+sp);
+                    stridedStencil<add>(m, u, out, s0, s1,
+                                        first+sp, last-sp);
+                    gatherStencil<add>(m, u, out, last-sp, last);
+                }
+            }
+        }
+
+    }
+
     NinePointLinearOp::NinePointLinearOp(
         Size d0, Size d1,
         const boost::shared_ptr<FdmMesher>& mesher)
@@ -71,7 +162,8 @@ namespace QuantLib {
     }
 
     NinePointLinearOp::NinePointLinearOp(const NinePointLinearOp& m)
-    : i00_(new Size[m.mesher_->layout()->size()]),
+    : d0_(m.d0_), d1_(m.d1_),
+      i00_(new Size[m.mesher_->layout()->size()]),
       i10_(new Size[m.mesher_->layout()->size()]),
       i20_(new Size[m.mesher_->layout()->size()]),
       i01_(new Size[m.mesher_->layout()->size()]),
@@ -130,35 +222,52 @@ namespace QuantLib {
 
     Disposable<Array> NinePointLinearOp::apply(const Array& u)
         const {
-
-        const boost::shared_ptr<FdmLinearOpLayout> index=mesher_->layout();
-        QL_REQUIRE(u.size() == index->size(),"inconsistent length of r "
-                    << u.size() << " vs " << index->size());
-
         Array retVal(u.size());
-        // direct access to make the following code faster.
-        const Real *a00(a00_.get()), *a01(a01_.get()), *a02(a02_.get());
-        const Real *a10(a10_.get()), *a11(a11_.get()), *a12(a12_.get());
-        const Real *a20(a20_.get()), *a21(a21_.get()), *a22(a22_.get());
-        const Size *i00(i00_.get()), *i01(i01_.get()), *i02(i02_.get());
-        const Size *i10(i10_.get()),                   *i12(i12_.get());
-        const Size *i20(i20_.get()), *i21(i21_.get()), *i22(i22_.get());
-
-        #pragma omp parallel for
-        for (Size i=0; i < retVal.size(); ++i) {
-            retVal[i] =   a00[i]*u[i00[i]]
-                        + a01[i]*u[i01[i]]
-                        + a02[i]*u[i02[i]]
-                        + a10[i]*u[i10[i]]
-                        + a11[i]*u[i]
-                        + a12[i]*u[i12[i]]
-                        + a20[i]*u[i20[i]]
-                        + a21[i]*u[i21[i]]
-                        + a22[i]*u[i22[i]];
-        }
+        apply(u, retVal);
         return retVal;
     }
 
+    void NinePointLinearOp::apply(const Array& u, Array& out) const {
+
+        const boost::shared_ptr<FdmLinearOpLayout> layout=mesher_->layout();
+        const Size size = layout->size();
+        QL_REQUIRE(u.size() == size,"inconsistent length of r "
+                    << u.size() << " vs " << size);
+        QL_REQUIRE(&u != &out, "input and output must be different arrays");
+        if (out.size() != size)
+            out = Array(size);
+
+        const NinePointStencil m = {
+            a00_.get(), a01_.get(), a02_.get(),
+            a10_.get(), a11_.get(), a12_.get(),
+            a20_.get(), a21_.get(), a22_.get(),
+            i00_.get(), i01_.get(), i02_.get(),
+            i10_.get(),             i12_.get(),
+            i20_.get(), i21_.get(), i22_.get() };
+        applyStencil<false>(m, u.begin(), out.begin(),
+                            *layout, d0_, d1_);
+    }
+
+    void NinePointLinearOp::apply_add(const Array& u, Array& out) const {
+
+        const boost::shared_ptr<FdmLinearOpLayout> layout=mesher_->layout();
+        const Size size = layout->size();
+        QL_REQUIRE(u.size() == size,"inconsistent length of r "
+                    << u.size() << " vs " << size);
+        QL_REQUIRE(out.size() == size, "inconsistent length of out");
+        QL_REQUIRE(&u != &out, "input and output must be different arrays");
+
+        const NinePointStencil m = {
+            a00_.get(), a01_.get(), a02_.get(),
+            a10_.get(), a11_.get(), a12_.get(),
+            a20_.get(), a21_.get(), a22_.get(),
+            i00_.get(), i01_.get(), i02_.get(),
+            i10_.get(),             i12_.get(),
+            i20_.get(), i21_.get(), i22_.get() };
+        applyStencil<true>(m, u.begin(), out.begin(),
+                           *layout, d0_, d1_);
+    }
+
 #if !defined(QL_NO_UBLAS_SUPPORT)
     Disposable<SparseMatrix> NinePointLinearOp::toMatrix() const {
         const boost::shared_ptr<FdmLinearOpLayout> index = mesher_->layout();
@@ -188,7 +297,7 @@ namespace QuantLib {
         NinePointLinearOp retVal(d0_, d1_, mesher_);
         const Size size = mesher_->layout()->size();
 
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(FdmOperatorThreads::current())
         for (Size i=0; i < size; ++i) {
             const Real s = u[i];
             retVal.a11_[i]=a11_[i]*s; retVal.a00_[i]=a00_[i]*s;
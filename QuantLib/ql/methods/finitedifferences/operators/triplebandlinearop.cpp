@@ -26,13 +26,127 @@
 
 namespace QuantLib {
 
+    namespace {
+
+        // out[i] = (or +=) lower[i]*r[i0[i]]+diag[i]*r[i]+upper[i]*r[i2[i]]
+        // for i in [from, to). The first version finds the neighbours
+        // through the index arrays; the second, used for the points
+        // not lying on the boundary along the operator direction,
+        // finds them at the given distance and can be vectorised.
+        template <bool add>
+        inline void gatherStencil(const Real* r, Real* out,
+                                  const Real* l, const Real* d,
+                                  const Real* u, const Size* i0,
+                                  const Size* i2, Size from, Size to) {
+            for (Size i=from; i < to; ++i) {
+                const Real v = r[i0[i]]*l[i]+r[i]*d[i]+r[i2[i]]*u[i];
+                if (add) out[i] += v; else out[i] = v;
+            }
+        }
+
+        template <bool add>
+        inline void stridedStencil(const Real* r, Real* out,
+                                   const Real* l, const Real* d,
+                                   const Real* u, Size s,
+                                   Size from, Size to) {
+            for (Size i=from; i < to; ++i) {
+                const Real v = r[i-s]*l[i]+r[i]*d[i]+r[i+s]*u[i];
+                if (add) out[i] += v; else out[i] = v;
+            }
+        }
+
+        template <bool add>
+        void applyStencil(const Real* r, Real* out,
+                          const Real* l, const Real* d, const Real* u,
+                          const Size* i0, const Size* i2,
+                          Size size, Size n, Size s) {
+            if (n < 3) {
+                gatherStencil<add>(r, out, l, d, u, i0, i2, 0, size);
+            } else if (s == 1) {
+                // each line is contiguous; only its ends are boundaries
+                const Size lines = size/n;
+                #pragma omp parallel for \
+                    num_threads(FdmOperatorThreads::current())
+                for (Size k=0; k < lines; ++k) {
+                    const Size first = k*n, last = first+n-1;
+                    gatherStencil<add>(r, out, l, d, u, i0, i2,
+                                       first, first+1);
+                    stridedStencil<add>(r, out, l, d, u, 1, first+1, last);
+                    gatherStencil<add>(r, out, l, d, u, i0, i2,
+                                       last, last+1);
+                }
+            } else {
+                // rows of s contiguous points share the coordinate
+                // along the direction, and lie either entirely on the
+                // boundary or entirely inside.
+                const Size rows = size/s;
+                #pragma omp parallel for \
+                    num_threads(FdmOperatorThreads::current())
+                for (Size k=0; k < rows; ++k) {
+                    const Size c = k % n, first = k*s;
+                    if (c == 0 || c == n-1)
+                        gatherStencil<add>(r, out, l, d, u, i0, i2,
+                                           first, first+s);
+                    else
+                        stridedStencil<add>(r, out, l, d, u, s,
+                                            first, first+s);
+                }
+            }
+        }
+
+        // Lines are solved in batches of this size along the
+        // contiguous dimension when they are not contiguous
+        // themselves.
+        const Size batchSize = 128;
+
+        // Thomson algorithm on the m lines starting at offset,...,
+        // offset+m-1, with n points at distance s; for contiguous
+        // lines, m=s=1. Example code taken from Tridiagonalopertor and
+        // changed to fit for the triple band operator. Returns the
+        // number of null pivots.
+        inline Size solveLines(const Real* l, const Real* d,
+                               const Real* u, const Real* r,
+                               Real* x, Real* tmp, Real a, Real b,
+                               Size offset, Size m, Size n, Size s) {
+            Size zeros = 0;
+            Real bet[batchSize];
+
+            for (Size q=0; q < m; ++q) {
+                const Size i = offset+q;
+                bet[q] = a*d[i]+b;
+                zeros += (bet[q] == 0.0);
+                bet[q] = 1.0/bet[q];
+                x[i] = r[i]*bet[q];
+            }
+            for (Size c=1; c < n; ++c) {
+                const Size row = offset+c*s;
+                for (Size q=0; q < m; ++q) {
+                    const Size i = row+q;
+                    tmp[i] = a*u[i-s]*bet[q];
+
+                    bet[q] = b+a*(d[i]-tmp[i]*l[i]);
+                    zeros += (bet[q] == 0.0);
+                    bet[q] = 1.0/bet[q];
+
+                    x[i] = (r[i]-a*l[i]*x[i-s])*bet[q];
+                }
+            }
+            for (Size c=n-1; c > 0; --c) {
+                const Size row = offset+c*s;
+                for (Size q=0; q < m; ++q)
+                    x[row+q-s] -= tmp[row+q]*x[row+q];
+            }
+            return zeros;
+        }
+
+    }
+
     TripleBandLinearOp::TripleBandLinearOp(
         Size direction,
         const boost::shared_ptr<FdmMesher>& mesher)
     : direction_(direction),
       i0_       (new Size[mesher->layout()->size()]),
       i2_       (new Size[mesher->layout()->size()]),
-      reverseIndex_ (new Size[mesher->layout()->size()]),
       lower_    (new Real[mesher->layout()->size()]),
       diag_     (new Real[mesher->layout()->size()]),
       upper_    (new Real[mesher->layout()->size()]),
@@ -41,22 +155,11 @@ namespace QuantLib {
         const boost::shared_ptr<FdmLinearOpLayout> layout = mesher->layout();
         const FdmLinearOpIterator endIter = layout->end();
 
-        std::vector<Size> newDim(layout->dim());
-        std::iter_swap(newDim.begin(), newDim.begin()+direction_);
-        std::vector<Size> newSpacing = FdmLinearOpLayout(newDim).spacing();
-        std::iter_swap(newSpacing.begin(), newSpacing.begin()+direction_);
-
         for (FdmLinearOpIterator iter = layout->begin(); iter!=endIter; ++iter) {
             const Size i = iter.index();
 
             i0_[i] = layout->neighbourhood(iter, direction, -1);
             i2_[i] = layout->neighbourhood(iter, direction,  1);
-
-            const std::vector<Size>& coordinates = iter.coordinates();
-            const Size newIndex =
-                  std::inner_product(coordinates.begin(), coordinates.end(),
-                                     newSpacing.begin(), Size(0));
-            reverseIndex_[newIndex] = i;
         }
     }
 
@@ -64,7 +167,6 @@ namespace QuantLib {
     : direction_(m.direction_),
       i0_   (new Size[m.mesher_->layout()->size()]),
       i2_   (new Size[m.mesher_->layout()->size()]),
-      reverseIndex_(new Size[m.mesher_->layout()->size()]),
       lower_(new Real[m.mesher_->layout()->size()]),
       diag_ (new Real[m.mesher_->layout()->size()]),
       upper_(new Real[m.mesher_->layout()->size()]),
@@ -72,8 +174,6 @@ namespace QuantLib {
         const Size len = m.mesher_->layout()->size();
         std::copy(m.i0_.get(), m.i0_.get() + len, i0_.get());
         std::copy(m.i2_.get(), m.i2_.get() + len, i2_.get());
-        std::copy(m.reverseIndex_.get(), m.reverseIndex_.get()+len,
-                  reverseIndex_.get());
         std::copy(m.lower_.get(), m.lower_.get() + len, lower_.get());
         std::copy(m.diag_.get(),  m.diag_.get() + len,  diag_.get());
         std::copy(m.upper_.get(), m.upper_.get() + len, upper_.get());
@@ -103,7 +203,6 @@ namespace QuantLib {
         std::swap(direction_, m.direction_);
 
         i0_.swap(m.i0_); i2_.swap(m.i2_);
-        reverseIndex_.swap(m.reverseIndex_);
         lower_.swap(m.lower_); diag_.swap(m.diag_); upper_.swap(m.upper_);
     }
 
@@ -123,7 +222,7 @@ namespace QuantLib {
 
         if (a.empty()) {
             if (b.empty()) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(FdmOperatorThreads::current())
                 for (Size i=0; i < size; ++i) {
                     diag[i]  = y_diag[i];
                     lower[i] = y_lower[i];
@@ -133,7 +232,7 @@ namespace QuantLib {
             else {
                 Array::const_iterator bptr(b.begin());
                 const Size binc = (b.size() > 1) ? 1 : 0;
-#pragma omp parallel for
+#pragma omp parallel for num_threads(FdmOperatorThreads::current())
                 for (Size i=0; i < size; ++i) {
                     diag[i]  = y_diag[i] + bptr[i*binc];
                     lower[i] = y_lower[i];
@@ -149,7 +248,7 @@ namespace QuantLib {
             const Real *x_lower(x.lower_.get());
             const Real *x_upper(x.upper_.get());
 
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(FdmOperatorThreads::current())
             for (Size i=0; i < size; ++i) {
                 const Real s = aptr[i*ainc];
                 diag[i]  = y_diag[i]  + s*x_diag[i];
@@ -168,7 +267,7 @@ namespace QuantLib {
             const Real *x_lower(x.lower_.get());
             const Real *x_upper(x.upper_.get());
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(FdmOperatorThreads::current())
             for (Size i=0; i < size; ++i) {
                 const Real s = aptr[i*ainc];
                 diag[i]  = y_diag[i]  + s*x_diag[i] + bptr[i*binc];
@@ -183,7 +282,7 @@ namespace QuantLib {
 
         TripleBandLinearOp retVal(direction_, mesher_);
         const Size size = mesher_->layout()->size();
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(FdmOperatorThreads::current())
         for (Size i=0; i < size; ++i) {
             retVal.lower_[i]= lower_[i] + m.lower_[i];
             retVal.diag_[i] = diag_[i]  + m.diag_[i];
@@ -199,7 +298,7 @@ namespace QuantLib {
         TripleBandLinearOp retVal(direction_, mesher_);
 
         const Size size = mesher_->layout()->size();
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(FdmOperatorThreads::current())
         for (Size i=0; i < size; ++i) {
             const Real s = u[i];
             retVal.lower_[i]= lower_[i]*s;
@@ -215,7 +314,7 @@ namespace QuantLib {
         TripleBandLinearOp retVal(direction_, mesher_);
 
         const Size size = mesher_->layout()->size();
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(FdmOperatorThreads::current())
         for (Size i=0; i < size; ++i) {
             retVal.lower_[i]= lower_[i];
             retVal.upper_[i]= upper_[i];
@@ -226,23 +325,40 @@ namespace QuantLib {
     }
 
     Disposable<Array> TripleBandLinearOp::apply(const Array& r) const {
-        const boost::shared_ptr<FdmLinearOpLayout> index = mesher_->layout();
+        array_type retVal(r.size());
+        apply(r, retVal);
+        return retVal;
+    }
 
-        QL_REQUIRE(r.size() == index->size(), "inconsistent length of r");
+    void TripleBandLinearOp::apply(const Array& r, Array& out) const {
+        const boost::shared_ptr<FdmLinearOpLayout> layout = mesher_->layout();
+        const Size size = layout->size();
+
+        QL_REQUIRE(r.size() == size, "inconsistent length of r");
+        QL_REQUIRE(&r != &out, "input and output must be different arrays");
+        if (out.size() != size)
+            out = Array(size);
+
+        applyStencil<false>(r.begin(), out.begin(),
+                            lower_.get(), diag_.get(), upper_.get(),
+                            i0_.get(), i2_.get(), size,
+                            layout->dim()[direction_],
+                            layout->spacing()[direction_]);
+    }
 
-        const Real* lptr = lower_.get();
-        const Real* dptr = diag_.get();
-        const Real* uptr = upper_.get();
-        const Size* i0ptr = i0_.get();
-        const Size* i2ptr = i2_.get();
+    void TripleBandLinearOp::apply_add(const Array& r, Array& out) const {
+        const boost::shared_ptr<FdmLinearOpLayout> layout = mesher_->layout();
+        const Size size = layout->size();
 
-        array_type retVal(r.size());
-        #pragma omp parallel for
-        for (Size i=0; i < index->size(); ++i) {
-            retVal[i] = r[i0ptr[i]]*lptr[i]+r[i]*dptr[i]+r[i2ptr[i]]*uptr[i];
-        }
+        QL_REQUIRE(r.size() == size, "inconsistent length of r");
+        QL_REQUIRE(out.size() == size, "inconsistent length of out");
+        QL_REQUIRE(&r != &out, "input and output must be different arrays");
 
-        return retVal;
+        applyStencil<true>(r.begin(), out.begin(),
+                           lower_.get(), diag_.get(), upper_.get(),
+                           i0_.get(), i2_.get(), size,
+                           layout->dim()[direction_],
+                           layout->spacing()[direction_]);
     }
 
 #if !defined(QL_NO_UBLAS_SUPPORT)
@@ -264,8 +380,24 @@ namespace QuantLib {
 
     Disposable<Array>
     TripleBandLinearOp::solve_splitting(const Array& r, Real a, Real b) const {
+        Array retVal(r.size());
+        solve_splitting(r, a, b, retVal);
+        return retVal;
+    }
+
+    void TripleBandLinearOp::solve_splitting(const Array& r, Real a, Real b,
+                                             Array& retVal) const {
+        Array workspace(r.size());
+        solve_splitting(r, a, b, retVal, workspace);
+    }
+
+    void TripleBandLinearOp::solve_splitting(const Array& r, Real a, Real b,
+                                             Array& retVal,
+                                             Array& workspace) const {
         const boost::shared_ptr<FdmLinearOpLayout> layout = mesher_->layout();
         QL_REQUIRE(r.size() == layout->size(), "inconsistent size of rhs");
+        QL_REQUIRE(&workspace != &r && &workspace != &retVal,
+                   "workspace must be different from input and output");
 
 #ifdef QL_EXTRA_SAFETY_CHECKS
         for (FdmLinearOpIterator iter = layout->begin();
@@ -278,36 +410,55 @@ namespace QuantLib {
         }
 #endif
 
-        Array retVal(r.size()), tmp(r.size());
+        // r and retVal might be the same array: r[i] is not used
+        // after retVal[i] is written in the forward sweeps below.
+        if (retVal.size() != r.size())
+            retVal = Array(r.size());
+        // the workspace is provided by the caller, so that the
+        // operator can be used by several threads at the same time
+        if (workspace.size() != r.size())
+            workspace = Array(r.size());
 
         const Real* lptr = lower_.get();
         const Real* dptr = diag_.get();
         const Real* uptr = upper_.get();
-
-        // Thomson algorithm to solve a tridiagonal system.
-        // Example code taken from Tridiagonalopertor and
-        // changed to fit for the triple band operator.
-        Size rim1 = reverseIndex_[0];
-        Real bet=1.0/(a*dptr[rim1]+b);
-        QL_REQUIRE(bet != 0.0, "division by zero");
-        retVal[reverseIndex_[0]] = r[rim1]*bet;
-
-        for (Size j=1; j<=layout->size()-1; j++){
-            const Size ri = reverseIndex_[j];
-            tmp[j] = a*uptr[rim1]*bet;
-
-            bet=b+a*(dptr[ri]-tmp[j]*lptr[ri]);
-            QL_ENSURE(bet != 0.0, "division by zero");
-            bet=1.0/bet;
-
-            retVal[ri] = (r[ri]-a*lptr[ri]*retVal[rim1])*bet;
-            rim1 = ri;
+        const Real* rptr = r.begin();
+        Real* xptr = retVal.begin();
+        Real* tptr = workspace.begin();
+
+        // Lines along the given direction are independent tridiagonal
+        // systems and can be solved in parallel; each of them goes
+        // through the same operations regardless of the number of
+        // threads and of the batch it belongs to.
+        const Size n = layout->dim()[direction_];
+        const Size s = layout->spacing()[direction_];
+        const Size size = layout->size();
+        Size zeros = 0;
+
+        if (s == 1) {
+            // contiguous lines, solved one by one
+            const Size lines = size/n;
+
+            #pragma omp parallel for reduction(+:zeros) \
+                num_threads(FdmOperatorThreads::current())
+            for (Size k=0; k < lines; ++k)
+                zeros += solveLines(lptr, dptr, uptr, rptr, xptr, tptr,
+                                    a, b, k*n, 1, n, 1);
+        } else {
+            // Lines at distance 1 are solved together, so that each
+            // step of the algorithm works on contiguous memory
+            const Size batches = (s+batchSize-1)/batchSize;
+            const Size tasks = (size/(n*s))*batches;
+
+            #pragma omp parallel for reduction(+:zeros) \
+                num_threads(FdmOperatorThreads::current())
+            for (Size k=0; k < tasks; ++k) {
+                const Size first = (k%batches)*batchSize;
+                zeros += solveLines(lptr, dptr, uptr, rptr, xptr, tptr,
+                                    a, b, (k/batches)*n*s + first,
+                                    std::min(batchSize, s-first), n, s);
+            }
         }
-        // cannot be j>=0 with Size j
-        for (Size j=layout->size()-2; j>0; --j)
-            retVal[reverseIndex_[j]] -= tmp[j+1]*retVal[reverseIndex_[j+1]];
-        retVal[reverseIndex_[0]] -= tmp[1]*retVal[reverseIndex_[1]];
-
-        return retVal;
+        QL_ENSURE(zeros == 0, "division by zero");
     }
 }
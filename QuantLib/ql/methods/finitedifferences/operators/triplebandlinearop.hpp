@@ -47,6 +47,18 @@ namespace QuantLib {
         Disposable<Array> solve_splitting(const Array& r, Real a,
                                           Real b = 1.0) const;
 
+        // versions writing into (or adding to) a given array
+        void apply(const Array& r, Array& out) const;
+        void apply_add(const Array& r, Array& out) const;
+        void solve_splitting(const Array& r, Real a, Real b,
+                             Array& out) const;
+        /*! as above, using the given array (different from both r
+            and out, and resized if needed) as scratch space, so
+            that repeated calls don't allocate memory.
+        */
+        void solve_splitting(const Array& r, Real a, Real b,
+                             Array& out, Array& workspace) const;
+
         Disposable<TripleBandLinearOp> mult(const Array& u) const;
         Disposable<TripleBandLinearOp> add(const TripleBandLinearOp& m) const;
         Disposable<TripleBandLinearOp> add(const Array& u) const;
@@ -66,7 +78,6 @@ namespace QuantLib {
 
         Size direction_;
         boost::shared_array<Size> i0_, i2_;
-        boost::shared_array<Size> reverseIndex_;
         boost::shared_array<Real> lower_, diag_, upper_;
 
         boost::shared_ptr<FdmMesher> mesher_;
@@ -38,16 +38,22 @@ namespace QuantLib {
         bcSet_.setTime(std::max(0.0, t-dt_));
 
         bcSet_.applyBeforeApplying(*map_);
-        Array y = a + dt_*map_->apply(a);
-        bcSet_.applyAfterApplying(y);
+        map_->apply(a, w_);
+        if (y_.size() != a.size())
+            y_ = Array(a.size());
+        for (Size j=0; j < a.size(); ++j)
+            y_[j] = a[j] + dt_*w_[j];
+        bcSet_.applyAfterApplying(y_);
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = y - theta_*dt_*map_->apply_direction(i, a);
-            y = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction(i, a, w_);
+            for (Size j=0; j < y_.size(); ++j)
+                y_[j] -= theta_*dt_*w_[j];
+            map_->solve_splitting(i, y_, -theta_*dt_, y_, w_);
         }
-        bcSet_.applyAfterSolving(y);
+        bcSet_.applyAfterSolving(y_);
 
-        a = y;
+        a.swap(y_);
     }
 
     void DouglasScheme::setStep(Time dt) {
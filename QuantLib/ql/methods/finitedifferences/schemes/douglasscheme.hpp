@@ -54,6 +54,9 @@ namespace QuantLib {
         const Real theta_;
         const boost::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // workspaces, allocated at the first step and then reused
+        array_type y_, w_;
     };
 }
 
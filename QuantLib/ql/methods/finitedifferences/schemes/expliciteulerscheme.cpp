@@ -34,7 +34,9 @@ namespace QuantLib {
         bcSet_.setTime(std::max(0.0, t-dt_));
 
         bcSet_.applyBeforeApplying(*map_);
-        a += dt_ * map_->apply(a);
+        map_->apply(a, w_);
+        for (Size j=0; j < a.size(); ++j)
+            a[j] += dt_*w_[j];
         bcSet_.applyAfterApplying(a);
     }
 
@@ -53,6 +53,9 @@ namespace QuantLib {
         Time dt_;
         const boost::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // workspace, allocated at the first step and then reused
+        array_type w_;
     };
 }
 
@@ -41,27 +41,43 @@ namespace QuantLib {
         bcSet_.setTime(std::max(0.0, t-dt_));
 
         bcSet_.applyBeforeApplying(*map_);
-        Array y = a + dt_*map_->apply(a);
-        bcSet_.applyAfterApplying(y);
+        map_->apply(a, w_);
+        if (y_.size() != a.size())
+            y_ = Array(a.size());
+        for (Size j=0; j < a.size(); ++j)
+            y_[j] = a[j] + dt_*w_[j];
+        bcSet_.applyAfterApplying(y_);
 
-        Array y0 = y;
+        if (y0_.size() != a.size())
+            y0_ = Array(a.size());
+        std::copy(y_.begin(), y_.end(), y0_.begin());
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = y - theta_*dt_*map_->apply_direction(i, a);
-            y = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction(i, a, w_);
+            for (Size j=0; j < y_.size(); ++j)
+                y_[j] -= theta_*dt_*w_[j];
+            map_->solve_splitting(i, y_, -theta_*dt_, y_, w_);
         }
 
         bcSet_.applyBeforeApplying(*map_);
-        Array yt = y0 + mu_*dt_*map_->apply(y-a);
-        bcSet_.applyAfterApplying(yt);
+        if (d_.size() != a.size())
+            d_ = Array(a.size());
+        for (Size j=0; j < a.size(); ++j)
+            d_[j] = y_[j] - a[j];
+        map_->apply(d_, w_);
+        for (Size j=0; j < a.size(); ++j)
+            y0_[j] += mu_*dt_*w_[j];
+        bcSet_.applyAfterApplying(y0_);
 
         for (Size i=0; i < map_->size(); ++i) {
-            Array rhs = yt - theta_*dt_*map_->apply_direction(i, y);
-            yt = map_->solve_splitting(i, rhs, -theta_*dt_);
+            map_->apply_direction(i, y_, w_);
+            for (Size j=0; j < y0_.size(); ++j)
+                y0_[j] -= theta_*dt_*w_[j];
+            map_->solve_splitting(i, y0_, -theta_*dt_, y0_, w_);
         }
-        bcSet_.applyAfterSolving(yt);
+        bcSet_.applyAfterSolving(y0_);
 
-        a = yt;
+        a.swap(y0_);
     }
 
     void HundsdorferScheme::setStep(Time dt) {
@@ -59,6 +59,9 @@ namespace QuantLib {
 
         const boost::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // workspaces, allocated at the first step and then reused
+        array_type y_, y0_, d_, w_;
     };
 }
 
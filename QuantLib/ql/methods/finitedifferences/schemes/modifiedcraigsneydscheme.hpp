@@ -60,6 +60,9 @@ namespace QuantLib {
         const Real mu_;
         const boost::shared_ptr<FdmLinearOpComposite> map_;
         const BoundaryConditionSchemeHelper bcSet_;
+
+        // workspaces, allocated at the first step and then reused
+        array_type y_, y0_, d_, w_;
     };
 }
 
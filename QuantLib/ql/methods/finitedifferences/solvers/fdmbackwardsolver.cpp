@@ -33,39 +33,44 @@
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 
 namespace QuantLib {
-    
-    FdmSchemeDesc::FdmSchemeDesc(FdmSchemeType aType, Real aTheta, Real aMu)
-    : type(aType), theta(aTheta), mu(aMu) { }
 
-    FdmSchemeDesc FdmSchemeDesc::Douglas() { 
-        return FdmSchemeDesc(FdmSchemeDesc::DouglasType, 0.5, 0.0);
+    FdmSchemeDesc::FdmSchemeDesc(FdmSchemeType aType, Real aTheta, Real aMu,
+                                 Size aThreads)
+    : type(aType), theta(aTheta), mu(aMu), threads(aThreads) {
+        QL_REQUIRE(threads != 0, "null number of threads");
+    }
+
+    FdmSchemeDesc FdmSchemeDesc::Douglas(Size threads) { 
+        return FdmSchemeDesc(FdmSchemeDesc::DouglasType, 0.5, 0.0, threads);
     }
     
-    FdmSchemeDesc FdmSchemeDesc::CraigSneyd() {
-        return FdmSchemeDesc(FdmSchemeDesc::CraigSneydType,0.5, 0.5);
+    FdmSchemeDesc FdmSchemeDesc::CraigSneyd(Size threads) {
+        return FdmSchemeDesc(FdmSchemeDesc::CraigSneydType,0.5, 0.5, threads);
     }
     
-    FdmSchemeDesc FdmSchemeDesc::ModifiedCraigSneyd() { 
+    FdmSchemeDesc FdmSchemeDesc::ModifiedCraigSneyd(Size threads) { 
         return FdmSchemeDesc(FdmSchemeDesc::ModifiedCraigSneydType, 
-                             1.0/3.0, 1.0/3.0);
+                             1.0/3.0, 1.0/3.0, threads);
     }
     
-    FdmSchemeDesc FdmSchemeDesc::Hundsdorfer() {
+    FdmSchemeDesc FdmSchemeDesc::Hundsdorfer(Size threads) {
         return FdmSchemeDesc(FdmSchemeDesc::HundsdorferType, 
-                             0.5+std::sqrt(3.0)/6, 0.5);
+                             0.5+std::sqrt(3.0)/6, 0.5, threads);
     }
     
-    FdmSchemeDesc FdmSchemeDesc::ModifiedHundsdorfer() {
+    FdmSchemeDesc FdmSchemeDesc::ModifiedHundsdorfer(Size threads) {
         return FdmSchemeDesc(FdmSchemeDesc::HundsdorferType, 
-                             1.0-std::sqrt(2.0)/2, 0.5);
+                             1.0-std::sqrt(2.0)/2, 0.5, threads);
     }
     
-    FdmSchemeDesc FdmSchemeDesc::ExplicitEuler() {
-        return FdmSchemeDesc(FdmSchemeDesc::ExplicitEulerType, 0.0, 0.0);
+    FdmSchemeDesc FdmSchemeDesc::ExplicitEuler(Size threads) {
+        return FdmSchemeDesc(FdmSchemeDesc::ExplicitEulerType, 0.0, 0.0,
+                             threads);
     }
 
-    FdmSchemeDesc FdmSchemeDesc::ImplicitEuler() {
-        return FdmSchemeDesc(FdmSchemeDesc::ImplicitEulerType, 0.0, 0.0);
+    FdmSchemeDesc FdmSchemeDesc::ImplicitEuler(Size threads) {
+        return FdmSchemeDesc(FdmSchemeDesc::ImplicitEulerType, 0.0, 0.0,
+                             threads);
     }
 
     FdmBackwardSolver::FdmBackwardSolver(
@@ -86,6 +91,8 @@ namespace QuantLib {
                                      Time from, Time to,
                                      Size steps, Size dampingSteps) {
 
+        FdmOperatorThreads threads(schemeDesc_.threads);
+
         const Time deltaT = from - to;
         const Size allSteps = steps + dampingSteps;
         const Time dampingTo = from - (deltaT*dampingSteps)/allSteps;
@@ -26,6 +26,7 @@
 #define quantlib_fdm_backward_solver_hpp
 
 #include <ql/methods/finitedifferences/utilities/fdmboundaryconditionset.hpp>
+#include <ql/utilities/null.hpp>
 
 namespace QuantLib {
 
@@ -37,19 +38,27 @@ namespace QuantLib {
                              CraigSneydType, ModifiedCraigSneydType, 
                              ImplicitEulerType, ExplicitEulerType };
 
-        FdmSchemeDesc(FdmSchemeType type, Real theta, Real mu);
+        /*! The number of threads is used by the operators for
+            applying the operator and solving the splitting lines
+            during the rollback; the results don't depend on it.
+            If no number is passed, the OpenMP default is used.
+            It has no effect unless OpenMP is enabled.
+        */
+        FdmSchemeDesc(FdmSchemeType type, Real theta, Real mu,
+                      Size threads = Null<Size>());
 
         const FdmSchemeType type;
         const Real theta, mu;
+        const Size threads;
 
         // some default scheme descriptions
-        static FdmSchemeDesc Douglas();
-        static FdmSchemeDesc ImplicitEuler();
-        static FdmSchemeDesc ExplicitEuler();
-        static FdmSchemeDesc CraigSneyd();
-        static FdmSchemeDesc ModifiedCraigSneyd(); 
-        static FdmSchemeDesc Hundsdorfer();
-        static FdmSchemeDesc ModifiedHundsdorfer();
+        static FdmSchemeDesc Douglas(Size threads = Null<Size>());
+        static FdmSchemeDesc ImplicitEuler(Size threads = Null<Size>());
+        static FdmSchemeDesc ExplicitEuler(Size threads = Null<Size>());
+        static FdmSchemeDesc CraigSneyd(Size threads = Null<Size>());
+        static FdmSchemeDesc ModifiedCraigSneyd(Size threads = Null<Size>());
+        static FdmSchemeDesc Hundsdorfer(Size threads = Null<Size>());
+        static FdmSchemeDesc ModifiedHundsdorfer(Size threads = Null<Size>());
     };
         
     class FdmBackwardSolver {
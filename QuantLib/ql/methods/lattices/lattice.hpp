@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2004, 2005 StatPro Italia srl
+ Copyright (C) 2004, 2005, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -51,6 +51,12 @@ namespace QuantLib {
                         Array& newValues) const;
         \endcode
 
+        The arrays used during a rollback are reused across its time
+        steps, so that no allocation is needed once the tree stops
+        widening.  They are local to each call, so that the
+        adjustments of an asset can roll back other assets on the
+        same lattice.
+
         \ingroup lattices
     */
     template <class Impl>
@@ -61,7 +67,10 @@ namespace QuantLib {
                     Size n)
         : Lattice(timeGrid), n_(n) {
             QL_REQUIRE(n>0, "there is no zeronomial lattice!");
-            statePrices_ = std::vector<Array>(1, Array(1, 1.0));
+            // reserve all the state prices that can be computed,
+            // so that growing the vector doesn't copy the arrays
+            statePrices_.reserve(timeGrid.size());
+            statePrices_.push_back(Array(1, 1.0));
             statePricesLimit_ = 0;
         }
 
@@ -70,6 +79,18 @@ namespace QuantLib {
         void initialize(DiscretizedAsset&, Time t) const;
         void rollback(DiscretizedAsset&, Time to) const;
         void partialRollback(DiscretizedAsset&, Time to) const;
+        /*! Rolls back all the assets together, performing a single
+            traversal of the tree for each time step.  The underlying
+            of a DiscretizedOption is stepped back together with the
+            option whenever the two are at the same time; the option
+            still performs its adjustments.
+        */
+        void rollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
+        void partialRollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
         //! Computes the present value of an asset using Arrow-Debrew prices
         Real presentValue(DiscretizedAsset&) const;
         //@}
@@ -79,6 +100,14 @@ namespace QuantLib {
         void stepback(Size i,
                       const Array& values,
                       Array& newValues) const;
+        /*! Steps back the values of a number of assets together.
+            This is always done by means of the discount(),
+            descendant() and probability() methods of the derived
+            class; its stepback() method, if any, is not used.
+        */
+        void stepback(Size i,
+                      const std::vector<Array>& values,
+                      std::vector<Array>& newValues) const;
 
       protected:
         void computeStatePrices(Size until) const;
@@ -96,8 +125,9 @@ namespace QuantLib {
 
     template <class Impl>
     void TreeLattice<Impl>::computeStatePrices(Size until) const {
+        statePrices_.resize(until+1);
         for (Size i=statePricesLimit_; i<until; i++) {
-            statePrices_.push_back(Array(this->impl().size(i+1), 0.0));
+            Array(this->impl().size(i+1), 0.0).swap(statePrices_[i+1]);
             for (Size j=0; j<this->impl().size(i); j++) {
                 DiscountFactor disc = this->impl().discount(i,j);
                 Real statePrice = statePrices_[i][j];
@@ -152,17 +182,99 @@ namespace QuantLib {
         Integer iFrom = Integer(t_.index(from));
         Integer iTo = Integer(t_.index(to));
 
+        Array newValues;
         for (Integer i=iFrom-1; i>=iTo; --i) {
-            Array newValues(this->impl().size(i));
+            Size size = this->impl().size(i);
+            if (newValues.size() != size)
+                Array(size).swap(newValues);
             this->impl().stepback(i, asset.values(), newValues);
             asset.time() = t_[i];
-            asset.values() = newValues;
+            // the old values are kept as the buffer for the next step
+            asset.values().swap(newValues);
             // skip the very last adjustment
             if (i != iTo)
                 asset.adjustValues();
         }
     }
 
+    template <class Impl>
+    inline void TreeLattice<Impl>::rollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+        partialRollback(assets,to);
+        for (Size k=0; k<assets.size(); ++k)
+            assets[k]->adjustValues();
+    }
+
+    template <class Impl>
+    void TreeLattice<Impl>::partialRollback(
+                const std::vector<boost::shared_ptr<DiscretizedAsset> >& assets,
+                Time to) const {
+
+        Integer iTo = Integer(t_.index(to));
+
+        // the assets can start from different times; each of them
+        // joins the others when they reach its own time.
+        std::vector<Integer> iFrom(assets.size());
+        Integer iMax = iTo;
+        for (Size k=0; k<assets.size(); ++k) {
+            Time from = assets[k]->time();
+            if (close(from,to)) {
+                iFrom[k] = iTo;
+            } else {
+                QL_REQUIRE(from > to,
+                           "cannot roll the asset back to" << to
+                           << " (it is already at t = " << from << ")");
+                iFrom[k] = Integer(t_.index(from));
+                iMax = std::max(iMax, iFrom[k]);
+            }
+        }
+
+        std::vector<DiscretizedAsset*> active;
+        std::vector<Array> values, newValues;
+        for (Integer i=iMax-1; i>=iTo; --i) {
+            active.clear();
+            for (Size k=0; k<assets.size(); ++k) {
+                if (iFrom[k] > i)
+                    active.push_back(assets[k].get());
+            }
+            // assets beyond this point are underlyings, which are
+            // stepped back but left for their options to adjust
+            Size adjusted = active.size();
+            for (Size k=0; k<active.size(); ++k) {
+                DiscretizedOption* option =
+                    dynamic_cast<DiscretizedOption*>(active[k]);
+                if (option) {
+                    DiscretizedAsset* underlying = option->underlying().get();
+                    if (close(underlying->time(), option->time()) &&
+                        std::find(active.begin(), active.end(),
+                                  underlying) == active.end())
+                        active.push_back(underlying);
+                }
+            }
+            // assets only join, so the buffers never shrink
+            Size m = active.size();
+            values.resize(m);
+            newValues.resize(m);
+            Size size = this->impl().size(i);
+            for (Size k=0; k<m; ++k) {
+                values[k].swap(active[k]->values());
+                if (newValues[k].size() != size)
+                    Array(size).swap(newValues[k]);
+            }
+            stepback(i, values, newValues);
+            for (Size k=0; k<m; ++k) {
+                active[k]->time() = t_[i];
+                active[k]->values().swap(newValues[k]);
+            }
+            // skip the very last adjustment
+            if (i != iTo) {
+                for (Size k=0; k<adjusted; ++k)
+                    active[k]->adjustValues();
+            }
+        }
+    }
+
     template <class Impl>
     void TreeLattice<Impl>::stepback(Size i, const Array& values,
                                      Array& newValues) const {
@@ -178,6 +290,27 @@ namespace QuantLib {
         }
     }
 
+    template <class Impl>
+    void TreeLattice<Impl>::stepback(Size i,
+                                     const std::vector<Array>& values,
+                                     std::vector<Array>& newValues) const {
+        Size m = values.size();
+        #pragma omp parallel for
+        for (Size j=0; j<this->impl().size(i); j++) {
+            for (Size k=0; k<m; ++k)
+                newValues[k][j] = 0.0;
+            for (Size l=0; l<n_; l++) {
+                Real p = this->impl().probability(i,j,l);
+                Size d = this->impl().descendant(i,j,l);
+                for (Size k=0; k<m; ++k)
+                    newValues[k][j] += p * values[k][d];
+            }
+            DiscountFactor discount = this->impl().discount(i,j);
+            for (Size k=0; k<m; ++k)
+                newValues[k][j] *= discount;
+        }
+    }
+
 }
 
 
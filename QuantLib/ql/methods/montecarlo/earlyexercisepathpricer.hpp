@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -24,7 +25,7 @@
 #ifndef quantlib_early_exercise_path_pricer_hpp
 #define quantlib_early_exercise_path_pricer_hpp
 
-#include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/methods/montecarlo/path.hpp>
 #include <ql/methods/montecarlo/multipath.hpp>
 #include <boost/function.hpp>
@@ -73,6 +74,23 @@ namespace QuantLib {
             state(const PathType& path, TimeType t) const = 0;
         virtual std::vector<boost::function1<ValueType, StateType> >
             basisSystem() const = 0;
+        /*! sets values[j][l] to the l-th function of the basis
+            system evaluated at states[j].  The default
+            implementation calls the functions one by one; derived
+            classes can override it with a faster evaluation on
+            all states at once.
+        */
+        virtual void basisValues(const std::vector<StateType>& states,
+                                 Matrix& values) const {
+            const std::vector<boost::function1<ValueType, StateType> > v =
+                basisSystem();
+            QL_REQUIRE(values.rows() == states.size() &&
+                       values.columns() == v.size(),
+                       "wrong matrix size");
+            for (Size j=0; j<states.size(); ++j)
+                for (Size l=0; l<v.size(); ++l)
+                    values[j][l] = v[l](states[j]);
+        }
     };
 }
 
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -18,8 +19,8 @@
 */
 
 #include <ql/methods/montecarlo/genericlsregression.hpp>
-#include <ql/math/statistics/sequencestatistics.hpp>
-#include <ql/math/matrixutilities/svd.hpp>
+#include <ql/methods/montecarlo/lsmregression.hpp>
+#include <ql/math/statistics/statistics.hpp>
 
 namespace QuantLib {
 
@@ -34,38 +35,32 @@ namespace QuantLib {
 
             std::vector<NodeData>& exerciseData = simulationData[i];
 
-            // 1) find the covariance matrix of basis function values and
-            //    deflated cash-flows
+            // 1) collect the basis function values and deflated
+            //    cash-flows; they're kept in case the normal
+            //    equations are ill-conditioned
             Size N = exerciseData.front().values.size();
-            std::vector<Real> temp(N+1);
-            SequenceStatistics stats(N+1);
-
-            Size j;
+            Size valid = 0, j;
             for (j=0; j<exerciseData.size(); ++j) {
+                if (exerciseData[j].isValid)
+                    ++valid;
+            }
+            Matrix basisValues(valid, N);
+            std::vector<Real> targets(valid);
+            for (j=0, valid=0; j<exerciseData.size(); ++j) {
                 if (exerciseData[j].isValid) {
                     std::copy(exerciseData[j].values.begin(),
                               exerciseData[j].values.end(),
-                              temp.begin());
-                    temp.back() = exerciseData[j].cumulatedCashFlows
-                                - exerciseData[j].controlValue;
-
-                    stats.add(temp);
+                              basisValues.row_begin(valid));
+                    targets[valid] = exerciseData[j].cumulatedCashFlows
+                                   - exerciseData[j].controlValue;
+                    ++valid;
                 }
             }
 
-            std::vector<Real> means = stats.mean();
-            Matrix covariance = stats.covariance();
-
-            Matrix C(N,N);
-            Array target(N);
-            for (Size k=0; k<N; ++k) {
-                target[k] = covariance[k][N] + means[k]*means[N];
-                for (Size l=0; l<=k; ++l)
-                    C[k][l] = C[l][k] = covariance[k][l] + means[k]*means[l];
-            }
-
             // 2) solve for least squares regression
-            Array alphas = SVD(C).solveFor(target);
+            LsmRegression regression(N);
+            regression.add(basisValues, targets);
+            Array alphas = regression.coefficients(basisValues, targets);
             basisCoefficients[i-1].resize(N);
             std::copy(alphas.begin(), alphas.end(),
                       basisCoefficients[i-1].begin());
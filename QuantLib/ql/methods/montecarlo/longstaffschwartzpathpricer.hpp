@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -26,11 +27,12 @@
 
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/math/functional.hpp>
-#include <ql/math/generallinearleastsquares.hpp>
+#include <ql/methods/montecarlo/lsmregression.hpp>
 #include <ql/methods/montecarlo/pathpricer.hpp>
 #include <ql/methods/montecarlo/earlyexercisepathpricer.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <numeric>
 
 namespace QuantLib {
 
@@ -41,6 +43,13 @@ namespace QuantLib {
         by Simulation: A Simple Least-Squares Approach, The Review of
         Financial Studies, Volume 14, No. 1, 113-147
 
+        During the calibration phase, the paths are not stored;
+        only the exercise values and, for in-the-money paths, the
+        regression states at each exercise time are kept.  The
+        memory required is therefore proportional to the number of
+        calibration paths and exercise times, but not to the size of
+        the paths themselves.
+
         \ingroup mcarlo
 
         \test the correctness of the returned value is tested by
@@ -67,7 +76,12 @@ namespace QuantLib {
         boost::scoped_array<Array> coeff_;
         boost::scoped_array<DiscountFactor> dF_;
 
-        mutable std::vector<PathType> paths_;
+        // calibration data: exercises_[i][j] is the exercise value of
+        // the j-th path at time i, while states_[i] contains the
+        // regression states at time i of the paths in the money.
+        mutable Size calibrationPaths_;
+        mutable std::vector<std::vector<Real> > exercises_;
+        mutable std::vector<std::vector<StateType> > states_;
         const   std::vector<boost::function1<Real, StateType> > v_;
     };
 
@@ -81,6 +95,7 @@ namespace QuantLib {
       pathPricer_(pathPricer),
       coeff_     (new Array[times.size()-1]),
       dF_        (new DiscountFactor[times.size()-1]),
+      calibrationPaths_(0),
       v_         (pathPricer_->basisSystem()) {
 
         for (Size i=0; i<times.size()-1; ++i) {
@@ -92,14 +107,28 @@ namespace QuantLib {
     template <class PathType> inline
     Real LongstaffSchwartzPathPricer<PathType>::operator()
         (const PathType& path) const {
+        const Size len = EarlyExerciseTraits<PathType>::pathLength(path);
+
         if (calibrationPhase_) {
-            // store paths for the calibration
-            paths_.push_back(path);
+            // store what the regression needs
+            if (calibrationPaths_ == 0) {
+                exercises_.resize(len);
+                states_.resize(len);
+            }
+            QL_REQUIRE(exercises_.size() == len,
+                       "calibration paths of different lengths");
+            exercises_[len-1].push_back((*pathPricer_)(path, len-1));
+            for (Size i=1; i<len-1; ++i) {
+                const Real exercise = (*pathPricer_)(path, i);
+                exercises_[i].push_back(exercise);
+                if (exercise > 0.0)
+                    states_[i].push_back(pathPricer_->state(path, i));
+            }
+            ++calibrationPaths_;
             // result doesn't matter
             return 0.0;
         }
 
-        const Size len = EarlyExerciseTraits<PathType>::pathLength(path);
         Real price = (*pathPricer_)(path, len-1);
         for (Size i=len-2; i>0; --i) {
             price*=dF_[i];
@@ -124,45 +153,49 @@ namespace QuantLib {
 
     template <class PathType> inline
     void LongstaffSchwartzPathPricer<PathType>::calibrate() {
-        const Size n = paths_.size();
-        Array prices(n), exercise(n);
-        const Size len = EarlyExerciseTraits<PathType>::pathLength(paths_[0]);
+        const Size n = calibrationPaths_;
+        QL_REQUIRE(n > 0, "no calibration paths");
+        const Size len = exercises_.size();
 
-        for (Size i=0; i<n; ++i)
-            prices[i] = (*pathPricer_)(paths_[i], len-1);
+        Array prices(exercises_[len-1].begin(), exercises_[len-1].end());
 
-        std::vector<Real>      y;
-        std::vector<StateType> x;
+        std::vector<Real> y;
         for (Size i=len-2; i>0; --i) {
-            y.clear();
-            x.clear();
+            const std::vector<Real>& exercise = exercises_[i];
+            const std::vector<StateType>& x = states_[i];
 
             //roll back step
+            y.clear();
             for (Size j=0; j<n; ++j) {
-                exercise[j]=(*pathPricer_)(paths_[j], i);
-
-                if (exercise[j]>0.0) {
-                    x.push_back(pathPricer_->state(paths_[j], i));
+                if (exercise[j]>0.0)
                     y.push_back(dF_[i]*prices[j]);
-                }
             }
 
-            if (v_.size() <=  x.size()) {
-                coeff_[i] = GeneralLinearLeastSquares(x, y, v_).coefficients();
+            // the basis functions are evaluated on all the paths in
+            // the money at once and reused for the exercise decision
+            const Size m = v_.size();
+            Matrix basisValues(x.size(), m);
+            if (m <= x.size()) {
+                pathPricer_->basisValues(x, basisValues);
+                LsmRegression regression(m);
+                regression.add(basisValues, y);
+                coeff_[i] = regression.coefficients(basisValues, y);
             }
             else {
             // if number of itm paths is smaller then the number of
             // calibration functions then early exercise if exerciseValue > 0
-                coeff_[i] = Array(v_.size(), 0.0);
+                coeff_[i] = Array(m, 0.0);
             }
 
             for (Size j=0, k=0; j<n; ++j) {
                 prices[j]*=dF_[i];
                 if (exercise[j]>0.0) {
                     Real continuationValue = 0.0;
-                    for (Size l=0; l<v_.size(); ++l) {
-                        continuationValue += coeff_[i][l] * v_[l](x[k]);
-                    }
+                    if (m <= x.size())
+                        continuationValue =
+                            std::inner_product(basisValues.row_begin(k),
+                                               basisValues.row_end(k),
+                                               coeff_[i].begin(), 0.0);
                     if (continuationValue < exercise[j]) {
                         prices[j] = exercise[j];
                     }
@@ -171,9 +204,12 @@ namespace QuantLib {
             }
         }
 
-        // remove calibration paths and release memory
-        std::vector<PathType> empty;
-        paths_.swap(empty);
+        // remove calibration data and release memory
+        std::vector<std::vector<Real> > emptyExercises;
+        exercises_.swap(emptyExercises);
+        std::vector<std::vector<StateType> > emptyStates;
+        states_.swap(emptyStates);
+        calibrationPaths_ = 0;
         // entering the calculation phase
         calibrationPhase_ = false;
     }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006 Klaus Spanderen
  Copyright (C) 2010 Kakhkhor Abdijalilov
+ Copyright (C) 2014 StatPro Italia srl
  
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -105,6 +106,84 @@ namespace QuantLib {
             VV ret(tuples.begin(), tuples.end());
             return ret;
         }
+
+        // all tuples of order up to the given one, in increasing order
+        VV multi_path_tuples(Size dim, Size order) {
+            // start with all 0 tuple
+            VV tuples(1, std::vector<Size>(dim));
+            VV ret = tuples;
+            for(Size i=1; i<=order; ++i) {
+                tuples = next_order_tuples(tuples);
+                ret.insert(ret.end(), tuples.begin(), tuples.end());
+            }
+            return ret;
+        }
+
+        boost::shared_ptr<GaussianOrthogonalPolynomial>
+        orthogonal_polynomial(LsmBasisSystem::PolynomType polyType) {
+            typedef boost::shared_ptr<GaussianOrthogonalPolynomial> ptr;
+            switch (polyType) {
+              case LsmBasisSystem::Laguerre:
+                return ptr(new GaussLaguerrePolynomial);
+              case LsmBasisSystem::Hermite:
+                return ptr(new GaussHermitePolynomial);
+              case LsmBasisSystem::Hyperbolic:
+                return ptr(new GaussHyperbolicPolynomial);
+              case LsmBasisSystem::Legendre:
+                return ptr(new GaussLegendrePolynomial);
+              case LsmBasisSystem::Chebyshev:
+                return ptr(new GaussChebyshevPolynomial);
+              case LsmBasisSystem::Chebyshev2nd:
+                return ptr(new GaussChebyshev2ndPolynomial);
+              default:
+                QL_FAIL("unknown regression type");
+            }
+        }
+
+        /* sets p[i][j] to the i-th polynomial evaluated at x[j].
+           Each row is calculated from the previous ones on all
+           points at once; the results are the same as those of
+           the functions returned by pathBasisSystem. */
+        void polynomial_values(Size order,
+                               LsmBasisSystem::PolynomType polyType,
+                               const std::vector<Real>& x,
+                               Matrix& p) {
+            const Size n = x.size();
+            std::fill(p.row_begin(0), p.row_end(0), 1.0);
+
+            if (polyType == LsmBasisSystem::Monomial) {
+                for (Size i=1; i<=order; ++i) {
+                    const Real* previous = p.row_begin(i-1);
+                    Real* current = p.row_begin(i);
+                    for (Size j=0; j<n; ++j)
+                        current[j] = previous[j]*x[j];
+                }
+                return;
+            }
+
+            const boost::shared_ptr<GaussianOrthogonalPolynomial> poly =
+                orthogonal_polynomial(polyType);
+            if (order >= 1) {
+                const Real alpha = poly->alpha(0);
+                Real* current = p.row_begin(1);
+                for (Size j=0; j<n; ++j)
+                    current[j] = x[j]-alpha;
+            }
+            for (Size i=2; i<=order; ++i) {
+                const Real alpha = poly->alpha(i-1), beta = poly->beta(i-1);
+                const Real* previous2 = p.row_begin(i-2);
+                const Real* previous = p.row_begin(i-1);
+                Real* current = p.row_begin(i);
+                for (Size j=0; j<n; ++j)
+                    current[j] = (x[j]-alpha)*previous[j]
+                               - beta*previous2[j];
+            }
+            for (Size j=0; j<n; ++j) {
+                const Real w = std::sqrt(poly->w(x[j]));
+                for (Size i=0; i<=order; ++i)
+                    p[i][j] *= w;
+            }
+        }
     } 
 
     // LsmBasisSystem static methods
@@ -146,23 +225,72 @@ namespace QuantLib {
         QL_REQUIRE(dim>0, "zero dimension");
         // get single factor basis
         VF_R pathBasis = pathBasisSystem(order, polyType);
+        VV tuples = multi_path_tuples(dim, order);
         VF_A ret;
-        // 0-th order term
-        VF_R term(dim, pathBasis[0]);
-        ret.push_back(MultiDimFct(term));
-        // start with all 0 tuple
-        VV tuples(1, std::vector<Size>(dim));
-        // add multi-factor terms
-        for(Size i=1; i<=order; ++i) {
-            tuples = next_order_tuples(tuples);
-            // now we have all tuples of order i
-            // for each tuple add the corresponding term
-            for(Size j=0; j<tuples.size(); ++j) {
-                for(Size k=0; k<dim; ++k)
-                    term[k] = pathBasis[tuples[j][k]];
-                ret.push_back(MultiDimFct(term));
-            }
+        // for each tuple add the corresponding term
+        VF_R term(dim);
+        for(Size j=0; j<tuples.size(); ++j) {
+            for(Size k=0; k<dim; ++k)
+                term[k] = pathBasis[tuples[j][k]];
+            ret.push_back(MultiDimFct(term));
         }
         return ret;
     }
+
+    void LsmBasisSystem::pathBasisValues(Size order, PolynomType polyType,
+                                         const std::vector<Real>& x,
+                                         Matrix& values) {
+        const Size n = x.size();
+        QL_REQUIRE(values.rows() == n,
+                   "wrong number of rows (" << values.rows() << ") for "
+                   << n << " points");
+        QL_REQUIRE(values.columns() > order,
+                   "not enough columns (" << values.columns() << ") for "
+                   << order+1 << " basis functions");
+        if (n == 0)
+            return;
+
+        Matrix p(order+1, n);
+        polynomial_values(order, polyType, x, p);
+        for (Size j=0; j<n; ++j)
+            for (Size i=0; i<=order; ++i)
+                values[j][i] = p[i][j];
+    }
+
+    void LsmBasisSystem::multiPathBasisValues(Size dim, Size order,
+                                              PolynomType polyType,
+                                              const std::vector<Array>& x,
+                                              Matrix& values) {
+        QL_REQUIRE(dim>0, "zero dimension");
+        const VV tuples = multi_path_tuples(dim, order);
+        const Size n = x.size();
+        QL_REQUIRE(values.rows() == n,
+                   "wrong number of rows (" << values.rows() << ") for "
+                   << n << " points");
+        QL_REQUIRE(values.columns() >= tuples.size(),
+                   "not enough columns (" << values.columns() << ") for "
+                   << tuples.size() << " basis functions");
+        if (n == 0)
+            return;
+
+        // one-dimensional values for each component
+        std::vector<Matrix> p(dim, Matrix(order+1, n));
+        std::vector<Real> component(n);
+        for (Size k=0; k<dim; ++k) {
+            for (Size j=0; j<n; ++j) {
+                QL_REQUIRE(x[j].size() == dim, "wrong argument size");
+                component[j] = x[j][k];
+            }
+            polynomial_values(order, polyType, component, p[k]);
+        }
+
+        for (Size j=0; j<n; ++j) {
+            for (Size t=0; t<tuples.size(); ++t) {
+                Real value = p[0][tuples[t][0]][j];
+                for (Size k=1; k<dim; ++k)
+                    value *= p[k][tuples[t][k]][j];
+                values[j][t] = value;
+            }
+        }
+    }
 }
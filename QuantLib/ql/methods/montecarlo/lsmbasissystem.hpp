@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006 Klaus Spanderen
  Copyright (C) 2010 Kakhkhor Abdijalilov
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -28,7 +29,7 @@
 #define quantlib_lsm_basis_system_hpp
 
 #include <ql/qldefines.hpp>
-#include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
 #include <boost/function.hpp>
 #include <vector>
 
@@ -44,6 +45,27 @@ namespace QuantLib {
 
         static std::vector<boost::function1<Real, Array> >
             multiPathBasisSystem(Size dim, Size order, PolynomType polyType);
+
+        /*! Sets values[j][i] to the i-th function returned by
+            pathBasisSystem(order, polyType) evaluated at x[j].
+            The polynomials are evaluated on all points at once by
+            means of their recurrence relations, which is a lot
+            faster than calling the functions one by one.  Any
+            columns of values beyond the first order+1 are left
+            untouched.
+        */
+        static void pathBasisValues(Size order, PolynomType polyType,
+                                    const std::vector<Real>& x,
+                                    Matrix& values);
+
+        /*! Sets values[j][i] to the i-th function returned by
+            multiPathBasisSystem(dim, order, polyType) evaluated at
+            x[j]; as above, any additional columns are left untouched.
+        */
+        static void multiPathBasisValues(Size dim, Size order,
+                                         PolynomType polyType,
+                                         const std::vector<Array>& x,
+                                         Matrix& values);
     };
 
 
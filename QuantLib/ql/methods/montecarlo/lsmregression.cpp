@@ -0,0 +1,123 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/methods/montecarlo/lsmregression.hpp>
+#include <ql/math/matrixutilities/svd.hpp>
+
+namespace QuantLib {
+
+    namespace {
+
+        /* a pivot smaller than this fraction of the corresponding
+           diagonal element means that the basis function is almost
+           a linear combination of the previous ones.  The ratio is
+           the squared relative distance of the function from the
+           span of the previous ones; 1e-10 corresponds to a design
+           matrix with a condition number of about 1e5, for which the
+           normal equations (condition number about 1e10) would lose
+           10 of the 16 significant digits of a double. */
+        const Real dependencyThreshold = 1.0e-10;
+
+    }
+
+    LsmRegression::LsmRegression(Size basisSize)
+    : normalMatrix_(basisSize, basisSize, 0.0), rhs_(basisSize, 0.0),
+      buffer_(basisSize), samples_(0) {
+        QL_REQUIRE(basisSize > 0, "empty basis system");
+    }
+
+    void LsmRegression::add(const Matrix& basisValues,
+                            const std::vector<Real>& targets) {
+        QL_REQUIRE(basisValues.rows() == targets.size(),
+                   "mismatch between number of rows (" << basisValues.rows()
+                   << ") and targets (" << targets.size() << ")");
+        QL_REQUIRE(basisValues.columns() == rhs_.size(),
+                   "wrong number of columns (" << basisValues.columns()
+                   << ", " << rhs_.size() << " required)");
+        for (Size j=0; j<targets.size(); ++j)
+            add(basisValues.row_begin(j), targets[j]);
+    }
+
+    Disposable<Array> LsmRegression::coefficients() const {
+        Array result;
+        QL_REQUIRE(solveNormalEquations(result),
+                   "degenerate basis functions: the samples are "
+                   "needed to solve the regression");
+        return result;
+    }
+
+    Disposable<Array> LsmRegression::coefficients(
+                                   const Matrix& basisValues,
+                                   const std::vector<Real>& targets) const {
+        QL_REQUIRE(basisValues.rows() == samples_ &&
+                   targets.size() == samples_,
+                   "mismatch between the samples passed (" <<
+                   basisValues.rows() << " rows, " << targets.size() <<
+                   " targets) and those added (" << samples_ << ")");
+        QL_REQUIRE(basisValues.columns() == rhs_.size(),
+                   "wrong number of columns (" << basisValues.columns()
+                   << ", " << rhs_.size() << " required)");
+        Array result;
+        if (!solveNormalEquations(result)) {
+            Array b(targets.begin(), targets.end());
+            result = SVD(basisValues).solveFor(b);
+        }
+        return result;
+    }
+
+    bool LsmRegression::solveNormalEquations(Array& result) const {
+        const Size m = rhs_.size();
+
+        // Cholesky decomposition A = L L^T
+        Matrix L(m, m, 0.0);
+        for (Size j=0; j<m; ++j) {
+            Real pivot = normalMatrix_[j][j];
+            for (Size k=0; k<j; ++k)
+                pivot -= L[j][k]*L[j][k];
+            // this also catches null basis functions and NaNs
+            if (!(pivot > dependencyThreshold*normalMatrix_[j][j]))
+                return false;
+            L[j][j] = std::sqrt(pivot);
+            for (Size i=j+1; i<m; ++i) {
+                Real sum = normalMatrix_[i][j];
+                for (Size k=0; k<j; ++k)
+                    sum -= L[i][k]*L[j][k];
+                L[i][j] = sum/L[j][j];
+            }
+        }
+
+        // forward and backward substitution
+        result = Array(m);
+        for (Size i=0; i<m; ++i) {
+            Real sum = rhs_[i];
+            for (Size k=0; k<i; ++k)
+                sum -= L[i][k]*result[k];
+            result[i] = sum/L[i][i];
+        }
+        for (Size i=m; i>0; --i) {
+            Real sum = result[i-1];
+            for (Size k=i; k<m; ++k)
+                sum -= L[k][i-1]*result[k];
+            result[i-1] = sum/L[i-1][i-1];
+        }
+        return true;
+    }
+
+}
+
@@ -0,0 +1,104 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file lsmregression.hpp
+    \brief least-squares regression for Longstaff-Schwartz Monte Carlo
+*/
+
+#ifndef quantlib_lsm_regression_hpp
+#define quantlib_lsm_regression_hpp
+
+#include <ql/math/matrix.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    //! least-squares regression on a set of basis functions
+    /*! The samples are added one at a time, as the values of the
+        basis functions and the corresponding target; only the
+        normal equations are stored, so that memory doesn't depend
+        on the number of samples.
+
+        The coefficients are obtained by a Cholesky decomposition of
+        the normal equations.  If any basis function is found to be
+        (nearly) linearly dependent on the previous ones, the normal
+        equations (whose condition number is the square of that of
+        the design matrix) can't be solved accurately; the solution
+        then falls back to a singular value decomposition of the
+        design matrix, which discards the degenerate directions.
+        This requires the samples to be passed to coefficients().
+
+        \ingroup mcarlo
+    */
+    class LsmRegression {
+      public:
+        explicit LsmRegression(Size basisSize);
+        //! adds a sample given the values of the basis functions
+        template <class Iterator>
+        void add(Iterator basisValues, Real target);
+        //! adds the rows of the given matrix as samples
+        void add(const Matrix& basisValues,
+                 const std::vector<Real>& targets);
+        //! number of samples added so far
+        Size samples() const { return samples_; }
+        //! regression coefficients
+        /*! \pre the basis functions must not be degenerate on the
+                 samples; an exception is raised otherwise.
+        */
+        Disposable<Array> coefficients() const;
+        //! regression coefficients, also for a degenerate basis
+        /*! The samples added so far must be passed, as the values
+            of the basis functions (one row per sample) and the
+            targets; they're only used if the normal equations are
+            ill-conditioned.
+        */
+        Disposable<Array> coefficients(
+                                   const Matrix& basisValues,
+                                   const std::vector<Real>& targets) const;
+      private:
+        // false if the normal equations are ill-conditioned
+        bool solveNormalEquations(Array& result) const;
+        // only the lower triangle is used
+        Matrix normalMatrix_;
+        Array rhs_, buffer_;
+        Size samples_;
+    };
+
+
+    // template definitions
+
+    template <class Iterator>
+    void LsmRegression::add(Iterator basisValues, Real target) {
+        const Size m = rhs_.size();
+        for (Size k=0; k<m; ++k, ++basisValues)
+            buffer_[k] = *basisValues;
+        for (Size k=0; k<m; ++k) {
+            const Real vk = buffer_[k];
+            rhs_[k] += vk*target;
+            Real* row = normalMatrix_.row_begin(k);
+            for (Size l=0; l<=k; ++l)
+                row[l] += vk*buffer_[l];
+        }
+        ++samples_;
+    }
+
+}
+
+
+#endif
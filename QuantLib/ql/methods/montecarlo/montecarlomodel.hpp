@@ -28,6 +28,7 @@
 #include <ql/methods/montecarlo/mctraits.hpp>
 #include <ql/math/statistics/statistics.hpp>
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace QuantLib {
 
@@ -45,6 +46,30 @@ namespace QuantLib {
         provide the additional control option, namely the option path
         pricer and the option value.
 
+        If a number of threads is passed, samples are drawn in
+        fixed-size chunks, each with its own sample accumulator, and
+        each thread simulates a contiguous range of chunks on its
+        own copy of the path generator.  The copy is positioned at
+        the start of the range by means of its skipTo() method, so
+        that the samples are the same that would be drawn in the
+        default, sequential mode; the accumulators are then merged
+        in chunk order.  The results are therefore reproducible and
+        do not depend on the number of threads.  Before the threads
+        are started, a path is drawn and discarded on a copy of each
+        generator, so that any lazy calculation in the process (e.g.,
+        the local volatility of a Black-Scholes process) is performed
+        sequentially; after that, the process and the path pricers
+        must be safe to use concurrently.
+
+        If a block size is passed, paths are drawn and priced in
+        blocks of the given size by means of the block methods of
+        the path generators and pricers, so that the process can
+        evolve all the paths of a block in a single call.  The
+        samples are the same that would be drawn one at a time, but
+        the pricers are called on all the paths of a block before
+        their antithetic paths; pricers whose results depend on the
+        order of the calls should not be used in this mode.
+
         \ingroup mcarlo
     */
     template <template <class> class MC, class RNG, class S = Statistics>
@@ -67,20 +92,36 @@ namespace QuantLib {
                         = boost::shared_ptr<path_pricer_type>(),
                   result_type cvOptionValue = result_type(),
                   const boost::shared_ptr<path_generator_type>& cvPathGenerator
-                        = boost::shared_ptr<path_generator_type>())
+                        = boost::shared_ptr<path_generator_type>(),
+                  Size threads = Null<Size>(),
+                  Size blockSize = Null<Size>())
         : pathGenerator_(pathGenerator), pathPricer_(pathPricer),
           sampleAccumulator_(sampleAccumulator),
           isAntitheticVariate_(antitheticVariate),
           cvPathPricer_(cvPathPricer), cvOptionValue_(cvOptionValue),
-          cvPathGenerator_(cvPathGenerator) {
+          cvPathGenerator_(cvPathGenerator),
+          threads_(threads), blockSize_(blockSize), simulatedSamples_(0) {
             if (!cvPathPricer_)
                 isControlVariate_ = false;
             else
                 isControlVariate_ = true;
+            QL_REQUIRE(threads_ != 0, "null number of threads");
+            QL_REQUIRE(blockSize_ != 0, "null block size");
         }
         void addSamples(Size samples);
         const stats_type& sampleAccumulator(void) const;
+        //! number of samples simulated in each concurrent chunk
+        static Size samplesPerChunk() { return 1024; }
       private:
+        void addSamples(path_generator_type& pathGenerator,
+                        path_generator_type* cvPathGenerator,
+                        stats_type& accumulator,
+                        Size samples) const;
+        void addSamplesInBlocks(path_generator_type& pathGenerator,
+                                path_generator_type* cvPathGenerator,
+                                stats_type& accumulator,
+                                Size samples) const;
+        void addSamplesInChunks(Size samples);
         boost::shared_ptr<path_generator_type> pathGenerator_;
         boost::shared_ptr<path_pricer_type> pathPricer_;
         stats_type sampleAccumulator_;
@@ -89,45 +130,183 @@ namespace QuantLib {
         result_type cvOptionValue_;
         bool isControlVariate_;
         boost::shared_ptr<path_generator_type> cvPathGenerator_;
+        Size threads_, blockSize_;
+        unsigned long simulatedSamples_;
     };
 
     // inline definitions
     template <template <class> class MC, class RNG, class S>
     inline void MonteCarloModel<MC,RNG,S>::addSamples(Size samples) {
+        if (threads_ == Null<Size>())
+            addSamples(*pathGenerator_, cvPathGenerator_.get(),
+                       sampleAccumulator_, samples);
+        else
+            addSamplesInChunks(samples);
+    }
+
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::addSamples(
+                                    path_generator_type& pathGenerator,
+                                    path_generator_type* cvPathGenerator,
+                                    stats_type& accumulator,
+                                    Size samples) const {
+        if (blockSize_ != Null<Size>()) {
+            addSamplesInBlocks(pathGenerator, cvPathGenerator,
+                               accumulator, samples);
+            return;
+        }
+
         for(Size j = 1; j <= samples; j++) {
 
-            sample_type path = pathGenerator_->next();
+            sample_type path = pathGenerator.next();
             result_type price = (*pathPricer_)(path.value);
 
             if (isControlVariate_) {
-                if (!cvPathGenerator_) {
+                if (!cvPathGenerator) {
                     price += cvOptionValue_-(*cvPathPricer_)(path.value);
                 }
                 else {
-                    sample_type cvPath = cvPathGenerator_->next();
+                    sample_type cvPath = cvPathGenerator->next();
                     price += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
                 }
             }
 
             if (isAntitheticVariate_) {
-                path = pathGenerator_->antithetic();
+                path = pathGenerator.antithetic();
                 result_type price2 = (*pathPricer_)(path.value);
                 if (isControlVariate_) {
-                    if (!cvPathGenerator_)
+                    if (!cvPathGenerator)
                         price2 += cvOptionValue_-(*cvPathPricer_)(path.value);
                     else {
-                        sample_type cvPath = cvPathGenerator_->antithetic();
+                        sample_type cvPath = cvPathGenerator->antithetic();
                         price2 += cvOptionValue_-(*cvPathPricer_)(cvPath.value);
                     }
                 }
 
-                sampleAccumulator_.add((price+price2)/2.0, path.weight);
+                accumulator.add((price+price2)/2.0, path.weight);
             } else {
-                sampleAccumulator_.add(price, path.weight);
+                accumulator.add(price, path.weight);
             }
         }
     }
 
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::addSamplesInBlocks(
+                                    path_generator_type& pathGenerator,
+                                    path_generator_type* cvPathGenerator,
+                                    stats_type& accumulator,
+                                    Size samples) const {
+        typedef typename path_generator_type::block_type block_type;
+        block_type paths, cvPaths;
+        std::vector<result_type> prices, prices2, cvPrices;
+
+        for (Size done = 0; done < samples; ) {
+            Size n = std::min(blockSize_, samples-done);
+            if (paths.size() != n) {
+                paths = pathGenerator.newBlock(n);
+                if (cvPathGenerator)
+                    cvPaths = cvPathGenerator->newBlock(n);
+            }
+
+            pathGenerator.next(paths);
+            (*pathPricer_)(paths, prices);
+
+            if (isControlVariate_) {
+                if (!cvPathGenerator) {
+                    (*cvPathPricer_)(paths, cvPrices);
+                } else {
+                    cvPathGenerator->next(cvPaths);
+                    (*cvPathPricer_)(cvPaths, cvPrices);
+                }
+                for (Size j=0; j<n; ++j)
+                    prices[j] += cvOptionValue_-cvPrices[j];
+            }
+
+            if (isAntitheticVariate_) {
+                pathGenerator.antithetic(paths);
+                (*pathPricer_)(paths, prices2);
+                if (isControlVariate_) {
+                    if (!cvPathGenerator) {
+                        (*cvPathPricer_)(paths, cvPrices);
+                    } else {
+                        cvPathGenerator->antithetic(cvPaths);
+                        (*cvPathPricer_)(cvPaths, cvPrices);
+                    }
+                    for (Size j=0; j<n; ++j)
+                        prices2[j] += cvOptionValue_-cvPrices[j];
+                }
+                for (Size j=0; j<n; ++j)
+                    accumulator.add((prices[j]+prices2[j])/2.0,
+                                    paths.weights()[j]);
+            } else {
+                for (Size j=0; j<n; ++j)
+                    accumulator.add(prices[j], paths.weights()[j]);
+            }
+
+            done += n;
+        }
+    }
+
+    template <template <class> class MC, class RNG, class S>
+    inline void MonteCarloModel<MC,RNG,S>::addSamplesInChunks(Size samples) {
+        if (samples == 0)
+            return;
+
+        const Size chunkSize = samplesPerChunk();
+        const Size chunks = (samples+chunkSize-1)/chunkSize;
+        const Size workers = std::min(threads_, chunks);
+        const unsigned long first = simulatedSamples_;
+
+        std::vector<stats_type> accumulators(chunks, stats_type());
+        std::vector<std::string> errors(workers);
+
+        // the first draw triggers the lazy calculations of the process,
+        // which would race if left to the workers.
+        {
+            path_generator_type warmUp(*pathGenerator_);
+            warmUp.next();
+            if (cvPathGenerator_) {
+                path_generator_type cvWarmUp(*cvPathGenerator_);
+                cvWarmUp.next();
+            }
+        }
+
+        // each worker repositions its generators once, at the
+        // beginning of its range of chunks, and then draws the
+        // samples in sequence.
+        #pragma omp parallel for num_threads(threads_) schedule(static)
+        for (long w=0; w<long(workers); ++w) {
+            try {
+                Size begin = (w*chunks)/workers, end = ((w+1)*chunks)/workers;
+                unsigned long start = first + begin*chunkSize;
+                path_generator_type generator(*pathGenerator_);
+                generator.skipTo(start);
+                boost::shared_ptr<path_generator_type> cvGenerator;
+                if (cvPathGenerator_) {
+                    cvGenerator = boost::shared_ptr<path_generator_type>(
+                                   new path_generator_type(*cvPathGenerator_));
+                    cvGenerator->skipTo(start);
+                }
+                for (Size i=begin; i<end; ++i) {
+                    Size n = std::min(chunkSize, samples-i*chunkSize);
+                    addSamples(generator, cvGenerator.get(),
+                               accumulators[i], n);
+                }
+            } catch (std::exception& e) {
+                errors[w] = e.what();
+            } catch (...) {
+                errors[w] = "unknown error";
+            }
+        }
+
+        for (Size w=0; w<workers; ++w)
+            QL_REQUIRE(errors[w].empty(), errors[w]);
+
+        for (Size i=0; i<chunks; ++i)
+            sampleAccumulator_.merge(accumulators[i]);
+        simulatedSamples_ += samples;
+    }
+
     template <template <class> class MC, class RNG, class S>
     inline const typename MonteCarloModel<MC,RNG,S>::stats_type&
     MonteCarloModel<MC,RNG,S>::sampleAccumulator() const {
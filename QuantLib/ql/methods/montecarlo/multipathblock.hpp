@@ -0,0 +1,110 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multipathblock.hpp
+    \brief block of correlated multiple asset paths
+*/
+
+#ifndef quantlib_montecarlo_multi_path_block_hpp
+#define quantlib_montecarlo_multi_path_block_hpp
+
+#include <ql/methods/montecarlo/multipath.hpp>
+#include <ql/math/matrix.hpp>
+
+namespace QuantLib {
+
+    //! block of correlated multiple asset paths
+    /*! The block stores a number of multi-asset paths sharing the
+        same time grid. Values are stored by time node, i.e.,
+        block[i] is a matrix whose rows hold the values of each asset
+        at the \f$ i \f$-th point of the grid for all paths, so that
+        block[i][k][j] is the value of the \f$ k \f$-th asset on the
+        \f$ j \f$-th path.
+
+        A block can be refilled any number of times without further
+        memory allocations.
+
+        \ingroup mcarlo
+    */
+    class MultiPathBlock {
+      public:
+        MultiPathBlock() {}
+        MultiPathBlock(Size nAsset,
+                       const TimeGrid& timeGrid,
+                       Size paths);
+        //! \name inspectors
+        //@{
+        //! number of paths in the block
+        Size size() const { return weights_.size(); }
+        Size assetNumber() const { return nAsset_; }
+        //! number of points in each path
+        Size pathSize() const { return timeGrid_.size(); }
+        const TimeGrid& timeGrid() const { return timeGrid_; }
+        //! values of all assets and paths at the \f$ i \f$-th point
+        const Matrix& operator[](Size i) const { return values_[i]; }
+        Matrix& operator[](Size i) { return values_[i]; }
+        //! weights of the paths
+        const Array& weights() const { return weights_; }
+        Array& weights() { return weights_; }
+        //@}
+        //! \name path extraction
+        //@{
+        //! copies the \f$ j \f$-th path of the block into the given path
+        void extract(Size j, MultiPath& path) const;
+        //@}
+      private:
+        Size nAsset_;
+        TimeGrid timeGrid_;
+        std::vector<Matrix> values_;
+        Array weights_;
+    };
+
+
+    // inline definitions
+
+    inline MultiPathBlock::MultiPathBlock(Size nAsset,
+                                          const TimeGrid& timeGrid,
+                                          Size paths)
+    : nAsset_(nAsset), timeGrid_(timeGrid),
+      values_(timeGrid.size(), Matrix(nAsset, paths)),
+      weights_(paths, 1.0) {
+        QL_REQUIRE(nAsset > 0, "number of asset must be positive");
+        QL_REQUIRE(paths > 0, "number of paths must be positive");
+    }
+
+    inline void MultiPathBlock::extract(Size j, MultiPath& path) const {
+        QL_REQUIRE(j < size(),
+                   "path index (" << j << ") out of range [0, "
+                   << size() << ")");
+        QL_REQUIRE(path.assetNumber() == nAsset_,
+                   "number of assets (" << path.assetNumber()
+                   << ") different from block (" << nAsset_ << ")");
+        QL_REQUIRE(path.pathSize() == pathSize(),
+                   "path length (" << path.pathSize()
+                   << ") different from block length (" << pathSize()
+                   << ")");
+        for (Size i=0; i<values_.size(); ++i)
+            for (Size k=0; k<nAsset_; ++k)
+                path[k][i] = values_[i][k][j];
+    }
+
+}
+
+
+#endif
@@ -3,7 +3,7 @@
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
  Copyright (C) 2003 Ferdinando Ametrano
- Copyright (C) 2003, 2004, 2005 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2005, 2014 StatPro Italia srl
  Copyright (C) 2005 Klaus Spanderen
 
  This file is part of QuantLib, a free-software/open-source library
@@ -28,6 +28,7 @@
 #define quantlib_multi_path_generator_hpp
 
 #include <ql/methods/montecarlo/multipath.hpp>
+#include <ql/methods/montecarlo/multipathblock.hpp>
 #include <ql/methods/montecarlo/sample.hpp>
 #include <ql/stochasticprocess.hpp>
 
@@ -50,21 +51,73 @@ namespace QuantLib {
     class MultiPathGenerator {
       public:
         typedef Sample<MultiPath> sample_type;
+        typedef MultiPathBlock block_type;
         MultiPathGenerator(const boost::shared_ptr<StochasticProcess>&,
                            const TimeGrid&,
                            GSG generator,
                            bool brownianBridge = false);
         const sample_type& next() const;
         const sample_type& antithetic() const;
+        //! \name block generation
+        /*! These methods fill a whole block of paths at once, which
+            allows the process to evolve all of them in a single
+            call. The paths are the same that would be returned by
+            as many calls to next() or antithetic().
+        */
+        //@{
+        //! returns a block of paths on the generator's time grid
+        block_type newBlock(Size paths) const {
+            return block_type(process_->size(),
+                              next_.value[0].timeGrid(), paths);
+        }
+        void next(block_type& block) const;
+        /*! returns the antithetic paths of the last block; the
+            passed block must have the same size.
+        */
+        void antithetic(block_type& block) const;
+        //@}
+        //! repositions the underlying sequence generator
+        void skipTo(unsigned long n) { generator_.skipTo(n); }
       private:
         const sample_type& next(bool antithetic) const;
+        void next(block_type& block, bool antithetic) const;
         bool brownianBridge_;
         boost::shared_ptr<StochasticProcess> process_;
         GSG generator_;
         mutable sample_type next_;
+        mutable std::vector<Matrix> draws_;
+        mutable Matrix negatedDraws_;
+        mutable Array weights_;
     };
 
 
+    //! fills a block of sequences from a sequence generator
+    /*! The sequences are stored by step, as the paths in a
+        MultiPathBlock: draws[i][k][j] is the \f$ k \f$-th variate
+        at the \f$ i \f$-th step of the \f$ j \f$-th sequence.
+
+        This generic version draws one sequence at a time; it can be
+        overloaded for generators that can write directly into the
+        block (see for instance SobolBrownianBridgeRsg.)
+    */
+    template <class GSG>
+    void nextSequenceBlock(const GSG& generator,
+                           std::vector<Matrix>& draws,
+                           Array& weights) {
+        typedef typename GSG::sample_type sequence_type;
+        Size steps = draws.size(), n = draws.front().rows();
+        for (Size j=0; j<weights.size(); j++) {
+            const sequence_type& sequence = generator.nextSequence();
+            for (Size i=0; i<steps; i++) {
+                Size offset = i*n;
+                for (Size k=0; k<n; k++)
+                    draws[i][k][j] = sequence.value[offset+k];
+            }
+            weights[j] = sequence.weight;
+        }
+    }
+
+
     // template definitions
 
     template <class GSG>
@@ -150,6 +203,70 @@ namespace QuantLib {
         }
     }
 
+    template <class GSG>
+    inline void MultiPathGenerator<GSG>::next(block_type& block) const {
+        next(block, false);
+    }
+
+    template <class GSG>
+    inline void MultiPathGenerator<GSG>::antithetic(block_type& block) const {
+        next(block, true);
+    }
+
+    template <class GSG>
+    void MultiPathGenerator<GSG>::next(block_type& block,
+                                       bool antithetic) const {
+
+        QL_REQUIRE(!brownianBridge_, "Brownian bridge not supported");
+
+        Size m = process_->size();
+        Size n = process_->factors();
+        const TimeGrid& timeGrid = next_.value[0].timeGrid();
+        Size steps = timeGrid.size()-1;
+        Size paths = block.size();
+
+        QL_REQUIRE(block.assetNumber() == m,
+                   "number of assets in block (" << block.assetNumber()
+                   << ") != process size (" << m << ")");
+        QL_REQUIRE(block.pathSize() == timeGrid.size(),
+                   "block length (" << block.pathSize()
+                   << ") != time-grid size (" << timeGrid.size() << ")");
+
+        if (antithetic) {
+            QL_REQUIRE(weights_.size() == paths,
+                       "block size (" << paths
+                       << ") different from last generated block ("
+                       << weights_.size() << ")");
+        } else {
+            // the draws are stored by time step, as the paths
+            if (weights_.size() != paths) {
+                draws_ = std::vector<Matrix>(steps, Matrix(n, paths));
+                negatedDraws_ = Matrix(n, paths);
+                weights_ = Array(paths);
+            }
+
+            nextSequenceBlock(generator_, draws_, weights_);
+        }
+
+        std::copy(weights_.begin(), weights_.end(), block.weights().begin());
+        Array asset = process_->initialValues();
+        for (Size k=0; k<m; k++)
+            std::fill(block[0].row_begin(k), block[0].row_end(k), asset[k]);
+
+        for (Size i=1; i<block.pathSize(); i++) {
+            Time t = timeGrid[i-1];
+            Time dt = timeGrid.dt(i-1);
+            if (antithetic) {
+                std::transform(draws_[i-1].begin(), draws_[i-1].end(),
+                               negatedDraws_.begin(),
+                               std::negate<Real>());
+                process_->evolve(t, block[i-1], dt, negatedDraws_, block[i]);
+            } else {
+                process_->evolve(t, block[i-1], dt, draws_[i-1], block[i]);
+            }
+        }
+    }
+
 }
 
 #endif
@@ -0,0 +1,97 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file pathblock.hpp
+    \brief block of single-factor random walks
+*/
+
+#ifndef quantlib_montecarlo_path_block_hpp
+#define quantlib_montecarlo_path_block_hpp
+
+#include <ql/methods/montecarlo/path.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    //! block of single-factor random walks
+    /*! The block stores a number of paths sharing the same time grid.
+        Values are stored by time node, i.e., block[i] holds the values
+        of all paths at the \f$ i \f$-th point of the grid, contiguous
+        in memory; this is the layout used by the batched evolve and
+        pricing methods.
+
+        A block can be refilled any number of times without further
+        memory allocations.
+
+        \ingroup mcarlo
+    */
+    class PathBlock {
+      public:
+        PathBlock() {}
+        PathBlock(const TimeGrid& timeGrid,
+                  Size paths);
+        //! \name inspectors
+        //@{
+        //! number of paths in the block
+        Size size() const { return weights_.size(); }
+        //! number of points in each path
+        Size length() const { return timeGrid_.size(); }
+        const TimeGrid& timeGrid() const { return timeGrid_; }
+        //! values of all paths at the \f$ i \f$-th point
+        const Array& operator[](Size i) const { return values_[i]; }
+        Array& operator[](Size i) { return values_[i]; }
+        //! weights of the paths
+        const Array& weights() const { return weights_; }
+        Array& weights() { return weights_; }
+        //@}
+        //! \name path extraction
+        //@{
+        //! copies the \f$ j \f$-th path of the block into the given path
+        void extract(Size j, Path& path) const;
+        //@}
+      private:
+        TimeGrid timeGrid_;
+        std::vector<Array> values_;
+        Array weights_;
+    };
+
+
+    // inline definitions
+
+    inline PathBlock::PathBlock(const TimeGrid& timeGrid, Size paths)
+    : timeGrid_(timeGrid), values_(timeGrid.size(), Array(paths)),
+      weights_(paths, 1.0) {
+        QL_REQUIRE(paths > 0, "number of paths must be positive");
+    }
+
+    inline void PathBlock::extract(Size j, Path& path) const {
+        QL_REQUIRE(j < size(),
+                   "path index (" << j << ") out of range [0, "
+                   << size() << ")");
+        QL_REQUIRE(path.length() == length(),
+                   "path length (" << path.length()
+                   << ") different from block length (" << length() << ")");
+        for (Size i=0; i<values_.size(); ++i)
+            path[i] = values_[i][j];
+    }
+
+}
+
+
+#endif
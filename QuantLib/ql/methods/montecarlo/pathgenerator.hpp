@@ -27,6 +27,7 @@
 #define quantlib_montecarlo_path_generator_hpp
 
 #include <ql/methods/montecarlo/brownianbridge.hpp>
+#include <ql/methods/montecarlo/pathblock.hpp>
 #include <ql/stochasticprocess.hpp>
 
 namespace QuantLib {
@@ -44,6 +45,7 @@ namespace QuantLib {
     class PathGenerator {
       public:
         typedef Sample<Path> sample_type;
+        typedef PathBlock block_type;
         // constructors
         PathGenerator(const boost::shared_ptr<StochasticProcess>&,
                       Time length,
@@ -61,8 +63,28 @@ namespace QuantLib {
         Size size() const { return dimension_; }
         const TimeGrid& timeGrid() const { return timeGrid_; }
         //@}
+        //! \name block generation
+        /*! These methods fill a whole block of paths at once, which
+            allows the process to evolve all of them in a single
+            call. The paths are the same that would be returned by
+            as many calls to next() or antithetic().
+        */
+        //@{
+        //! returns a block of paths on the generator's time grid
+        block_type newBlock(Size paths) const {
+            return block_type(timeGrid_, paths);
+        }
+        void next(block_type& block) const;
+        /*! returns the antithetic paths of the last block; the
+            passed block must have the same size.
+        */
+        void antithetic(block_type& block) const;
+        //@}
+        //! repositions the underlying sequence generator
+        void skipTo(unsigned long n) { generator_.skipTo(n); }
       private:
         const sample_type& next(bool antithetic) const;
+        void next(block_type& block, bool antithetic) const;
         bool brownianBridge_;
         GSG generator_;
         Size dimension_;
@@ -71,6 +93,8 @@ namespace QuantLib {
         mutable sample_type next_;
         mutable std::vector<Real> temp_;
         BrownianBridge bb_;
+        mutable std::vector<Array> draws_;
+        mutable Array weights_, negatedDraws_;
     };
 
 
@@ -154,6 +178,72 @@ namespace QuantLib {
         return next_;
     }
 
+    template <class GSG>
+    void PathGenerator<GSG>::next(block_type& block) const {
+        next(block, false);
+    }
+
+    template <class GSG>
+    void PathGenerator<GSG>::antithetic(block_type& block) const {
+        next(block, true);
+    }
+
+    template <class GSG>
+    void PathGenerator<GSG>::next(block_type& block, bool antithetic) const {
+
+        QL_REQUIRE(block.length() == timeGrid_.size(),
+                   "block length (" << block.length()
+                   << ") != time-grid size (" << timeGrid_.size() << ")");
+        Size paths = block.size();
+
+        if (antithetic) {
+            QL_REQUIRE(weights_.size() == paths,
+                       "block size (" << paths
+                       << ") different from last generated block ("
+                       << weights_.size() << ")");
+        } else {
+            // the draws are stored by time step, as the paths
+            if (weights_.size() != paths) {
+                draws_ = std::vector<Array>(dimension_, Array(paths));
+                weights_ = Array(paths);
+                negatedDraws_ = Array(paths);
+            }
+
+            typedef typename GSG::sample_type sequence_type;
+            for (Size j=0; j<paths; j++) {
+                const sequence_type& sequence_ = generator_.nextSequence();
+                if (brownianBridge_) {
+                    bb_.transform(sequence_.value.begin(),
+                                  sequence_.value.end(),
+                                  temp_.begin());
+                } else {
+                    std::copy(sequence_.value.begin(),
+                              sequence_.value.end(),
+                              temp_.begin());
+                }
+                for (Size i=0; i<dimension_; i++)
+                    draws_[i][j] = temp_[i];
+                weights_[j] = sequence_.weight;
+            }
+        }
+
+        std::copy(weights_.begin(), weights_.end(), block.weights().begin());
+        std::fill(block[0].begin(), block[0].end(), process_->x0());
+
+        for (Size i=1; i<block.length(); i++) {
+            Time t = timeGrid_[i-1];
+            Time dt = timeGrid_.dt(i-1);
+            if (antithetic) {
+                std::transform(draws_[i-1].begin(), draws_[i-1].end(),
+                               negatedDraws_.begin(),
+                               std::negate<Real>());
+                process_->evolve(t, block[i-1], dt, negatedDraws_, block[i]);
+            } else {
+                process_->evolve(t, block[i-1], dt, draws_[i-1], block[i]);
+            }
+        }
+    }
+
 }
 
 
@@ -25,12 +25,60 @@
 #ifndef quantlib_montecarlo_path_pricer_hpp
 #define quantlib_montecarlo_path_pricer_hpp
 
+#include <ql/methods/montecarlo/pathblock.hpp>
+#include <ql/methods/montecarlo/multipathblock.hpp>
 #include <ql/option.hpp>
 #include <ql/types.hpp>
 #include <functional>
+#include <vector>
 
 namespace QuantLib {
 
+    //! block of paths corresponding to a given path type
+    /*! By default, a block is a vector of paths; specializations
+        are provided for Path and MultiPath.
+
+        \ingroup mcarlo
+    */
+    template <class PathType>
+    struct PathBlockTraits {
+        typedef std::vector<PathType> block_type;
+        static Size size(const block_type& block) { return block.size(); }
+        static PathType path(const block_type& block) {
+            return block.front();
+        }
+        static void extract(const block_type& block, Size j,
+                            PathType& path) {
+            path = block[j];
+        }
+    };
+
+    template <>
+    struct PathBlockTraits<Path> {
+        typedef PathBlock block_type;
+        static Size size(const block_type& block) { return block.size(); }
+        static Path path(const block_type& block) {
+            return Path(block.timeGrid());
+        }
+        static void extract(const block_type& block, Size j, Path& path) {
+            block.extract(j, path);
+        }
+    };
+
+    template <>
+    struct PathBlockTraits<MultiPath> {
+        typedef MultiPathBlock block_type;
+        static Size size(const block_type& block) { return block.size(); }
+        static MultiPath path(const block_type& block) {
+            return MultiPath(block.assetNumber(), block.timeGrid());
+        }
+        static void extract(const block_type& block, Size j,
+                            MultiPath& path) {
+            block.extract(j, path);
+        }
+    };
+
+
     //! base class for path pricers
     /*! Returns the value of an option on a given path.
 
@@ -39,10 +87,37 @@ namespace QuantLib {
     template<class PathType, class ValueType=Real>
     class PathPricer : public std::unary_function<PathType, ValueType> {
       public:
+        typedef typename PathBlockTraits<PathType>::block_type block_type;
         virtual ~PathPricer() {}
         virtual ValueType operator()(const PathType& path) const=0;
+        /*! returns the values of the option on each path of the
+            given block. By default, each path is extracted from the
+            block and priced in turn; derived classes can override
+            this method and work on the block directly.
+        */
+        virtual void operator()(const block_type& paths,
+                                std::vector<ValueType>& values) const;
     };
 
+
+    // template definitions
+
+    template<class PathType, class ValueType>
+    void PathPricer<PathType,ValueType>::operator()(
+                                      const block_type& paths,
+                                      std::vector<ValueType>& values) const {
+        typedef PathBlockTraits<PathType> traits;
+        Size n = traits::size(paths);
+        values.resize(n);
+        if (n == 0)
+            return;
+        PathType path = traits::path(paths);
+        for (Size j=0; j<n; ++j) {
+            traits::extract(paths, j, path);
+            values[j] = (*this)(path);
+        }
+    }
+
 }
 
 
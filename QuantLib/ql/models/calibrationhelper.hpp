@@ -82,6 +82,11 @@ namespace QuantLib {
             engine_ = engine;
         }
 
+        //! returns the pricing engine used by modelValue(), if any
+        const boost::shared_ptr<PricingEngine>& pricingEngine() const {
+            return engine_;
+        }
+
       protected:
         mutable Real marketValue_;
         Handle<Quote> volatility_;
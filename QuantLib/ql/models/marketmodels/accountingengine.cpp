@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -22,6 +23,7 @@
 #include <ql/models/marketmodels/evolver.hpp>
 #include <ql/models/marketmodels/evolutiondescription.hpp>
 #include <ql/models/marketmodels/curvestate.hpp>
+#include <ql/models/marketmodels/curvestates/lmmcurvestate.hpp>
 #include <algorithm>
 
 namespace QuantLib {
@@ -29,10 +31,13 @@ namespace QuantLib {
     AccountingEngine::AccountingEngine(
                          const boost::shared_ptr<MarketModelEvolver>& evolver,
                          const Clone<MarketModelMultiProduct>& product,
-                         Real initialNumeraireValue)
+                         Real initialNumeraireValue,
+                         Size threads,
+                         Size blockSize)
     : evolver_(evolver), product_(product),
       initialNumeraireValue_(initialNumeraireValue),
       numberProducts_(product->numberOfProducts()),
+      threads_(threads), blockSize_(blockSize), simulatedPaths_(0),
       numerairesHeld_(product->numberOfProducts()),
       numberCashFlowsThisStep_(product->numberOfProducts()),
       cashFlowsGenerated_(product->numberOfProducts()) {
@@ -60,61 +65,77 @@ namespace QuantLib {
         do {
             Size thisStep = evolver_->currentStep();
             weight *= evolver_->advanceStep();
-            done = product_->nextTimeStep(evolver_->currentState(),
-                                          numberCashFlowsThisStep_,
-                                          cashFlowsGenerated_);
-            Size numeraire =
-                evolver_->numeraires()[thisStep];
-
-            // for each product...
-            for (Size i=0; i<numberProducts_; ++i) {
-                // ...and each cash flow...
-                const std::vector<MarketModelMultiProduct::CashFlow>& cashflows =
-                    cashFlowsGenerated_[i];
-                for (Size j=0; j<numberCashFlowsThisStep_[i]; ++j) {
-                    // ...convert the cash flow to numeraires.
-                    // This is done by calculating the number of
-                    // numeraire bonds corresponding to such cash flow...
-                    const MarketModelDiscounter& discounter =
-                        discounters_[cashflows[j].timeIndex];
-
-                    Real bonds = cashflows[j].amount *
-                        discounter.numeraireBonds(evolver_->currentState(),
-                                                  numeraire);
-
-                    // ...and adding the newly bought bonds to the number
-                    // of numeraires held.
-                    numerairesHeld_[i] += bonds/principalInNumerairePortfolio;
-                }
-            }
+            done = collectCashFlows(evolver_->currentState(), thisStep,
+                                    principalInNumerairePortfolio);
+        } while (!done);
+
+        for (Size i=0; i<numerairesHeld_.size(); ++i)
+            values[i] = numerairesHeld_[i] * initialNumeraireValue_;
 
-            if (!done) {
+        return weight;
+    }
 
-                // The numeraire might change between steps. This implies
-                // that we might have to convert the numeraire bonds for
-                // this step into a corresponding amount of numeraire
-                // bonds for the next step. This can be done by changing
-                // the principal of the numeraire and updating the number
-                // of bonds in the numeraire portfolio accordingly.
+    bool AccountingEngine::collectCashFlows(
+                                   const CurveState& state,
+                                   Size thisStep,
+                                   Real& principalInNumerairePortfolio) {
+        bool done = product_->nextTimeStep(state,
+                                           numberCashFlowsThisStep_,
+                                           cashFlowsGenerated_);
+        Size numeraire =
+            evolver_->numeraires()[thisStep];
 
-                Size nextNumeraire = evolver_->numeraires()[thisStep+1];
+        // for each product...
+        for (Size i=0; i<numberProducts_; ++i) {
+            // ...and each cash flow...
+            const std::vector<MarketModelMultiProduct::CashFlow>& cashflows =
+                cashFlowsGenerated_[i];
+            for (Size j=0; j<numberCashFlowsThisStep_[i]; ++j) {
+                // ...convert the cash flow to numeraires.
+                // This is done by calculating the number of
+                // numeraire bonds corresponding to such cash flow...
+                const MarketModelDiscounter& discounter =
+                    discounters_[cashflows[j].timeIndex];
 
-                principalInNumerairePortfolio *=
-                    evolver_->currentState().discountRatio(numeraire,
-                                                           nextNumeraire);
+                Real bonds = cashflows[j].amount *
+                    discounter.numeraireBonds(state, numeraire);
+
+                // ...and adding the newly bought bonds to the number
+                // of numeraires held.
+                numerairesHeld_[i] += bonds/principalInNumerairePortfolio;
             }
+        }
 
-        } while (!done);
+        if (!done) {
 
-        for (Size i=0; i<numerairesHeld_.size(); ++i)
-            values[i] = numerairesHeld_[i] * initialNumeraireValue_;
+            // The numeraire might change between steps. This implies
+            // that we might have to convert the numeraire bonds for
+            // this step into a corresponding amount of numeraire
+            // bonds for the next step. This can be done by changing
+            // the principal of the numeraire and updating the number
+            // of bonds in the numeraire portfolio accordingly.
 
-        return weight;
+            Size nextNumeraire = evolver_->numeraires()[thisStep+1];
+
+            principalInNumerairePortfolio *=
+                state.discountRatio(numeraire, nextNumeraire);
+        }
+
+        return done;
     }
 
     void AccountingEngine::multiplePathValues(SequenceStatisticsInc& stats,
                                               Size numberOfPaths)
     {
+        if (threads_ != Null<Size>()) {
+            multiplePathValuesInChunks(stats, numberOfPaths);
+            return;
+        }
+        if (blockSize_ != Null<Size>()) {
+            multiplePathValuesInBlocks(stats, numberOfPaths);
+            return;
+        }
+
         std::vector<Real> values(product_->numberOfProducts());
         for (Size i=0; i<numberOfPaths; ++i) {
             Real weight = singlePathValues(values);
@@ -122,4 +143,147 @@ namespace QuantLib {
         }
     }
 
+    void AccountingEngine::multiplePathValuesInBlocks(
+                                                SequenceStatisticsInc& stats,
+                                                Size numberOfPaths) {
+        QL_REQUIRE(blockSize_ != 0, "null block size");
+
+        const EvolutionDescription& evolution = product_->evolution();
+        Size steps = evolution.numberOfSteps();
+        Size rates = evolution.numberOfRates();
+
+        // forwards[i] holds the rates at the end of the i-th step,
+        // with one column per path
+        std::vector<Matrix> forwards;
+        LMMCurveState curveState(evolution.rateTimes());
+        std::vector<Rate> pathForwards(rates);
+        std::vector<Real> values(numberProducts_);
+
+        for (Size done=0; done<numberOfPaths; ) {
+            Size paths = std::min(blockSize_, numberOfPaths-done);
+            if (forwards.empty() || forwards.front().columns() != paths)
+                forwards = std::vector<Matrix>(steps, Matrix(rates, paths));
+            evolver_->evolveBlock(forwards);
+
+            for (Size j=0; j<paths; ++j) {
+                std::fill(numerairesHeld_.begin(), numerairesHeld_.end(),
+                          0.0);
+                product_->reset();
+                Real principalInNumerairePortfolio = 1.0;
+
+                bool finished = false;
+                for (Size i=0; i<steps && !finished; ++i) {
+                    std::copy(forwards[i].column_begin(j),
+                              forwards[i].column_end(j),
+                              pathForwards.begin());
+                    curveState.setOnForwardRates(pathForwards);
+                    finished = collectCashFlows(curveState, i,
+                                               principalInNumerairePortfolio);
+                }
+
+                for (Size i=0; i<numberProducts_; ++i)
+                    values[i] = numerairesHeld_[i] * initialNumeraireValue_;
+                stats.add(values);
+            }
+            done += paths;
+        }
+    }
+
+
+    namespace {
+
+        class AccountingChunks : public detail::ChunkedSimulation {
+          public:
+            AccountingChunks(
+                         const boost::shared_ptr<MarketModelEvolver>& evolver,
+                         const Clone<MarketModelMultiProduct>& product,
+                         Real initialNumeraireValue,
+                         Size blockSize,
+                         Size firstPath,
+                         Size numberOfPaths,
+                         SequenceStatisticsInc& stats)
+            : detail::ChunkedSimulation(firstPath, numberOfPaths),
+              evolver_(evolver), product_(product),
+              initialNumeraireValue_(initialNumeraireValue),
+              blockSize_(blockSize),
+              stats_(stats), chunkStats_(chunks()) {}
+          private:
+            void simulate(Size begin, Size end) {
+                AccountingEngine engine(evolver_->clone(firstPath(begin)),
+                                        product_, initialNumeraireValue_,
+                                        Null<Size>(), blockSize_);
+                for (Size i=begin; i<end; ++i)
+                    engine.multiplePathValues(chunkStats_[i], paths(i));
+            }
+            void merge(Size i) {
+                stats_.merge(chunkStats_[i]);
+            }
+            boost::shared_ptr<MarketModelEvolver> evolver_;
+            const Clone<MarketModelMultiProduct>& product_;
+            Real initialNumeraireValue_;
+            Size blockSize_;
+            SequenceStatisticsInc& stats_;
+            std::vector<SequenceStatisticsInc> chunkStats_;
+        };
+
+    }
+
+    void AccountingEngine::multiplePathValuesInChunks(
+                                                SequenceStatisticsInc& stats,
+                                                Size numberOfPaths) {
+        QL_REQUIRE(threads_ != 0, "null number of threads");
+        AccountingChunks chunks(evolver_, product_, initialNumeraireValue_,
+                                blockSize_, simulatedPaths_, numberOfPaths,
+                                stats);
+        chunks.run(threads_);
+        simulatedPaths_ += numberOfPaths;
+    }
+
+
+    namespace detail {
+
+        ChunkedSimulation::ChunkedSimulation(Size firstPath,
+                                             Size numberOfPaths)
+        : firstPath_(firstPath), numberOfPaths_(numberOfPaths),
+          chunkSize_(AccountingEngine::pathsPerChunk()),
+          chunks_((numberOfPaths+chunkSize_-1)/chunkSize_) {}
+
+        Size ChunkedSimulation::firstPath(Size chunk) const {
+            return firstPath_ + chunk*chunkSize_;
+        }
+
+        Size ChunkedSimulation::paths(Size chunk) const {
+            return std::min(chunkSize_, numberOfPaths_-chunk*chunkSize_);
+        }
+
+        void ChunkedSimulation::run(Size threads) {
+            QL_REQUIRE(threads != 0, "null number of threads");
+            if (chunks_ == 0)
+                return;
+
+            const Size workers = std::min(threads, chunks_);
+            std::vector<std::string> errors(workers);
+
+            // each worker positions its evolvers once and then
+            // simulates a contiguous range of chunks
+            #pragma omp parallel for num_threads(workers) schedule(static)
+            for (long w=0; w<long(workers); ++w) {
+                try {
+                    simulate((w*chunks_)/workers, ((w+1)*chunks_)/workers);
+                } catch (std::exception& e) {
+                    errors[w] = e.what();
+                } catch (...) {
+                    errors[w] = "unknown error";
+                }
+            }
+
+            for (Size w=0; w<workers; ++w)
+                QL_REQUIRE(errors[w].empty(), errors[w]);
+
+            for (Size i=0; i<chunks_; ++i)
+                merge(i);
+        }
+
+    }
+
 }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Ferdinando Ametrano
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -28,34 +29,98 @@
 #include <ql/math/statistics/sequencestatistics.hpp>
 
 #include <ql/utilities/clone.hpp>
+#include <ql/utilities/null.hpp>
 #include <ql/types.hpp>
 #include <vector>
 
 namespace QuantLib {
 
     class MarketModelEvolver;
+    class CurveState;
 
     //class MarketModelDiscounter;
     //class SequenceStatistics;
     //class MarketModelMultiProduct;
     //struct MarketModelMultiProduct::CashFlow;
 
+    namespace detail {
+
+        //! simulation of a number of paths in fixed-size chunks
+        /*! Paths are divided in chunks of
+            AccountingEngine::pathsPerChunk() paths.  Derived classes
+            keep their results by chunk; run() lets each thread
+            simulate a contiguous range of chunks and then merges
+            their results in chunk order, so that they don't depend
+            on the number of threads.
+        */
+        class ChunkedSimulation {
+          public:
+            ChunkedSimulation(Size firstPath, Size numberOfPaths);
+            virtual ~ChunkedSimulation() {}
+            void run(Size threads);
+            Size chunks() const { return chunks_; }
+            //! index of the first path of the given chunk
+            Size firstPath(Size chunk) const;
+            //! number of paths in the given chunk
+            Size paths(Size chunk) const;
+          private:
+            /*! simulates the chunks in [begin,end); it is called
+                concurrently for disjoint ranges.
+            */
+            virtual void simulate(Size begin, Size end) = 0;
+            //! merges the results of the given chunk
+            virtual void merge(Size chunk) = 0;
+            Size firstPath_, numberOfPaths_, chunkSize_, chunks_;
+        };
+
+    }
+
     //! Engine collecting cash flows along a market-model simulation
+    /*! If a number of threads is passed, paths are simulated in
+        fixed-size chunks that can run concurrently.  Each thread
+        simulates a contiguous range of chunks with its own copies
+        of the evolver and of the product; the evolver copy is
+        obtained once per thread by MarketModelEvolver::clone() and
+        draws a disjoint substream of the original Brownian
+        generator.  The statistics of the chunks are merged in chunk
+        order, so that the results do not depend on the number of
+        threads.  Unlike in the default, sequential mode, the passed
+        evolver is not advanced; it must support cloning.
+
+        If a block size is passed, the paths are evolved in blocks by
+        MarketModelEvolver::evolveBlock() and the cash flows of each
+        path are then collected from a curve state built on its
+        forward rates.  This requires paths with unit weight and an
+        evolver starting from the first step of the evolution.
+    */
     class AccountingEngine {
       public:
         AccountingEngine(const boost::shared_ptr<MarketModelEvolver>& evolver,
                          const Clone<MarketModelMultiProduct>& product,
-                         Real initialNumeraireValue);
+                         Real initialNumeraireValue,
+                         Size threads = Null<Size>(),
+                         Size blockSize = Null<Size>());
         void multiplePathValues(SequenceStatisticsInc& stats,
                                 Size numberOfPaths);
+        //! number of paths simulated in each concurrent chunk
+        static Size pathsPerChunk() { return 1024; }
       private:
         Real singlePathValues(std::vector<Real>& values);
+        void multiplePathValuesInChunks(SequenceStatisticsInc& stats,
+                                        Size numberOfPaths);
+        void multiplePathValuesInBlocks(SequenceStatisticsInc& stats,
+                                        Size numberOfPaths);
+        bool collectCashFlows(const CurveState& state,
+                              Size step,
+                              Real& principalInNumerairePortfolio);
 
         boost::shared_ptr<MarketModelEvolver> evolver_;
         Clone<MarketModelMultiProduct> product_;
 
         Real initialNumeraireValue_;
         Size numberProducts_;
+        Size threads_, blockSize_;
+        Size simulatedPaths_;
 
         // workspace
         std::vector<Real> numerairesHeld_;
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -21,7 +22,7 @@
 #ifndef quantlib_brownian_generator_hpp
 #define quantlib_brownian_generator_hpp
 
-#include <ql/types.hpp>
+#include <ql/math/matrix.hpp>
 #include <boost/shared_ptr.hpp>
 #include <vector>
 
@@ -37,6 +38,34 @@ namespace QuantLib {
 
         virtual Size numberOfFactors() const = 0;
         virtual Size numberOfSteps() const = 0;
+
+        /*! returns a new generator drawing the paths that this one
+            draws after being created, starting from the given path;
+            that is, the first paths are skipped.  Multi-threaded
+            engines use it to divide a simulation into disjoint
+            substreams.
+
+            The default implementation fails; derived classes
+            override it if they can skip paths.
+        */
+        virtual boost::shared_ptr<BrownianGenerator>
+        clone(Size) const {
+            QL_FAIL("this Brownian generator cannot skip paths");
+        }
+
+        /*! fills the passed matrices with the variates of as many
+            paths as their columns; variates[i][k][j] is the variate
+            for the \f$ k \f$-th factor at the \f$ i \f$-th step of the
+            \f$ j \f$-th path.  The paths are the same that would be
+            returned by as many calls to nextPath().
+
+            The default implementation draws one path at a time;
+            derived classes can override it to generate the whole
+            block at once.
+
+            \pre the paths must have unit weight.
+        */
+        virtual void nextBlock(std::vector<Matrix>& variates);
     };
 
     class BrownianGeneratorFactory {
@@ -47,6 +76,32 @@ namespace QuantLib {
                                                             Size steps) const = 0;
     };
 
+
+
+    // inline definitions
+
+    inline void BrownianGenerator::nextBlock(std::vector<Matrix>& variates) {
+        QL_REQUIRE(variates.size() == numberOfSteps(),
+                   "wrong number of steps (" << variates.size()
+                   << ", " << numberOfSteps() << " required)");
+        Size factors = numberOfFactors();
+        std::vector<Real> variate(factors);
+        for (Size j=0; j<variates.front().columns(); ++j) {
+            Real weight = nextPath();
+            for (Size i=0; i<variates.size(); ++i) {
+                QL_REQUIRE(variates[i].rows() == factors &&
+                           variates[i].columns() ==
+                                              variates.front().columns(),
+                           "wrong variate size");
+                weight *= nextStep(variate);
+                std::copy(variate.begin(), variate.end(),
+                          variates[i].column_begin(j));
+            }
+            QL_REQUIRE(weight == 1.0,
+                       "weighted paths cannot be generated in blocks");
+        }
+    }
+
 }
 
 #endif
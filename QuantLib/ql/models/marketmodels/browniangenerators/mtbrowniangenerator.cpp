@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2006 StatPro Italia srl
+ Copyright (C) 2006, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -18,6 +18,7 @@
 */
 
 #include <ql/models/marketmodels/browniangenerators/mtbrowniangenerator.hpp>
+#include <ql/math/randomnumbers/seedgenerator.hpp>
 
 namespace QuantLib {
 
@@ -25,7 +26,9 @@ namespace QuantLib {
                                              Size steps,
                                              unsigned long seed)
     : factors_(factors), steps_(steps), lastStep_(0),
-      generator_(factors*steps, MersenneTwisterUniformRng(seed)) {}
+      // the seed is stored so that clone() can restart the sequence
+      seed_(seed != 0 ? seed : SeedGenerator::instance().get()),
+      generator_(factors*steps, MersenneTwisterUniformRng(seed_)) {}
 
     Real MTBrownianGenerator::nextStep(std::vector<Real>& output) {
         #if defined(QL_EXTRA_SAFETY_CHECKS)
@@ -56,6 +59,14 @@ namespace QuantLib {
 
     Size MTBrownianGenerator::numberOfSteps() const { return steps_; }
 
+    boost::shared_ptr<BrownianGenerator>
+    MTBrownianGenerator::clone(Size firstPath) const {
+        boost::shared_ptr<MTBrownianGenerator> generator(
+                             new MTBrownianGenerator(factors_, steps_, seed_));
+        generator->generator_.discard(firstPath);
+        return generator;
+    }
+
 
     MTBrownianGeneratorFactory::MTBrownianGeneratorFactory(unsigned long seed)
     : seed_(seed) {}
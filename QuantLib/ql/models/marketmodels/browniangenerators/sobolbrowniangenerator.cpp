@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2006 StatPro Italia srl
+ Copyright (C) 2006, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -18,12 +18,16 @@
 */
 
 #include <ql/models/marketmodels/browniangenerators/sobolbrowniangenerator.hpp>
+#include <ql/utilities/dataformatters.hpp>
 #include <boost/iterator/permutation_iterator.hpp>
 
 namespace QuantLib {
 
     namespace {
 
+        // number of paths generated at a time
+        const Size blockSize = 32;
+
         void fillByFactor(std::vector<std::vector<Size> >& M,
                           Size factors, Size steps) {
             Size counter = 0;
@@ -114,11 +118,14 @@ namespace QuantLib {
                                         unsigned long seed,
                                         SobolRsg::DirectionIntegers integers)
     : factors_(factors), steps_(steps), ordering_(ordering),
-      generator_(SobolRsg(factors*steps, seed, integers),
-                 InverseCumulativeNormal()),
-      bridge_(steps), lastStep_(0),
+      seed_(seed), integers_(integers),
+      generator_(factors*steps, seed, integers),
+      bridge_(steps), sqrtdt_(steps), lastStep_(0),
       orderedIndices_(factors, std::vector<Size>(steps)),
-      bridgedVariates_(factors, std::vector<Real>(steps)) {
+      uniforms_(factors*steps, blockSize),
+      gaussians_(factors*steps, blockSize),
+      bridgedVariates_(steps, Matrix(factors, blockSize)),
+      currentPath_(0), nextPath_(blockSize) {
 
         switch (ordering_) {
           case Factors:
@@ -133,29 +140,133 @@ namespace QuantLib {
           default:
             QL_FAIL("unknown ordering");
         }
+
+        const std::vector<Time>& t = bridge_.times();
+        sqrtdt_[0] = std::sqrt(t[0]);
+        for (Size i=1; i<steps_; ++i)
+            sqrtdt_[i] = std::sqrt(t[i]-t[i-1]);
+    }
+
+
+    void SobolBrownianGenerator::fill(std::vector<Matrix>& variates,
+                                      Size offset, Size paths) {
+        Size dimension = factors_*steps_;
+
+        // Sobol points, stored by dimension across paths...
+        for (Size j=0; j<paths; ++j) {
+            const std::vector<Real>& point = generator_.nextSequence().value;
+            for (Size d=0; d<dimension; ++d)
+                uniforms_[d][j] = point[d];
+        }
+        // ...mapped to Gaussian variates...
+        for (Size d=0; d<dimension; ++d)
+            InverseCumulativeNormal::standard_values(
+                                              uniforms_.row_begin(d),
+                                              uniforms_.row_begin(d)+paths,
+                                              gaussians_.row_begin(d));
+
+        // ...and Brownian-bridged according to the ordered indices.
+        // This is the same as BrownianBridge::transform, done for
+        // all paths at each step.
+        const std::vector<Size>& bridgeIndex = bridge_.bridgeIndex();
+        const std::vector<Size>& leftIndex = bridge_.leftIndex();
+        const std::vector<Size>& rightIndex = bridge_.rightIndex();
+        const std::vector<Real>& leftWeight = bridge_.leftWeight();
+        const std::vector<Real>& rightWeight = bridge_.rightWeight();
+        const std::vector<Real>& stdDev = bridge_.stdDeviation();
+        for (Size k=0; k<factors_; ++k) {
+            const std::vector<Size>& indices = orderedIndices_[k];
+            // the path is stored in the output first...
+            Real* y = variates[steps_-1].row_begin(k) + offset;
+            const Real* z = gaussians_.row_begin(indices[0]);
+            for (Size j=0; j<paths; ++j)
+                y[j] = stdDev[0] * z[j];
+            for (Size i=1; i<steps_; ++i) {
+                Size l = bridgeIndex[i], m = rightIndex[i];
+                y = variates[l].row_begin(k) + offset;
+                z = gaussians_.row_begin(indices[i]);
+                const Real* right = variates[m].row_begin(k) + offset;
+                Real wr = rightWeight[i], s = stdDev[i];
+                if (leftIndex[i] != 0) {
+                    const Real* left =
+                        variates[leftIndex[i]-1].row_begin(k) + offset;
+                    Real wl = leftWeight[i];
+                    for (Size j=0; j<paths; ++j)
+                        y[j] = wl * left[j] + wr * right[j] + s * z[j];
+                } else {
+                    for (Size j=0; j<paths; ++j)
+                        y[j] = wr * right[j] + s * z[j];
+                }
+            }
+            // ...after which, the variations are normalized to unit times
+            for (Size i=steps_-1; i>=1; --i) {
+                y = variates[i].row_begin(k) + offset;
+                const Real* previous = variates[i-1].row_begin(k) + offset;
+                for (Size j=0; j<paths; ++j) {
+                    y[j] -= previous[j];
+                    y[j] /= sqrtdt_[i];
+                }
+            }
+            y = variates[0].row_begin(k) + offset;
+            for (Size j=0; j<paths; ++j)
+                y[j] /= sqrtdt_[0];
+        }
     }
 
 
     Real SobolBrownianGenerator::nextPath() {
-        typedef InverseCumulativeRsg<SobolRsg,
-                                     InverseCumulativeNormal>::sample_type
-            sample_type;
-
-        const sample_type& sample = generator_.nextSequence();
-        // Brownian-bridge the variates according to the ordered indices
-        for (Size i=0; i<factors_; ++i) {
-            bridge_.transform(boost::make_permutation_iterator(
-                                                  sample.value.begin(),
-                                                  orderedIndices_[i].begin()),
-                              boost::make_permutation_iterator(
-                                                  sample.value.begin(),
-                                                  orderedIndices_[i].end()),
-                              bridgedVariates_[i].begin());
+        if (nextPath_ == blockSize) {
+            fill(bridgedVariates_, 0, blockSize);
+            nextPath_ = 0;
         }
+        currentPath_ = nextPath_++;
         lastStep_ = 0;
-        return sample.weight;
+        return 1.0;
     }
-    
+
+
+    boost::shared_ptr<BrownianGenerator>
+    SobolBrownianGenerator::clone(Size firstPath) const {
+        // built from scratch, since skipping on a Sobol generator
+        // that already drew a point would start one point later
+        boost::shared_ptr<SobolBrownianGenerator> generator(
+                   new SobolBrownianGenerator(factors_, steps_, ordering_,
+                                              seed_, integers_));
+        generator->generator_.skipTo(firstPath);
+        return generator;
+    }
+
+
+    void SobolBrownianGenerator::nextBlock(std::vector<Matrix>& variates) {
+        QL_REQUIRE(variates.size() == steps_,
+                   "wrong number of steps (" << variates.size()
+                   << ", " << steps_ << " required)");
+        Size paths = variates.front().columns();
+        for (Size i=0; i<steps_; ++i)
+            QL_REQUIRE(variates[i].rows() == factors_ &&
+                       variates[i].columns() == paths,
+                       "wrong size (" << variates[i].rows() << "x"
+                       << variates[i].columns() << ") for " << io::ordinal(i+1)
+                       << " step; " << factors_ << "x" << paths
+                       << " required");
+
+        // paths already generated are returned first...
+        Size j = 0;
+        for (; j<paths && nextPath_<blockSize; ++j, ++nextPath_) {
+            for (Size i=0; i<steps_; ++i)
+                for (Size k=0; k<factors_; ++k)
+                    variates[i][k][j] = bridgedVariates_[i][k][nextPath_];
+        }
+        // ...and the others are written directly in the output.
+        while (j < paths) {
+            Size n = std::min(blockSize, paths-j);
+            fill(variates, j, n);
+            j += n;
+        }
+        // no current path for nextStep
+        lastStep_ = steps_;
+    }
+
     
     const std::vector<std::vector<Size> >& 
     SobolBrownianGenerator::orderedIndices() const {
@@ -198,8 +309,9 @@ namespace QuantLib {
         QL_REQUIRE(output.size() == factors_, "size mismatch");
         QL_REQUIRE(lastStep_<steps_, "sequence exhausted");
         #endif
+        const Matrix& variates = bridgedVariates_[lastStep_];
         for (Size i=0; i<factors_; ++i)
-            output[i] = bridgedVariates_[i][lastStep_];
+            output[i] = variates[i][currentPath_];
         ++lastStep_;
         return 1.0;
     }
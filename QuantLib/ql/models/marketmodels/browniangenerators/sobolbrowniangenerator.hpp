@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2006 StatPro Italia srl
+ Copyright (C) 2006, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -26,6 +26,7 @@
 #include <ql/math/randomnumbers/sobolrsg.hpp>
 #include <ql/methods/montecarlo/brownianbridge.hpp>
 #include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/matrix.hpp>
 #include <vector>
 
 namespace QuantLib {
@@ -33,6 +34,12 @@ namespace QuantLib {
     //! Sobol Brownian generator for market-model simulations
     /*! Incremental Brownian generator using a Sobol generator,
         inverse-cumulative Gaussian method, and Brownian bridging.
+
+        The variates are generated for a block of paths at a time:
+        the Sobol points are stored by dimension across paths, so
+        that the inverse cumulative normal and the Brownian bridge
+        run over contiguous memory for all the paths in the block.
+        The results are the same as bridging each path separately.
     */
     class SobolBrownianGenerator : public BrownianGenerator {
       public:
@@ -59,6 +66,11 @@ namespace QuantLib {
 
         Size numberOfFactors() const;
         Size numberOfSteps() const;
+
+        boost::shared_ptr<BrownianGenerator> clone(Size firstPath) const;
+
+        //! writes the variates directly into the passed matrices
+        void nextBlock(std::vector<Matrix>& variates);
         
         // test interface
         const std::vector<std::vector<Size> >& orderedIndices() const;
@@ -66,14 +78,20 @@ namespace QuantLib {
                               const std::vector<std::vector<Real> >& variates);
 
       private:
+        void fill(std::vector<Matrix>& variates, Size offset, Size paths);
         Size factors_, steps_;
         Ordering ordering_;
-        InverseCumulativeRsg<SobolRsg,InverseCumulativeNormal> generator_;
+        unsigned long seed_;
+        SobolRsg::DirectionIntegers integers_;
+        SobolRsg generator_;
         BrownianBridge bridge_;
+        std::vector<Real> sqrtdt_;
         // work variables
         Size lastStep_;
         std::vector<std::vector<Size> > orderedIndices_;
-        std::vector<std::vector<Real> > bridgedVariates_;
+        Matrix uniforms_, gaussians_;
+        std::vector<Matrix> bridgedVariates_;
+        Size currentPath_, nextPath_;
     };
 
     class SobolBrownianGeneratorFactory : public BrownianGeneratorFactory {
@@ -4,6 +4,7 @@
  Copyright (C) 2007 Ferdinando Ametrano
  Copyright (C) 2007 Franois du Vignaud
  Copyright (C) 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
 This file is part of QuantLib, a free-software/open-source library
 for financial quantitative analysts and developers - http://quantlib.org/
@@ -135,4 +136,86 @@ namespace QuantLib {
         }
     }
 
+    void CMSMMDriftCalculator::compute(
+                                   const std::vector<CMSwapCurveState>& cs,
+                                   Matrix& drifts) const {
+        Size paths = cs.size();
+        QL_REQUIRE(paths>0, "no curve states given");
+        QL_REQUIRE(drifts.rows()==numberOfRates_ && drifts.columns()==paths,
+                   "drifts size <> curve states");
+
+        // swap rates and annuities are collected across paths...
+        Matrix SR(numberOfRates_, paths), annuities(numberOfRates_, paths),
+               numeraireAnnuities(numberOfRates_, paths);
+        std::vector<Real> PnOverPN(paths);
+        for (Size p=0; p<paths; ++p) {
+            for (Size j=alive_; j<numberOfRates_; ++j) {
+                SR[j][p] = cs[p].cmSwapRate(j, spanningFwds_);
+                annuities[j][p] =
+                    cs[p].cmSwapAnnuity(numberOfRates_, j, spanningFwds_);
+                numeraireAnnuities[j][p] =
+                    cs[p].cmSwapAnnuity(numeraire_, j, spanningFwds_);
+            }
+            PnOverPN[p] = cs[p].discountRatio(numberOfRates_, numeraire_);
+        }
+        const std::vector<Time>& taus = cs.front().rateTaus();
+
+        // ...and the single-path calculation is repeated, storing the
+        // values for the current factor only.  The last rows of
+        // PjPnWk and wkaj stay null.
+        Matrix PjPnWk(numberOfRates_+1, paths, 0.0);
+        Matrix wkaj(numberOfRates_, paths, 0.0);
+        for (Size j=alive_; j<numberOfRates_; ++j)
+            std::fill(drifts.row_begin(j), drifts.row_end(j), 0.0);
+
+        for (Size k=0; k<numberOfFactors_; ++k) {
+            for (Integer j=static_cast<Integer>(numberOfRates_)-2;
+                 j>=static_cast<Integer>(alive_)-1; --j) {
+                Integer endIndex =
+                    std::min<Integer>(j + static_cast<Integer>(spanningFwds_) + 1,
+                                      static_cast<Integer>(numberOfRates_));
+                Real a = pseudo_[j+1][k], d = displacements_[j+1];
+                Matrix::const_row_iterator sr = SR.row_begin(j+1);
+                Matrix::const_row_iterator annuity = annuities.row_begin(j+1);
+                Matrix::const_row_iterator third = PjPnWk.row_begin(endIndex);
+                Matrix::row_iterator pw = PjPnWk.row_begin(j+1);
+                Matrix::const_row_iterator wa = wkaj.row_begin(j+1);
+                for (Size p=0; p<paths; ++p)
+                    pw[p] = sr[p] * wa[p]
+                        + annuity[p] * (sr[p]+d) * a
+                        + third[p];
+
+                if (j>=static_cast<Integer>(alive_)) {
+                    Matrix::row_iterator w = wkaj.row_begin(j);
+                    for (Size p=0; p<paths; ++p)
+                        w[p] = wa[p] + pw[p]*taus[j];
+                    if (j+spanningFwds_+1 <= numberOfRates_) {
+                        for (Size p=0; p<paths; ++p)
+                            w[p] -= third[p]*taus[endIndex-1];
+                    }
+                }
+            }
+
+            Matrix::const_row_iterator pn = PjPnWk.row_begin(numeraire_);
+            for (Size j=alive_; j<numberOfRates_; ++j) {
+                Real a = pseudo_[j][k];
+                Matrix::const_row_iterator w = wkaj.row_begin(j);
+                Matrix::const_row_iterator annuity =
+                    numeraireAnnuities.row_begin(j);
+                Matrix::row_iterator drift = drifts.row_begin(j);
+                for (Size p=0; p<paths; ++p)
+                    drift[p] += a*(w[p]*PnOverPN[p]
+                                   -pn[p]*PnOverPN[p]*annuity[p]);
+            }
+        }
+
+        for (Size j=alive_; j<numberOfRates_; ++j) {
+            Matrix::const_row_iterator annuity =
+                numeraireAnnuities.row_begin(j);
+            Matrix::row_iterator drift = drifts.row_begin(j);
+            for (Size p=0; p<paths; ++p)
+                drift[p] /= -annuity[p];
+        }
+    }
+
 }
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006, 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -64,6 +65,20 @@ namespace QuantLib {
         void computeReduced(const std::vector<Rate>& fwds,
                             std::vector<Real>& drifts) const;
 
+        //! \name Block computation
+        /*! These methods compute the drifts on a block of paths;
+            forwards[k][j] is the \f$ k \f$-th forward rate on the
+            \f$ j \f$-th path and the drifts are returned with the
+            same layout.  The results are the same as for the
+            corresponding single-path methods, but the innermost
+            loops run across paths.
+        */
+        //@{
+        void compute(const Matrix& fwds, Matrix& drifts) const;
+        void computePlain(const Matrix& fwds, Matrix& drifts) const;
+        void computeReduced(const Matrix& fwds, Matrix& drifts) const;
+        //@}
+
       private:
         Size numberOfRates_, numberOfFactors_;
         bool isFullFactor_;
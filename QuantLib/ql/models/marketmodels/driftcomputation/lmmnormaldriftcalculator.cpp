@@ -3,6 +3,7 @@
 /*
   Copyright (C) 2007 Giorgio Facchinetti
   Copyright (C) 2007 Chiara Fornarola
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -159,4 +160,107 @@ namespace QuantLib {
         }
     }
 
+    void LMMNormalDriftCalculator::compute(const Matrix& fwds,
+                                           Matrix& drifts) const {
+        QL_REQUIRE(fwds.rows()==numberOfRates_, "numberOfRates <> dim");
+        QL_REQUIRE(drifts.rows()==numberOfRates_ &&
+                   drifts.columns()==fwds.columns(),
+                   "drifts size <> forwards size");
+
+        if (isFullFactor_)
+            computePlain(fwds, drifts);
+        else
+            computeReduced(fwds, drifts);
+    }
+
+    void LMMNormalDriftCalculator::computePlain(const Matrix& forwards,
+                                                Matrix& drifts) const {
+
+        // Same as the single-path version, with each rate replaced by
+        // a row of values across paths.
+
+        Size paths = forwards.columns();
+        Matrix tmp(numberOfRates_, paths);
+        Size i;
+        for (i=alive_; i<numberOfRates_; ++i) {
+            Matrix::const_row_iterator f = forwards.row_begin(i);
+            Matrix::row_iterator t = tmp.row_begin(i);
+            for (Size j=0; j<paths; ++j)
+                t[j] = 1.0/(oneOverTaus_[i]+f[j]);
+        }
+
+        for (i=alive_; i<numberOfRates_; ++i) {
+            Matrix::row_iterator d = drifts.row_begin(i);
+            std::fill(d, drifts.row_end(i), 0.0);
+            for (Size k=downs_[i]; k<ups_[i]; ++k) {
+                Real c = C_[i][k];
+                Matrix::const_row_iterator t = tmp.row_begin(k);
+                for (Size j=0; j<paths; ++j)
+                    d[j] += t[j]*c;
+            }
+            if (numeraire_>i+1) {
+                for (Size j=0; j<paths; ++j)
+                    d[j] = -d[j];
+            }
+        }
+    }
+
+    void LMMNormalDriftCalculator::computeReduced(const Matrix& forwards,
+                                                  Matrix& drifts) const {
+
+        // Same as the single-path version, with each rate replaced by
+        // a row of values across paths.  Only the current value of
+        // e_[r][i] is needed for each factor, so e holds one row per
+        // factor.
+
+        Size paths = forwards.columns();
+        Matrix tmp(numberOfRates_, paths);
+        for (Size i=alive_; i<numberOfRates_; ++i) {
+            Matrix::const_row_iterator f = forwards.row_begin(i);
+            Matrix::row_iterator t = tmp.row_begin(i);
+            for (Size j=0; j<paths; ++j)
+                t[j] = 1.0/(oneOverTaus_[i]+f[j]);
+        }
+        Matrix e(numberOfFactors_, paths, 0.0);
+
+        // 1st step: the drift corresponding to the numeraire is zero.
+        if (numeraire_>0)
+            std::fill(drifts.row_begin(numeraire_-1),
+                      drifts.row_end(numeraire_-1), 0.0);
+
+        // 2nd step: move backward from N-2 (included) back to alive
+        // (included), starting from e = 0.
+        for (Integer i=static_cast<Integer>(numeraire_)-2;
+             i>=static_cast<Integer>(alive_); --i) {
+            Matrix::row_iterator d = drifts.row_begin(i);
+            std::fill(d, drifts.row_end(i), 0.0);
+            Matrix::const_row_iterator t = tmp.row_begin(i+1);
+            for (Size r=0; r<numberOfFactors_; ++r) {
+                Real a1 = pseudo_[i+1][r], a = pseudo_[i][r];
+                Matrix::row_iterator er = e.row_begin(r);
+                for (Size j=0; j<paths; ++j) {
+                    er[j] = er[j] + t[j] * a1;
+                    d[j] -= er[j]*a;
+                }
+            }
+        }
+
+        // 3rd step: move forward from N (included) up to n
+        // (excluded), starting again from e = 0.
+        std::fill(e.begin(), e.end(), 0.0);
+        for (Size i=numeraire_; i<numberOfRates_; ++i) {
+            Matrix::row_iterator d = drifts.row_begin(i);
+            std::fill(d, drifts.row_end(i), 0.0);
+            Matrix::const_row_iterator t = tmp.row_begin(i);
+            for (Size r=0; r<numberOfFactors_; ++r) {
+                Real a = pseudo_[i][r];
+                Matrix::row_iterator er = e.row_begin(r);
+                for (Size j=0; j<paths; ++j) {
+                    er[j] = er[j] + t[j] * a;
+                    d[j] += er[j]*a;
+                }
+            }
+        }
+    }
+
 }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Giorgio Facchinetti
  Copyright (C) 2007 Chiara Fornarola
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -65,6 +66,20 @@ namespace QuantLib {
         void computeReduced(const std::vector<Rate>& fwds,
                             std::vector<Real>& drifts) const;
 
+        //! \name Block computation
+        /*! These methods compute the drifts on a block of paths;
+            forwards[k][j] is the \f$ k \f$-th forward rate on the
+            \f$ j \f$-th path and the drifts are returned with the
+            same layout.  The results are the same as for the
+            corresponding single-path methods, but the innermost
+            loops run across paths.
+        */
+        //@{
+        void compute(const Matrix& fwds, Matrix& drifts) const;
+        void computePlain(const Matrix& fwds, Matrix& drifts) const;
+        void computeReduced(const Matrix& fwds, Matrix& drifts) const;
+        //@}
+
 
       private:
         Size numberOfRates_, numberOfFactors_;
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Ferdinando Ametrano
  Copyright (C) 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -125,4 +126,67 @@ namespace QuantLib {
 
     }
 
+    void SMMDriftCalculator::compute(
+                            const std::vector<CoterminalSwapCurveState>& cs,
+                            Matrix& drifts) const {
+        Size paths = cs.size();
+        QL_REQUIRE(paths>0, "no curve states given");
+        QL_REQUIRE(drifts.rows()==numberOfRates_ && drifts.columns()==paths,
+                   "drifts size <> curve states");
+
+        // swap rates and annuities are collected across paths...
+        Matrix SR(numberOfRates_, paths), annuities(numberOfRates_, paths);
+        std::vector<Real> numeraireRatios(paths);
+        for (Size p=0; p<paths; ++p) {
+            const std::vector<Rate>& rates = cs[p].coterminalSwapRates();
+            for (Size j=alive_; j<numberOfRates_; ++j) {
+                SR[j][p] = rates[j];
+                annuities[j][p] =
+                    cs[p].coterminalSwapAnnuity(numberOfRates_, j);
+            }
+            numeraireRatios[p] = cs[p].discountRatio(numberOfRates_,
+                                                     numeraire_);
+        }
+        const std::vector<Time>& taus = cs.front().rateTaus();
+
+        // ...and the single-path calculation is repeated, storing the
+        // values for the current factor only.  The last rows of wkaj
+        // and wkpj stay null.
+        Matrix wkaj(numberOfRates_, paths, 0.0);
+        Matrix wkpj(numberOfRates_+1, paths, 0.0);
+        for (Size j=alive_; j<numberOfRates_; ++j)
+            std::fill(drifts.row_begin(j), drifts.row_end(j), 0.0);
+
+        for (Size k=0; k<numberOfFactors_; ++k) {
+            for (Integer j=numberOfRates_-2;
+                 j>=static_cast<Integer>(alive_)-1; --j) {
+                Real a = pseudo_[j+1][k], d = displacements_[j+1];
+                Matrix::const_row_iterator sr = SR.row_begin(j+1);
+                Matrix::const_row_iterator annuity = annuities.row_begin(j+1);
+                Matrix::row_iterator wp = wkpj.row_begin(j+1);
+                Matrix::const_row_iterator wa = wkaj.row_begin(j+1);
+                for (Size p=0; p<paths; ++p)
+                    wp[p] = sr[p] * (a * annuity[p] + wa[p]) +
+                            a*d*annuity[p];
+
+                if (j >= static_cast<Integer>(alive_)) {
+                    Matrix::row_iterator w = wkaj.row_begin(j);
+                    for (Size p=0; p<paths; ++p)
+                        w[p] = wp[p]*taus[j] + wa[p];
+                }
+            }
+
+            Matrix::const_row_iterator wn = wkpj.row_begin(numeraire_);
+            for (Size j=alive_; j<numberOfRates_; ++j) {
+                Real a = pseudo_[j][k];
+                Matrix::const_row_iterator w = wkaj.row_begin(j);
+                Matrix::const_row_iterator annuity = annuities.row_begin(j);
+                Matrix::row_iterator drift = drifts.row_begin(j);
+                for (Size p=0; p<paths; ++p)
+                    drift[p] += (-w[p]/annuity[p] +
+                                 wn[p]*numeraireRatios[p])*a;
+            }
+        }
+    }
+
 }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Ferdinando Ametrano
  Copyright (C) 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -47,6 +48,14 @@ namespace QuantLib {
         //! Computes the drifts
         void compute(const CoterminalSwapCurveState& cs,
                      std::vector<Real>& drifts) const;
+        /*! Computes the drifts on a block of paths, one for each
+            curve state; drifts[k][j] is the drift of the
+            \f$ k \f$-th rate on the \f$ j \f$-th path.  The results
+            are the same as for the single-path method, but the
+            innermost loops run across paths.
+        */
+        void compute(const std::vector<CoterminalSwapCurveState>& cs,
+                     Matrix& drifts) const;
       private:
         Size numberOfRates_, numberOfFactors_;
         bool isFullFactor_;
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -21,13 +22,13 @@
 #ifndef quantlib_market_model_evolver_hpp
 #define quantlib_market_model_evolver_hpp
 
-#include <ql/types.hpp>
+#include <ql/models/marketmodels/curvestate.hpp>
+#include <ql/math/matrix.hpp>
+#include <boost/shared_ptr.hpp>
 #include <vector>
 
 namespace QuantLib {
 
-    class CurveState;
-
     //! Market-model evolver
     /*! Abstract base class. The evolver does the actual gritty work of
         evolving the forward rates from one time to the next.
@@ -42,8 +43,57 @@ namespace QuantLib {
         virtual Size currentStep() const = 0;
         virtual const CurveState& currentState() const = 0;
         virtual void setInitialState(const CurveState&) = 0;
+        /*! returns a copy of the evolver whose Brownian generator
+            starts from the given path, as described in
+            BrownianGenerator::clone().  Multi-threaded engines use
+            it to give each task its own evolver.
+
+            The default implementation fails.
+        */
+        virtual boost::shared_ptr<MarketModelEvolver>
+        clone(Size) const {
+            QL_FAIL("this evolver cannot be cloned");
+        }
+        /*! evolves a block of new paths from the initial step to the
+            end of the evolution.  On return, forwards[i][k][j] is the
+            \f$ k \f$-th forward rate on the \f$ j \f$-th path at the
+            end of the \f$ i \f$-th evolved step; the paths are the
+            same that would be obtained by as many calls to
+            startNewPath() followed by advanceStep().
+
+            The default implementation evolves one path at a time;
+            derived classes can override it to evolve all paths
+            together, e.g., with matrix-matrix operations.
+
+            \pre the paths must have unit weight.
+        */
+        virtual void evolveBlock(std::vector<Matrix>& forwards);
     };
 
+
+    // inline definitions
+
+    inline void MarketModelEvolver::evolveBlock(
+                                            std::vector<Matrix>& forwards) {
+        QL_REQUIRE(!forwards.empty(), "no steps to evolve");
+        Size paths = forwards.front().columns();
+        for (Size j=0; j<paths; ++j) {
+            Real weight = startNewPath();
+            for (Size i=0; i<forwards.size(); ++i) {
+                weight *= advanceStep();
+                const std::vector<Rate>& rates =
+                    currentState().forwardRates();
+                QL_REQUIRE(forwards[i].rows() == rates.size() &&
+                           forwards[i].columns() == paths,
+                           "wrong forward-rate block size");
+                std::copy(rates.begin(), rates.end(),
+                          forwards[i].column_begin(j));
+            }
+            QL_REQUIRE(weight == 1.0,
+                       "weighted paths cannot be evolved in blocks");
+        }
+    }
+
 }
 
 #endif
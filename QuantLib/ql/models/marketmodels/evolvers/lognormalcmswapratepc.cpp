@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006, 2007 Ferdinando Ametrano
  Copyright (C) 2006, 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -99,6 +100,14 @@ namespace QuantLib {
         setCMSwapRates(swapRates);
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalCmSwapRatePc::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalCmSwapRatePc> evolver(
+                                            new LogNormalCmSwapRatePc(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalCmSwapRatePc::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogSwapRates_.begin(), initialLogSwapRates_.end(),
@@ -152,6 +161,100 @@ namespace QuantLib {
         return weight;
     }
 
+    void LogNormalCmSwapRatePc::evolveBlock(std::vector<Matrix>& forwards) {
+        Size steps = marketModel_->evolution().numberOfSteps()-initialStep_;
+        QL_REQUIRE(forwards.size() == steps,
+                   "wrong number of steps (" << forwards.size()
+                   << ", " << steps << " required)");
+        Size paths = forwards.front().columns();
+        for (Size s=0; s<steps; ++s)
+            QL_REQUIRE(forwards[s].rows() == numberOfRates_ &&
+                       forwards[s].columns() == paths,
+                       "wrong forward-rate block size");
+
+        std::vector<Matrix> brownians(steps,
+                                      Matrix(numberOfFactors_, paths));
+        generator_->nextBlock(brownians);
+
+        // same as advanceStep(), with each rate replaced by a row of
+        // values across paths; the drift calculator needs a curve
+        // state for each path.
+        Matrix logSwapRates(numberOfRates_, paths), current(numberOfRates_, paths);
+        Matrix drifts1(numberOfRates_, paths), drifts2(numberOfRates_, paths);
+        std::vector<CMSwapCurveState> states(paths, curveState_);
+        std::vector<Rate> swapRates(numberOfRates_);
+        for (Size i=0; i<numberOfRates_; ++i) {
+            std::fill(logSwapRates.row_begin(i), logSwapRates.row_end(i),
+                      initialLogSwapRates_[i]);
+            std::fill(current.row_begin(i), current.row_end(i),
+                      std::exp(initialLogSwapRates_[i]) - displacements_[i]);
+        }
+
+        for (Size s=0; s<steps; ++s) {
+            Size step = initialStep_+s;
+
+            // a) compute drifts D1 at T1;
+            if (s > 0) {
+                calculators_[step].compute(states, drifts1);
+            } else {
+                for (Size i=0; i<numberOfRates_; ++i)
+                    std::fill(drifts1.row_begin(i), drifts1.row_end(i),
+                              initialDrifts_[i]);
+            }
+
+            // b) evolve forwards up to T2 using D1;
+            const Matrix& A = marketModel_->pseudoRoot(step);
+            Matrix correlatedBrownians = A*brownians[s];
+            const std::vector<Real>& fixedDrift = fixedDrifts_[step];
+
+            Size i, alive = alive_[step];
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator l = logSwapRates.row_begin(i);
+                Matrix::row_iterator sr = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator w =
+                    correlatedBrownians.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    l[j] += d1[j] + fixedDrift[i];
+                    l[j] += w[j];
+                    sr[j] = std::exp(l[j]) - displacements_[i];
+                }
+            }
+
+            // intermediate curve state update
+            for (Size j=0; j<paths; ++j) {
+                std::copy(current.column_begin(j), current.column_end(j),
+                          swapRates.begin());
+                states[j].setOnCMSwapRates(swapRates);
+            }
+
+            // c) recompute drifts D2 using the predicted forwards;
+            calculators_[step].compute(states, drifts2);
+
+            // d) correct forwards using both drifts
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator l = logSwapRates.row_begin(i);
+                Matrix::row_iterator sr = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator d2 = drifts2.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    l[j] += (d2[j]-d1[j])/2.0;
+                    sr[j] = std::exp(l[j]) - displacements_[i];
+                }
+            }
+
+            // e) update curve states and store the forward rates
+            for (Size j=0; j<paths; ++j) {
+                std::copy(current.column_begin(j), current.column_end(j),
+                          swapRates.begin());
+                states[j].setOnCMSwapRates(swapRates);
+                const std::vector<Rate>& rates = states[j].forwardRates();
+                std::copy(rates.begin(), rates.end(),
+                          forwards[s].column_begin(j));
+            }
+        }
+    }
+
     Size LogNormalCmSwapRatePc::currentStep() const {
         return currentStep_;
     }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006, 2007 Ferdinando Ametrano
  Copyright (C) 2006, 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -97,6 +98,14 @@ namespace QuantLib {
         setCoterminalSwapRates(swapRates);
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalCotSwapRatePc::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalCotSwapRatePc> evolver(
+                                           new LogNormalCotSwapRatePc(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalCotSwapRatePc::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogSwapRates_.begin(), initialLogSwapRates_.end(),
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Marco Bianchetti
  Copyright (C) 2007 Cristina Duminuco
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -46,6 +47,7 @@ namespace QuantLib {
         Size currentStep() const;
         const CurveState& currentState() const;
         void setInitialState(const CurveState&);
+        boost::shared_ptr<MarketModelEvolver> clone(Size firstPath) const;
         //@}
       private:
         void setCoterminalSwapRates(const std::vector<Real>& swapRates);
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2009 Sun Xiuxin
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -92,6 +93,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalFwdRateBalland::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalFwdRateBalland> evolver(
+                                          new LogNormalFwdRateBalland(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalFwdRateBalland::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogForwards_.begin(), initialLogForwards_.end(),
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006 Ferdinando Ametrano
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -92,6 +93,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalFwdRateEuler::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalFwdRateEuler> evolver(
+                                            new LogNormalFwdRateEuler(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalFwdRateEuler::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogForwards_.begin(), initialLogForwards_.end(),
@@ -3,6 +3,7 @@
 /*
 Copyright (C) 2006 Ferdinando Ametrano
 Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
 This file is part of QuantLib, a free-software/open-source library
 for financial quantitative analysts and developers - http://quantlib.org/
@@ -97,6 +98,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalFwdRateEulerConstrained::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalFwdRateEulerConstrained> evolver(
+                                 new LogNormalFwdRateEulerConstrained(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     void LogNormalFwdRateEulerConstrained::setConstraintType(
         const std::vector<Size>& startIndexOfSwapRate,
         const std::vector<Size>& endIndexOfSwapRate)
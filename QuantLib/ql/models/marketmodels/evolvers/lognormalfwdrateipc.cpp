@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006 Ferdinando Ametrano
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -95,6 +96,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalFwdRateIpc::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalFwdRateIpc> evolver(
+                                              new LogNormalFwdRateIpc(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalFwdRateIpc::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogForwards_.begin(), initialLogForwards_.end(),
@@ -143,6 +152,78 @@ namespace QuantLib {
         return weight;
     }
 
+    void LogNormalFwdRateIpc::evolveBlock(std::vector<Matrix>& forwards) {
+        Size steps = marketModel_->evolution().numberOfSteps()-initialStep_;
+        QL_REQUIRE(forwards.size() == steps,
+                   "wrong number of steps (" << forwards.size()
+                   << ", " << steps << " required)");
+        Size paths = forwards.front().columns();
+        for (Size s=0; s<steps; ++s)
+            QL_REQUIRE(forwards[s].rows() == numberOfRates_ &&
+                       forwards[s].columns() == paths,
+                       "wrong forward-rate block size");
+
+        std::vector<Matrix> brownians(steps,
+                                      Matrix(numberOfFactors_, paths));
+        generator_->nextBlock(brownians);
+
+        // same as advanceStep(), with each rate replaced by a row of
+        // values across paths
+        Matrix logForwards(numberOfRates_, paths), current(numberOfRates_, paths);
+        Matrix drifts1(numberOfRates_, paths), g(numberOfRates_, paths);
+        std::vector<Real> drifts2(paths);
+        for (Size i=0; i<numberOfRates_; ++i) {
+            std::fill(logForwards.row_begin(i), logForwards.row_end(i),
+                      initialLogForwards_[i]);
+            std::fill(current.row_begin(i), current.row_end(i),
+                      std::exp(initialLogForwards_[i]) - displacements_[i]);
+        }
+
+        for (Size s=0; s<steps; ++s) {
+            Size step = initialStep_+s;
+
+            // a) compute drifts D1 at T1;
+            if (s > 0) {
+                calculators_[step].computePlain(current, drifts1);
+            } else {
+                for (Size i=0; i<numberOfRates_; ++i)
+                    std::fill(drifts1.row_begin(i), drifts1.row_end(i),
+                              initialDrifts_[i]);
+            }
+
+            const Matrix& A = marketModel_->pseudoRoot(step);
+            const Matrix& C = marketModel_->covariance(step);
+            Matrix correlatedBrownians = A*brownians[s];
+            const std::vector<Real>& fixedDrift = fixedDrifts_[step];
+
+            Integer alive = alive_[step];
+            for (Integer i=numberOfRates_-1; i>=alive; --i) {
+                std::fill(drifts2.begin(), drifts2.end(), 0.0);
+                for (Size k=i+1; k<numberOfRates_; ++k) {
+                    Real c = C[i][k];
+                    Matrix::const_row_iterator gk = g.row_begin(k);
+                    for (Size j=0; j<paths; ++j)
+                        drifts2[j] -= gk[j]*c;
+                }
+                Matrix::row_iterator l = logForwards.row_begin(i);
+                Matrix::row_iterator f = current.row_begin(i);
+                Matrix::row_iterator gi = g.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator w =
+                    correlatedBrownians.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    l[j] += 0.5*(d1[j]+drifts2[j]) + fixedDrift[i];
+                    l[j] += w[j];
+                    f[j] = std::exp(l[j]) - displacements_[i];
+                    gi[j] = rateTaus_[i]*(f[j]+displacements_[i])/
+                        (1.0+rateTaus_[i]*f[j]);
+                }
+            }
+
+            forwards[s] = current;
+        }
+    }
+
     Size LogNormalFwdRateIpc::currentStep() const {
         return currentStep_;
     }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2006 Ferdinando Ametrano
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -94,6 +95,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    LogNormalFwdRatePc::clone(Size firstPath) const {
+        boost::shared_ptr<LogNormalFwdRatePc> evolver(
+                                               new LogNormalFwdRatePc(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real LogNormalFwdRatePc::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialLogForwards_.begin(), initialLogForwards_.end(),
@@ -144,6 +153,82 @@ namespace QuantLib {
         return weight;
     }
 
+    void LogNormalFwdRatePc::evolveBlock(std::vector<Matrix>& forwards) {
+        Size steps = marketModel_->evolution().numberOfSteps()-initialStep_;
+        QL_REQUIRE(forwards.size() == steps,
+                   "wrong number of steps (" << forwards.size()
+                   << ", " << steps << " required)");
+        Size paths = forwards.front().columns();
+        for (Size s=0; s<steps; ++s)
+            QL_REQUIRE(forwards[s].rows() == numberOfRates_ &&
+                       forwards[s].columns() == paths,
+                       "wrong forward-rate block size");
+
+        std::vector<Matrix> brownians(steps,
+                                      Matrix(numberOfFactors_, paths));
+        generator_->nextBlock(brownians);
+
+        // same as advanceStep(), with each rate replaced by a row of
+        // values across paths
+        Matrix logForwards(numberOfRates_, paths), current(numberOfRates_, paths);
+        Matrix drifts1(numberOfRates_, paths), drifts2(numberOfRates_, paths);
+        for (Size i=0; i<numberOfRates_; ++i) {
+            std::fill(logForwards.row_begin(i), logForwards.row_end(i),
+                      initialLogForwards_[i]);
+            std::fill(current.row_begin(i), current.row_end(i),
+                      std::exp(initialLogForwards_[i]) - displacements_[i]);
+        }
+
+        for (Size s=0; s<steps; ++s) {
+            Size step = initialStep_+s;
+
+            // a) compute drifts D1 at T1;
+            if (s > 0) {
+                calculators_[step].compute(current, drifts1);
+            } else {
+                for (Size i=0; i<numberOfRates_; ++i)
+                    std::fill(drifts1.row_begin(i), drifts1.row_end(i),
+                              initialDrifts_[i]);
+            }
+
+            // b) evolve forwards up to T2 using D1;
+            const Matrix& A = marketModel_->pseudoRoot(step);
+            Matrix correlatedBrownians = A*brownians[s];
+            const std::vector<Real>& fixedDrift = fixedDrifts_[step];
+
+            Size i, alive = alive_[step];
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator l = logForwards.row_begin(i);
+                Matrix::row_iterator f = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator w =
+                    correlatedBrownians.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    l[j] += d1[j] + fixedDrift[i];
+                    l[j] += w[j];
+                    f[j] = std::exp(l[j]) - displacements_[i];
+                }
+            }
+
+            // c) recompute drifts D2 using the predicted forwards;
+            calculators_[step].compute(current, drifts2);
+
+            // d) correct forwards using both drifts
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator l = logForwards.row_begin(i);
+                Matrix::row_iterator f = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator d2 = drifts2.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    l[j] += (d2[j]-d1[j])/2.0;
+                    f[j] = std::exp(l[j]) - displacements_[i];
+                }
+            }
+
+            forwards[s] = current;
+        }
+    }
+
     Size LogNormalFwdRatePc::currentStep() const {
         return currentStep_;
     }
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2007 Giorgio Facchinetti
  Copyright (C) 2007 Chiara Fornarola
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -88,6 +89,14 @@ namespace QuantLib {
         setForwards(cs.forwardRates());
     }
 
+    boost::shared_ptr<MarketModelEvolver>
+    NormalFwdRatePc::clone(Size firstPath) const {
+        boost::shared_ptr<NormalFwdRatePc> evolver(
+                                                  new NormalFwdRatePc(*this));
+        evolver->generator_ = generator_->clone(firstPath);
+        return evolver;
+    }
+
     Real NormalFwdRatePc::startNewPath() {
         currentStep_ = initialStep_;
         std::copy(initialForwards_.begin(), initialForwards_.end(),
@@ -135,6 +144,73 @@ namespace QuantLib {
         return weight;
     }
 
+    void NormalFwdRatePc::evolveBlock(std::vector<Matrix>& forwards) {
+        Size steps = marketModel_->evolution().numberOfSteps()-initialStep_;
+        QL_REQUIRE(forwards.size() == steps,
+                   "wrong number of steps (" << forwards.size()
+                   << ", " << steps << " required)");
+        Size paths = forwards.front().columns();
+        for (Size s=0; s<steps; ++s)
+            QL_REQUIRE(forwards[s].rows() == numberOfRates_ &&
+                       forwards[s].columns() == paths,
+                       "wrong forward-rate block size");
+
+        std::vector<Matrix> brownians(steps,
+                                      Matrix(numberOfFactors_, paths));
+        generator_->nextBlock(brownians);
+
+        // same as advanceStep(), with each rate replaced by a row of
+        // values across paths
+        Matrix current(numberOfRates_, paths);
+        Matrix drifts1(numberOfRates_, paths), drifts2(numberOfRates_, paths);
+        for (Size i=0; i<numberOfRates_; ++i)
+            std::fill(current.row_begin(i), current.row_end(i),
+                      initialForwards_[i]);
+
+        for (Size s=0; s<steps; ++s) {
+            Size step = initialStep_+s;
+
+            // a) compute drifts D1 at T1;
+            if (s > 0) {
+                calculators_[step].compute(current, drifts1);
+            } else {
+                for (Size i=0; i<numberOfRates_; ++i)
+                    std::fill(drifts1.row_begin(i), drifts1.row_end(i),
+                              initialDrifts_[i]);
+            }
+
+            // b) evolve forwards up to T2 using D1;
+            const Matrix& A = marketModel_->pseudoRoot(step);
+            Matrix correlatedBrownians = A*brownians[s];
+
+            Size i, alive = alive_[step];
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator f = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator w =
+                    correlatedBrownians.row_begin(i);
+                for (Size j=0; j<paths; ++j) {
+                    f[j] += d1[j];
+                    f[j] += w[j];
+                }
+            }
+
+            // c) recompute drifts D2 using the predicted forwards;
+            calculators_[step].compute(current, drifts2);
+
+            // d) correct forwards using both drifts
+            for (i=alive; i<numberOfRates_; ++i) {
+                Matrix::row_iterator f = current.row_begin(i);
+                Matrix::const_row_iterator d1 = drifts1.row_begin(i);
+                Matrix::const_row_iterator d2 = drifts2.row_begin(i);
+                for (Size j=0; j<paths; ++j)
+                    f[j] += (d2[j]-d1[j])/2.0;
+            }
+
+            forwards[s] = current;
+        }
+    }
+
     Size NormalFwdRatePc::currentStep() const {
         return currentStep_;
     }
@@ -2,6 +2,7 @@
 
 /*
 Copyright (C) 2008 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
 This file is part of QuantLib, a free-software/open-source library
 for financial quantitative analysts and developers - http://quantlib.org/
@@ -18,6 +19,7 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 */
 
 #include <ql/models/marketmodels/pathwiseaccountingengine.hpp>
+#include <ql/models/marketmodels/accountingengine.hpp>
 #include <ql/models/marketmodels/discounter.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdrateeuler.hpp>
 #include <ql/models/marketmodels/evolutiondescription.hpp>
@@ -30,7 +32,8 @@ namespace QuantLib {
     PathwiseAccountingEngine::PathwiseAccountingEngine(const boost::shared_ptr<LogNormalFwdRateEuler>& evolver, // method relies heavily on LMM Euler
         const Clone<MarketModelPathwiseMultiProduct>& product,
         const boost::shared_ptr<MarketModel>& pseudoRootStructure, // we need pseudo-roots and displacements
-        Real initialNumeraireValue)
+        Real initialNumeraireValue,
+        Size threads)
         : evolver_(evolver), product_(product),pseudoRootStructure_(pseudoRootStructure),
         initialNumeraireValue_(initialNumeraireValue),
         numberProducts_(product->numberOfProducts()),
@@ -38,7 +41,8 @@ namespace QuantLib {
         numerairesHeld_(product->numberOfProducts()),
         numberCashFlowsThisStep_(product->numberOfProducts()),
         cashFlowsGenerated_(product->numberOfProducts()) ,
-        deflatorAndDerivatives_(pseudoRootStructure_->numberOfRates()+1)
+        deflatorAndDerivatives_(pseudoRootStructure_->numberOfRates()+1),
+        threads_(threads), simulatedPaths_(0)
     {
 
         numberRates_ = pseudoRootStructure_->numberOfRates();
@@ -312,6 +316,11 @@ namespace QuantLib {
     void PathwiseAccountingEngine::multiplePathValues(SequenceStatisticsInc& stats,
         Size numberOfPaths)
     {
+        if (threads_ != Null<Size>()) {
+            multiplePathValuesInChunks(stats, numberOfPaths);
+            return;
+        }
+
         std::vector<Real> values(product_->numberOfProducts()*(numberRates_+1));
         for (Size i=0; i<numberOfPaths; ++i)
         {
@@ -320,6 +329,63 @@ namespace QuantLib {
         }
     }
 
+    namespace {
+
+        class PathwiseAccountingChunks : public detail::ChunkedSimulation {
+          public:
+            PathwiseAccountingChunks(
+                    const boost::shared_ptr<LogNormalFwdRateEuler>& evolver,
+                    const Clone<MarketModelPathwiseMultiProduct>& product,
+                    const boost::shared_ptr<MarketModel>& pseudoRootStructure,
+                    Real initialNumeraireValue,
+                    Size firstPath,
+                    Size numberOfPaths,
+                    SequenceStatisticsInc& stats)
+            : detail::ChunkedSimulation(firstPath, numberOfPaths),
+              evolver_(evolver), product_(product),
+              pseudoRootStructure_(pseudoRootStructure),
+              initialNumeraireValue_(initialNumeraireValue),
+              stats_(stats), chunkStats_(chunks()) {}
+          private:
+            void simulate(Size begin, Size end) {
+                boost::shared_ptr<LogNormalFwdRateEuler> evolver =
+                    boost::dynamic_pointer_cast<LogNormalFwdRateEuler>(
+                                          evolver_->clone(firstPath(begin)));
+                QL_REQUIRE(evolver,
+                           "LogNormalFwdRateEuler evolver cloned "
+                           "as a different type");
+                PathwiseAccountingEngine engine(evolver, product_,
+                                                pseudoRootStructure_,
+                                                initialNumeraireValue_);
+                for (Size i=begin; i<end; ++i)
+                    engine.multiplePathValues(chunkStats_[i], paths(i));
+            }
+            void merge(Size i) {
+                stats_.merge(chunkStats_[i]);
+            }
+            boost::shared_ptr<LogNormalFwdRateEuler> evolver_;
+            const Clone<MarketModelPathwiseMultiProduct>& product_;
+            boost::shared_ptr<MarketModel> pseudoRootStructure_;
+            Real initialNumeraireValue_;
+            SequenceStatisticsInc& stats_;
+            std::vector<SequenceStatisticsInc> chunkStats_;
+        };
+
+    }
+
+    void PathwiseAccountingEngine::multiplePathValuesInChunks(
+                                                SequenceStatisticsInc& stats,
+                                                Size numberOfPaths) {
+        QL_REQUIRE(threads_ != 0, "null number of threads");
+        PathwiseAccountingChunks chunks(evolver_, product_,
+                                        pseudoRootStructure_,
+                                        initialNumeraireValue_,
+                                        simulatedPaths_, numberOfPaths,
+                                        stats);
+        chunks.run(threads_);
+        simulatedPaths_ += numberOfPaths;
+    }
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
  
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
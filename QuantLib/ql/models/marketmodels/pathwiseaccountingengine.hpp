@@ -3,6 +3,7 @@
 /*
 
  Copyright (C) 2008 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -28,6 +29,7 @@
 #include <ql/models/marketmodels/pathwisegreeks/ratepseudorootjacobian.hpp>
 
 #include <ql/utilities/clone.hpp>
+#include <ql/utilities/null.hpp>
 #include <ql/types.hpp>
 #include <vector>
 
@@ -41,18 +43,23 @@ namespace QuantLib {
     // using Giles--Glasserman smoking adjoints method
     // note only works with displaced LMM, and requires knowledge of pseudo-roots and displacements 
     // This is tested in MarketModelTest::testPathwiseGreeks
+    // If a number of threads is passed, paths are simulated in chunks
+    // as in AccountingEngine.
     class PathwiseAccountingEngine 
     {
       public:
         PathwiseAccountingEngine(const boost::shared_ptr<LogNormalFwdRateEuler>& evolver, // method relies heavily on LMM Euler
                          const Clone<MarketModelPathwiseMultiProduct>& product,
                          const boost::shared_ptr<MarketModel>& pseudoRootStructure, // we need pseudo-roots and displacements
-                         Real initialNumeraireValue);
+                         Real initialNumeraireValue,
+                         Size threads = Null<Size>());
 
         void multiplePathValues(SequenceStatisticsInc& stats,
                                 Size numberOfPaths);
       private:
           Real singlePathValues(std::vector<Real>& values);
+          void multiplePathValuesInChunks(SequenceStatisticsInc& stats,
+                                          Size numberOfPaths);
 
         boost::shared_ptr<LogNormalFwdRateEuler> evolver_;
         Clone<MarketModelPathwiseMultiProduct> product_;
@@ -95,6 +102,8 @@ namespace QuantLib {
 
         std::vector<std::vector<Size> > cashFlowIndicesThisStep_;
 
+        Size threads_;
+        Size simulatedPaths_;
     };
 
 
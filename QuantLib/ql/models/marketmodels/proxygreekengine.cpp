@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -18,6 +19,7 @@
 */
 
 #include <ql/models/marketmodels/proxygreekengine.hpp>
+#include <ql/models/marketmodels/accountingengine.hpp>
 #include <ql/models/marketmodels/evolutiondescription.hpp>
 #include <ql/models/marketmodels/curvestate.hpp>
 #include <ql/models/marketmodels/discounter.hpp>
@@ -35,7 +37,8 @@ namespace QuantLib {
             const std::vector<Size>& startIndexOfConstraint,
             const std::vector<Size>& endIndexOfConstraint,
             const Clone<MarketModelMultiProduct>& product,
-            Real initialNumeraireValue)
+            Real initialNumeraireValue,
+            Size threads)
     : originalEvolver_(evolver), constrainedEvolvers_(constrainedEvolvers),
       diffWeights_(diffWeights),
       startIndexOfConstraint_(startIndexOfConstraint),
@@ -43,6 +46,7 @@ namespace QuantLib {
       product_(product),
       initialNumeraireValue_(initialNumeraireValue),
       numberProducts_(product->numberOfProducts()),
+      threads_(threads), simulatedPaths_(0),
       numerairesHeld_(product->numberOfProducts()),
       numberCashFlowsThisStep_(product->numberOfProducts()),
       cashFlowsGenerated_(product->numberOfProducts()) {
@@ -82,6 +86,11 @@ namespace QuantLib {
                   SequenceStatisticsInc& stats,
                   std::vector<std::vector<SequenceStatisticsInc> >& modifiedStats,
                   Size numberOfPaths) {
+        if (threads_ != Null<Size>()) {
+            multiplePathValuesInChunks(stats, modifiedStats, numberOfPaths);
+            return;
+        }
+
         Size N = product_->numberOfProducts();
 
         std::vector<Real> values(N);
@@ -113,6 +122,106 @@ namespace QuantLib {
         }
     }
 
+    namespace {
+
+        class ProxyGreekChunks : public detail::ChunkedSimulation {
+            typedef std::vector<std::vector<
+                boost::shared_ptr<ConstrainedEvolver> > > evolvers_type;
+            typedef std::vector<std::vector<SequenceStatisticsInc> >
+                                                        modified_stats_type;
+          public:
+            ProxyGreekChunks(
+                const boost::shared_ptr<MarketModelEvolver>& evolver,
+                const evolvers_type& constrainedEvolvers,
+                const std::vector<std::vector<std::vector<Real> > >&
+                                                                 diffWeights,
+                const std::vector<Size>& startIndexOfConstraint,
+                const std::vector<Size>& endIndexOfConstraint,
+                const Clone<MarketModelMultiProduct>& product,
+                Real initialNumeraireValue,
+                Size firstPath,
+                Size numberOfPaths,
+                SequenceStatisticsInc& stats,
+                modified_stats_type& modifiedStats)
+            : detail::ChunkedSimulation(firstPath, numberOfPaths),
+              evolver_(evolver), constrainedEvolvers_(constrainedEvolvers),
+              diffWeights_(diffWeights),
+              startIndexOfConstraint_(startIndexOfConstraint),
+              endIndexOfConstraint_(endIndexOfConstraint),
+              product_(product),
+              initialNumeraireValue_(initialNumeraireValue),
+              stats_(stats), modifiedStats_(modifiedStats),
+              chunkStats_(chunks()), chunkModifiedStats_(chunks()) {
+                for (Size i=0; i<chunks(); ++i) {
+                    chunkModifiedStats_[i].resize(diffWeights_.size());
+                    for (Size j=0; j<diffWeights_.size(); ++j)
+                        chunkModifiedStats_[i][j].resize(
+                                                   diffWeights_[j].size());
+                }
+            }
+          private:
+            void simulate(Size begin, Size end) {
+                Size start = firstPath(begin);
+                evolvers_type constrainedEvolvers(
+                                                constrainedEvolvers_.size());
+                for (Size j=0; j<constrainedEvolvers_.size(); ++j) {
+                    for (Size k=0; k<constrainedEvolvers_[j].size(); ++k) {
+                        boost::shared_ptr<ConstrainedEvolver> evolver =
+                            boost::dynamic_pointer_cast<ConstrainedEvolver>(
+                                  constrainedEvolvers_[j][k]->clone(start));
+                        QL_REQUIRE(evolver,
+                                   "constrained evolver cloned as "
+                                   "unconstrained");
+                        constrainedEvolvers[j].push_back(evolver);
+                    }
+                }
+                ProxyGreekEngine engine(evolver_->clone(start),
+                                        constrainedEvolvers, diffWeights_,
+                                        startIndexOfConstraint_,
+                                        endIndexOfConstraint_,
+                                        product_, initialNumeraireValue_);
+                for (Size i=begin; i<end; ++i)
+                    engine.multiplePathValues(chunkStats_[i],
+                                              chunkModifiedStats_[i],
+                                              paths(i));
+            }
+            void merge(Size i) {
+                stats_.merge(chunkStats_[i]);
+                for (Size j=0; j<diffWeights_.size(); ++j)
+                    for (Size k=0; k<diffWeights_[j].size(); ++k)
+                        modifiedStats_[j][k].merge(
+                                                chunkModifiedStats_[i][j][k]);
+            }
+            boost::shared_ptr<MarketModelEvolver> evolver_;
+            const evolvers_type& constrainedEvolvers_;
+            const std::vector<std::vector<std::vector<Real> > >& diffWeights_;
+            const std::vector<Size>& startIndexOfConstraint_;
+            const std::vector<Size>& endIndexOfConstraint_;
+            const Clone<MarketModelMultiProduct>& product_;
+            Real initialNumeraireValue_;
+            SequenceStatisticsInc& stats_;
+            modified_stats_type& modifiedStats_;
+            std::vector<SequenceStatisticsInc> chunkStats_;
+            std::vector<modified_stats_type> chunkModifiedStats_;
+        };
+
+    }
+
+    void ProxyGreekEngine::multiplePathValuesInChunks(
+                  SequenceStatisticsInc& stats,
+                  std::vector<std::vector<SequenceStatisticsInc> >& modifiedStats,
+                  Size numberOfPaths) {
+        QL_REQUIRE(threads_ != 0, "null number of threads");
+        ProxyGreekChunks chunks(originalEvolver_, constrainedEvolvers_,
+                                diffWeights_, startIndexOfConstraint_,
+                                endIndexOfConstraint_, product_,
+                                initialNumeraireValue_,
+                                simulatedPaths_, numberOfPaths,
+                                stats, modifiedStats);
+        chunks.run(threads_);
+        simulatedPaths_ += numberOfPaths;
+    }
+
     void ProxyGreekEngine::singleEvolverValues(MarketModelEvolver& evolver,
                                                std::vector<Real>& values,
                                                bool storeRates) {
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -26,6 +27,7 @@
 
 #include <ql/math/statistics/sequencestatistics.hpp>
 #include <ql/utilities/clone.hpp>
+#include <ql/utilities/null.hpp>
 #include <valarray>
 
 namespace QuantLib {
@@ -34,6 +36,11 @@ namespace QuantLib {
     class ConstrainedEvolver;
     class MarketModelDiscounter;
 
+    //! Engine collecting cash flows for proxy-simulation Greeks
+    /*! If a number of threads is passed, paths are simulated in
+        chunks as in AccountingEngine; both the original and the
+        constrained evolvers must support cloning.
+    */
     class ProxyGreekEngine {
       public:
         ProxyGreekEngine(
@@ -45,7 +52,8 @@ namespace QuantLib {
             const std::vector<Size>& startIndexOfConstraint,
             const std::vector<Size>& endIndexOfConstraint,
             const Clone<MarketModelMultiProduct>& product,
-            Real initialNumeraireValue);
+            Real initialNumeraireValue,
+            Size threads = Null<Size>());
         void multiplePathValues(
                   SequenceStatisticsInc& stats,
                   std::vector<std::vector<SequenceStatisticsInc> >& modifiedStats,
@@ -54,6 +62,10 @@ namespace QuantLib {
                 std::vector<Real>& values,
                 std::vector<std::vector<std::vector<Real> > >& modifiedValues);
       private:
+        void multiplePathValuesInChunks(
+                  SequenceStatisticsInc& stats,
+                  std::vector<std::vector<SequenceStatisticsInc> >& modifiedStats,
+                  Size numberOfPaths);
         void singleEvolverValues(MarketModelEvolver& evolver,
                                  std::vector<Real>& values,
                                  bool storeRates = false);
@@ -67,6 +79,8 @@ namespace QuantLib {
 
         Real initialNumeraireValue_;
         Size numberProducts_;
+        Size threads_;
+        Size simulatedPaths_;
 
         // workspace
         std::vector<Rate> constraints_;
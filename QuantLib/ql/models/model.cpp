@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
  Copyright (C) 2013 Peter Caspers
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -22,6 +23,9 @@
 #include <ql/math/optimization/problem.hpp>
 #include <ql/math/optimization/projection.hpp>
 #include <ql/math/optimization/projectedconstraint.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <map>
 
 namespace QuantLib {
 
@@ -41,17 +45,51 @@ namespace QuantLib {
                   const std::vector<boost::shared_ptr<CalibrationHelper> >&
                                                                   instruments,
                   const std::vector<Real>& weights,
-                  const Projection& projection)
+                  const Projection& projection,
+                  Size threads = Null<Size>())
         : model_(model, no_deletion), instruments_(instruments),
-          weights_(weights), projection_(projection) { }
+          weights_(weights), projection_(projection), threads_(threads) {
+            QL_REQUIRE(threads_ != 0, "null number of threads");
+            if (threads_ != Null<Size>()) {
+                // helpers sharing an engine are evaluated by the
+                // same thread; so are those without an engine.
+                std::map<PricingEngine*, Size> indexes;
+                for (Size i=0; i<instruments_.size(); ++i) {
+                    PricingEngine* engine =
+                        instruments_[i]->pricingEngine().get();
+                    std::map<PricingEngine*, Size>::const_iterator k =
+                        indexes.find(engine);
+                    if (k == indexes.end()) {
+                        indexes[engine] = groups_.size();
+                        groups_.push_back(std::vector<Size>(1, i));
+                    } else {
+                        groups_[k->second].push_back(i);
+                    }
+                }
+                // with no helpers, a single thread does the (empty) work
+                threads_ = std::max<Size>(std::min(threads_, groups_.size()),
+                                          1);
+                #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+                // a context can't be current in two threads; each
+                // thread gets its own fork of the current one, made
+                // once for the whole calibration.
+                if (threads_ > 1) {
+                    for (Size t=0; t<threads_; ++t)
+                        contexts_.push_back(
+                                       SingletonContext::current().fork());
+                }
+                #endif
+            }
+        }
 
         virtual ~CalibrationFunction() {}
 
         virtual Real value(const Array& params) const {
             model_->setParams(projection_.include(params));
+            Array errors = calibrationErrors();
             Real value = 0.0;
             for (Size i=0; i<instruments_.size(); i++) {
-                Real diff = instruments_[i]->calibrationError();
+                Real diff = errors[i];
                 value += diff*diff*weights_[i];
             }
             return std::sqrt(value);
@@ -59,10 +97,9 @@ namespace QuantLib {
 
         virtual Disposable<Array> values(const Array& params) const {
             model_->setParams(projection_.include(params));
-            Array values(instruments_.size());
+            Array values = calibrationErrors();
             for (Size i=0; i<instruments_.size(); i++) {
-                values[i] = instruments_[i]->calibrationError()
-                           *std::sqrt(weights_[i]);
+                values[i] *= std::sqrt(weights_[i]);
             }
             return values;
         }
@@ -70,19 +107,76 @@ namespace QuantLib {
         virtual Real finiteDifferenceEpsilon() const { return 1e-6; }
 
       private:
+        Disposable<Array> calibrationErrors() const;
         boost::shared_ptr<CalibratedModel> model_;
         const std::vector<boost::shared_ptr<CalibrationHelper> >& instruments_;
         std::vector<Real> weights_;
         const Projection projection_;
+        Size threads_;
+        std::vector<std::vector<Size> > groups_;
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        std::vector<SingletonContext> contexts_;
+        #endif
     };
 
+    Disposable<Array>
+    CalibratedModel::CalibrationFunction::calibrationErrors() const {
+        Size n = instruments_.size();
+        Array errors(n);
+
+        if (threads_ == Null<Size>() || threads_ == 1) {
+            for (Size i=0; i<n; i++)
+                errors[i] = instruments_[i]->calibrationError();
+            return errors;
+        }
+
+        QL_REQUIRE(!ObservableSettings::instance().batching(),
+                   "helpers can't be evaluated on multiple threads "
+                   "while a notification batch is open");
+
+        // market values are lazy and might register the helpers
+        // with shared market data when first calculated; they're
+        // calculated here before the threads are started.
+        for (Size i=0; i<n; i++)
+            instruments_[i]->marketValue();
+
+        // each thread takes the next available group until none is left
+        boost::detail::atomic_count next(0);
+        std::vector<std::string> errorMessages(threads_);
+
+        #pragma omp parallel for num_threads(threads_) schedule(static,1)
+        for (long t=0; t<long(threads_); ++t) {
+            #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+            SingletonContextGuard guard(contexts_[t]);
+            #endif
+            try {
+                for (Size g = ++next - 1; g < groups_.size(); g = ++next - 1) {
+                    for (Size k=0; k<groups_[g].size(); ++k) {
+                        Size i = groups_[g][k];
+                        errors[i] = instruments_[i]->calibrationError();
+                    }
+                }
+            } catch (std::exception& e) {
+                errorMessages[t] = e.what();
+            } catch (...) {
+                errorMessages[t] = "unknown error";
+            }
+        }
+
+        for (Size t=0; t<threads_; ++t)
+            QL_REQUIRE(errorMessages[t].empty(), errorMessages[t]);
+
+        return errors;
+    }
+
     void CalibratedModel::calibrate(
         const std::vector<boost::shared_ptr<CalibrationHelper> >& instruments,
         OptimizationMethod& method,
         const EndCriteria& endCriteria,
         const Constraint& additionalConstraint,
         const std::vector<Real>& weights,
-        const std::vector<bool>& fixParameters) {
+        const std::vector<bool>& fixParameters,
+        Size threads) {
 
         QL_REQUIRE(weights.empty() ||
                    weights.size() == instruments.size(),
@@ -100,7 +194,7 @@ namespace QuantLib {
         Array prms = params();
         std::vector<bool> all(prms.size(), false);
         Projection proj(prms,fixParameters.size()>0 ? fixParameters : all);
-        CalibrationFunction f(this,instruments,w,proj);
+        CalibrationFunction f(this,instruments,w,proj,threads);
         ProjectedConstraint pc(c,proj);
         Problem prob(f, pc, proj.project(prms));
         shortRateEndCriteria_ = method.minimize(prob, endCriteria);
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2005, 2007 StatPro Italia srl
+ Copyright (C) 2005, 2007, 2014 StatPro Italia srl
  Copyright (C) 2013 Peter Caspers
 
  This file is part of QuantLib, a free-software/open-source library
@@ -31,6 +31,7 @@
 #include <ql/models/parameter.hpp>
 #include <ql/models/calibrationhelper.hpp>
 #include <ql/math/optimization/endcriteria.hpp>
+#include <ql/utilities/null.hpp>
 
 namespace QuantLib {
 
@@ -97,6 +98,19 @@ namespace QuantLib {
         //! Calibrate to a set of market instruments (caps/swaptions)
         /*! An additional constraint can be passed which must be
             satisfied in addition to the constraints of the model.
+
+            If a number of threads is passed, the calibration errors
+            of the helpers are calculated concurrently at each
+            evaluation of the cost function, after the parameters
+            are set to the model. Since an engine can't be used by
+            two threads at the same time, helpers are grouped by
+            pricing engine and each group is evaluated by a single
+            thread; thus, helpers should be given separate engines
+            in order to benefit from this. The model and market data
+            must only be read during the calculation of the helpers.
+
+            \warning Helpers can't be evaluated concurrently while a
+                     notification batch is open.
         */
         virtual void calibrate(
                    const std::vector<boost::shared_ptr<CalibrationHelper> >&,
@@ -104,7 +118,8 @@ namespace QuantLib {
                    const EndCriteria& endCriteria,
                    const Constraint& constraint = Constraint(),
                    const std::vector<Real>& weights = std::vector<Real>(),
-                   const std::vector<bool>& fixParameters = std::vector<bool>());
+                   const std::vector<bool>& fixParameters = std::vector<bool>(),
+                   Size threads = Null<Size>());
 
         Real value(const Array& params,
                    const std::vector<boost::shared_ptr<CalibrationHelper> >&);
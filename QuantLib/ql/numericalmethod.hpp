@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2004, 2005 StatPro Italia srl
+ Copyright (C) 2004, 2005, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -27,6 +27,7 @@
 
 #include <ql/timegrid.hpp>
 #include <ql/math/array.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace QuantLib {
 
@@ -86,6 +87,28 @@ namespace QuantLib {
         //! computes the present value of an asset.
         virtual Real presentValue(DiscretizedAsset&) const = 0;
 
+        /*! Roll back a number of assets until the given time,
+            performing any needed adjustment.
+
+            The default implementation rolls back each asset in
+            turn; numerical methods can override it so that the
+            assets are evolved together.
+
+            \warning The assets should be independent of each other;
+                     for instance, the underlying of an option should
+                     not be passed together with the option itself.
+        */
+        virtual void rollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
+
+        /*! Roll back a number of assets until the given time, but do
+            not perform the final adjustment.
+        */
+        virtual void partialRollback(
+                    const std::vector<boost::shared_ptr<DiscretizedAsset> >&,
+                    Time to) const;
+
         //@}
 
         // this is a smell, but we need it. We'll rethink it later.
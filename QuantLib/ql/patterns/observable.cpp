@@ -0,0 +1,476 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/patterns/observable.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <algorithm>
+
+#if defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+#include <boost/thread/recursive_mutex.hpp>
+#endif
+
+namespace QuantLib {
+
+    namespace {
+
+        #if defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+
+        // a single mutex for all observers and observables; a
+        // per-object one would need both sides to be locked when
+        // registering, and would deadlock on cyclic notifications.
+        boost::recursive_mutex& observerMutex() {
+            static boost::recursive_mutex mutex;
+            return mutex;
+        }
+
+        // make sure the mutex is created before any thread is started
+        boost::recursive_mutex& initializedMutex = observerMutex();
+
+        #define QL_OBSERVER_LOCK \
+        boost::recursive_mutex::scoped_lock lock(observerMutex())
+
+        #else
+
+        #define QL_OBSERVER_LOCK
+
+        #endif
+
+        // beyond this number of observables, observers keep an index
+        // of their positions instead of searching them linearly
+        const Size indexThreshold = 16;
+
+        // number of batches open or being delivered in any session
+        // or context; when null, as is usually the case,
+        // notifications don't need to look up the settings. It is
+        // only a hint: the batch state itself is read from the
+        // settings of the current session or context. The counter
+        // is atomic, since batches can be opened concurrently by
+        // threads working in different contexts.
+        boost::detail::atomic_count activeBatches(0);
+
+    }
+
+
+    Observable::~Observable() {
+        if (deferred_ != Null<Size>()) {
+            QL_OBSERVER_LOCK;
+            ObservableSettings::instance().remove(this);
+        }
+    }
+
+
+    Size Observable::registerObserver(Observer* o, Size position) {
+        observers_.push_back(o);
+        positions_.push_back(position);
+        return observers_.size()-1;
+    }
+
+    void Observable::unregisterObserver(Size slot) {
+        if (notifying_ > 0) {
+            // the loop in notifyObservers() relies on the slots not
+            // moving; the observer is removed when it's finished
+            observers_[slot] = 0;
+            ++removed_;
+            return;
+        }
+        Size last = observers_.size()-1;
+        if (slot != last) {
+            observers_[slot] = observers_[last];
+            positions_[slot] = positions_[last];
+            observers_[slot]->slots_[positions_[slot]] = slot;
+        }
+        observers_.pop_back();
+        positions_.pop_back();
+    }
+
+    void Observable::removeUnregistered() {
+        Size j = 0;
+        for (Size i=0; i<observers_.size(); ++i) {
+            if (observers_[i] != 0) {
+                if (i != j) {
+                    observers_[j] = observers_[i];
+                    positions_[j] = positions_[i];
+                    observers_[j]->slots_[positions_[j]] = j;
+                }
+                ++j;
+            }
+        }
+        observers_.resize(j);
+        positions_.resize(j);
+        removed_ = 0;
+    }
+
+    void Observable::notifyObservers() {
+        QL_OBSERVER_LOCK;
+        if (observers_.size() == removed_)
+            return;
+        // the batch state is kept by the settings of the current
+        // session or context, and is only accessed under the lock
+        ObservableSettings* settings = 0;
+        if (activeBatches != 0) {
+            settings = &ObservableSettings::instance();
+            if (settings->delivering_) {
+                // observers scheduled by the batch are only flagged
+                // here and updated later in the delivery loop
+            } else if (settings->depth_ > 0) {
+                settings->defer(this);
+                return;
+            } else {
+                settings = 0;
+            }
+        }
+        bool successful = true;
+        std::string errMsg;
+        ++notifying_;
+        // observers registering during the loop are not notified
+        Size n = observers_.size();
+        for (Size i=0; i<n; ++i) {
+            Observer* o = observers_[i];
+            if (o == 0)
+                continue;
+            if (settings != 0 && settings->schedule(o))
+                continue;
+            try {
+                o->update();
+            } catch (std::exception& e) {
+                // quite a dilemma. If we don't catch the exception,
+                // other observers will not receive the notification
+                // and might be left in an incorrect state. If we do
+                // catch it and continue the loop (as we do here) we
+                // lose the exception. The least evil might be to try
+                // and notify all observers, while raising an
+                // exception if something bad happened.
+                successful = false;
+                errMsg = e.what();
+            } catch (...) {
+                successful = false;
+            }
+        }
+        if (--notifying_ == 0 && removed_ > 0)
+            removeUnregistered();
+        QL_ENSURE(successful,
+                  "could not notify one or more observers: " << errMsg);
+    }
+
+
+    Observer::Observer(const Observer& o)
+    : batchGeneration_(0), batchIndex_(0) {
+        QL_OBSERVER_LOCK;
+        observables_ = o.observables_;
+        registerWithAll();
+    }
+
+    Observer& Observer::operator=(const Observer& o) {
+        QL_OBSERVER_LOCK;
+        if (&o != this) {
+            // copy first, in case o is only kept alive by an
+            // observable we're about to release
+            observables_type observables = o.observables_;
+            unregisterWithAll();
+            observables_.swap(observables);
+            registerWithAll();
+        }
+        return *this;
+    }
+
+    Observer::~Observer() {
+        if (batchGeneration_ != 0) {
+            // the observer is scheduled by a batch being delivered
+            QL_OBSERVER_LOCK;
+            ObservableSettings::instance().remove(this);
+        }
+        unregisterWithAll();
+    }
+
+    Size Observer::find(const boost::shared_ptr<Observable>& h) const {
+        if (index_) {
+            std::map<Observable*, Size>::const_iterator i =
+                index_->find(h.get());
+            return i != index_->end() ? i->second : Null<Size>();
+        }
+        for (Size i=0; i<observables_.size(); ++i) {
+            if (observables_[i] == h)
+                return i;
+        }
+        return Null<Size>();
+    }
+
+    void Observer::buildIndex() {
+        if (observables_.size() <= indexThreshold) {
+            index_.reset();
+            return;
+        }
+        index_.reset(new std::map<Observable*, Size>);
+        for (Size i=0; i<observables_.size(); ++i)
+            (*index_)[observables_[i].get()] = i;
+    }
+
+    std::pair<Observer::iterator, bool>
+    Observer::registerWith(const boost::shared_ptr<Observable>& h) {
+        if (!h)
+            return std::make_pair(observables_.end(), false);
+        QL_OBSERVER_LOCK;
+        Size found = find(h);
+        if (found != Null<Size>())
+            return std::make_pair(observables_.begin()+found, false);
+        Size position = observables_.size();
+        observables_.push_back(h);
+        slots_.push_back(h->registerObserver(this, position));
+        if (index_)
+            (*index_)[h.get()] = position;
+        else if (observables_.size() > indexThreshold)
+            buildIndex();
+        return std::make_pair(observables_.begin()+position, true);
+    }
+
+    Size Observer::unregisterWith(const boost::shared_ptr<Observable>& h) {
+        if (!h)
+            return 0;
+        QL_OBSERVER_LOCK;
+        Size position = find(h);
+        if (position == Null<Size>())
+            return 0;
+        h->unregisterObserver(slots_[position]);
+        if (index_)
+            index_->erase(h.get());
+        Size last = observables_.size()-1;
+        if (position != last) {
+            observables_[position].swap(observables_[last]);
+            slots_[position] = slots_[last];
+            observables_[position]->positions_[slots_[position]] = position;
+            if (index_)
+                (*index_)[observables_[position].get()] = position;
+        }
+        observables_.pop_back();
+        slots_.pop_back();
+        return 1;
+    }
+
+    void Observer::unregisterWithAll() {
+        QL_OBSERVER_LOCK;
+        for (Size i=0; i<observables_.size(); ++i)
+            observables_[i]->unregisterObserver(slots_[i]);
+        // the observables are released after our own lists are
+        // cleared, since their destruction might trigger further
+        // unregistrations.
+        observables_type observables;
+        observables.swap(observables_);
+        slots_.clear();
+        index_.reset();
+    }
+
+    void Observer::registerWithAll() {
+        slots_.resize(observables_.size());
+        for (Size i=0; i<observables_.size(); ++i)
+            slots_[i] = observables_[i]->registerObserver(this, i);
+        buildIndex();
+    }
+
+
+
+    ObservableSettings::ObservableSettings()
+    : depth_(0), delivering_(false), generation_(0),
+      notifications_(0), requested_(0), delivered_(0) {}
+
+    void ObservableSettings::resetCounters() {
+        notifications_ = requested_ = delivered_ = 0;
+    }
+
+    void ObservableSettings::beginBatch() {
+        ++depth_;
+        ++activeBatches;
+    }
+
+    void ObservableSettings::endBatch() {
+        QL_REQUIRE(depth_ > 0, "no notification batch open");
+        --depth_;
+        --activeBatches;
+        if (depth_ == 0 && !delivering_)
+            deliver();
+    }
+
+    void ObservableSettings::defer(Observable* o) {
+        ++notifications_;
+        requested_ += o->observers_.size() - o->removed_;
+        if (o->deferred_ == Null<Size>()) {
+            o->deferred_ = dirty_.size();
+            dirty_.push_back(o);
+        }
+    }
+
+    bool ObservableSettings::schedule(Observer* o) {
+        ++requested_;
+        if (o->batchGeneration_ != generation_ || done_[o->batchIndex_])
+            return false;
+        pending_[o->batchIndex_] = true;
+        return true;
+    }
+
+    void ObservableSettings::remove(Observable* o) {
+        if (o->deferred_ < dirty_.size() && dirty_[o->deferred_] == o)
+            dirty_[o->deferred_] = 0;
+        o->deferred_ = Null<Size>();
+    }
+
+    void ObservableSettings::remove(Observer* o) {
+        nodes_[o->batchIndex_] = 0;
+        o->batchGeneration_ = 0;
+    }
+
+    void ObservableSettings::deliver() {
+        if (dirty_.empty())
+            return;
+
+        if (++generation_ == 0)
+            ++generation_;
+        nodes_.clear();
+
+        // collect the observers reachable from the deferred
+        // observables; nodes_ doubles as the queue of the search.
+        std::vector<Observable*> observables;
+        std::vector<Size> parents;
+        for (Size i=0; i<dirty_.size(); ++i) {
+            Observable* root = dirty_[i];
+            if (root == 0)
+                continue;
+            for (Size j=0; j<root->observers_.size(); ++j) {
+                Observer* o = root->observers_[j];
+                if (o != 0 && o->batchGeneration_ != generation_) {
+                    o->batchGeneration_ = generation_;
+                    o->batchIndex_ = nodes_.size();
+                    nodes_.push_back(o);
+                    parents.push_back(0);
+                }
+            }
+        }
+        for (Size k=0; k<nodes_.size(); ++k) {
+            Observable* node = dynamic_cast<Observable*>(nodes_[k]);
+            observables.push_back(node);
+            if (node == 0)
+                continue;
+            for (Size j=0; j<node->observers_.size(); ++j) {
+                Observer* o = node->observers_[j];
+                if (o == 0)
+                    continue;
+                if (o->batchGeneration_ != generation_) {
+                    o->batchGeneration_ = generation_;
+                    o->batchIndex_ = nodes_.size();
+                    nodes_.push_back(o);
+                    parents.push_back(0);
+                }
+                ++parents[o->batchIndex_];
+            }
+        }
+
+        // sort them topologically...
+        Size n = nodes_.size();
+        std::vector<Size> order;
+        order.reserve(n);
+        for (Size k=0; k<n; ++k)
+            if (parents[k] == 0)
+                order.push_back(k);
+        for (Size h=0; h<order.size(); ++h) {
+            Observable* node = observables[order[h]];
+            if (node == 0)
+                continue;
+            for (Size j=0; j<node->observers_.size(); ++j) {
+                Observer* o = node->observers_[j];
+                if (o != 0 && --parents[o->batchIndex_] == 0)
+                    order.push_back(o->batchIndex_);
+            }
+        }
+        // ...except for cycles, which are left in discovery order
+        if (order.size() < n) {
+            for (Size k=0; k<n; ++k)
+                if (parents[k] != 0)
+                    order.push_back(k);
+        }
+
+        // flag the observers of the deferred observables...
+        pending_.assign(n, false);
+        done_.assign(n, false);
+        for (Size i=0; i<dirty_.size(); ++i) {
+            Observable* root = dirty_[i];
+            if (root == 0)
+                continue;
+            root->deferred_ = Null<Size>();
+            for (Size j=0; j<root->observers_.size(); ++j) {
+                Observer* o = root->observers_[j];
+                if (o != 0)
+                    pending_[o->batchIndex_] = true;
+            }
+        }
+        dirty_.clear();
+
+        // ...and update them; the ones they notify in turn are
+        // flagged by notifyObservers() and updated later on.
+        delivering_ = true;
+        ++activeBatches;
+        bool successful = true;
+        std::string errMsg;
+        for (Size h=0; h<n; ++h) {
+            Size k = order[h];
+            done_[k] = true;
+            Observer* o = nodes_[k];
+            if (o == 0 || !pending_[k])
+                continue;
+            ++delivered_;
+            try {
+                o->update();
+            } catch (std::exception& e) {
+                // as in notifyObservers(), all observers are updated
+                // before reporting the error
+                successful = false;
+                errMsg = e.what();
+            } catch (...) {
+                successful = false;
+            }
+        }
+        for (Size k=0; k<n; ++k)
+            if (nodes_[k] != 0)
+                nodes_[k]->batchGeneration_ = 0;
+        nodes_.clear();
+        delivering_ = false;
+        --activeBatches;
+        QL_ENSURE(successful,
+                  "could not notify one or more observers: " << errMsg);
+    }
+
+
+    NotificationBatch::NotificationBatch()
+    : open_(true) {
+        QL_OBSERVER_LOCK;
+        ObservableSettings::instance().beginBatch();
+    }
+
+    NotificationBatch::~NotificationBatch() {
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    void NotificationBatch::close() {
+        if (open_) {
+            open_ = false;
+            QL_OBSERVER_LOCK;
+            ObservableSettings::instance().endBatch();
+        }
+    }
+
+}
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
- Copyright (C) 2003, 2004, 2005, 2006 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2005, 2006, 2014 StatPro Italia srl
  Copyright (C) 2011, 2012 Ferdinando Ametrano
 
  This file is part of QuantLib, a free-software/open-source library
@@ -28,65 +28,235 @@
 
 #include <ql/errors.hpp>
 #include <ql/types.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <ql/utilities/null.hpp>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 
+#include <vector>
 #include <set>
+#include <map>
 
 namespace QuantLib {
 
     class Observer;
+    class ObservableSettings;
 
     //! Object that notifies its changes to a set of observers
-    /*! \ingroup patterns */
+    /*! Observers are kept in a flat vector, in the order in which
+        they registered. Each observer appears only once, no matter
+        how many times it registers, and is thus notified once for
+        each change; also, each observer remembers its position in
+        the vector, so that adding and removing it take constant
+        time and don't allocate memory besides the occasional growth
+        of the vector. On the observer side, the observable is looked
+        up in a similar vector; the lookup is linear for a few
+        observables and goes through an index, taking logarithmic
+        time, when an observer registers with many of them.
+
+        Observers can register or unregister while a notification is
+        in progress. Observers registering during the notification
+        are not notified; observers unregistering before being
+        reached are not notified either.
+
+        While a NotificationBatch is open, notifications are not
+        sent immediately; see the NotificationBatch documentation.
+
+        If QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN is defined,
+        registration, unregistration and notification are serialized
+        by a library-wide recursive mutex, so that observers and
+        observables can be shared between threads.
+
+        \ingroup patterns
+    */
     class Observable {
         friend class Observer;
+        friend class ObservableSettings;
       public:
         // constructors, assignment, destructor
-        Observable() {}
+        Observable();
         Observable(const Observable&);
         Observable& operator=(const Observable&);
-        virtual ~Observable() {}
+        virtual ~Observable();
         /*! This method should be called at the end of non-const methods
             or when the programmer desires to notify any changes.
         */
         void notifyObservers();
       private:
-        typedef std::set<Observer*>::iterator iterator;
-        std::pair<iterator, bool> registerObserver(Observer*);
-        Size unregisterObserver(Observer*);
-        std::set<Observer*> observers_;
+        Size registerObserver(Observer*, Size position);
+        void unregisterObserver(Size slot);
+        void removeUnregistered();
+        // positions_[i] holds the position of this instance in the
+        // observables_ vector of observers_[i]
+        std::vector<Observer*> observers_;
+        std::vector<Size> positions_;
+        // while notifications are in progress, unregistered observers
+        // are replaced by null pointers and removed at the end
+        Size notifying_, removed_;
+        // position in the list of deferred observables, if any
+        Size deferred_;
     };
 
     //! Object that gets notified when a given observable changes
     /*! \ingroup patterns */
     class Observer {
+        friend class Observable;
+        friend class ObservableSettings;
       public:
+        /*! \deprecated observables are no longer stored in a set;
+                        this typedef is kept for backward compatibility
+                        and will be removed in a future release.
+        */
+        QL_DEPRECATED
+        typedef std::set<boost::shared_ptr<Observable> > set_type;
+        typedef std::vector<boost::shared_ptr<Observable> >::iterator
+                                                                  iterator;
         // constructors, assignment, destructor
-        Observer() {}
+        Observer();
         Observer(const Observer&);
         Observer& operator=(const Observer&);
         virtual ~Observer();
         // observer interface
-        std::pair<std::set<boost::shared_ptr<Observable> >::iterator, bool>
+        /*! \warning the returned iterator is invalidated by further
+                     registrations or unregistrations.
+        */
+        std::pair<iterator, bool>
                             registerWith(const boost::shared_ptr<Observable>&);
         Size unregisterWith(const boost::shared_ptr<Observable>&);
+        void unregisterWithAll();
         /*! This method must be implemented in derived classes. An
             instance of %Observer does not call this method directly:
             instead, it will be called by the observables the instance
             registered with when they need to notify any changes.
         */
-        void unregisterWithAll();
         virtual void update() = 0;
       private:
-        std::set<boost::shared_ptr<Observable> > observables_;
-        typedef std::set<boost::shared_ptr<Observable> >::iterator iterator;
+        void registerWithAll();
+        Size find(const boost::shared_ptr<Observable>&) const;
+        void buildIndex();
+        typedef std::vector<boost::shared_ptr<Observable> > observables_type;
+        // slots_[i] holds the position of this instance in the
+        // observers_ vector of observables_[i]
+        observables_type observables_;
+        std::vector<Size> slots_;
+        // positions of the observables, kept when there are many
+        boost::scoped_ptr<std::map<Observable*, Size> > index_;
+        // position in the schedule of the batch being delivered, if any
+        Size batchGeneration_, batchIndex_;
+    };
+
+
+    //! Global settings for the notification of observers
+    /*! This class keeps the state of notification batches and
+        counts the notifications they coalesced. As for other
+        singletons, a separate instance is kept for each session if
+        QL_ENABLE_SESSIONS is defined, or for each context if
+        QL_ENABLE_SINGLETON_CONTEXTS is defined; batches opened in
+        one of them don't affect notifications sent in the others.
+        If QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN is defined, the
+        state is only accessed under the observer mutex.
+
+        \ingroup patterns
+    */
+    class ObservableSettings : public Singleton<ObservableSettings> {
+        friend class Singleton<ObservableSettings>;
+        friend class Observable;
+        friend class Observer;
+        friend class NotificationBatch;
+      private:
+        ObservableSettings();
+      public:
+        //! whether a notification batch is open
+        bool batching() const { return depth_ > 0 || delivering_; }
+        //! \name counters
+        //@{
+        //! calls to notifyObservers() whose effect was deferred
+        Size deferredNotifications() const { return notifications_; }
+        //! observer updates that immediate notification would have sent
+        Size requestedUpdates() const { return requested_; }
+        //! observer updates actually sent when closing the batches
+        Size deliveredUpdates() const { return delivered_; }
+        //! observer updates saved by coalescing notifications
+        Size coalescedUpdates() const { return requested_ - delivered_; }
+        void resetCounters();
+        //@}
+      private:
+        void beginBatch();
+        void endBatch();
+        void defer(Observable*);
+        bool schedule(Observer*);
+        void remove(Observable*);
+        void remove(Observer*);
+        void deliver();
+        Size depth_;
+        bool delivering_;
+        std::vector<Observable*> dirty_;
+        Size generation_;
+        std::vector<Observer*> nodes_;
+        std::vector<bool> pending_, done_;
+        Size notifications_, requested_, delivered_;
+    };
+
+
+    //! Scoped batch of notifications
+    /*! While an instance of this class is alive, calls to
+        Observable::notifyObservers() are not forwarded to the
+        observers; instead, the observables are collected and
+        notified once when the batch is closed, either explicitly or
+        by the destructor. Batches can be nested; notifications are
+        delivered when the outermost one is closed.
+
+        Upon delivery, each observer reachable from the collected
+        observables is sent at most one update, in topological order
+        (that is, after all the observables it depends upon were
+        updated.) Observers are only sent an update if an observable
+        they registered with actually notified them, either before
+        delivery or from its own update() method; thus, for instance,
+        frozen lazy objects still don't forward notifications.
+        Observers that are part of a cycle are notified in the order
+        of discovery.
+
+        For example, after
+        \code
+        {
+            NotificationBatch batch;
+            for (Size i=0; i<quotes.size(); ++i)
+                quotes[i]->setValue(values[i]);
+        }
+        \endcode
+        a curve bootstrapped on the quotes and the instruments priced
+        on the curve are notified once instead of once per quote.
+
+        \warning Observers are sent no notification until the batch
+                 is closed; therefore, they must not be asked for
+                 results depending on the changed observables while
+                 the batch is open.
+
+        \ingroup patterns
+    */
+    class NotificationBatch : private boost::noncopyable {
+      public:
+        NotificationBatch();
+        /*! If still open, the batch is closed. Any exception thrown
+            by the observers is swallowed; close() should be called
+            if it's to be reported.
+        */
+        ~NotificationBatch();
+        //! delivers the collected notifications if outermost
+        void close();
+      private:
+        bool open_;
     };
 
 
     // inline definitions
 
-    inline Observable::Observable(const Observable&) {
+    inline Observable::Observable()
+    : notifying_(0), removed_(0), deferred_(Null<Size>()) {}
+
+    inline Observable::Observable(const Observable&)
+    : notifying_(0), removed_(0), deferred_(Null<Size>()) {
         // the observer set is not copied; no observer asked to
         // register with this object
     }
@@ -107,82 +277,9 @@ namespace QuantLib {
         return *this;
     }
 
-    inline std::pair<std::set<Observer*>::iterator, bool>
-    Observable::registerObserver(Observer* o) {
-        return observers_.insert(o);
-    }
-
-    inline Size Observable::unregisterObserver(Observer* o) {
-        return observers_.erase(o);
-    }
-
-    inline void Observable::notifyObservers() {
-        bool successful = true;
-        std::string errMsg;
-        for (iterator i=observers_.begin(); i!=observers_.end(); ++i) {
-            try {
-                (*i)->update();
-            } catch (std::exception& e) {
-                // quite a dilemma. If we don't catch the exception,
-                // other observers will not receive the notification
-                // and might be left in an incorrect state. If we do
-                // catch it and continue the loop (as we do here) we
-                // lose the exception. The least evil might be to try
-                // and notify all observers, while raising an
-                // exception if something bad happened.
-                successful = false;
-                errMsg = e.what();
-            } catch (...) {
-                successful = false;
-            }
-        }
-        QL_ENSURE(successful,
-                  "could not notify one or more observers: " << errMsg);
-    }
-
-
-    inline Observer::Observer(const Observer& o)
-    : observables_(o.observables_) {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->registerObserver(this);
-    }
-
-    inline Observer& Observer::operator=(const Observer& o) {
-        iterator i;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
-        observables_ = o.observables_;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->registerObserver(this);
-        return *this;
-    }
-
-    inline Observer::~Observer() {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
-    }
 
-    inline std::pair<std::set<boost::shared_ptr<Observable> >::iterator, bool>
-    Observer::registerWith(const boost::shared_ptr<Observable>& h) {
-        if (h) {
-            h->registerObserver(this);
-            return observables_.insert(h);
-        }
-        return std::make_pair(observables_.end(), false);
-    }
-
-    inline
-    Size Observer::unregisterWith(const boost::shared_ptr<Observable>& h) {
-        if (h)
-            h->unregisterObserver(this);
-        return observables_.erase(h);
-    }
-
-    inline void Observer::unregisterWithAll() {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
-        observables_.clear();
-    }
+    inline Observer::Observer()
+    : batchGeneration_(0), batchIndex_(0) {}
 
 }
 
@@ -0,0 +1,176 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/patterns/singleton.hpp>
+
+#if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+
+#include <ql/errors.hpp>
+#include <boost/enable_shared_from_this.hpp>
+
+namespace QuantLib {
+
+    namespace detail {
+
+        class SingletonContextData
+            : public boost::enable_shared_from_this<SingletonContextData> {
+          public:
+            SingletonContextData() : forkSource(0) {}
+            std::vector<boost::shared_ptr<void> > instances;
+            std::vector<SingletonForker> forkers;
+            // the context this one is being forked from, if any
+            const SingletonContextData* forkSource;
+        };
+
+    }
+
+    namespace {
+
+        // constant-initialized, so that it can be used by other static
+        // initializers; indices are only assigned during static
+        // initialization, before any thread is started
+        Size singletonClasses = 0;
+
+        const boost::shared_ptr<detail::SingletonContextData>&
+        globalContext() {
+            static boost::shared_ptr<detail::SingletonContextData> global(
+                                          new detail::SingletonContextData);
+            return global;
+        }
+
+        // make sure the global context is created before any thread
+        // is started
+        const boost::shared_ptr<detail::SingletonContextData>&
+            initializedContext = globalContext();
+
+        // null if the thread is using the global context
+        QL_THREAD_LOCAL detail::SingletonContextData* currentContext = 0;
+
+        void* store(detail::SingletonContextData& context, Size index,
+                    const boost::shared_ptr<void>& instance,
+                    detail::SingletonForker fork) {
+            if (context.instances.size() <= index) {
+                context.instances.resize(index+1);
+                context.forkers.resize(index+1);
+            }
+            context.instances[index] = instance;
+            context.forkers[index] = fork;
+            return instance.get();
+        }
+
+        // forks the instance with the given index from the context
+        // being forked, if it has one
+        void* forkFromSource(detail::SingletonContextData& context,
+                             Size index) {
+            const detail::SingletonContextData* source =
+                context.forkSource;
+            if (source == 0 || source->instances.size() <= index
+                || !source->instances[index])
+                return 0;
+            return store(context, index,
+                         source->forkers[index](source->instances[index]),
+                         source->forkers[index]);
+        }
+
+    }
+
+    namespace detail {
+
+        Size singletonIndex(Size& index) {
+            if (index == 0)
+                index = ++singletonClasses;
+            return index;
+        }
+
+        void* currentSingleton(Size index) {
+            SingletonContextData* context = currentContext;
+            if (context == 0)
+                context = globalContext().get();
+            if (context->instances.size() <= index
+                || !context->instances[index]) {
+                // while a context is being forked, the singletons
+                // used by the constructors of the forked instances
+                // are forked first rather than default-constructed
+                return forkFromSource(*context, index);
+            }
+            return context->instances[index].get();
+        }
+
+        void* storeSingleton(Size index,
+                             const boost::shared_ptr<void>& instance,
+                             SingletonForker fork) {
+            SingletonContextData* context = currentContext;
+            if (context == 0)
+                context = globalContext().get();
+            return store(*context, index, instance, fork);
+        }
+
+    }
+
+
+    SingletonContext::SingletonContext()
+    : data_(new detail::SingletonContextData) {}
+
+    SingletonContext::SingletonContext(
+                 const boost::shared_ptr<detail::SingletonContextData>& data)
+    : data_(data) {}
+
+    SingletonContext SingletonContext::fork() const {
+        SingletonContext forked;
+        detail::SingletonContextData& source = *data_;
+        detail::SingletonContextData& target = *forked.data_;
+        // any singleton used by the constructors must come from the
+        // new context, and is forked in turn when first used; thus,
+        // instances already there when their turn comes are skipped.
+        SingletonContextGuard guard(forked);
+        target.forkSource = &source;
+        for (Size i=0; i<source.instances.size(); ++i) {
+            if (target.instances.size() <= i || !target.instances[i])
+                forkFromSource(target, i);
+        }
+        target.forkSource = 0;
+        return forked;
+    }
+
+    SingletonContext SingletonContext::current() {
+        if (currentContext == 0)
+            return global();
+        // guards keep the current context alive
+        return SingletonContext(currentContext->shared_from_this());
+    }
+
+    SingletonContext SingletonContext::global() {
+        return SingletonContext(globalContext());
+    }
+
+
+    SingletonContextGuard::SingletonContextGuard(
+                                             const SingletonContext& context)
+    : context_(context), previous_(currentContext) {
+        currentContext = context_.data_.get();
+    }
+
+    SingletonContextGuard::~SingletonContextGuard() {
+        currentContext = previous_;
+    }
+
+}
+
+#endif
+
@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2004, 2005, 2007 StatPro Italia srl
+ Copyright (C) 2004, 2005, 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -34,6 +34,7 @@
     #pragma managed(pop)
 #endif
 #include <map>
+#include <vector>
 
 #if (_MANAGED == 1) || (_M_CEE == 1)
 // One of the Visual C++ /clr modes. In this case, the global instance
@@ -48,10 +49,102 @@
 namespace QuantLib {
 
     #if defined(QL_ENABLE_SESSIONS)
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    #error QL_ENABLE_SESSIONS and QL_ENABLE_SINGLETON_CONTEXTS are mutually exclusive
+    #endif
     // definition must be provided by the user
     Integer sessionId();
     #endif
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+
+    namespace detail {
+
+        class SingletonContextData;
+
+        typedef boost::shared_ptr<void> (*SingletonForker)(
+                                            const boost::shared_ptr<void>&);
+
+        // assigns the next index to a singleton class unless already
+        // assigned (i.e., unless nonzero) and returns it
+        Size singletonIndex(Size& index);
+        // instance in the context current in the calling thread, or
+        // null if it wasn't created yet
+        void* currentSingleton(Size index);
+        // stores a new instance in the current context
+        void* storeSingleton(Size index,
+                             const boost::shared_ptr<void>& instance,
+                             SingletonForker fork);
+
+    }
+
+    //! Set of singleton instances
+    /*! Each thread has a current context, from which the instances
+        returned by Singleton<T>::instance() are taken; for instance,
+        threads can value the same instruments as of different dates
+        by switching to different contexts. Threads that never
+        switched share the global context.
+
+        Instances of this class are handles; copies refer to the same
+        context, which is destroyed with the last handle referring to
+        it and the last guard keeping it current.
+
+        \warning A context must not be current in two threads at the
+                 same time, unless the singletons it holds are only
+                 read. Also, objects built in a context (e.g., term
+                 structures registered with the evaluation date) are
+                 meant to be used in the same context.
+
+        \ingroup patterns
+    */
+    class SingletonContext {
+      public:
+        //! creates a context with default-constructed instances
+        SingletonContext();
+        /*! creates a context whose instances are initialized from
+            those existing in this one. By default, the new instances
+            are default-constructed; singleton classes can customize
+            this by declaring a
+            \code
+            void forkFrom(T& source);
+            \endcode
+            method, which will be called on the new instance.
+        */
+        SingletonContext fork() const;
+        //! the context current in the calling thread
+        static SingletonContext current();
+        //! the context shared by threads that never switched
+        static SingletonContext global();
+        bool operator==(const SingletonContext& c) const {
+            return data_ == c.data_;
+        }
+        bool operator!=(const SingletonContext& c) const {
+            return data_ != c.data_;
+        }
+      private:
+        friend class SingletonContextGuard;
+        explicit SingletonContext(
+                     const boost::shared_ptr<detail::SingletonContextData>&);
+        boost::shared_ptr<detail::SingletonContextData> data_;
+    };
+
+    //! Switches the context of the calling thread for its lifetime
+    /*! Switching takes constant time and no locks. Guards can be
+        nested; the destructor restores the previous context.
+
+        \ingroup patterns
+    */
+    class SingletonContextGuard : private boost::noncopyable {
+      public:
+        explicit SingletonContextGuard(const SingletonContext&);
+        ~SingletonContextGuard();
+      private:
+        SingletonContext context_;
+        detail::SingletonContextData* previous_;
+    };
+
+    #endif
+
     // this is required on VC++ when CLR support is enabled
     #if defined(QL_PATCH_MSVC)
         #pragma managed(push, off)
@@ -73,6 +166,10 @@ namespace QuantLib {
         as a single implemementation point should synchronization
         features be added.
 
+        If QL_ENABLE_SESSIONS is defined, a separate instance is kept
+        for each session; if QL_ENABLE_SINGLETON_CONTEXTS is defined,
+        a separate instance is kept for each SingletonContext.
+
         \ingroup patterns
     */
     template <class T>
@@ -86,6 +183,14 @@ namespace QuantLib {
         static T& instance();
       protected:
         Singleton() {}
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        // default initialization of forked instances; can be hidden
+        // by a method with the same name in derived classes
+        void forkFrom(T&) {}
+      private:
+        static boost::shared_ptr<void> fork(const boost::shared_ptr<void>&);
+        static Size index_;
+        #endif
     };
 
     #if (QL_MANAGED == 1)
@@ -96,6 +201,38 @@ namespace QuantLib {
 
     // template definitions
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+
+    // assigned during static initialization, before any thread is
+    // started; instance() assigns it earlier if called by another
+    // static initializer.
+    template <class T>
+    Size Singleton<T>::index_ = detail::singletonIndex(Singleton<T>::index_);
+
+    template <class T>
+    T& Singleton<T>::instance() {
+        Size index = index_ != 0 ? index_ : detail::singletonIndex(index_);
+        void* instance = detail::currentSingleton(index);
+        if (instance == 0) {
+            // stored after construction, since the constructor might
+            // create other singletons in the same context
+            boost::shared_ptr<T> created(new T);
+            instance = detail::storeSingleton(index, created,
+                                              &Singleton<T>::fork);
+        }
+        return *static_cast<T*>(instance);
+    }
+
+    template <class T>
+    boost::shared_ptr<void>
+    Singleton<T>::fork(const boost::shared_ptr<void>& source) {
+        boost::shared_ptr<T> instance(new T);
+        instance->forkFrom(*static_cast<T*>(source.get()));
+        return instance;
+    }
+
+    #else
+
     template <class T>
     T& Singleton<T>::instance() {
         #if (QL_MANAGED == 0)
@@ -112,6 +249,8 @@ namespace QuantLib {
         return *instance;
     }
 
+    #endif
+
     // reverts the change above
     #if defined(QL_PATCH_MSVC)
         #pragma managed(pop)
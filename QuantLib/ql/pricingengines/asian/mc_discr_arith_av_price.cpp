@@ -51,4 +51,34 @@ namespace QuantLib {
         return discount_ * payoff_(averagePrice);
     }
 
+    void ArithmeticAPOPathPricer::operator()(
+                                      const PathBlock& paths,
+                                      std::vector<Real>& values) const {
+        Size n = paths.length();
+        QL_REQUIRE(n>1, "the paths cannot be empty");
+
+        Size first, fixings;
+        if (paths.timeGrid().mandatoryTimes()[0]==0.0) {
+            // include initial fixing
+            first = 0;
+            fixings = pastFixings_ + n;
+        } else {
+            first = 1;
+            fixings = pastFixings_ + n - 1;
+        }
+
+        // sums are accumulated one time node at a time, so that the
+        // inner loop runs over contiguous values
+        values.assign(paths.size(), runningSum_);
+        for (Size i=first; i<n; i++) {
+            const Array& prices = paths[i];
+            for (Size j=0; j<values.size(); j++)
+                values[j] += prices[j];
+        }
+        for (Size j=0; j<values.size(); j++) {
+            Real averagePrice = values[j]/fixings;
+            values[j] = discount_ * payoff_(averagePrice);
+        }
+    }
+
 }
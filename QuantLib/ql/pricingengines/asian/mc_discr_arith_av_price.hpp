@@ -84,6 +84,8 @@ namespace QuantLib {
                                 Real runningSum = 0.0,
                                 Size pastFixings = 0);
         Real operator()(const Path& path) const;
+        void operator()(const PathBlock& paths,
+                        std::vector<Real>& values) const;
       private:
         PlainVanillaPayoff payoff_;
         DiscountFactor discount_;
@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2004 Neil Firth
  Copyright (C) 2006 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -34,6 +35,8 @@ namespace QuantLib {
         LsmBasisSystem::PolynomType polynomType)
     : assetNumber_ (assetNumber),
       payoff_      (payoff),
+      polynomOrder_(polynomOrder),
+      polynomType_ (polynomType),
       scalingValue_(1.0),
       v_           (LsmBasisSystem::multiPathBasisSystem(assetNumber_,
                                                          polynomOrder,
@@ -90,4 +93,15 @@ namespace QuantLib {
         return v_;
     }
 
+    void AmericanBasketPathPricer::basisValues(
+                                          const std::vector<Array>& states,
+                                          Matrix& values) const {
+        QL_REQUIRE(values.columns() == v_.size(), "wrong matrix size");
+        LsmBasisSystem::multiPathBasisValues(assetNumber_, polynomOrder_,
+                                             polynomType_, states, values);
+        // the payoff gives the last value
+        for (Size j=0; j<states.size(); ++j)
+            values[j][v_.size()-1] = payoff(states[j]);
+    }
+
 }
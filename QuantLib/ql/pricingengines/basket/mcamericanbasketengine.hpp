@@ -3,7 +3,7 @@
 /*
  Copyright (C) 2004 Neil Firth
  Copyright (C) 2006 Klaus Spanderen
- Copyright (C) 2007, 2008 StatPro Italia srl
+ Copyright (C) 2007, 2008, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -104,12 +104,16 @@ namespace QuantLib {
         Real operator()(const MultiPath& path, Size t) const;
 
         std::vector<boost::function1<Real, Array> > basisSystem() const;
+        void basisValues(const std::vector<Array>& states,
+                         Matrix& values) const;
 
       protected:
         Real payoff(const Array& state) const;
 
         const Size assetNumber_;
         const boost::shared_ptr<Payoff> payoff_;
+        const Size polynomOrder_;
+        const LsmBasisSystem::PolynomType polynomType_;
 
         Real scalingValue_;
         std::vector<boost::function1<Real, Array> > v_;
@@ -64,7 +64,8 @@ namespace QuantLib {
             Real requiredTolerance,
             Size maxSamples,
             BigNatural seed,
-            Size nCalibrationSamples = Null<Size>());
+            Size nCalibrationSamples = Null<Size>(),
+            Size threads = Null<Size>());
 
         void calculate() const;
 
@@ -104,8 +105,9 @@ namespace QuantLib {
             Real requiredTolerance,
             Size maxSamples,
             BigNatural seed,
-            Size nCalibrationSamples)
-    : McSimulation<MC,RNG,S> (antitheticVariate, controlVariate),
+            Size nCalibrationSamples,
+            Size threads)
+    : McSimulation<MC,RNG,S> (antitheticVariate, controlVariate, threads),
       process_            (process),
       timeSteps_          (timeSteps),
       timeStepsPerYear_   (timeStepsPerYear),
@@ -37,6 +37,12 @@ namespace QuantLib {
         Carlo engine.
 
         See McVanillaEngine as an example.
+
+        If a number of threads is given, samples are simulated
+        concurrently as described in MonteCarloModel; the results do
+        not depend on the number of threads used.  If a block size
+        is given, paths are drawn and priced in blocks, also as
+        described in MonteCarloModel.
     */
 
     template <template <class> class MC, class RNG, class S = Statistics>
@@ -67,9 +73,12 @@ namespace QuantLib {
                        Size maxSamples) const;
       protected:
         McSimulation(bool antitheticVariate,
-                     bool controlVariate)
+                     bool controlVariate,
+                     Size threads = Null<Size>(),
+                     Size blockSize = Null<Size>())
         : antitheticVariate_(antitheticVariate),
-          controlVariate_(controlVariate) {}
+          controlVariate_(controlVariate), threads_(threads),
+          blockSize_(blockSize) {}
         virtual boost::shared_ptr<path_pricer_type> pathPricer() const = 0;
         virtual boost::shared_ptr<path_generator_type> pathGenerator()
                                                                    const = 0;
@@ -97,6 +106,7 @@ namespace QuantLib {
         
         mutable boost::shared_ptr<MonteCarloModel<MC,RNG,S> > mcModel_;
         bool antitheticVariate_, controlVariate_;
+        Size threads_, blockSize_;
     };
 
 
@@ -186,13 +196,18 @@ namespace QuantLib {
                     new MonteCarloModel<MC,RNG,S>(
                            pathGenerator(), this->pathPricer(), stats_type(),
                            this->antitheticVariate_, controlPP,
-                           controlVariateValue, controlPG));
+                           controlVariateValue, controlPG,
+                           this->threads_, this->blockSize_));
         } else {
             this->mcModel_ =
                 boost::shared_ptr<MonteCarloModel<MC,RNG,S> >(
                     new MonteCarloModel<MC,RNG,S>(
                            pathGenerator(), this->pathPricer(), S(),
-                           this->antitheticVariate_));
+                           this->antitheticVariate_,
+                           boost::shared_ptr<path_pricer_type>(),
+                           result_type(),
+                           boost::shared_ptr<path_generator_type>(),
+                           this->threads_, this->blockSize_));
         }
 
         if (requiredTolerance != Null<Real>()) {
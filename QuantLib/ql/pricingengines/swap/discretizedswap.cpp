@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2001, 2002, 2003 Sadruddin Rejeb
- Copyright (C) 2004, 2007 StatPro Italia srl
+ Copyright (C) 2004, 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -83,44 +83,64 @@ namespace QuantLib {
     }
 
     void DiscretizedSwap::preAdjustValuesImpl() {
-        // floating payments
+        // the discount bonds for the coupons resetting at this time
+        // are rolled back together, floating ones first
+        std::vector<Size> floating, fixed;
+        std::vector<boost::shared_ptr<DiscretizedAsset> > bonds;
         for (Size i=0; i<floatingResetTimes_.size(); i++) {
             Time t = floatingResetTimes_[i];
             if (t >= 0.0 && isOnTime(t)) {
-                DiscretizedDiscountBond bond;
-                bond.initialize(method(), floatingPayTimes_[i]);
-                bond.rollback(time_);
-
-                Real nominal = arguments_.nominal;
-                Time T = arguments_.floatingAccrualTimes[i];
-                Spread spread = arguments_.floatingSpreads[i];
-                Real accruedSpread = nominal*T*spread;
-                for (Size j=0; j<values_.size(); j++) {
-                    Real coupon = nominal * (1.0 - bond.values()[j])
-                                + accruedSpread * bond.values()[j];
-                    if (arguments_.type == VanillaSwap::Payer)
-                        values_[j] += coupon;
-                    else
-                        values_[j] -= coupon;
-                }
+                boost::shared_ptr<DiscretizedAsset> bond(
+                                              new DiscretizedDiscountBond);
+                bond->initialize(method(), floatingPayTimes_[i]);
+                bonds.push_back(bond);
+                floating.push_back(i);
             }
         }
-        // fixed payments
         for (Size i=0; i<fixedResetTimes_.size(); i++) {
             Time t = fixedResetTimes_[i];
             if (t >= 0.0 && isOnTime(t)) {
-                DiscretizedDiscountBond bond;
-                bond.initialize(method(), fixedPayTimes_[i]);
-                bond.rollback(time_);
+                boost::shared_ptr<DiscretizedAsset> bond(
+                                              new DiscretizedDiscountBond);
+                bond->initialize(method(), fixedPayTimes_[i]);
+                bonds.push_back(bond);
+                fixed.push_back(i);
+            }
+        }
+        if (bonds.empty())
+            return;
+        method()->rollback(bonds, time_);
 
-                Real fixedCoupon = arguments_.fixedCoupons[i];
-                for (Size j=0; j<values_.size(); j++) {
-                    Real coupon = fixedCoupon*bond.values()[j];
-                    if (arguments_.type == VanillaSwap::Payer)
-                        values_[j] -= coupon;
-                    else
-                        values_[j] += coupon;
-                }
+        // floating payments
+        for (Size k=0; k<floating.size(); k++) {
+            Size i = floating[k];
+            const Array& bond = bonds[k]->values();
+
+            Real nominal = arguments_.nominal;
+            Time T = arguments_.floatingAccrualTimes[i];
+            Spread spread = arguments_.floatingSpreads[i];
+            Real accruedSpread = nominal*T*spread;
+            for (Size j=0; j<values_.size(); j++) {
+                Real coupon = nominal * (1.0 - bond[j])
+                            + accruedSpread * bond[j];
+                if (arguments_.type == VanillaSwap::Payer)
+                    values_[j] += coupon;
+                else
+                    values_[j] -= coupon;
+            }
+        }
+        // fixed payments
+        for (Size k=0; k<fixed.size(); k++) {
+            Size i = fixed[k];
+            const Array& bond = bonds[floating.size()+k]->values();
+
+            Real fixedCoupon = arguments_.fixedCoupons[i];
+            for (Size j=0; j<values_.size(); j++) {
+                Real coupon = fixedCoupon*bond[j];
+                if (arguments_.type == VanillaSwap::Payer)
+                    values_[j] -= coupon;
+                else
+                    values_[j] += coupon;
             }
         }
     }
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2004, 2005, 2008 Klaus Spanderen
- Copyright (C) 2007 StatPro Italia srl
+ Copyright (C) 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -40,10 +40,34 @@
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/lambda.hpp>
 
+#include <algorithm>
+#include <functional>
+
 using namespace boost::lambda;
 
 namespace QuantLib {
 
+    namespace {
+
+        Real optionValue(const TypePayoff& type,
+                         Real spotPrice, Real dividendDiscount,
+                         Real strikePrice, Real riskFreeDiscount,
+                         Real p1, Real p2) {
+            switch (type.optionType())
+            {
+              case Option::Call:
+                return spotPrice*dividendDiscount*(p1+0.5)
+                    - strikePrice*riskFreeDiscount*(p2+0.5);
+              case Option::Put:
+                return spotPrice*dividendDiscount*(p1-0.5)
+                    - strikePrice*riskFreeDiscount*(p2-0.5);
+              default:
+                QL_FAIL("unknown option type");
+            }
+        }
+
+    }
+
     // helper class for integration
     class AnalyticHestonEngine::Fj_Helper
         : public std::unary_function<Real, Real>
@@ -74,6 +98,10 @@ namespace QuantLib {
 
         Real operator()(Real phi)      const;
 
+        // strike-independent part of the exponent (Gatheral's formula)
+        std::complex<Real> exponent(Real phi) const;
+        std::complex<Real> addOnTerm(Real phi) const;
+
     private:
         const Size j_;
         //     const VanillaOption::arguments& arg_;
@@ -172,8 +200,8 @@ namespace QuantLib {
     }
 
 
-    Real AnalyticHestonEngine::Fj_Helper::operator()(Real phi) const
-    {
+    std::complex<Real>
+    AnalyticHestonEngine::Fj_Helper::exponent(Real phi) const {
         const Real rpsig(rsigma_*phi);
 
         const std::complex<Real> t1 = t0_+std::complex<Real>(0, -rpsig);
@@ -181,36 +209,38 @@ namespace QuantLib {
             std::sqrt(t1*t1 - sigma2_*phi
                       *std::complex<Real>(-phi, (j_== 1)? 1 : -1));
         const std::complex<Real> ex = std::exp(-d*term_);
-        const std::complex<Real> addOnTerm
-            = engine_ > 0 ? engine_->addOnTerm(phi, term_, j_) : 0.0;
 
+        if (sigma_ > 1e-5) {
+            const std::complex<Real> p = (t1-d)/(t1+d);
+            const std::complex<Real> g = std::log((1.0 - p*ex)/(1.0 - p));
+
+            return v0_*(t1-d)*(1.0-ex)/(sigma2_*(1.0-ex*p))
+                + (kappa_*theta_)/sigma2_*((t1-d)*term_-2.0*g);
+        }
+        else {
+            const std::complex<Real> td = phi/(2.0*t1)
+                *std::complex<Real>(-phi, (j_== 1)? 1 : -1);
+            const std::complex<Real> p = td*sigma2_/(t1+d);
+            const std::complex<Real> g = p*(1.0-ex);
+
+            return v0_*td*(1.0-ex)/(1.0-p*ex)
+                + (kappa_*theta_)*(td*term_-2.0*g/sigma2_);
+        }
+    }
+
+    std::complex<Real>
+    AnalyticHestonEngine::Fj_Helper::addOnTerm(Real phi) const {
+        return engine_ != 0 ? engine_->addOnTerm(phi, term_, j_) : 0.0;
+    }
+
+    Real AnalyticHestonEngine::Fj_Helper::operator()(Real phi) const
+    {
         if (cpxLog_ == Gatheral) {
             if (phi != 0.0) {
-                if (sigma_ > 1e-5) {
-                    const std::complex<Real> p = (t1-d)/(t1+d);
-                    const std::complex<Real> g
-                                            = std::log((1.0 - p*ex)/(1.0 - p));
-
-                    return
-                        std::exp(v0_*(t1-d)*(1.0-ex)/(sigma2_*(1.0-ex*p))
-                                 + (kappa_*theta_)/sigma2_*((t1-d)*term_-2.0*g)
-                                 + std::complex<Real>(0.0, phi*(dd_-sx_))
-                                 + addOnTerm
-                                 ).imag()/phi;
-                }
-                else {
-                    const std::complex<Real> td = phi/(2.0*t1)
-                                   *std::complex<Real>(-phi, (j_== 1)? 1 : -1);
-                    const std::complex<Real> p = td*sigma2_/(t1+d);
-                    const std::complex<Real> g = p*(1.0-ex);
-
-                    return
-                        std::exp(v0_*td*(1.0-ex)/(1.0-p*ex)
-                                 + (kappa_*theta_)*(td*term_-2.0*g/sigma2_)
-                                 + std::complex<Real>(0.0, phi*(dd_-sx_))
-                                 + addOnTerm
-                                 ).imag()/phi;
-                }
+                return std::exp(exponent(phi)
+                                + std::complex<Real>(0.0, phi*(dd_-sx_))
+                                + addOnTerm(phi)
+                                ).imag()/phi;
             }
             else {
                 // use l'Hospital's rule to get lim_{phi->0}
@@ -236,6 +266,13 @@ namespace QuantLib {
             }
         }
         else if (cpxLog_ == BranchCorrection) {
+            const Real rpsig(rsigma_*phi);
+
+            const std::complex<Real> t1 = t0_+std::complex<Real>(0, -rpsig);
+            const std::complex<Real> d =
+                std::sqrt(t1*t1 - sigma2_*phi
+                          *std::complex<Real>(-phi, (j_== 1)? 1 : -1));
+            const std::complex<Real> ex = std::exp(-d*term_);
             const std::complex<Real> p  = (t1+d)/(t1 - d);
 
             // next term: g = std::log((1.0 - p*std::exp(d*term_))/(1.0 - p))
@@ -281,7 +318,7 @@ namespace QuantLib {
             return std::exp(v0_*(t1+d)*(ex-1.0)/(sigma2_*(ex-p))
                             + (kappa_*theta_)/sigma2_*((t1+d)*term_-2.0*g)
                             + std::complex<Real>(0,phi*(dd_-sx_))
-                            + addOnTerm
+                            + addOnTerm(phi)
                             ).imag()/phi;
         }
         else {
@@ -361,20 +398,48 @@ namespace QuantLib {
                       cpxLog, term, strikePrice, ratio, 2))/M_PI;
         evaluations+= integration.numberOfEvaluations();
 
-        switch (type.optionType())
-        {
-          case Option::Call:
-            value = spotPrice*dividendDiscount*(p1+0.5)
-                           - strikePrice*riskFreeDiscount*(p2+0.5);
-            break;
-          case Option::Put:
-            value = spotPrice*dividendDiscount*(p1-0.5)
-                           - strikePrice*riskFreeDiscount*(p2-0.5);
-            break;
-          default:
-            QL_FAIL("unknown option type");
-        }
+        value = optionValue(type, spotPrice, dividendDiscount,
+                            strikePrice, riskFreeDiscount, p1, p2);
+    }
 
+    void AnalyticHestonEngine::update() {
+        nodeValues_.clear();
+        GenericModelEngine<HestonModel,
+                           VanillaOption::arguments,
+                           VanillaOption::results>::update();
+    }
+
+    boost::shared_ptr<AnalyticHestonEngine::NodeValues>
+    AnalyticHestonEngine::nodeValues(Time term) const {
+        std::map<Time, boost::shared_ptr<NodeValues> >::const_iterator i =
+            nodeValues_.find(term);
+        if (i != nodeValues_.end())
+            return i->second;
+
+        const Real kappa = model_->kappa(), theta = model_->theta(),
+            sigma = model_->sigma(), v0 = model_->v0(), rho = model_->rho();
+        const Real c_inf = std::min(10.0, std::max(0.0001,
+                std::sqrt(1.0-square<Real>()(rho))/sigma))
+                *(v0 + kappa*theta*term);
+
+        boost::shared_ptr<NodeValues> values(
+                                    new NodeValues(*integration_, c_inf));
+        for (Size j=1; j<=2 && values; ++j) {
+            // spot, strike and discount ratio only enter operator()
+            const Fj_Helper f(kappa, theta, sigma, v0, 1.0, rho, this,
+                              cpxLog_, term, 1.0, 1.0, j);
+            for (Size k=0; k<values->size(); ++k) {
+                const Real phi = values->node(k);
+                if (phi == 0.0) {
+                    // the limit is taken in operator(); no caching
+                    values.reset();
+                    break;
+                }
+                values->setValues(j, k, f.exponent(phi), f.addOnTerm(phi));
+            }
+        }
+        nodeValues_[term] = values;
+        return values;
     }
 
     void AnalyticHestonEngine::calculate() const
@@ -401,6 +466,23 @@ namespace QuantLib {
         const Real strikePrice = payoff->strike();
         const Real term = process->time(arguments_.exercise->lastDate());
 
+        if (cpxLog_ == Gatheral && !integration_->isAdaptiveIntegration()) {
+            const boost::shared_ptr<NodeValues> values = nodeValues(term);
+            if (values) {
+                const Real ratio = riskFreeDiscount/dividendDiscount;
+                const Real s = (std::log(spotPrice) - std::log(ratio))
+                             - std::log(strikePrice);
+                const Real p1 = values->integral(1, s)/M_PI;
+                const Real p2 = values->integral(2, s)/M_PI;
+                results_.value = optionValue(*payoff,
+                                             spotPrice, dividendDiscount,
+                                             strikePrice, riskFreeDiscount,
+                                             p1, p2);
+                evaluations_ = 2*values->size();
+                return;
+            }
+        }
+
         doCalculation(riskFreeDiscount,
                       dividendDiscount,
                       spotPrice,
@@ -512,6 +594,41 @@ namespace QuantLib {
         }
     }
 
+    void AnalyticHestonEngine::Integration::nodes(Real c_inf,
+                                                  Array& nodes,
+                                                  Array& weights,
+                                                  Array& scales) const {
+        QL_REQUIRE(gaussianQuadrature_,
+                   "adaptive integrations have no fixed nodes");
+        const Array& x = gaussianQuadrature_->x();
+        const Size n = x.size();
+        nodes = Array(n);
+        weights = gaussianQuadrature_->weights();
+        scales = Array(n);
+
+        switch(intAlgo_) {
+          case GaussLaguerre:
+            std::copy(x.begin(), x.end(), nodes.begin());
+            std::fill(scales.begin(), scales.end(), 1.0);
+            break;
+          case GaussLegendre:
+          case GaussChebyshev:
+          case GaussChebyshev2nd:
+            // same mapping of [-1,1] onto [0,inf) as in calculate()
+            for (Size i=0; i<n; ++i) {
+                if ((x[i]+1.0)*c_inf > QL_EPSILON) {
+                    nodes[i] = -std::log(0.5*x[i]+0.5)/c_inf;
+                    scales[i] = (x[i]+1.0)*c_inf;
+                } else {
+                    nodes[i] = scales[i] = 0.0;
+                }
+            }
+            break;
+          default:
+            QL_FAIL("unknwon integration algorithm");
+        }
+    }
+
     bool AnalyticHestonEngine::Integration::isAdaptiveIntegration() const {
         return intAlgo_ == GaussLobatto
             || intAlgo_ == GaussKronrod
@@ -562,4 +679,58 @@ namespace QuantLib {
 
         return retVal;
      }
+
+
+    AnalyticHestonEngine::NodeValues::NodeValues(
+                                        const Integration& integration,
+                                        Real c_inf, Real minNode) {
+        Array nodes, weights, scales;
+        integration.nodes(c_inf, nodes, weights, scales);
+
+        // nodes with null scale don't contribute to the integral
+        const Size n = std::count_if(scales.begin(), scales.end(),
+                                     std::bind2nd(std::not_equal_to<Real>(),
+                                                  0.0));
+        nodes_ = Array(n);
+        weights_ = Array(n);
+        scales_ = Array(n);
+        for (Size i=0, k=0; i<nodes.size(); ++i) {
+            if (scales[i] != 0.0) {
+                nodes_[k] = std::max(minNode, nodes[i]);
+                weights_[k] = weights[i];
+                scales_[k] = scales[i];
+                ++k;
+            }
+        }
+        for (Size j=0; j<2; ++j) {
+            exponents_[j].resize(n);
+            addOns_[j].resize(n);
+        }
+    }
+
+    void AnalyticHestonEngine::NodeValues::setValues(
+                                        Size j, Size i,
+                                        const std::complex<Real>& exponent,
+                                        const std::complex<Real>& addOn) {
+        QL_REQUIRE(j == 1 || j == 2, "invalid probability index " << j);
+        exponents_[j-1][i] = exponent;
+        addOns_[j-1][i] = addOn;
+    }
+
+    Real AnalyticHestonEngine::NodeValues::integral(Size j, Real s) const {
+        QL_REQUIRE(j == 1 || j == 2, "invalid probability index " << j);
+        const std::vector<std::complex<Real> >& e = exponents_[j-1];
+        const std::vector<std::complex<Real> >& a = addOns_[j-1];
+
+        // same summation order as GaussianQuadrature
+        Real sum = 0.0;
+        for (Integer i = Integer(size())-1; i >= 0; --i) {
+            const Real phi = nodes_[i];
+            const Real f =
+                std::exp(e[i] + std::complex<Real>(0.0, phi*s) + a[i]).imag()
+                /phi;
+            sum += weights_[i] * (f/scales_[i]);
+        }
+        return sum;
+    }
 }
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2004, 2005, 2008 Klaus Spanderen
- Copyright (C) 2007 StatPro Italia srl
+ Copyright (C) 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -33,6 +33,7 @@
 
 #include <boost/function.hpp>
 #include <complex>
+#include <map>
 
 namespace QuantLib {
 
@@ -69,6 +70,17 @@ namespace QuantLib {
         J. Gatheral, The Volatility Surface: A Practitioner's Guide,
         Wiley Finance
 
+        When Gatheral's formula is used together with a non-adaptive
+        integration, the integrands are evaluated on the same nodes
+        for all options with a given maturity, and their
+        strike-independent part is the most expensive to calculate.
+        The latter is therefore stored for each maturity and reused
+        for any strike until the engine is notified of a change in
+        the model; thus, pricing a strip of strikes (e.g., the
+        helpers of a model calibration sharing this engine) only
+        requires a full evaluation of the integrands once per
+        maturity.
+
         \ingroup vanillaengines
 
         \test the correctness of the returned value is tested by
@@ -81,6 +93,7 @@ namespace QuantLib {
                                     VanillaOption::results> {
       public:
         class Integration;
+        class NodeValues;
         enum ComplexLogFormula { Gatheral, BranchCorrection };
 
         // Simple to use constructor: Using adaptive
@@ -103,6 +116,7 @@ namespace QuantLib {
 
 
         void calculate() const;
+        void update();
         Size numberOfEvaluations() const;
 
         static void doCalculation(Real riskFreeDiscount,
@@ -128,12 +142,12 @@ namespace QuantLib {
       private:
         class Fj_Helper;
 
+        boost::shared_ptr<NodeValues> nodeValues(Time term) const;
+
         mutable Size evaluations_;
         const ComplexLogFormula cpxLog_;
         const boost::shared_ptr<Integration> integration_;
-
-
-
+        mutable std::map<Time, boost::shared_ptr<NodeValues> > nodeValues_;
     };
 
 
@@ -166,6 +180,14 @@ namespace QuantLib {
         Size numberOfEvaluations() const;
         bool isAdaptiveIntegration() const;
 
+        //! nodes of non-adaptive algorithms
+        /*! calculate(c_inf, f) returns the sum, for i going from
+            n-1 down to 0, of weights[i]*(f(nodes[i])/scales[i]);
+            terms with a null scale are not included.
+        */
+        void nodes(Real c_inf,
+                   Array& nodes, Array& weights, Array& scales) const;
+
       private:
         enum Algorithm
             { GaussLobatto, GaussKronrod, Simpson, Trapezoid,
@@ -183,6 +205,38 @@ namespace QuantLib {
         const boost::shared_ptr<GaussianQuadrature> gaussianQuadrature_;
     };
 
+    //! integrands of the Heston engines on the nodes of an integration
+    /*! The integrands used for the calculation of the probabilities
+        \f$ P_1 \f$ and \f$ P_2 \f$ have the form
+        \f[
+            f_j(\phi) = \frac{1}{\phi}
+                \mathrm{Im} \left[ e^{E_j(\phi) + i \phi s + A_j(\phi)}
+                            \right]
+        \f]
+        where only \f$ s \f$ depends on the strike. This class
+        stores the values of \f$ E_j \f$ and \f$ A_j \f$ on the
+        nodes of a non-adaptive integration, so that the integrals
+        can be calculated for any strike without evaluating them
+        again.
+    */
+    class AnalyticHestonEngine::NodeValues {
+      public:
+        /*! nodes below the given minimum are raised to it */
+        NodeValues(const Integration& integration, Real c_inf,
+                   Real minNode = 0.0);
+        Size size() const { return nodes_.size(); }
+        Real node(Size i) const { return nodes_[i]; }
+        //! sets the values of \f$ E_j \f$ and \f$ A_j \f$ at the i-th node
+        void setValues(Size j, Size i,
+                       const std::complex<Real>& exponent,
+                       const std::complex<Real>& addOn = 0.0);
+        //! integral of \f$ f_j \f$ for the given \f$ s \f$
+        Real integral(Size j, Real s) const;
+      private:
+        Array nodes_, weights_, scales_;
+        std::vector<std::complex<Real> > exponents_[2], addOns_[2];
+    };
+
     // inline
 
     inline 
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2010 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -37,7 +38,9 @@ namespace QuantLib {
             Time term, Real strike, Size j);
     
         Real operator()(Real phi) const;
-        
+        // strike-independent part of the exponent
+        std::complex<Real> exponent(Real phi) const;
+
       private:
         const Size j_;    
         const Time term_;
@@ -81,7 +84,13 @@ namespace QuantLib {
         // avoid numeric overflow for phi->0. 
         // todo: use l'Hospital's rule use to get lim_{phi->0}
         phi = std::max(Real(std::numeric_limits<float>::epsilon()), phi);
-        
+
+        return std::exp(exponent(phi)
+                        + std::complex<Real>(0.0, phi*(x_ - sx_))).imag()/phi;
+    }
+
+    std::complex<Real>
+    AnalyticPTDHestonEngine::Fj_Helper::exponent(Real phi) const {
         std::complex<Real> D = 0.0;
         std::complex<Real> C = 0.0;
 
@@ -118,8 +127,7 @@ namespace QuantLib {
                     + std::complex<Real>(0.0, phi*(r_[i-1]-q_[i-1])*tau) + C;
             }
         }
-        return std::exp(v0_*D+C+std::complex<Real>(0.0, phi*(x_ - sx_))).imag()
-                /phi; 
+        return v0_*D+C;
     }
 
     AnalyticPTDHestonEngine::AnalyticPTDHestonEngine(
@@ -185,11 +193,21 @@ namespace QuantLib {
                 std::sqrt(1.0-square<Real>()(rhoAvg))/sigmaAvg))
                 *(v0 + kappaAvg*thetaAvg*term);
 
-        const Real p1 = integration_->calculate(c_inf,
+        Real p1, p2;
+        const boost::shared_ptr<AnalyticHestonEngine::NodeValues> values =
+            integration_->isAdaptiveIntegration()
+            ? boost::shared_ptr<AnalyticHestonEngine::NodeValues>()
+            : nodeValues(term, c_inf);
+        if (values) {
+            const Real s = std::log(spotPrice) - std::log(strike);
+            p1 = values->integral(1, s)/M_PI;
+            p2 = values->integral(2, s)/M_PI;
+        } else {
+            p1 = integration_->calculate(c_inf,
                                 Fj_Helper(model_, term, strike, 1))/M_PI;
-
-        const Real p2 = integration_->calculate(c_inf,
+            p2 = integration_->calculate(c_inf,
                                 Fj_Helper(model_, term, strike, 2))/M_PI;
+        }
 
         switch (payoff->optionType())
         {
@@ -205,4 +223,33 @@ namespace QuantLib {
             QL_FAIL("unknown option type");
         }
     }
+
+    void AnalyticPTDHestonEngine::update() {
+        nodeValues_.clear();
+        GenericModelEngine<PiecewiseTimeDependentHestonModel,
+                           VanillaOption::arguments,
+                           VanillaOption::results>::update();
+    }
+
+    boost::shared_ptr<AnalyticHestonEngine::NodeValues>
+    AnalyticPTDHestonEngine::nodeValues(Time term, Real c_inf) const {
+        std::map<Time, boost::shared_ptr<AnalyticHestonEngine::NodeValues> >
+            ::const_iterator i = nodeValues_.find(term);
+        if (i != nodeValues_.end())
+            return i->second;
+
+        // nodes are floored as in Fj_Helper::operator()
+        boost::shared_ptr<AnalyticHestonEngine::NodeValues> values(
+            new AnalyticHestonEngine::NodeValues(
+                *integration_, c_inf,
+                std::numeric_limits<float>::epsilon()));
+        for (Size j=1; j<=2; ++j) {
+            // the strike only enters operator()
+            const Fj_Helper f(model_, term, 1.0, j);
+            for (Size k=0; k<values->size(); ++k)
+                values->setValues(j, k, f.exponent(values->node(k)));
+        }
+        nodeValues_[term] = values;
+        return values;
+    }
 }
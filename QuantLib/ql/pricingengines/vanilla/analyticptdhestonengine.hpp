@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2010 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -27,7 +28,7 @@
 #include <ql/instruments/vanillaoption.hpp>
 #include <ql/pricingengines/vanilla/analytichestonengine.hpp>
 #include <ql/models/equity/piecewisetimedependenthestonmodel.hpp>
-
+#include <map>
 
 namespace QuantLib {
 
@@ -47,6 +48,10 @@ namespace QuantLib {
         transform methods: application to Heston’s model,
         http://arxiv.org/pdf/0708.2020
 
+        As in AnalyticHestonEngine, the strike-independent part of
+        the integrands is stored for each maturity when a
+        non-adaptive integration is used.
+
         \ingroup vanillaengines
     */
     class AnalyticPTDHestonEngine
@@ -70,11 +75,18 @@ namespace QuantLib {
             Size integrationOrder = 144);
 
         void calculate() const;
+        void update();
 
       private:
         class Fj_Helper;
-        
+
+        boost::shared_ptr<AnalyticHestonEngine::NodeValues>
+        nodeValues(Time term, Real c_inf) const;
+
         const boost::shared_ptr<AnalyticHestonEngine::Integration> integration_;
+        mutable std::map<Time,
+                         boost::shared_ptr<AnalyticHestonEngine::NodeValues> >
+                                                                nodeValues_;
     };
 }
 
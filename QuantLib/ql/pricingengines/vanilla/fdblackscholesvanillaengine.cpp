@@ -21,11 +21,14 @@
 
 #include <ql/exercise.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+#include <ql/termstructures/volatility/equityfx/blackvariancecurve.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmblackscholessolver.hpp>
 #include <ql/methods/finitedifferences/utilities/fdminnervaluecalculator.hpp>
 #include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmblackscholesmesher.hpp>
+#include <ql/methods/finitedifferences/meshers/fdmblackscholesmultistrikemesher.hpp>
 #include <ql/methods/finitedifferences/stepconditions/fdmstepconditioncomposite.hpp>
 #include <ql/pricingengines/vanilla/fdblackscholesvanillaengine.hpp>
 
@@ -47,16 +50,40 @@ namespace QuantLib {
 
     void FdBlackScholesVanillaEngine::calculate() const {
 
+        // cache lookup for precalculated results
+        if (cache_.find(arguments_, results_))
+            return;
+
         // 1. Mesher
         const boost::shared_ptr<StrikedTypePayoff> payoff =
             boost::dynamic_pointer_cast<StrikedTypePayoff>(arguments_.payoff);
 
         const Time maturity = process_->time(arguments_.exercise->lastDate());
-        const boost::shared_ptr<Fdm1dMesher> equityMesher(
-            new FdmBlackScholesMesher(
+        boost::shared_ptr<Fdm1dMesher> equityMesher;
+        if (strikes_.empty()) {
+            equityMesher = boost::shared_ptr<Fdm1dMesher>(
+                new FdmBlackScholesMesher(
                     xGrid_, process_, maturity, payoff->strike(), 
                     Null<Real>(), Null<Real>(), 0.0001, 1.5, 
                     std::pair<Real, Real>(payoff->strike(), 0.1)));
+        }
+        else {
+            QL_REQUIRE(arguments_.cashFlow.empty(),"multiple strikes engine "
+                       "does not work with discrete dividends");
+            QL_REQUIRE(!localVol_, "multiple strikes engine "
+                       "does not work with local volatility");
+            // homogeneity in the spot doesn't hold with a smile
+            const boost::shared_ptr<BlackVolTermStructure> vol =
+                process_->blackVolatility().currentLink();
+            QL_REQUIRE(boost::dynamic_pointer_cast<BlackConstantVol>(vol) ||
+                       boost::dynamic_pointer_cast<BlackVarianceCurve>(vol),
+                       "multiple strikes engine requires a "
+                       "strike-independent volatility");
+            equityMesher = boost::shared_ptr<Fdm1dMesher>(
+                new FdmBlackScholesMultiStrikeMesher(
+                    xGrid_, process_, maturity, strikes_, 0.0001, 1.5,
+                    std::pair<Real, Real>(payoff->strike(), 0.075)));
+        }
         
         const boost::shared_ptr<FdmMesher> mesher (
             new FdmMesherComposite(equityMesher));
@@ -91,5 +118,43 @@ namespace QuantLib {
         results_.delta = solver->deltaAt(spot);
         results_.gamma = solver->gammaAt(spot);
         results_.theta = solver->thetaAt(spot);
+
+        // only plain-vanilla payoffs are homogeneous in the spot and
+        // the strike; results for other payoffs (e.g., digitals) can't
+        // be rescaled and must not be cached under plain-vanilla keys.
+        if (!boost::dynamic_pointer_cast<PlainVanillaPayoff>(payoff))
+            return;
+
+        // results previously cached for the same exercise and option
+        // type are replaced, so that the cache holds at most one strip
+        // of strikes for each of them.
+        cache_.removeStrip(arguments_.exercise, payoff->optionType());
+
+        // the solution for the other strikes follows from the
+        // homogeneity of the payoff and of the process in the spot.
+        // Results are added to the ones for other exercises, so that
+        // a strip of maturities needs one rollback per maturity.
+        for (Size i=0; i < strikes_.size(); ++i) {
+            const Real d = payoff->strike()/strikes_[i];
+
+            DividendVanillaOption::results results;
+            results.value = solver->valueAt(spot*d)/d;
+            results.delta = solver->deltaAt(spot*d);
+            results.gamma = solver->gammaAt(spot*d)*d;
+            results.theta = solver->thetaAt(spot*d)/d;
+            cache_.add(arguments_.exercise, payoff->optionType(),
+                       strikes_[i], results);
+        }
+    }
+
+    void FdBlackScholesVanillaEngine::update() {
+        cache_.clear();
+        DividendVanillaOption::engine::update();
+    }
+
+    void FdBlackScholesVanillaEngine::enableMultipleStrikesCaching(
+                                        const std::vector<Real>& strikes) {
+        strikes_ = strikes;
+        cache_.clear();
     }
 }
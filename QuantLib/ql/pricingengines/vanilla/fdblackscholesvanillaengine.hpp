@@ -28,6 +28,7 @@
 
 #include <ql/pricingengine.hpp>
 #include <ql/instruments/dividendvanillaoption.hpp>
+#include <ql/pricingengines/vanilla/multiplestrikescache.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 
 namespace QuantLib {
@@ -39,6 +40,14 @@ namespace QuantLib {
         \test the correctness of the returned value is tested by
               reproducing results available in web/literature
               and comparison with Black pricing.
+
+        \warning When multiple strikes caching is enabled, the
+                 results for all strikes are obtained by scaling
+                 the solution for the strike of the priced option.
+                 This only holds when the volatility doesn't depend
+                 on the strike; therefore, the engine requires a
+                 BlackConstantVol or BlackVarianceCurve volatility
+                 and raises an error for any other term structure.
     */
     class GeneralizedBlackScholesProcess;
 
@@ -54,12 +63,21 @@ namespace QuantLib {
 
         void calculate() const;
 
+        // multiple strikes caching engine
+        void update();
+        void enableMultipleStrikesCaching(const std::vector<Real>& strikes);
+        //! number of results returned from the multiple-strikes cache
+        Size multipleStrikesCacheHits() const { return cache_.hits(); }
+
       private:
         const boost::shared_ptr<GeneralizedBlackScholesProcess> process_;
         const Size tGrid_, xGrid_, dampingSteps_;
         const FdmSchemeDesc schemeDesc_;
         const bool localVol_;
         const Real illegalLocalVolOverwrite_;
+
+        std::vector<Real> strikes_;
+        mutable MultipleStrikesCache cache_;
     };
 }
 
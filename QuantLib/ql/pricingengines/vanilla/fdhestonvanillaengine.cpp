@@ -115,28 +115,8 @@ namespace QuantLib {
     void FdHestonVanillaEngine::calculate() const {
 
         // cache lookup for precalculated results
-        for (Size i=0; i < cachedArgs2results_.size(); ++i) {
-            if (   cachedArgs2results_[i].first.exercise->type()
-                        == arguments_.exercise->type()
-                && cachedArgs2results_[i].first.exercise->dates()
-                        == arguments_.exercise->dates()) {
-                boost::shared_ptr<PlainVanillaPayoff> p1 =
-                    boost::dynamic_pointer_cast<PlainVanillaPayoff>(
-                                                            arguments_.payoff);
-                boost::shared_ptr<PlainVanillaPayoff> p2 =
-                    boost::dynamic_pointer_cast<PlainVanillaPayoff>(
-                                          cachedArgs2results_[i].first.payoff);
-
-                if (p1 && p1->strike()     == p2->strike()
-                       && p1->optionType() == p2->optionType()) {
-                    QL_REQUIRE(arguments_.cashFlow.empty(),
-                               "multiple strikes engine does "
-                               "not work with discrete dividends");
-                    results_ = cachedArgs2results_[i].second;
-                    return;
-                }
-            }
-        }
+        if (cache_.find(arguments_, results_))
+            return;
 
         const boost::shared_ptr<HestonProcess> process = model_->process();
 
@@ -152,27 +132,37 @@ namespace QuantLib {
         results_.gamma = solver->gammaAt(spot, v0);
         results_.theta = solver->thetaAt(spot, v0);
         
-        cachedArgs2results_.resize(strikes_.size());
         const boost::shared_ptr<StrikedTypePayoff> payoff =
             boost::dynamic_pointer_cast<StrikedTypePayoff>(arguments_.payoff);
+
+        // only plain-vanilla payoffs are homogeneous in the spot and
+        // the strike; results for other payoffs (e.g., digitals) can't
+        // be rescaled and must not be cached under plain-vanilla keys.
+        if (!boost::dynamic_pointer_cast<PlainVanillaPayoff>(payoff))
+            return;
+
+        // results previously cached for the same exercise and option
+        // type are replaced, so that the cache holds at most one strip
+        // of strikes for each of them.
+        cache_.removeStrip(arguments_.exercise, payoff->optionType());
+
+        // results are added to the ones for other exercises, so that
+        // a strip of maturities needs one rollback per maturity.
         for (Size i=0; i < strikes_.size(); ++i) {
-            cachedArgs2results_[i].first.exercise = arguments_.exercise;
-            cachedArgs2results_[i].first.payoff = 
-                boost::shared_ptr<PlainVanillaPayoff>(
-                    new PlainVanillaPayoff(payoff->optionType(), strikes_[i]));
             const Real d = payoff->strike()/strikes_[i];
-            
-            DividendVanillaOption::results& 
-                                results = cachedArgs2results_[i].second;
+
+            DividendVanillaOption::results results;
             results.value = solver->valueAt(spot*d, v0)/d;
             results.delta = solver->deltaAt(spot*d, v0);
             results.gamma = solver->gammaAt(spot*d, v0)*d;
-            results.theta = solver->thetaAt(spot*d, v0)/d;                
+            results.theta = solver->thetaAt(spot*d, v0)/d;
+            cache_.add(arguments_.exercise, payoff->optionType(),
+                       strikes_[i], results);
         }
     }
     
     void FdHestonVanillaEngine::update() {
-        cachedArgs2results_.clear();
+        cache_.clear();
         GenericModelEngine<HestonModel, DividendVanillaOption::arguments,
                            DividendVanillaOption::results>::update();
     }
@@ -180,6 +170,6 @@ namespace QuantLib {
     void FdHestonVanillaEngine::enableMultipleStrikesCaching(
                                         const std::vector<Real>& strikes) {
         strikes_ = strikes;
-        cachedArgs2results_.clear();
+        cache_.clear();
     }
 }
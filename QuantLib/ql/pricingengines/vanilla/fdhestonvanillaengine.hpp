@@ -27,6 +27,7 @@
 #define quantlib_fd_heston_vanilla_engine_hpp
 
 #include <ql/instruments/dividendvanillaoption.hpp>
+#include <ql/pricingengines/vanilla/multiplestrikescache.hpp>
 #include <ql/models/equity/hestonmodel.hpp>
 #include <ql/pricingengines/genericmodelengine.hpp>
 #include <ql/methods/finitedifferences/solvers/fdmsolverdesc.hpp>
@@ -59,6 +60,8 @@ namespace QuantLib {
         // multiple strikes caching engine
         void update();
         void enableMultipleStrikesCaching(const std::vector<Real>& strikes);
+        //! number of results returned from the multiple-strikes cache
+        Size multipleStrikesCacheHits() const { return cache_.hits(); }
         
         // helper method for Heston like engines
         FdmSolverDesc getSolverDesc(Real equityScaleFactor) const;
@@ -68,9 +71,7 @@ namespace QuantLib {
         const FdmSchemeDesc schemeDesc_;
         
         std::vector<Real> strikes_;
-        mutable std::vector<std::pair<DividendVanillaOption::arguments,
-                                      DividendVanillaOption::results> >
-                                                            cachedArgs2results_;
+        mutable MultipleStrikesCache cache_;
     };
 
 }
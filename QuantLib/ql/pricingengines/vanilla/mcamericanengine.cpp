@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2006 Klaus Spanderen
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -37,6 +38,8 @@ namespace QuantLib {
         LsmBasisSystem::PolynomType polynomType)
     : scalingValue_(1.0),
       payoff_      (payoff),
+      polynomOrder_(polynomOrder),
+      polynomType_ (polynomType),
       v_           (LsmBasisSystem::pathBasisSystem(polynomOrder,
                                                     polynomType)) {
 
@@ -78,4 +81,14 @@ namespace QuantLib {
         return v_;
     }
 
+    void AmericanPathPricer::basisValues(const std::vector<Real>& states,
+                                         Matrix& values) const {
+        QL_REQUIRE(values.columns() == v_.size(), "wrong matrix size");
+        LsmBasisSystem::pathBasisValues(polynomOrder_, polynomType_,
+                                        states, values);
+        // the payoff gives the last value
+        for (Size j=0; j<states.size(); ++j)
+            values[j][v_.size()-1] = payoff(states[j]);
+    }
+
 }
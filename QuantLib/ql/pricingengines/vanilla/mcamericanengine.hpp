@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2006 Klaus Spanderen
- Copyright (C) 2007 StatPro Italia srl
+ Copyright (C) 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -61,7 +61,8 @@ namespace QuantLib {
              BigNatural seed,
              Size polynomOrder,
              LsmBasisSystem::PolynomType polynomType,
-             Size nCalibrationSamples = Null<Size>());
+             Size nCalibrationSamples = Null<Size>(),
+             Size threads = Null<Size>());
 
         void calculate() const;
         
@@ -88,12 +89,16 @@ namespace QuantLib {
         Real operator()(const Path& path, Size t) const;
 
         std::vector<boost::function1<Real, Real> > basisSystem() const;
+        void basisValues(const std::vector<Real>& states,
+                         Matrix& values) const;
 
       protected:
         Real payoff(Real state) const;
 
         Real scalingValue_;
         const boost::shared_ptr<Payoff> payoff_;
+        Size polynomOrder_;
+        LsmBasisSystem::PolynomType polynomType_;
         std::vector<boost::function1<Real, Real> > v_;
     };
 
@@ -116,6 +121,7 @@ namespace QuantLib {
         MakeMCAmericanEngine& withPolynomOrder(Size polynomOrer);
         MakeMCAmericanEngine& withBasisSystem(LsmBasisSystem::PolynomType);
         MakeMCAmericanEngine& withCalibrationSamples(Size calibrationSamples);
+        MakeMCAmericanEngine& withThreads(Size threads);
 
         // conversion to pricing engine
         operator boost::shared_ptr<PricingEngine>() const;
@@ -128,6 +134,7 @@ namespace QuantLib {
         BigNatural seed_;
         Size polynomOrder_;
         LsmBasisSystem::PolynomType polynomType_;
+        Size threads_;
     };
 
     template <class RNG, class S> inline
@@ -138,14 +145,14 @@ namespace QuantLib {
         Size requiredSamples, Real requiredTolerance,
         Size maxSamples,BigNatural seed,
         Size polynomOrder, LsmBasisSystem::PolynomType polynomType,
-        Size nCalibrationSamples)
+        Size nCalibrationSamples, Size threads)
     : MCLongstaffSchwartzEngine<VanillaOption::engine,
                                 SingleVariate,RNG,S>(
                                          process, timeSteps, timeStepsPerYear,
                                          false, antitheticVariate,
                                          controlVariate, requiredSamples,
                                          requiredTolerance, maxSamples,
-                                         seed, nCalibrationSamples),
+                                         seed, nCalibrationSamples, threads),
       polynomOrder_(polynomOrder),
       polynomType_(polynomType) {}
 
@@ -252,7 +259,8 @@ namespace QuantLib {
       calibrationSamples_(2048),
       tolerance_(Null<Real>()), seed_(0),
       polynomOrder_(2),
-      polynomType_ (LsmBasisSystem::Monomial) {}
+      polynomType_ (LsmBasisSystem::Monomial),
+      threads_(Null<Size>()) {}
 
     template <class RNG, class S>
     inline MakeMCAmericanEngine<RNG,S>&
@@ -339,6 +347,13 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S>
+    inline MakeMCAmericanEngine<RNG,S>&
+    MakeMCAmericanEngine<RNG,S>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
 
     template <class RNG, class S>
     inline
@@ -359,7 +374,8 @@ namespace QuantLib {
                                      seed_,
                                      polynomOrder_,
                                      polynomType_,
-                                     calibrationSamples_));
+                                     calibrationSamples_,
+                                     threads_));
     }
 
 }
@@ -60,7 +60,9 @@ namespace QuantLib {
              Size requiredSamples,
              Real requiredTolerance,
              Size maxSamples,
-             BigNatural seed);
+             BigNatural seed,
+             Size threads = Null<Size>(),
+             Size blockSize = Null<Size>());
       protected:
         boost::shared_ptr<path_pricer_type> pathPricer() const;
     };
@@ -80,6 +82,8 @@ namespace QuantLib {
         MakeMCEuropeanEngine& withMaxSamples(Size samples);
         MakeMCEuropeanEngine& withSeed(BigNatural seed);
         MakeMCEuropeanEngine& withAntitheticVariate(bool b = true);
+        MakeMCEuropeanEngine& withThreads(Size threads);
+        MakeMCEuropeanEngine& withBlockSize(Size paths);
         // conversion to pricing engine
         operator boost::shared_ptr<PricingEngine>() const;
       private:
@@ -89,6 +93,7 @@ namespace QuantLib {
         Real tolerance_;
         bool brownianBridge_;
         BigNatural seed_;
+        Size threads_, blockSize_;
     };
 
     class EuropeanPathPricer : public PathPricer<Path> {
@@ -97,6 +102,8 @@ namespace QuantLib {
                            Real strike,
                            DiscountFactor discount);
         Real operator()(const Path& path) const;
+        void operator()(const PathBlock& paths,
+                        std::vector<Real>& values) const;
       private:
         PlainVanillaPayoff payoff_;
         DiscountFactor discount_;
@@ -116,7 +123,9 @@ namespace QuantLib {
              Size requiredSamples,
              Real requiredTolerance,
              Size maxSamples,
-             BigNatural seed)
+             BigNatural seed,
+             Size threads,
+             Size blockSize)
     : MCVanillaEngine<SingleVariate,RNG,S>(process,
                                            timeSteps,
                                            timeStepsPerYear,
@@ -126,7 +135,9 @@ namespace QuantLib {
                                            requiredSamples,
                                            requiredTolerance,
                                            maxSamples,
-                                           seed) {}
+                                           seed,
+                                           threads,
+                                           blockSize) {}
 
 
     template <class RNG, class S>
@@ -159,7 +170,8 @@ namespace QuantLib {
     : process_(process), antithetic_(false),
       steps_(Null<Size>()), stepsPerYear_(Null<Size>()),
       samples_(Null<Size>()), maxSamples_(Null<Size>()),
-      tolerance_(Null<Real>()), brownianBridge_(false), seed_(0) {}
+      tolerance_(Null<Real>()), brownianBridge_(false), seed_(0),
+      threads_(Null<Size>()), blockSize_(Null<Size>()) {}
 
     template <class RNG, class S>
     inline MakeMCEuropeanEngine<RNG,S>&
@@ -224,6 +236,20 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S>
+    inline MakeMCEuropeanEngine<RNG,S>&
+    MakeMCEuropeanEngine<RNG,S>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
+    template <class RNG, class S>
+    inline MakeMCEuropeanEngine<RNG,S>&
+    MakeMCEuropeanEngine<RNG,S>::withBlockSize(Size paths) {
+        blockSize_ = paths;
+        return *this;
+    }
+
     template <class RNG, class S>
     inline
     MakeMCEuropeanEngine<RNG,S>::operator boost::shared_ptr<PricingEngine>()
@@ -240,7 +266,9 @@ namespace QuantLib {
                                     antithetic_,
                                     samples_, tolerance_,
                                     maxSamples_,
-                                    seed_));
+                                    seed_,
+                                    threads_,
+                                    blockSize_));
     }
 
 
@@ -258,6 +286,16 @@ namespace QuantLib {
         return payoff_(path.back()) * discount_;
     }
 
+    inline void EuropeanPathPricer::operator()(
+                                      const PathBlock& paths,
+                                      std::vector<Real>& values) const {
+        QL_REQUIRE(paths.length() > 0, "the paths cannot be empty");
+        const Array& last = paths[paths.length()-1];
+        values.resize(last.size());
+        for (Size j=0; j<last.size(); ++j)
+            values[j] = payoff_(last[j]) * discount_;
+    }
+
 }
 
 
@@ -51,7 +51,8 @@ namespace QuantLib {
                Size requiredSamples,
                Real requiredTolerance,
                Size maxSamples,
-               BigNatural seed);
+               BigNatural seed,
+               Size threads = Null<Size>());
 
         void calculate() const;
         
@@ -81,6 +82,7 @@ namespace QuantLib {
         MakeMCHestonHullWhiteEngine& withAbsoluteTolerance(Real tolerance);
         MakeMCHestonHullWhiteEngine& withMaxSamples(Size samples);
         MakeMCHestonHullWhiteEngine& withSeed(BigNatural seed);
+        MakeMCHestonHullWhiteEngine& withThreads(Size threads);
         // conversion to pricing engine
         operator boost::shared_ptr<PricingEngine>() const;
       private:
@@ -89,6 +91,7 @@ namespace QuantLib {
         bool antithetic_, controlVariate_;
         Real tolerance_;
         BigNatural seed_;
+        Size threads_;
     };
 
 
@@ -118,11 +121,12 @@ namespace QuantLib {
               Size requiredSamples,
               Real requiredTolerance,
               Size maxSamples,
-              BigNatural seed)
+              BigNatural seed,
+              Size threads)
     : base_type(process, timeSteps, timeStepsPerYear,
                 false, antitheticVariate,
                 controlVariate, requiredSamples,
-                requiredTolerance, maxSamples, seed),
+                requiredTolerance, maxSamples, seed, threads),
       process_(process) {}
 
     template<class RNG,class S>
@@ -228,7 +232,7 @@ namespace QuantLib {
       steps_(Null<Size>()), stepsPerYear_(Null<Size>()),
       samples_(Null<Size>()), maxSamples_(Null<Size>()),
       antithetic_(false), controlVariate_(false),
-      tolerance_(Null<Real>()), seed_(0) {}
+      tolerance_(Null<Real>()), seed_(0), threads_(Null<Size>()) {}
 
     template <class RNG, class S>
     inline MakeMCHestonHullWhiteEngine<RNG,S>&
@@ -293,6 +297,13 @@ namespace QuantLib {
         return *this;
     }
 
+    template <class RNG, class S>
+    inline MakeMCHestonHullWhiteEngine<RNG,S>&
+    MakeMCHestonHullWhiteEngine<RNG,S>::withThreads(Size threads) {
+        threads_ = threads;
+        return *this;
+    }
+
     template <class RNG, class S>
     inline
     MakeMCHestonHullWhiteEngine<RNG,S>::operator
@@ -310,7 +321,8 @@ namespace QuantLib {
                                            samples_,
                                            tolerance_,
                                            maxSamples_,
-                                           seed_));
+                                           seed_,
+                                           threads_));
     }
 
 }
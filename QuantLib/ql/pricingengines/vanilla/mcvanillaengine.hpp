@@ -65,7 +65,9 @@ namespace QuantLib {
                         Size requiredSamples,
                         Real requiredTolerance,
                         Size maxSamples,
-                        BigNatural seed);
+                        BigNatural seed,
+                        Size threads = Null<Size>(),
+                        Size blockSize = Null<Size>());
         // McSimulation implementation
         TimeGrid timeGrid() const;
         boost::shared_ptr<path_generator_type> pathGenerator() const {
@@ -102,8 +104,11 @@ namespace QuantLib {
                           Size requiredSamples,
                           Real requiredTolerance,
                           Size maxSamples,
-                          BigNatural seed)
-    : McSimulation<MC,RNG,S>(antitheticVariate, controlVariate),
+                          BigNatural seed,
+                          Size threads,
+                          Size blockSize)
+    : McSimulation<MC,RNG,S>(antitheticVariate, controlVariate,
+                             threads, blockSize),
       process_(process), timeSteps_(timeSteps),
       timeStepsPerYear_(timeStepsPerYear),
       requiredSamples_(requiredSamples), maxSamples_(maxSamples),
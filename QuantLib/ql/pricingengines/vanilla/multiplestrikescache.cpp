@@ -0,0 +1,92 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include <ql/pricingengines/vanilla/multiplestrikescache.hpp>
+#include <ql/exercise.hpp>
+
+namespace QuantLib {
+
+    namespace {
+
+        bool sameExercise(const Exercise& e1, const Exercise& e2) {
+            return e1.type() == e2.type() && e1.dates() == e2.dates();
+        }
+
+    }
+
+    bool MultipleStrikesCache::find(
+                         const DividendVanillaOption::arguments& arguments,
+                         DividendVanillaOption::results& results) const {
+        boost::shared_ptr<PlainVanillaPayoff> payoff =
+            boost::dynamic_pointer_cast<PlainVanillaPayoff>(arguments.payoff);
+        if (!payoff)
+            return false;
+
+        for (Size i=0; i<cached_.size(); ++i) {
+            const DividendVanillaOption::arguments& cachedArgs =
+                cached_[i].first;
+            boost::shared_ptr<PlainVanillaPayoff> cachedPayoff =
+                boost::dynamic_pointer_cast<PlainVanillaPayoff>(
+                                                          cachedArgs.payoff);
+            if (sameExercise(*cachedArgs.exercise, *arguments.exercise)
+                && cachedPayoff->strike() == payoff->strike()
+                && cachedPayoff->optionType() == payoff->optionType()) {
+                QL_REQUIRE(arguments.cashFlow.empty(),
+                           "multiple strikes engine does "
+                           "not work with discrete dividends");
+                results = cached_[i].second;
+                ++hits_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void MultipleStrikesCache::removeStrip(
+                               const boost::shared_ptr<Exercise>& exercise,
+                               Option::Type type) {
+        for (Size i=cached_.size(); i > 0; --i) {
+            const DividendVanillaOption::arguments& cachedArgs =
+                cached_[i-1].first;
+            if (sameExercise(*cachedArgs.exercise, *exercise)
+                && boost::dynamic_pointer_cast<PlainVanillaPayoff>(
+                               cachedArgs.payoff)->optionType() == type)
+                cached_.erase(cached_.begin()+i-1);
+        }
+    }
+
+    void MultipleStrikesCache::add(
+                         const boost::shared_ptr<Exercise>& exercise,
+                         Option::Type type,
+                         Real strike,
+                         const DividendVanillaOption::results& results) {
+        std::pair<DividendVanillaOption::arguments,
+                  DividendVanillaOption::results> entry;
+        entry.first.exercise = exercise;
+        entry.first.payoff = boost::shared_ptr<PlainVanillaPayoff>(
+                                       new PlainVanillaPayoff(type, strike));
+        entry.second = results;
+        cached_.push_back(entry);
+    }
+
+    void MultipleStrikesCache::clear() {
+        cached_.clear();
+    }
+
+}
@@ -0,0 +1,67 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file multiplestrikescache.hpp
+    \brief cache of results for multiple-strikes finite-difference engines
+*/
+
+#ifndef quantlib_multiple_strikes_cache_hpp
+#define quantlib_multiple_strikes_cache_hpp
+
+#include <ql/instruments/dividendvanillaoption.hpp>
+#include <vector>
+
+namespace QuantLib {
+
+    //! cache of results for multiple-strikes finite-difference engines
+    /*! The cache holds the results obtained from a single rollback
+        for a strip of strikes. Results are keyed by exercise, option
+        type and strike; at most one strip is kept for each exercise
+        and option type, so that strips of different maturities can
+        be cached at the same time.
+    */
+    class MultipleStrikesCache {
+      public:
+        MultipleStrikesCache() : hits_(0) {}
+        /*! returns true and copies the cached results if the option
+            described by the given arguments was priced as part of
+            a strip.
+        */
+        bool find(const DividendVanillaOption::arguments& arguments,
+                  DividendVanillaOption::results& results) const;
+        //! removes the strip cached for the given exercise and type
+        void removeStrip(const boost::shared_ptr<Exercise>& exercise,
+                         Option::Type type);
+        //! adds the results for a strike of the strip
+        void add(const boost::shared_ptr<Exercise>& exercise,
+                 Option::Type type,
+                 Real strike,
+                 const DividendVanillaOption::results& results);
+        void clear();
+        //! number of results returned from the cache so far
+        Size hits() const { return hits_; }
+      private:
+        std::vector<std::pair<DividendVanillaOption::arguments,
+                              DividendVanillaOption::results> > cached_;
+        mutable Size hits_;
+    };
+
+}
+
+#endif
@@ -59,6 +59,12 @@ namespace QuantLib {
         return retVal;
     }
 
+    void BatesProcess::evolve(Time t0, const Matrix& x0,
+                              Time dt, const Matrix& dw, Matrix& x) const {
+        // jumps are not vectorized; each path is evolved separately
+        StochasticProcess::evolve(t0, x0, dt, dw, x);
+    }
+
     Size BatesProcess::factors() const {
         return 4;
     }
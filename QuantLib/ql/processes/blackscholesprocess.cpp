@@ -78,6 +78,37 @@ namespace QuantLib {
                          stdDeviation(t0,x0,dt)*dw);
     }
 
+    void GeneralizedBlackScholesProcess::evolve(Time t0, const Array& x0,
+                                                Time dt, const Array& dw,
+                                                Array& x) const {
+        const boost::shared_ptr<LocalVolTermStructure>& localVol =
+            *localVolatility();
+        bool flatInSpace =
+            boost::dynamic_pointer_cast<LocalConstantVol>(localVol) ||
+            boost::dynamic_pointer_cast<LocalVolCurve>(localVol);
+        if (!flatInSpace ||
+            !boost::dynamic_pointer_cast<EulerDiscretization>(
+                                                           discretization_)) {
+            StochasticProcess1D::evolve(t0, x0, dt, dw, x);
+            return;
+        }
+
+        QL_REQUIRE(dw.size() == x0.size(),
+                   "number of paths (" << x0.size()
+                   << ") and of random draws (" << dw.size()
+                   << ") differ");
+        QL_REQUIRE(x.size() == x0.size(),
+                   "wrong size for the evolved block");
+        if (x0.empty())
+            return;
+
+        // drift and diffusion are the same for all paths
+        Real drift = discretization_->drift(*this,t0,x0[0],dt);
+        Real stdDev = stdDeviation(t0,x0[0],dt);
+        for (Size j=0; j<x0.size(); ++j)
+            x[j] = x0[j] * std::exp(drift + stdDev*dw[j]);
+    }
+
     Time GeneralizedBlackScholesProcess::time(const Date& d) const {
         return riskFreeRate_->dayCounter().yearFraction(
                                            riskFreeRate_->referenceDate(), d);
@@ -67,6 +67,15 @@ namespace QuantLib {
         */
         Real expectation(Time t0, Real x0, Time dt) const;
         Real evolve(Time t0, Real x0, Time dt, Real dw) const;
+        /*! \note the block is evolved in a single pass when the
+                  Euler discretization is used and the local
+                  volatility doesn't depend on the underlying value,
+                  i.e., for constant or strike-independent Black
+                  volatilities; otherwise, each path is evolved
+                  separately.
+        */
+        void evolve(Time t0, const Array& x0,
+                    Time dt, const Array& dw, Array& x) const;
         //@}
         Time time(const Date&) const;
         //! \name Observer interface
@@ -44,4 +44,22 @@ namespace QuantLib {
         return sigma_ * x;
     }
 
+    void GeometricBrownianMotionProcess::evolve(Time, const Array& x0,
+                                                Time dt, const Array& dw,
+                                                Array& x) const {
+        QL_REQUIRE(dw.size() == x0.size(),
+                   "number of paths (" << x0.size()
+                   << ") and of random draws (" << dw.size()
+                   << ") differ");
+        QL_REQUIRE(x.size() == x0.size(),
+                   "wrong size for the evolved block");
+        // same Euler step as the single-path evolve(), without the
+        // virtual calls to drift() and diffusion()
+        Real sdt = std::sqrt(dt);
+        for (Size j=0; j<x0.size(); ++j) {
+            Real expectation = x0[j] + mue_*x0[j]*dt;
+            x[j] = expectation + sigma_*x0[j]*sdt*dw[j];
+        }
+    }
+
 }
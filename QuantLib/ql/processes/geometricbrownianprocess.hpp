@@ -46,6 +46,8 @@ namespace QuantLib {
         Real x0() const;
         Real drift(Time t, Real x) const;
         Real diffusion(Time t, Real x) const;
+        void evolve(Time t0, const Array& x0,
+                    Time dt, const Array& dw, Array& x) const;
       protected:
         double initialValue_;
         double mue_;
@@ -482,6 +482,120 @@ namespace QuantLib {
         return retVal;
     }
 
+    namespace {
+
+        // variance terms of the truncation and reflection schemes;
+        // each scheme gets its own loop over the paths below, so
+        // that no branch on the scheme is taken inside it.
+
+        struct PartialTruncationScheme {
+            static void terms(Real v, Real kappa, Real theta,
+                              Real& vol, Real& nu, Real& vnext) {
+                vol = (v > 0.0) ? std::sqrt(v) : 0.0;
+                nu = kappa*(theta - v);
+                vnext = v;
+            }
+        };
+
+        struct FullTruncationScheme {
+            static void terms(Real v, Real kappa, Real theta,
+                              Real& vol, Real& nu, Real& vnext) {
+                vol = (v > 0.0) ? std::sqrt(v) : 0.0;
+                nu = kappa*(theta - vol*vol);
+                vnext = v;
+            }
+        };
+
+        struct ReflectionScheme {
+            static void terms(Real v, Real kappa, Real theta,
+                              Real& vol, Real& nu, Real& vnext) {
+                vol = std::sqrt(std::fabs(v));
+                nu = kappa*(theta - vol*vol);
+                vnext = vol*vol;
+            }
+        };
+
+        template <class Scheme>
+        void evolvePaths(Size paths,
+                         Matrix::const_row_iterator s0,
+                         Matrix::const_row_iterator v0,
+                         Matrix::const_row_iterator dw0,
+                         Matrix::const_row_iterator dw1,
+                         Matrix::row_iterator s,
+                         Matrix::row_iterator v,
+                         Real rates, Real kappa, Real theta, Real sigma,
+                         Real rho, Time dt) {
+            const Real sdt = std::sqrt(dt);
+            const Real sqrhov = std::sqrt(1.0 - rho*rho);
+            for (Size j=0; j<paths; ++j) {
+                const Real sj = s0[j], vj = v0[j];
+                Real vol, nu, vnext;
+                Scheme::terms(vj, kappa, theta, vol, nu, vnext);
+                const Real vol2 = sigma * vol;
+                const Real mu = rates - 0.5 * vol * vol;
+
+                s[j] = sj * std::exp(mu*dt+vol*dw0[j]*sdt);
+                v[j] = vnext + nu*dt
+                       + vol2*sdt*(rho*dw0[j] + sqrhov*dw1[j]);
+            }
+        }
+
+    }
+
+    void HestonProcess::evolve(Time t0, const Matrix& x0,
+                               Time dt, const Matrix& dw,
+                               Matrix& x) const {
+        switch (discretization_) {
+          case PartialTruncation:
+          case FullTruncation:
+          case Reflection:
+            break;
+          default:
+            StochasticProcess::evolve(t0, x0, dt, dw, x);
+            return;
+        }
+
+        QL_REQUIRE(x0.rows() == 2 && dw.rows() == 2,
+                   "wrong number of state variables or factors");
+        QL_REQUIRE(dw.columns() == x0.columns(),
+                   "number of paths (" << x0.columns()
+                   << ") and of random draws (" << dw.columns()
+                   << ") differ");
+        QL_REQUIRE(x.rows() == x0.rows() && x.columns() == x0.columns(),
+                   "wrong size for the evolved block");
+
+        // same schemes as the single-path evolve(); the rates don't
+        // depend on the path and are only calculated once
+        const Real rates =
+              riskFreeRate_->forwardRate(t0, t0+dt, Continuous)
+            - dividendYield_->forwardRate(t0, t0+dt, Continuous);
+
+        Matrix::const_row_iterator s0 = x0.row_begin(0);
+        Matrix::const_row_iterator v0 = x0.row_begin(1);
+        Matrix::const_row_iterator dw0 = dw.row_begin(0);
+        Matrix::const_row_iterator dw1 = dw.row_begin(1);
+        Matrix::row_iterator s = x.row_begin(0);
+        Matrix::row_iterator v = x.row_begin(1);
+
+        switch (discretization_) {
+          case PartialTruncation:
+            evolvePaths<PartialTruncationScheme>(
+                                   x0.columns(), s0, v0, dw0, dw1, s, v,
+                                   rates, kappa_, theta_, sigma_, rho_, dt);
+            break;
+          case FullTruncation:
+            evolvePaths<FullTruncationScheme>(
+                                   x0.columns(), s0, v0, dw0, dw1, s, v,
+                                   rates, kappa_, theta_, sigma_, rho_, dt);
+            break;
+          default:
+            evolvePaths<ReflectionScheme>(
+                                   x0.columns(), s0, v0, dw0, dw1, s, v,
+                                   rates, kappa_, theta_, sigma_, rho_, dt);
+            break;
+        }
+    }
+
     const Handle<Quote>& HestonProcess::s0() const {
         return s0_;
     }
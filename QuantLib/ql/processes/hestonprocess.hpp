@@ -71,6 +71,13 @@ namespace QuantLib {
         Disposable<Array> apply(const Array& x0, const Array& dx) const;
         Disposable<Array> evolve(Time t0, const Array& x0,
                                  Time dt, const Array& dw) const;
+        /*! \note the block is evolved in a single pass for the
+                  PartialTruncation, FullTruncation and Reflection
+                  discretizations; otherwise, each path is evolved
+                  separately.
+        */
+        void evolve(Time t0, const Matrix& x0,
+                    Time dt, const Matrix& dw, Matrix& x) const;
 
         Real v0()    const { return v0_; }
         Real rho()   const { return rho_; }
@@ -160,4 +160,12 @@
 #endif
 
 
+// storage local to each thread, for PODs initialized by constants
+#if defined(BOOST_MSVC)       // Microsoft Visual C++
+#define QL_THREAD_LOCAL __declspec(thread)
+#else
+#define QL_THREAD_LOCAL __thread
+#endif
+
+
 #endif
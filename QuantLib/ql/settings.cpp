@@ -35,6 +35,16 @@ namespace QuantLib {
     : includeReferenceDateEvents_(false),
       enforcesTodaysHistoricFixings_(false) {}
 
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    void Settings::forkFrom(const Settings& settings) {
+        evaluationDate_ = settings.evaluationDate_.value();
+        includeReferenceDateEvents_ = settings.includeReferenceDateEvents_;
+        includeTodaysCashFlows_ = settings.includeTodaysCashFlows_;
+        enforcesTodaysHistoricFixings_ =
+            settings.enforcesTodaysHistoricFixings_;
+    }
+    #endif
+
     void Settings::anchorEvaluationDate() {
         // set to today's date if not already set.
         if (evaluationDate_.value() == Date())
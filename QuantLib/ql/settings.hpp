@@ -119,6 +119,9 @@ namespace QuantLib {
         bool& enforcesTodaysHistoricFixings();
         bool enforcesTodaysHistoricFixings() const;
       private:
+        #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+        void forkFrom(const Settings&);
+        #endif
         DateProxy evaluationDate_;
         bool includeReferenceDateEvents_;
         boost::optional<bool> includeTodaysCashFlows_;
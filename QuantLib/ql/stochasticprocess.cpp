@@ -59,6 +59,24 @@ namespace QuantLib {
         return apply(expectation(t0,x0,dt), stdDeviation(t0,x0,dt)*dw);
     }
 
+    void StochasticProcess::evolve(Time t0, const Matrix& x0,
+                                   Time dt, const Matrix& dw,
+                                   Matrix& x) const {
+        QL_REQUIRE(dw.columns() == x0.columns(),
+                   "number of paths (" << x0.columns()
+                   << ") and of random draws (" << dw.columns()
+                   << ") differ");
+        QL_REQUIRE(x.rows() == x0.rows() && x.columns() == x0.columns(),
+                   "wrong size for the evolved block");
+        Array state(x0.rows()), draws(dw.rows());
+        for (Size j=0; j<x0.columns(); ++j) {
+            std::copy(x0.column_begin(j), x0.column_end(j), state.begin());
+            std::copy(dw.column_begin(j), dw.column_end(j), draws.begin());
+            Array next = evolve(t0, state, dt, draws);
+            std::copy(next.begin(), next.end(), x.column_begin(j));
+        }
+    }
+
     Disposable<Array> StochasticProcess::apply(const Array& x0,
                                                const Array& dx) const {
         return x0 + dx;
@@ -98,6 +116,19 @@ namespace QuantLib {
         return apply(expectation(t0,x0,dt), stdDeviation(t0,x0,dt)*dw);
     }
 
+    void StochasticProcess1D::evolve(Time t0, const Array& x0,
+                                     Time dt, const Array& dw,
+                                     Array& x) const {
+        QL_REQUIRE(dw.size() == x0.size(),
+                   "number of paths (" << x0.size()
+                   << ") and of random draws (" << dw.size()
+                   << ") differ");
+        QL_REQUIRE(x.size() == x0.size(),
+                   "wrong size for the evolved block");
+        for (Size j=0; j<x0.size(); ++j)
+            x[j] = evolve(t0, x0[j], dt, dw[j]);
+    }
+
     Real StochasticProcess1D::apply(Real x0, Real dx) const {
         return x0 + dx;
     }
@@ -123,6 +123,19 @@ namespace QuantLib {
                                          const Array& x0,
                                          Time dt,
                                          const Array& dw) const;
+        /*! evolves a block of paths over the same time interval.
+            Each column of the matrices corresponds to a path; the
+            rows of \f$ \mathrm{x}_0 \f$ and \f$ \mathrm{x} \f$ hold
+            the state variables, and the rows of \f$ \Delta \mathrm{w}
+            \f$ hold the random factors. By default, it calls the
+            single-path evolve() method on each column; derived classes
+            can override it with a vectorized implementation.
+        */
+        virtual void evolve(Time t0,
+                            const Matrix& x0,
+                            Time dt,
+                            const Matrix& dw,
+                            Matrix& x) const;
         /*! applies a change to the asset value. By default, it
             returns \f$ \mathrm{x} + \Delta \mathrm{x} \f$.
         */
@@ -216,6 +229,14 @@ namespace QuantLib {
             standard deviation.
         */
         virtual Real evolve(Time t0, Real x0, Time dt, Real dw) const;
+        /*! evolves a block of paths over the same time interval;
+            \f$ x_0 \f$, \f$ \Delta w \f$ and \f$ x \f$ hold one
+            value per path. By default, it calls the single-path
+            evolve() method on each value; derived classes can
+            override it with a vectorized implementation.
+        */
+        virtual void evolve(Time t0, const Array& x0,
+                            Time dt, const Array& dw, Array& x) const;
         /*! applies a change to the asset value. By default, it
             returns \f$ x + \Delta x \f$.
         */
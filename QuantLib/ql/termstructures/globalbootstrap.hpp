@@ -0,0 +1,287 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file globalbootstrap.hpp
+    \brief simultaneous bootstrapper for most curve types
+*/
+
+#ifndef quantlib_global_bootstrap_hpp
+#define quantlib_global_bootstrap_hpp
+
+#include <ql/termstructures/bootstraphelper.hpp>
+#include <ql/termstructures/bootstraperror.hpp>
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <ql/utilities/dataformatters.hpp>
+
+namespace QuantLib {
+
+    //! Global bootstrapper for most curve types
+    /*! As in IterativeBootstrap, the curve is solved on a number of
+        market instruments passed as bootstrap helpers, whose
+        maturities mark the pillars of the interpolated curve.
+
+        Unlike IterativeBootstrap, which solves one pillar at a time
+        and, for non-local interpolations, repeats the whole sweep
+        until the nodes stop changing, this class solves for all
+        pillars at once: the quote errors of all helpers are driven
+        to zero by a Newton method with finite-difference Jacobian
+        and step halving. The starting point is given by a single
+        pillar-by-pillar sweep (using linear interpolation if the
+        target one is global) or, when available, by the previous
+        solution; if the latter fails to converge (e.g., after a
+        large move in the quotes) the solution is restarted once
+        from a sweep.
+
+        For local interpolations, the initial sweep already solves
+        the curve and no Newton step is taken.
+    */
+    template <class Curve>
+    class GlobalBootstrap {
+        typedef typename Curve::traits_type Traits;
+        typedef typename Curve::interpolator_type Interpolator;
+      public:
+        GlobalBootstrap();
+        void setup(Curve* ts);
+        void calculate() const;
+      private:
+        void initialize() const;
+        void sweep() const;
+        void solve() const;
+        Real errors(Array& result) const;
+        Curve* ts_;
+        Size n_;
+        Brent solver_;
+        mutable bool initialized_, validCurve_;
+        mutable Size firstAliveHelper_, alive_;
+        mutable std::vector<boost::shared_ptr<BootstrapError<Curve> > > errors_;
+    };
+
+
+    // template definitions
+
+    template <class Curve>
+    GlobalBootstrap<Curve>::GlobalBootstrap()
+    : ts_(0), initialized_(false), validCurve_(false) {}
+
+    template <class Curve>
+    void GlobalBootstrap<Curve>::setup(Curve* ts) {
+
+        ts_ = ts;
+        n_ = ts_->instruments_.size();
+        QL_REQUIRE(n_ > 0, "no bootstrap helpers given")
+        for (Size j=0; j<n_; ++j)
+            ts_->registerWith(ts_->instruments_[j]);
+
+        // do not initialize yet: instruments could be invalid here
+        // but valid later when bootstrapping is actually required
+    }
+
+    template <class Curve>
+    void GlobalBootstrap<Curve>::initialize() const {
+        // ensure helpers are sorted
+        std::sort(ts_->instruments_.begin(), ts_->instruments_.end(),
+                  detail::BootstrapHelperSorter());
+
+        // skip expired helpers
+        Date firstDate = Traits::initialDate(ts_);
+        QL_REQUIRE(ts_->instruments_[n_-1]->latestDate()>firstDate,
+                   "all instruments expired");
+        firstAliveHelper_ = 0;
+        while (ts_->instruments_[firstAliveHelper_]->latestDate() <= firstDate)
+            ++firstAliveHelper_;
+        alive_ = n_-firstAliveHelper_;
+        QL_REQUIRE(alive_>=Interpolator::requiredPoints-1,
+                   "not enough alive instruments: " << alive_ <<
+                   " provided, " << Interpolator::requiredPoints-1 <<
+                   " required");
+
+        // calculate dates and times, create errors_
+        std::vector<Date>& dates = ts_->dates_;
+        std::vector<Time>& times = ts_->times_;
+        dates.resize(alive_+1);
+        times.resize(alive_+1);
+        errors_.resize(alive_+1);
+        dates[0] = firstDate;
+        times[0] = ts_->timeFromReference(dates[0]);
+        for (Size i=1, j=firstAliveHelper_; j<n_; ++i, ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            dates[i] = helper->latestDate();
+            times[i] = ts_->timeFromReference(dates[i]);
+            // check for duplicated maturity
+            QL_REQUIRE(dates[i-1]!=dates[i],
+                       "more than one instrument with maturity " << dates[i]);
+            errors_[i] = boost::shared_ptr<BootstrapError<Curve> >(new
+                BootstrapError<Curve>(ts_, helper, i));
+        }
+
+        // set initial guess only if the current curve cannot be used as guess
+        if (!validCurve_ || ts_->data_.size()!=alive_+1) {
+            validCurve_ = false;
+            ts_->data_ = std::vector<Real>(alive_+1, Traits::initialValue(ts_));
+        }
+        initialized_ = true;
+    }
+
+    template <class Curve>
+    void GlobalBootstrap<Curve>::sweep() const {
+        const std::vector<Time>& times = ts_->times_;
+        const std::vector<Real>& data = ts_->data_;
+        for (Size i=1; i<=alive_; ++i) {
+            // bracket root and calculate guess
+            Real min = Traits::minValueAfter(i, ts_, false, firstAliveHelper_);
+            Real max = Traits::maxValueAfter(i, ts_, false, firstAliveHelper_);
+            Real guess = Traits::guess(i, ts_, false, firstAliveHelper_);
+            // adjust guess if needed
+            if (guess>=max)
+                guess = max - (max-min)/5.0;
+            else if (guess<=min)
+                guess = min + (max-min)/5.0;
+
+            // extend interpolation a point at a time. Global
+            // interpolations might oscillate on the partial curve;
+            // Linear is used instead, and the solution fixed later.
+            if (Interpolator::global)
+                ts_->interpolation_ = Linear().interpolate(
+                    times.begin(), times.begin()+i+1, data.begin());
+            else
+                ts_->interpolation_ = ts_->interpolator_.interpolate(
+                    times.begin(), times.begin()+i+1, data.begin());
+            ts_->interpolation_.update();
+
+            try {
+                solver_.solve(*errors_[i], ts_->accuracy_, guess, min, max);
+            } catch (std::exception &e) {
+                QL_FAIL("initial guess: failed at " << io::ordinal(i) <<
+                        " alive instrument, maturity " <<
+                        errors_[i]->helper()->latestDate() <<
+                        ", reference date " << ts_->dates_[0] <<
+                        ": " << e.what());
+            }
+        }
+    }
+
+    template <class Curve>
+    Real GlobalBootstrap<Curve>::errors(Array& result) const {
+        ts_->interpolation_.update();
+        Real norm = 0.0;
+        for (Size i=1; i<=alive_; ++i) {
+            result[i-1] = errors_[i]->helper()->quoteError();
+            norm = std::max(norm, std::fabs(result[i-1]));
+        }
+        // this also takes care of NaNs
+        return norm < QL_MAX_REAL ? norm : QL_MAX_REAL;
+    }
+
+    template <class Curve>
+    void GlobalBootstrap<Curve>::calculate() const {
+
+        // as in IterativeBootstrap, helpers might be date relative
+        // and change with the evaluation date.
+        if (!initialized_ || ts_->moving_)
+            initialize();
+
+        // setup helpers
+        for (Size j=firstAliveHelper_; j<n_; ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            // check for valid quote
+            QL_REQUIRE(helper->quote()->isValid(),
+                       io::ordinal(j+1) << " instrument (maturity: " <<
+                       helper->latestDate() << ") has an invalid quote");
+            // don't try this at home!
+            // This call creates helpers, and removes "const".
+            // There is a significant interaction with observability.
+            helper->setTermStructure(const_cast<Curve*>(ts_));
+        }
+
+        bool warmStart = validCurve_;
+        validCurve_ = false;
+        if (!warmStart)
+            sweep();
+        try {
+            solve();
+        } catch (std::exception&) {
+            if (!warmStart)
+                throw;
+            // the previous solution is too far from the new one;
+            // start again from scratch.
+            std::fill(ts_->data_.begin(), ts_->data_.end(),
+                      Traits::initialValue(ts_));
+            sweep();
+            solve();
+        }
+        validCurve_ = true;
+    }
+
+    template <class Curve>
+    void GlobalBootstrap<Curve>::solve() const {
+
+        // from now on, the target interpolation is used on all pillars
+        ts_->interpolation_ = ts_->interpolator_.interpolate(
+                 ts_->times_.begin(), ts_->times_.end(), ts_->data_.begin());
+
+        std::vector<Real>& data = ts_->data_;
+        Real accuracy = ts_->accuracy_;
+        Array f(alive_), fh(alive_), x(alive_), dx(alive_);
+        Matrix jacobian(alive_, alive_);
+
+        Real norm = errors(f);
+        Size maxIterations = Traits::maxIterations();
+        for (Size iteration=0; norm > accuracy; ++iteration) {
+            QL_REQUIRE(iteration < maxIterations,
+                       "convergence not reached after " << iteration <<
+                       " iterations; last error " << norm <<
+                       ", required accuracy " << accuracy);
+
+            // forward-difference Jacobian
+            for (Size i=1; i<=alive_; ++i) {
+                x[i-1] = data[i];
+                Real h = 1.0e-7 * std::max(1.0, std::fabs(x[i-1]));
+                Traits::updateGuess(data, x[i-1]+h, i);
+                errors(fh);
+                for (Size j=0; j<alive_; ++j)
+                    jacobian[j][i-1] = (fh[j]-f[j])/h;
+                Traits::updateGuess(data, x[i-1], i);
+            }
+            dx = qrSolve(jacobian, f);
+
+            // Newton step, halved until the errors decrease
+            Real step = 1.0, newNorm = QL_MAX_REAL;
+            for (Size k=0; k<30; ++k, step /= 2.0) {
+                for (Size i=1; i<=alive_; ++i)
+                    Traits::updateGuess(data, x[i-1]-step*dx[i-1], i);
+                newNorm = errors(fh);
+                if (newNorm < norm)
+                    break;
+            }
+            QL_REQUIRE(newNorm < norm,
+                       io::ordinal(iteration+1) << " iteration: failed to "
+                       "reduce the error " << norm << " with reference date "
+                       << ts_->dates_[0]);
+            f.swap(fh);
+            norm = newNorm;
+        }
+    }
+
+}
+
+#endif
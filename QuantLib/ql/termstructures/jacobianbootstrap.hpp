@@ -0,0 +1,344 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file jacobianbootstrap.hpp
+    \brief incremental bootstrapper providing the node/quote Jacobian
+*/
+
+#ifndef quantlib_jacobian_bootstrap_hpp
+#define quantlib_jacobian_bootstrap_hpp
+
+#include <ql/termstructures/bootstraphelper.hpp>
+#include <ql/termstructures/bootstraperror.hpp>
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
+#include <ql/math/solvers1d/brent.hpp>
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <ql/utilities/dataformatters.hpp>
+
+namespace QuantLib {
+
+    //! Incremental piecewise-term-structure bootstrapper
+    /*! The curve is bootstrapped as in IterativeBootstrap the first
+        time. Afterwards, when the curve is notified of a change,
+        the bootstrapper looks for the first pillar whose helper is
+        no longer matched by the curve (e.g., because its quote
+        changed) and, if the interpolation is local, only re-solves
+        that pillar and the following ones, starting from the
+        previous solution. With global interpolations, all pillars
+        are re-solved, again starting from the previous solution.
+
+        The bootstrapper can also return the Jacobian of the curve
+        nodes with respect to the helper quotes; once calculated,
+        the sensitivities of any instrument to the quotes can be
+        obtained from its sensitivities to the nodes by means of a
+        single matrix product instead of a re-bootstrap for each
+        quote.
+
+        \warning The residual of each helper is compared with the
+                 one obtained during the previous bootstrap; thus,
+                 helpers must return the same implied quote when
+                 nothing changed.
+    */
+    template <class Curve>
+    class JacobianBootstrap {
+        typedef typename Curve::traits_type Traits;
+        typedef typename Curve::interpolator_type Interpolator;
+      public:
+        JacobianBootstrap();
+        void setup(Curve* ts);
+        void calculate() const;
+        //! \name Inspectors
+        //@{
+        /*! returns the sensitivities of the curve nodes to the quotes
+            of the alive helpers: element \f$ (i,j) \f$ is the
+            derivative of the \f$ (i+1) \f$-th node (the first being
+            fixed by the reference date) with respect to the quote
+            of the \f$ j \f$-th alive helper, sorted by maturity.
+            The Jacobian is calculated by finite differences the
+            first time it's requested after each bootstrap.
+        */
+        const Matrix& jacobian() const;
+        //! index of the first pillar re-solved during the last bootstrap
+        Size firstSolvedPillar() const;
+        //@}
+      private:
+        void initialize() const;
+        void solve(Size i, Size iteration, bool validData) const;
+        Curve* ts_;
+        Size n_;
+        Brent firstSolver_;
+        FiniteDifferenceNewtonSafe solver_;
+        mutable bool initialized_, validCurve_, validJacobian_;
+        mutable Size firstAliveHelper_, alive_, firstSolvedPillar_;
+        mutable std::vector<Real> previousData_, residuals_;
+        mutable std::vector<boost::shared_ptr<BootstrapError<Curve> > > errors_;
+        mutable Matrix jacobian_;
+    };
+
+
+    // template definitions
+
+    template <class Curve>
+    JacobianBootstrap<Curve>::JacobianBootstrap()
+    : ts_(0), initialized_(false), validCurve_(false), validJacobian_(false),
+      alive_(0), firstSolvedPillar_(0) {}
+
+    template <class Curve>
+    void JacobianBootstrap<Curve>::setup(Curve* ts) {
+
+        ts_ = ts;
+        n_ = ts_->instruments_.size();
+        QL_REQUIRE(n_ > 0, "no bootstrap helpers given")
+        for (Size j=0; j<n_; ++j)
+            ts_->registerWith(ts_->instruments_[j]);
+
+        // do not initialize yet: instruments could be invalid here
+        // but valid later when bootstrapping is actually required
+    }
+
+    template <class Curve>
+    void JacobianBootstrap<Curve>::initialize() const {
+        // ensure helpers are sorted
+        std::sort(ts_->instruments_.begin(), ts_->instruments_.end(),
+                  detail::BootstrapHelperSorter());
+
+        // skip expired helpers
+        Date firstDate = Traits::initialDate(ts_);
+        QL_REQUIRE(ts_->instruments_[n_-1]->latestDate()>firstDate,
+                   "all instruments expired");
+        firstAliveHelper_ = 0;
+        while (ts_->instruments_[firstAliveHelper_]->latestDate() <= firstDate)
+            ++firstAliveHelper_;
+        Size alive = n_-firstAliveHelper_;
+        QL_REQUIRE(alive>=Interpolator::requiredPoints-1,
+                   "not enough alive instruments: " << alive <<
+                   " provided, " << Interpolator::requiredPoints-1 <<
+                   " required");
+        // a different number of pillars invalidates the previous solution
+        if (alive != alive_)
+            validCurve_ = false;
+        alive_ = alive;
+
+        // calculate dates and times, create errors_
+        std::vector<Date>& dates = ts_->dates_;
+        std::vector<Time>& times = ts_->times_;
+        dates.resize(alive_+1);
+        times.resize(alive_+1);
+        errors_.resize(alive_+1);
+        dates[0] = firstDate;
+        times[0] = ts_->timeFromReference(dates[0]);
+        for (Size i=1, j=firstAliveHelper_; j<n_; ++i, ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            dates[i] = helper->latestDate();
+            times[i] = ts_->timeFromReference(dates[i]);
+            // check for duplicated maturity
+            QL_REQUIRE(dates[i-1]!=dates[i],
+                       "more than one instrument with maturity " << dates[i]);
+            errors_[i] = boost::shared_ptr<BootstrapError<Curve> >(new
+                BootstrapError<Curve>(ts_, helper, i));
+        }
+
+        // set initial guess only if the current curve cannot be used as guess
+        if (!validCurve_ || ts_->data_.size()!=alive_+1) {
+            validCurve_ = false;
+            ts_->data_ = std::vector<Real>(alive_+1, Traits::initialValue(ts_));
+            previousData_.resize(alive_+1);
+        }
+        residuals_.resize(alive_+1);
+        initialized_ = true;
+    }
+
+    template <class Curve>
+    void JacobianBootstrap<Curve>::solve(Size i, Size iteration,
+                                         bool validData) const {
+        // bracket root and calculate guess
+        Real min = Traits::minValueAfter(i, ts_, validData, firstAliveHelper_);
+        Real max = Traits::maxValueAfter(i, ts_, validData, firstAliveHelper_);
+        Real guess = Traits::guess(i, ts_, validData, firstAliveHelper_);
+        // adjust guess if needed
+        if (guess>=max)
+            guess = max - (max-min)/5.0;
+        else if (guess<=min)
+            guess = min + (max-min)/5.0;
+
+        // extend interpolation if needed
+        if (!validData) {
+            const std::vector<Time>& times = ts_->times_;
+            const std::vector<Real>& data = ts_->data_;
+            try { // extend interpolation a point at a time
+                  // including the pillar to be boostrapped
+                ts_->interpolation_ = ts_->interpolator_.interpolate(
+                    times.begin(), times.begin()+i+1, data.begin());
+            } catch (...) {
+                if (!Interpolator::global)
+                    throw; // no chance to fix it in a later iteration
+
+                // otherwise use Linear while the target
+                // interpolation is not usable yet
+                ts_->interpolation_ = Linear().interpolate(
+                    times.begin(), times.begin()+i+1, data.begin());
+            }
+            ts_->interpolation_.update();
+        }
+
+        try {
+            if (validData)
+                solver_.solve(*errors_[i], ts_->accuracy_, guess, min, max);
+            else
+                firstSolver_.solve(*errors_[i], ts_->accuracy_,
+                                   guess, min, max);
+        } catch (std::exception &e) {
+            validCurve_ = false;
+            QL_FAIL(io::ordinal(iteration+1) << " iteration: failed "
+                    "at " << io::ordinal(i) << " alive instrument, "
+                    "maturity " << errors_[i]->helper()->latestDate() <<
+                    ", reference date " << ts_->dates_[0] <<
+                    ": " << e.what());
+        }
+    }
+
+    template <class Curve>
+    void JacobianBootstrap<Curve>::calculate() const {
+
+        // as in IterativeBootstrap, helpers might be date relative
+        // and change with the evaluation date.
+        if (!initialized_ || ts_->moving_)
+            initialize();
+
+        // setup helpers
+        for (Size j=firstAliveHelper_; j<n_; ++j) {
+            const boost::shared_ptr<typename Traits::helper>& helper =
+                                                        ts_->instruments_[j];
+            // check for valid quote
+            QL_REQUIRE(helper->quote()->isValid(),
+                       io::ordinal(j+1) << " instrument (maturity: " <<
+                       helper->latestDate() << ") has an invalid quote");
+            // don't try this at home!
+            // This call creates helpers, and removes "const".
+            // There is a significant interaction with observability.
+            helper->setTermStructure(const_cast<Curve*>(ts_));
+        }
+
+        validJacobian_ = false;
+        const std::vector<Real>& data = ts_->data_;
+
+        if (validCurve_ && !Interpolator::global) {
+            // pillars before the first one whose helper changed its
+            // residual are still solved; with a local interpolation,
+            // they don't depend on the following ones. Changes within
+            // the bootstrap accuracy are below the noise of the solver
+            // and don't trigger a new solution.
+            ts_->interpolation_.update();
+            Size k = 1;
+            while (k<=alive_ &&
+                   std::fabs(errors_[k]->helper()->quoteError() -
+                             residuals_[k]) <= ts_->accuracy_)
+                ++k;
+            firstSolvedPillar_ = k;
+            for (Size i=k; i<=alive_; ++i)
+                solve(i, 0, true);
+        } else {
+            firstSolvedPillar_ = 1;
+            Size maxIterations = Traits::maxIterations()-1;
+
+            for (Size iteration=0; ; ++iteration) {
+                previousData_ = ts_->data_;
+
+                for (Size i=1; i<=alive_; ++i)
+                    solve(i, iteration, validCurve_ || iteration>0);
+
+                if (!Interpolator::global)
+                    break;     // no need for convergence loop
+                else if (iteration==0 && !validCurve_)
+                    continue; // at least one more iteration
+
+                // exit condition
+                Real change = std::fabs(data[1]-previousData_[1]);
+                for (Size i=2; i<=alive_; ++i)
+                    change = std::max(change,
+                                      std::fabs(data[i]-previousData_[i]));
+                if (change<=ts_->accuracy_)  // convergence reached
+                    break;
+
+                QL_REQUIRE(iteration<maxIterations,
+                           "convergence not reached after " << iteration <<
+                           " iterations; last improvement " << change <<
+                           ", required accuracy " << ts_->accuracy_);
+            }
+        }
+
+        // store the residuals to detect later changes
+        for (Size i=1; i<=alive_; ++i)
+            residuals_[i] = errors_[i]->helper()->quoteError();
+        validCurve_ = true;
+    }
+
+    template <class Curve>
+    const Matrix& JacobianBootstrap<Curve>::jacobian() const {
+        ts_->calculate();
+        if (!validJacobian_) {
+            // helpers might have been used by another curve since
+            for (Size j=firstAliveHelper_; j<n_; ++j)
+                ts_->instruments_[j]->setTermStructure(ts_);
+            std::vector<Real>& data = ts_->data_;
+            // first, the sensitivities of the implied quotes to the
+            // nodes; the nodes are bumped as done while solving.
+            Matrix a(alive_, alive_);
+            for (Size i=1; i<=alive_; ++i) {
+                Real x = data[i];
+                Real h = 1.0e-6 * std::max(1.0, std::fabs(x));
+                Traits::updateGuess(data, x+h, i);
+                ts_->interpolation_.update();
+                for (Size j=1; j<=alive_; ++j)
+                    a[j-1][i-1] = errors_[j]->helper()->impliedQuote();
+                Traits::updateGuess(data, x-h, i);
+                ts_->interpolation_.update();
+                for (Size j=1; j<=alive_; ++j)
+                    a[j-1][i-1] = (a[j-1][i-1] -
+                                   errors_[j]->helper()->impliedQuote())/(2*h);
+                Traits::updateGuess(data, x, i);
+                ts_->interpolation_.update();
+            }
+            // then, since the implied quotes match the quotes, the
+            // node sensitivities are given by the inverse; its
+            // columns are solved for by QR, as in GlobalBootstrap.
+            jacobian_ = Matrix(alive_, alive_);
+            Array unit(alive_, 0.0);
+            for (Size j=0; j<alive_; ++j) {
+                unit[j] = 1.0;
+                const Array column = qrSolve(a, unit);
+                std::copy(column.begin(), column.end(),
+                          jacobian_.column_begin(j));
+                unit[j] = 0.0;
+            }
+            validJacobian_ = true;
+        }
+        return jacobian_;
+    }
+
+    template <class Curve>
+    Size JacobianBootstrap<Curve>::firstSolvedPillar() const {
+        return firstSolvedPillar_;
+    }
+
+}
+
+#endif
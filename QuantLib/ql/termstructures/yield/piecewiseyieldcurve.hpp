@@ -166,6 +166,7 @@ namespace QuantLib {
         const std::vector<Date>& dates() const;
         const std::vector<Real>& data() const;
         std::vector<std::pair<Date, Real> > nodes() const;
+        const Bootstrap<this_curve>& bootstrap() const { return bootstrap_; }
         //@}
         //! \name Observer interface
         //@{
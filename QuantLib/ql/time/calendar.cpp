@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
- Copyright (C) 2003, 2004, 2005, 2006, 2007 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2005, 2006, 2007, 2014 StatPro Italia srl
  Copyright (C) 2004 Jeff Yu
 
  This file is part of QuantLib, a free-software/open-source library
@@ -21,9 +21,182 @@
 
 #include <ql/time/calendar.hpp>
 #include <ql/errors.hpp>
+#include <algorithm>
 
 namespace QuantLib {
 
+    namespace {
+
+        Size bitCount(boost::uint32_t x) {
+            x = x - ((x >> 1) & 0x55555555);
+            x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+            x = (x + (x >> 4)) & 0x0F0F0F0F;
+            return (x * 0x01010101) >> 24;
+        }
+
+        void setBit(std::vector<boost::uint32_t>& bits,
+                    BigInteger i, bool value) {
+            if (value)
+                bits[i/32] |= (boost::uint32_t(1) << (i%32));
+            else
+                bits[i/32] &= ~(boost::uint32_t(1) << (i%32));
+        }
+
+        // number of business days with serial number lower than i
+        BigInteger businessDaysBefore(
+                                const std::vector<boost::uint32_t>& bits,
+                                const std::vector<boost::uint32_t>& counts,
+                                BigInteger i) {
+            BigInteger n = counts[i/32];
+            if (i%32 != 0)
+                n += bitCount(bits[i/32] &
+                              ((boost::uint32_t(1) << (i%32)) - 1));
+            return n;
+        }
+
+        // the k-th business day (starting from 0)
+        Date businessDay(const std::vector<boost::uint32_t>& bits,
+                         const std::vector<boost::uint32_t>& counts,
+                         BigInteger k) {
+            QL_REQUIRE(k >= 0 && k < BigInteger(counts.back()),
+                       "date out of range");
+            Size w = std::upper_bound(counts.begin(), counts.end(),
+                                      boost::uint32_t(k))
+                   - counts.begin() - 1;
+            BigInteger r = k - counts[w];
+            for (Size b=0; ; ++b) {
+                if ((bits[w] >> b) & 1) {
+                    if (r == 0)
+                        return Date(BigInteger(w*32+b));
+                    --r;
+                }
+            }
+        }
+
+    }
+
+    void Calendar::Impl::fillBusinessDays(
+                                  std::vector<boost::uint32_t>& bits) const {
+        BigInteger first = Date::minDate().serialNumber(),
+                   last = Date::maxDate().serialNumber();
+        bits.assign(last/32+1, 0);
+        for (BigInteger i=first; i<=last; ++i)
+            if (isBusinessDay(Date(i)))
+                setBit(bits, i, true);
+    }
+
+    std::vector<Calendar> Calendar::Impl::components() const {
+        return std::vector<Calendar>();
+    }
+
+    void Calendar::fillBusinessDays(const Calendar& c,
+                                    std::vector<boost::uint32_t>& bits) {
+        if (!c.impl_->businessDayBits.empty()) {
+            bits = c.impl_->businessDayBits;
+            return;
+        }
+        c.impl_->fillBusinessDays(bits);
+        std::set<Date>::const_iterator i;
+        for (i=c.impl_->addedHolidays.begin();
+             i!=c.impl_->addedHolidays.end(); ++i)
+            setBit(bits, i->serialNumber(), false);
+        for (i=c.impl_->removedHolidays.begin();
+             i!=c.impl_->removedHolidays.end(); ++i)
+            setBit(bits, i->serialNumber(), true);
+    }
+
+    void Calendar::computeBusinessDays(const boost::shared_ptr<Impl>& impl) {
+        Calendar c;
+        c.impl_ = impl;
+        std::vector<boost::uint32_t> bits;
+        impl->businessDayBits.clear();
+        fillBusinessDays(c, bits);
+        std::vector<boost::uint32_t> counts(bits.size()+1, 0);
+        for (Size i=0; i<bits.size(); ++i)
+            counts[i+1] = counts[i] + bitCount(bits[i]);
+        impl->businessDayBits.swap(bits);
+        impl->businessDayCounts.swap(counts);
+    }
+
+    void Calendar::refreshBusinessDays(const boost::shared_ptr<Impl>& impl) {
+        if (!impl->businessDayBits.empty())
+            computeBusinessDays(impl);
+        for (Size i=0; i<impl->dependents.size(); ++i) {
+            boost::shared_ptr<Impl> dependent = impl->dependents[i].lock();
+            if (dependent)
+                refreshBusinessDays(dependent);
+        }
+    }
+
+    void Calendar::refreshBusinessDay(const boost::shared_ptr<Impl>& impl,
+                                      const Date& d) {
+        std::vector<boost::uint32_t>& bits = impl->businessDayBits;
+        if (!bits.empty()) {
+            bool businessDay;
+            if (impl->addedHolidays.find(d) != impl->addedHolidays.end())
+                businessDay = false;
+            else if (impl->removedHolidays.find(d) !=
+                                               impl->removedHolidays.end())
+                businessDay = true;
+            else
+                businessDay = impl->isBusinessDay(d);
+            BigInteger i = d.serialNumber();
+            if ((((bits[i/32] >> (i%32)) & 1) != 0) == businessDay)
+                return; // no change, so dependents are unaffected
+            setBit(bits, i, businessDay);
+            std::vector<boost::uint32_t>& counts = impl->businessDayCounts;
+            for (Size j=i/32+1; j<counts.size(); ++j) {
+                if (businessDay)
+                    ++counts[j];
+                else
+                    --counts[j];
+            }
+        }
+        for (Size i=0; i<impl->dependents.size(); ++i) {
+            boost::shared_ptr<Impl> dependent = impl->dependents[i].lock();
+            if (dependent)
+                refreshBusinessDay(dependent, d);
+        }
+    }
+
+    void Calendar::precomputeBusinessDays() {
+        QL_REQUIRE(impl_, "no calendar implementation provided");
+        if (!impl_->businessDayBits.empty())
+            return;
+        computeBusinessDays(impl_);
+
+        std::vector<Calendar> components = impl_->components();
+        for (Size i=0; i<components.size(); ++i)
+            addDependent(components[i], impl_);
+    }
+
+    void Calendar::addDependent(const Calendar& component,
+                                const boost::shared_ptr<Impl>& dependent) {
+        // the dependent is registered with the components of nested
+        // calendars as well, since those don't necessarily keep track
+        // of their own dependents.  A component precomputed later is
+        // refreshed after the dependent and refreshes it again.
+        std::vector<boost::weak_ptr<Impl> >& dependents =
+            component.impl_->dependents;
+        // forget about calendars no longer around
+        std::vector<boost::weak_ptr<Impl> > alive;
+        bool registered = false;
+        for (Size j=0; j<dependents.size(); ++j) {
+            boost::shared_ptr<Impl> d = dependents[j].lock();
+            if (d) {
+                alive.push_back(d);
+                registered = registered || (d == dependent);
+            }
+        }
+        if (!registered)
+            alive.push_back(dependent);
+        dependents.swap(alive);
+
+        std::vector<Calendar> components = component.impl_->components();
+        for (Size i=0; i<components.size(); ++i)
+            addDependent(components[i], dependent);
+    }
+
     void Calendar::addHoliday(const Date& d) {
         // if d was a genuine holiday previously removed, revert the change
         impl_->removedHolidays.erase(d);
@@ -31,6 +204,7 @@ namespace QuantLib {
         // Otherwise, add it.
         if (impl_->isBusinessDay(d))
             impl_->addedHolidays.insert(d);
+        refreshBusinessDay(impl_, d);
     }
 
     void Calendar::removeHoliday(const Date& d) {
@@ -40,6 +214,7 @@ namespace QuantLib {
         // Otherwise, add it.
         if (!impl_->isBusinessDay(d))
             impl_->removedHolidays.insert(d);
+        refreshBusinessDay(impl_, d);
     }
 
     Date Calendar::adjust(const Date& d,
@@ -77,6 +252,16 @@ namespace QuantLib {
         QL_REQUIRE(d!=Date(), "null date");
         if (n == 0) {
             return adjust(d,c);
+        } else if (unit == Days && !impl_->businessDayBits.empty()) {
+            const std::vector<boost::uint32_t>& bits = impl_->businessDayBits;
+            const std::vector<boost::uint32_t>& counts =
+                                                    impl_->businessDayCounts;
+            // business days are numbered from 0; find the index of
+            // the target from the number of those preceding d.
+            BigInteger k = (n > 0) ?
+                businessDaysBefore(bits, counts, d.serialNumber()+1) + n-1 :
+                businessDaysBefore(bits, counts, d.serialNumber()) + n;
+            return businessDay(bits, counts, k);
         } else if (unit == Days) {
             Date d1 = d;
             if (n > 0) {
@@ -121,7 +306,23 @@ namespace QuantLib {
                                              bool includeFirst,
                                              bool includeLast) const {
         BigInteger wd = 0;
-        if (from != to) {
+        if (from != to && !impl_->businessDayBits.empty()) {
+            const std::vector<boost::uint32_t>& bits = impl_->businessDayBits;
+            const std::vector<boost::uint32_t>& counts =
+                                                    impl_->businessDayCounts;
+            BigInteger first = std::min(from, to).serialNumber(),
+                       last = std::max(from, to).serialNumber();
+            wd = businessDaysBefore(bits, counts, last+1)
+               - businessDaysBefore(bits, counts, first);
+
+            if (isBusinessDay(from) && !includeFirst)
+                wd--;
+            if (isBusinessDay(to) && !includeLast)
+                wd--;
+
+            if (from > to)
+                wd = -wd;
+        } else if (from != to) {
             if (from < to) {
                 // the last one is treated separately to avoid
                 // incrementing Date::maxDate()
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
- Copyright (C) 2003, 2004, 2005, 2006, 2007 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2005, 2006, 2007, 2014 StatPro Italia srl
  Copyright (C) 2006 Piter Dias
 
  This file is part of QuantLib, a free-software/open-source library
@@ -29,6 +29,8 @@
 #include <ql/time/date.hpp>
 #include <ql/time/businessdayconvention.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <set>
 #include <vector>
 #include <string>
@@ -54,6 +56,10 @@ namespace QuantLib {
         \test the methods for adding and removing holidays are tested
               by inspecting the calendar before and after their
               invocation.
+
+        \test the results of precomputed calendars are checked
+              against those of the same calendars without
+              precomputed business days.
     */
     class Calendar {
       protected:
@@ -64,9 +70,32 @@ namespace QuantLib {
             virtual std::string name() const = 0;
             virtual bool isBusinessDay(const Date&) const = 0;
             virtual bool isWeekend(Weekday) const = 0;
+            /*! sets one bit for each business day, indexed by serial
+                number, according to the implementation alone (added
+                and removed holidays are managed by the calendar).
+            */
+            virtual void fillBusinessDays(std::vector<boost::uint32_t>&) const;
+            //! calendars whose business days are used by this one
+            virtual std::vector<Calendar> components() const;
             std::set<Date> addedHolidays, removedHolidays;
+            // precomputed business days (empty unless requested) and
+            // number of business days before each 32-day block
+            std::vector<boost::uint32_t> businessDayBits, businessDayCounts;
+            // calendars whose precomputed data use this one
+            std::vector<boost::weak_ptr<Impl> > dependents;
         };
         boost::shared_ptr<Impl> impl_;
+        //! business days of the given calendar, including changes
+        static void fillBusinessDays(const Calendar&,
+                                     std::vector<boost::uint32_t>&);
+        //! to be called when the business days of an implementation change
+        static void refreshBusinessDays(const boost::shared_ptr<Impl>&);
+      private:
+        static void computeBusinessDays(const boost::shared_ptr<Impl>&);
+        static void refreshBusinessDay(const boost::shared_ptr<Impl>&,
+                                       const Date&);
+        static void addDependent(const Calendar&,
+                                 const boost::shared_ptr<Impl>&);
       public:
         /*! The default constructor returns a calendar with a null
             implementation, which is therefore unusable except as a
@@ -107,6 +136,24 @@ namespace QuantLib {
         /*! Removes a date from the set of holidays for the given calendar. */
         void removeHoliday(const Date&);
 
+        /*! Precomputes the business days of the calendar over the
+            whole range of valid dates, so that isBusinessDay()
+            takes constant time and businessDaysBetween() and
+            advance() by a number of days don't need to loop over
+            the days in between. The data take about 27 kB and are
+            shared by all the copies of the calendar.
+
+            Holidays added or removed later are applied to the
+            precomputed data, as well as those added or removed from
+            the calendars a precomputed joint calendar is based on,
+            however deeply nested.
+
+            \warning this method, as well as addHoliday() and
+                     removeHoliday(), must not be called while other
+                     threads are using the calendar.
+        */
+        void precomputeBusinessDays();
+
         //! Returns the holidays between two dates
         static std::vector<Date> holidayList(const Calendar& calendar,
                                              const Date& from,
@@ -193,6 +240,11 @@ namespace QuantLib {
     }
 
     inline bool Calendar::isBusinessDay(const Date& d) const {
+        const std::vector<boost::uint32_t>& bits = impl_->businessDayBits;
+        if (!bits.empty()) {
+            BigInteger i = d.serialNumber();
+            return ((bits[i/32] >> (i%32)) & 1) != 0;
+        }
         if (impl_->addedHolidays.find(d) != impl_->addedHolidays.end())
             return false;
         if (impl_->removedHolidays.find(d) != impl_->removedHolidays.end())
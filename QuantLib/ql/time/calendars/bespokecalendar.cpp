@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2008 StatPro Italia srl
+ Copyright (C) 2008, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -50,6 +50,7 @@ namespace QuantLib {
 
     void BespokeCalendar::addWeekend(Weekday w) {
         bespokeImpl_->addWeekend(w);
+        refreshBusinessDays(impl_);
     }
 
 }
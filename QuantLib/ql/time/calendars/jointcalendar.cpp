@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2003 RiskMap srl
- Copyright (C) 2007 StatPro Italia srl
+ Copyright (C) 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -114,6 +114,31 @@ namespace QuantLib {
         }
     }
 
+    void JointCalendar::Impl::fillBusinessDays(
+                                  std::vector<boost::uint32_t>& bits) const {
+        Calendar::fillBusinessDays(calendars_.front(), bits);
+        std::vector<boost::uint32_t> other;
+        for (Size i=1; i<calendars_.size(); ++i) {
+            Calendar::fillBusinessDays(calendars_[i], other);
+            switch (rule_) {
+              case JoinHolidays:
+                for (Size j=0; j<bits.size(); ++j)
+                    bits[j] &= other[j];
+                break;
+              case JoinBusinessDays:
+                for (Size j=0; j<bits.size(); ++j)
+                    bits[j] |= other[j];
+                break;
+              default:
+                QL_FAIL("unknown joint calendar rule");
+            }
+        }
+    }
+
+    std::vector<Calendar> JointCalendar::Impl::components() const {
+        return calendars_;
+    }
+
 
     JointCalendar::JointCalendar(const Calendar& c1,
                                  const Calendar& c2,
@@ -65,6 +65,8 @@ namespace QuantLib {
             std::string name() const;
             bool isWeekend(Weekday) const;
             bool isBusinessDay(const Date&) const;
+            void fillBusinessDays(std::vector<boost::uint32_t>&) const;
+            std::vector<Calendar> components() const;
           private:
             JointCalendarRule rule_;
             std::vector<Calendar> calendars_;
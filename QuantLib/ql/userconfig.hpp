@@ -72,4 +72,19 @@
 //#   define QL_ENABLE_SESSIONS
 #endif
 
+/* Define this to make registration and notification of observers
+   thread-safe, so that observables can be shared between threads.
+   You will have to link with the Boost.Thread library. */
+#ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+//#   define QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+#endif
+
+/* Define this to enable singleton contexts; each thread can then
+   switch to its own copy of the singletons (e.g., evaluation date,
+   index fixings, exchange rates) by means of a SingletonContextGuard.
+   This is not compatible with sessions. */
+#ifndef QL_ENABLE_SINGLETON_CONTEXTS
+//#   define QL_ENABLE_SINGLETON_CONTEXTS
+#endif
+
 #endif
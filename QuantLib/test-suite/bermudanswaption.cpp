@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2005, 2007 StatPro Italia srl
+ Copyright (C) 2005, 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -21,9 +21,11 @@
 #include "utilities.hpp"
 #include <ql/instruments/swaption.hpp>
 #include <ql/pricingengines/swaption/treeswaptionengine.hpp>
+#include <ql/pricingengines/swaption/discretizedswaption.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/pricingengines/swaption/fdhullwhiteswaptionengine.hpp>
 #include <ql/models/shortrate/onefactormodels/hullwhite.hpp>
+#include <ql/models/shortrate/onefactormodels/blackkarasinski.hpp>
 #include <ql/cashflows/coupon.hpp>
 #include <ql/time/daycounters/thirty360.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
@@ -224,10 +226,119 @@ void BermudanSwaptionTest::testCachedValues() {
                     << "expected:   " << otmValue);
 }
 
+void BermudanSwaptionTest::testBatchRollback() {
+
+    BOOST_TEST_MESSAGE("Testing batch rollback of Bermudan swaptions...");
+
+    CommonVars vars;
+
+    vars.today = Date(15, February, 2002);
+
+    Settings::instance().evaluationDate() = vars.today;
+
+    vars.settlement = Date(19, February, 2002);
+    vars.termStructure.linkTo(flatRate(vars.settlement,
+                                          0.04875825,
+                                          Actual365Fixed()));
+
+    Rate atmRate = vars.makeSwap(0.0)->fairRate();
+
+    std::vector<boost::shared_ptr<VanillaSwap> > swaps;
+    swaps.push_back(vars.makeSwap(0.8*atmRate));
+    swaps.push_back(vars.makeSwap(atmRate));
+    swaps.push_back(vars.makeSwap(1.2*atmRate));
+
+    // exercises on the coupon start dates and a few days earlier,
+    // so that the swaptions start their rollback at different times
+    std::vector<Date> exerciseDates, earlierDates;
+    const Leg& leg = swaps[1]->fixedLeg();
+    for (Size i=0; i<leg.size(); i++) {
+        boost::shared_ptr<Coupon> coupon =
+            boost::dynamic_pointer_cast<Coupon>(leg[i]);
+        exerciseDates.push_back(coupon->accrualStartDate());
+        earlierDates.push_back(
+                     vars.calendar.adjust(coupon->accrualStartDate()-10));
+    }
+    std::vector<boost::shared_ptr<Exercise> > exercises;
+    exercises.push_back(boost::shared_ptr<Exercise>(
+                                    new BermudanExercise(exerciseDates)));
+    exercises.push_back(boost::shared_ptr<Exercise>(
+                                    new BermudanExercise(earlierDates)));
+
+    std::vector<boost::shared_ptr<Swaption> > swaptions;
+    for (Size i=0; i<swaps.size(); i++)
+        for (Size j=0; j<exercises.size(); j++)
+            swaptions.push_back(boost::shared_ptr<Swaption>(
+                                       new Swaption(swaps[i], exercises[j])));
+
+    Date referenceDate = vars.termStructure->referenceDate();
+    DayCounter dayCounter = vars.termStructure->dayCounter();
+
+    std::vector<boost::shared_ptr<DiscretizedAsset> > assets;
+    std::vector<Time> times;
+    Time firstExercise = QL_MAX_REAL;
+    for (Size i=0; i<swaptions.size(); i++) {
+        Swaption::arguments arguments;
+        swaptions[i]->setupArguments(&arguments);
+        boost::shared_ptr<DiscretizedAsset> asset(
+                  new DiscretizedSwaption(arguments, referenceDate,
+                                          dayCounter));
+        std::vector<Time> t = asset->mandatoryTimes();
+        times.insert(times.end(), t.begin(), t.end());
+        firstExercise = std::min(firstExercise,
+                                 dayCounter.yearFraction(
+                                     referenceDate,
+                                     arguments.exercise->dates().front()));
+        assets.push_back(asset);
+    }
+    TimeGrid grid(times.begin(), times.end(), 50);
+
+    std::vector<boost::shared_ptr<ShortRateModel> > models;
+    models.push_back(boost::shared_ptr<ShortRateModel>(
+                        new HullWhite(vars.termStructure, 0.048696, 0.0058904)));
+    models.push_back(boost::shared_ptr<ShortRateModel>(
+                        new BlackKarasinski(vars.termStructure, 0.1, 0.1)));
+
+    Real tolerance = 1.0e-8;
+
+    for (Size k=0; k<models.size(); k++) {
+        boost::shared_ptr<Lattice> lattice = models[k]->tree(grid);
+        boost::shared_ptr<PricingEngine> engine(
+                                    new TreeSwaptionEngine(models[k], grid));
+
+        // the assets are initialized at their own last exercise
+        for (Size i=0; i<assets.size(); i++) {
+            Time t = dayCounter.yearFraction(
+                           referenceDate,
+                           swaptions[i]->exercise()->dates().back());
+            assets[i]->initialize(lattice, t);
+        }
+        // all rolled back together...
+        lattice->rollback(assets, firstExercise);
+
+        for (Size i=0; i<swaptions.size(); i++) {
+            // ...and compared with their separate valuation
+            swaptions[i]->setPricingEngine(engine);
+            Real expected = swaptions[i]->NPV();
+            Real calculated = assets[i]->presentValue();
+            if (std::fabs(calculated-expected) > tolerance)
+                BOOST_ERROR("failed to reproduce swaption value "
+                            "with batch rollback:\n"
+                            << "    model:      " << (k == 0 ? "Hull-White"
+                                                     : "Black-Karasinski")
+                            << "\n"
+                            << "    swaption:   " << i+1 << "\n"
+                            << "    calculated: " << calculated << "\n"
+                            << "    expected:   " << expected);
+        }
+    }
+}
+
 
 test_suite* BermudanSwaptionTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Bermudan swaption tests");
     suite->add(QUANTLIB_TEST_CASE(&BermudanSwaptionTest::testCachedValues));
+    suite->add(QUANTLIB_TEST_CASE(&BermudanSwaptionTest::testBatchRollback));
     return suite;
 }
 
@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2003, 2004, 2008 StatPro Italia srl
+ Copyright (C) 2003, 2004, 2008, 2014 StatPro Italia srl
  Copyright (C) 2005 Ferdinando Ametrano
  Copyright (C) 2006 Piter Dias
  Copyright (C) 2008 Charles Chongseok Hyun
@@ -995,6 +995,162 @@ void CalendarTest::testBusinessDaysBetween() {
 }
 
 
+namespace {
+
+    struct CalendarData {
+        std::vector<bool> businessDays;
+        std::vector<Date> advancedDates;
+        std::vector<BigInteger> businessDaysBetween;
+    };
+
+    CalendarData calendarData(const Calendar& c) {
+        CalendarData data;
+        Date first = Date::minDate(), last = Date::maxDate();
+        for (Date d = first; d < last; ++d)
+            data.businessDays.push_back(c.isBusinessDay(d));
+        data.businessDays.push_back(c.isBusinessDay(last));
+
+        Integer days[] = { -40, -7, -1, 1, 3, 25 };
+        Integer intervals[] = { -250, -1, 1, 13, 400 };
+        for (Date d = first + 300; d < last - 480; d += 97) {
+            for (Size i=0; i<LENGTH(days); ++i)
+                data.advancedDates.push_back(c.advance(d, days[i], Days));
+            for (Size i=0; i<LENGTH(intervals); ++i) {
+                Date d2 = d + intervals[i];
+                data.businessDaysBetween.push_back(
+                               c.businessDaysBetween(d, d2));
+                data.businessDaysBetween.push_back(
+                               c.businessDaysBetween(d, d2, false, true));
+            }
+        }
+        return data;
+    }
+
+    void checkPrecomputedCalendar(Calendar c) {
+        CalendarData expected = calendarData(c);
+        c.precomputeBusinessDays();
+        CalendarData calculated = calendarData(c);
+
+        if (calculated.businessDays != expected.businessDays)
+            BOOST_ERROR("business days not reproduced by precomputed "
+                        << c.name() << " calendar");
+        if (calculated.advancedDates != expected.advancedDates)
+            BOOST_ERROR("advanced dates not reproduced by precomputed "
+                        << c.name() << " calendar");
+        if (calculated.businessDaysBetween != expected.businessDaysBetween)
+            BOOST_ERROR("business days between dates not reproduced by "
+                        "precomputed " << c.name() << " calendar");
+    }
+
+}
+
+
+void CalendarTest::testPrecomputedCalendars() {
+
+    BOOST_TEST_MESSAGE("Testing precomputed calendars...");
+
+    Calendar c1 = TARGET(),
+             c2 = UnitedKingdom(),
+             c3 = UnitedStates(UnitedStates::NYSE),
+             c4 = Japan();
+
+    checkPrecomputedCalendar(JointCalendar(c1,c2,JoinHolidays));
+    checkPrecomputedCalendar(JointCalendar(c3,c4,JoinBusinessDays));
+    checkPrecomputedCalendar(JointCalendar(c1,c2,c3,c4,JoinHolidays));
+
+    BespokeCalendar bespoke("bespoke");
+    bespoke.addWeekend(Friday);
+    bespoke.addHoliday(Date(15, May, 2014));
+    checkPrecomputedCalendar(bespoke);
+
+    // changes after precomputation
+    Date d1(1,May,2014);      // holiday for TARGET
+    Date d2(28,April,2014);   // business day for both calendars
+
+    QL_REQUIRE(c1.isHoliday(d1), "wrong assumption---correct the test");
+    QL_REQUIRE(c1.isBusinessDay(d2), "wrong assumption---correct the test");
+    QL_REQUIRE(c2.isBusinessDay(d2), "wrong assumption---correct the test");
+
+    Calendar c12 = JointCalendar(c1,c2,JoinHolidays);
+    c12.precomputeBusinessDays();
+
+    BigInteger businessDays = c12.businessDaysBetween(d2-7, d2+7);
+    c2.addHoliday(d2);
+    if (c12.isBusinessDay(d2))
+        BOOST_ERROR(d2 << " still a business day for " << c12.name()
+                    << " after being added to " << c2.name() << " holidays");
+    if (c12.businessDaysBetween(d2-7, d2+7) != businessDays-1)
+        BOOST_ERROR("wrong number of business days for " << c12.name()
+                    << " after holiday added to " << c2.name() << ":"
+                    << "\n    calculated: "
+                    << c12.businessDaysBetween(d2-7, d2+7)
+                    << "\n    expected:   " << businessDays-1);
+    c2.removeHoliday(d2);
+    if (!c12.isBusinessDay(d2))
+        BOOST_ERROR(d2 << " still a holiday for " << c12.name()
+                    << " after being removed from " << c2.name()
+                    << " holidays");
+
+    c12.removeHoliday(d1);
+    if (!c12.isBusinessDay(d1))
+        BOOST_ERROR(d1 << " still a holiday for " << c12.name()
+                    << " after being removed");
+    if (c12.advance(d1-1, 1, Days) != d1)
+        BOOST_ERROR("holiday removed from " << c12.name()
+                    << " not used when advancing:"
+                    << "\n    calculated: " << c12.advance(d1-1, 1, Days)
+                    << "\n    expected:   " << d1);
+    c12.addHoliday(d1);
+    if (c12.isBusinessDay(d1))
+        BOOST_ERROR(d1 << " still a business day for " << c12.name()
+                    << " after being added to holidays");
+
+    // changes to the components of nested joint calendars
+    QL_REQUIRE(c3.isBusinessDay(d2) && c3.isBusinessDay(d2+1),
+               "wrong assumption---correct the test");
+    Calendar inner = JointCalendar(c1,c2,JoinHolidays);
+    Calendar outer = JointCalendar(inner,c3,JoinHolidays);
+    outer.precomputeBusinessDays();
+
+    for (Size i=0; i<2; ++i) {
+        // the second time, the inner calendar is precomputed as well
+        if (i == 1)
+            inner.precomputeBusinessDays();
+        Calendar changed = (i == 0 ? c2 : c1);
+
+        businessDays = outer.businessDaysBetween(d2-7, d2+7);
+        changed.addHoliday(d2);
+        if (outer.isBusinessDay(d2))
+            BOOST_ERROR(d2 << " still a business day for " << outer.name()
+                        << " after being added to " << changed.name()
+                        << " holidays");
+        if (outer.advance(d2-1, 1, Days) != d2+1)
+            BOOST_ERROR("holiday added to " << changed.name()
+                        << " not used when advancing " << outer.name()
+                        << ":\n    calculated: "
+                        << outer.advance(d2-1, 1, Days)
+                        << "\n    expected:   " << d2+1);
+        if (outer.businessDaysBetween(d2-7, d2+7) != businessDays-1)
+            BOOST_ERROR("wrong number of business days for "
+                        << outer.name() << " after holiday added to "
+                        << changed.name() << ":"
+                        << "\n    calculated: "
+                        << outer.businessDaysBetween(d2-7, d2+7)
+                        << "\n    expected:   " << businessDays-1);
+        changed.removeHoliday(d2);
+        if (!outer.isBusinessDay(d2))
+            BOOST_ERROR(d2 << " still a holiday for " << outer.name()
+                        << " after being removed from " << changed.name()
+                        << " holidays");
+    }
+
+    bespoke.addWeekend(Monday);
+    if (bespoke.isBusinessDay(d2))
+        BOOST_ERROR(d2 << " still a business day for " << bespoke.name()
+                    << " after adding Monday to the weekend");
+}
+
+
 void CalendarTest::testBespokeCalendars() {
 
     BOOST_TEST_MESSAGE("Testing bespoke calendars...");
@@ -1141,6 +1297,7 @@ test_suite* CalendarTest::suite() {
 
     suite->add(QUANTLIB_TEST_CASE(&CalendarTest::testEndOfMonth));
     suite->add(QUANTLIB_TEST_CASE(&CalendarTest::testBusinessDaysBetween));
+    suite->add(QUANTLIB_TEST_CASE(&CalendarTest::testPrecomputedCalendars));
 
     return suite;
 }
@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2008, 2009 StatPro Italia srl
+ Copyright (C) 2008, 2009, 2014 StatPro Italia srl
  Copyright (C) 2009 Ferdinando Ametrano
 
  This file is part of QuantLib, a free-software/open-source library
@@ -23,12 +23,14 @@
 #include <ql/termstructures/credit/piecewisedefaultcurve.hpp>
 #include <ql/termstructures/credit/defaultprobabilityhelpers.hpp>
 #include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/termstructures/globalbootstrap.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/instruments/creditdefaultswap.hpp>
 #include <ql/pricingengines/credit/midpointcdsengine.hpp>
 #include <ql/math/interpolations/linearinterpolation.hpp>
 #include <ql/math/interpolations/backwardflatinterpolation.hpp>
 #include <ql/math/interpolations/loginterpolation.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/daycounters/actual360.hpp>
@@ -139,7 +141,7 @@ void DefaultProbabilityCurveTest::testFlatHazardRate() {
 
 namespace {
 
-    template <class T, class I>
+    template <class T, class I, template <class> class B>
     void testBootstrapFromSpread() {
 
         Calendar calendar = TARGET();
@@ -184,8 +186,8 @@ namespace {
         RelinkableHandle<DefaultProbabilityTermStructure> piecewiseCurve;
         piecewiseCurve.linkTo(
             boost::shared_ptr<DefaultProbabilityTermStructure>(
-                new PiecewiseDefaultCurve<T,I>(today, helpers,
-                                               Thirty360())));
+                new PiecewiseDefaultCurve<T,I,B>(today, helpers,
+                                                 Thirty360())));
 
         Real notional = 1.0;
         double tolerance = 1.0e-6;
@@ -223,7 +225,7 @@ namespace {
     }
 
 
-    template <class T, class I>
+    template <class T, class I, template <class> class B>
     void testBootstrapFromUpfront() {
 
         Calendar calendar = TARGET();
@@ -270,8 +272,8 @@ namespace {
         RelinkableHandle<DefaultProbabilityTermStructure> piecewiseCurve;
         piecewiseCurve.linkTo(
             boost::shared_ptr<DefaultProbabilityTermStructure>(
-                new PiecewiseDefaultCurve<T,I>(today, helpers,
-                                               Thirty360())));
+                new PiecewiseDefaultCurve<T,I,B>(today, helpers,
+                                                 Thirty360())));
 
         Real notional = 1.0;
         double tolerance = 1.0e-6;
@@ -313,26 +315,26 @@ namespace {
 
 void DefaultProbabilityCurveTest::testFlatHazardConsistency() {
     BOOST_TEST_MESSAGE("Testing piecewise-flat hazard-rate consistency...");
-    testBootstrapFromSpread<HazardRate,BackwardFlat>();
-    testBootstrapFromUpfront<HazardRate,BackwardFlat>();
+    testBootstrapFromSpread<HazardRate,BackwardFlat,IterativeBootstrap>();
+    testBootstrapFromUpfront<HazardRate,BackwardFlat,IterativeBootstrap>();
 }
 
 void DefaultProbabilityCurveTest::testFlatDensityConsistency() {
     BOOST_TEST_MESSAGE("Testing piecewise-flat default-density consistency...");
-    testBootstrapFromSpread<DefaultDensity,BackwardFlat>();
-    testBootstrapFromUpfront<DefaultDensity,BackwardFlat>();
+    testBootstrapFromSpread<DefaultDensity,BackwardFlat,IterativeBootstrap>();
+    testBootstrapFromUpfront<DefaultDensity,BackwardFlat,IterativeBootstrap>();
 }
 
 void DefaultProbabilityCurveTest::testLinearDensityConsistency() {
     BOOST_TEST_MESSAGE("Testing piecewise-linear default-density consistency...");
-    testBootstrapFromSpread<DefaultDensity,Linear>();
-    testBootstrapFromUpfront<DefaultDensity,Linear>();
+    testBootstrapFromSpread<DefaultDensity,Linear,IterativeBootstrap>();
+    testBootstrapFromUpfront<DefaultDensity,Linear,IterativeBootstrap>();
 }
 
 void DefaultProbabilityCurveTest::testLogLinearSurvivalConsistency() {
     BOOST_TEST_MESSAGE("Testing log-linear survival-probability consistency...");
-    testBootstrapFromSpread<SurvivalProbability,LogLinear>();
-    testBootstrapFromUpfront<SurvivalProbability,LogLinear>();
+    testBootstrapFromSpread<SurvivalProbability,LogLinear,IterativeBootstrap>();
+    testBootstrapFromUpfront<SurvivalProbability,LogLinear,IterativeBootstrap>();
 }
 
 void DefaultProbabilityCurveTest::testSingleInstrumentBootstrap() {
@@ -378,7 +380,7 @@ void DefaultProbabilityCurveTest::testUpfrontBootstrap() {
     // not taken into account, this would prevent the upfront from being used
     Settings::instance().includeTodaysCashFlows() = false;
 
-    testBootstrapFromUpfront<HazardRate,BackwardFlat>();
+    testBootstrapFromUpfront<HazardRate,BackwardFlat,IterativeBootstrap>();
 
     // also ensure that we didn't override the flag permanently
     boost::optional<bool> flag = Settings::instance().includeTodaysCashFlows();
@@ -387,6 +389,14 @@ void DefaultProbabilityCurveTest::testUpfrontBootstrap() {
 }
 
 
+void DefaultProbabilityCurveTest::testGlobalBootstrapConsistency() {
+    BOOST_TEST_MESSAGE("Testing consistency of global-bootstrap algorithm...");
+    testBootstrapFromSpread<HazardRate,Cubic,GlobalBootstrap>();
+    testBootstrapFromUpfront<HazardRate,Cubic,GlobalBootstrap>();
+    testBootstrapFromSpread<DefaultDensity,Linear,GlobalBootstrap>();
+}
+
+
 test_suite* DefaultProbabilityCurveTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Default-probability curve tests");
     suite->add(QUANTLIB_TEST_CASE(
@@ -405,5 +415,7 @@ test_suite* DefaultProbabilityCurveTest::suite() {
                 &DefaultProbabilityCurveTest::testSingleInstrumentBootstrap));
     suite->add(QUANTLIB_TEST_CASE(
                          &DefaultProbabilityCurveTest::testUpfrontBootstrap));
+    suite->add(QUANTLIB_TEST_CASE(
+               &DefaultProbabilityCurveTest::testGlobalBootstrapConsistency));
     return suite;
 }
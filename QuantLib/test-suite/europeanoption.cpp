@@ -1265,6 +1265,244 @@ void EuropeanOptionTest::testQmcEngines() {
     testEngineConsistency(engine,steps,samples,relativeTol);
 }
 
+void EuropeanOptionTest::testMultiThreadedMcEngines() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded Monte Carlo "
+                       "European engines...");
+
+    SavedSettings backup;
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    boost::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.03, dc);
+    boost::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.06, dc);
+    boost::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.2, dc);
+    boost::shared_ptr<BlackScholesMertonProcess> process(new
+        BlackScholesMertonProcess(Handle<Quote>(spot),
+                                  Handle<YieldTermStructure>(qTS),
+                                  Handle<YieldTermStructure>(rTS),
+                                  Handle<BlackVolTermStructure>(volTS)));
+
+    boost::shared_ptr<StrikedTypePayoff> payoff(
+                                 new PlainVanillaPayoff(Option::Call, 105.0));
+    boost::shared_ptr<Exercise> exercise(
+                                 new EuropeanExercise(today + Period(1,Years)));
+    EuropeanOption option(payoff, exercise);
+
+    option.setPricingEngine(boost::shared_ptr<PricingEngine>(
+                                   new AnalyticEuropeanEngine(process)));
+    Real expected = option.NPV();
+
+    const Size samples = 20000;
+    const Size threads[] = { 1, 2, 3, 8 };
+
+    // the samples must be the same drawn in sequential mode
+    option.setPricingEngine(
+        MakeMCEuropeanEngine<PseudoRandom>(process)
+        .withSteps(1)
+        .withSamples(samples)
+        .withSeed(42)
+        .withAntitheticVariate());
+    Real pseudoRandomValue = option.NPV();
+    option.setPricingEngine(
+        MakeMCEuropeanEngine<LowDiscrepancy>(process)
+        .withSteps(1)
+        .withSamples(samples));
+    Real lowDiscrepancyValue = option.NPV();
+
+    Real tolerance = 1.0e-10;
+    for (Size i=0; i<LENGTH(threads); ++i) {
+        option.setPricingEngine(
+            MakeMCEuropeanEngine<PseudoRandom>(process)
+            .withSteps(1)
+            .withSamples(samples)
+            .withSeed(42)
+            .withAntitheticVariate()
+            .withThreads(threads[i]));
+        Real calculated = option.NPV();
+        Real error = option.errorEstimate();
+
+        if (std::fabs(calculated-expected) > 3.0*error)
+            BOOST_ERROR("failed to reproduce analytic price with "
+                        << threads[i] << " threads"
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected
+                        << "\n    error:      " << error);
+        if (std::fabs(calculated-pseudoRandomValue) > tolerance)
+            BOOST_ERROR("failed to reproduce sequential pseudo-random result"
+                        << "\n    threads:    " << threads[i]
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << pseudoRandomValue);
+
+        option.setPricingEngine(
+            MakeMCEuropeanEngine<LowDiscrepancy>(process)
+            .withSteps(1)
+            .withSamples(samples)
+            .withThreads(threads[i]));
+        calculated = option.NPV();
+
+        if (std::fabs(calculated-expected) > 0.01*expected)
+            BOOST_ERROR("failed to reproduce analytic price with "
+                        << threads[i] << " threads"
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected);
+        if (std::fabs(calculated-lowDiscrepancyValue) > tolerance)
+            BOOST_ERROR("failed to reproduce sequential low-discrepancy result"
+                        << "\n    threads:    " << threads[i]
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << lowDiscrepancyValue);
+    }
+}
+
+void EuropeanOptionTest::testMultiThreadedMcEnginesOnFreshProcess() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded Monte Carlo "
+                       "European engines on a fresh process...");
+
+    SavedSettings backup;
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    boost::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.03, dc);
+    boost::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.06, dc);
+    boost::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.2, dc);
+
+    boost::shared_ptr<StrikedTypePayoff> payoff(
+                                 new PlainVanillaPayoff(Option::Call, 105.0));
+    boost::shared_ptr<Exercise> exercise(
+                                 new EuropeanExercise(today + Period(1,Years)));
+    EuropeanOption option(payoff, exercise);
+
+    const Size samples = 20000;
+    const Size threads[] = { 2, 3, 8 };
+
+    // the process is never used before going multi-threaded, so that
+    // its local volatility is first required by the workers.
+    Real tolerance = 1.0e-10;
+    for (Size i=0; i<LENGTH(threads); ++i) {
+        boost::shared_ptr<BlackScholesMertonProcess> process(new
+            BlackScholesMertonProcess(Handle<Quote>(spot),
+                                      Handle<YieldTermStructure>(qTS),
+                                      Handle<YieldTermStructure>(rTS),
+                                      Handle<BlackVolTermStructure>(volTS)));
+        option.setPricingEngine(
+            MakeMCEuropeanEngine<PseudoRandom>(process)
+            .withSteps(10)
+            .withSamples(samples)
+            .withSeed(42)
+            .withThreads(threads[i]));
+        Real calculated = option.NPV();
+
+        boost::shared_ptr<BlackScholesMertonProcess> sequentialProcess(new
+            BlackScholesMertonProcess(Handle<Quote>(spot),
+                                      Handle<YieldTermStructure>(qTS),
+                                      Handle<YieldTermStructure>(rTS),
+                                      Handle<BlackVolTermStructure>(volTS)));
+        option.setPricingEngine(
+            MakeMCEuropeanEngine<PseudoRandom>(sequentialProcess)
+            .withSteps(10)
+            .withSamples(samples)
+            .withSeed(42));
+        Real expected = option.NPV();
+
+        if (std::fabs(calculated-expected) > tolerance)
+            BOOST_ERROR("failed to reproduce sequential result "
+                        "on a fresh process"
+                        << "\n    threads:    " << threads[i]
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected);
+    }
+}
+
+void EuropeanOptionTest::testMcEnginesInBlocks() {
+
+    BOOST_TEST_MESSAGE("Testing Monte Carlo European engines "
+                       "drawing paths in blocks...");
+
+    SavedSettings backup;
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    boost::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.03, dc);
+    boost::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.06, dc);
+    boost::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.2, dc);
+    boost::shared_ptr<BlackScholesMertonProcess> process(new
+        BlackScholesMertonProcess(Handle<Quote>(spot),
+                                  Handle<YieldTermStructure>(qTS),
+                                  Handle<YieldTermStructure>(rTS),
+                                  Handle<BlackVolTermStructure>(volTS)));
+
+    boost::shared_ptr<StrikedTypePayoff> payoff(
+                                 new PlainVanillaPayoff(Option::Put, 95.0));
+    boost::shared_ptr<Exercise> exercise(
+                                 new EuropeanExercise(today + Period(1,Years)));
+    EuropeanOption option(payoff, exercise);
+
+    const Size samples = 10000;
+    // the last block is shorter than the others
+    const Size blockSizes[] = { 1, 100, 300, 20000 };
+    const Size threads[] = { Null<Size>(), 3 };
+
+    option.setPricingEngine(
+        MakeMCEuropeanEngine<PseudoRandom>(process)
+        .withSteps(10)
+        .withSamples(samples)
+        .withSeed(42)
+        .withAntitheticVariate());
+    Real pseudoRandomValue = option.NPV();
+    option.setPricingEngine(
+        MakeMCEuropeanEngine<LowDiscrepancy>(process)
+        .withSteps(10)
+        .withBrownianBridge()
+        .withSamples(samples));
+    Real lowDiscrepancyValue = option.NPV();
+
+    Real tolerance = 1.0e-10;
+    for (Size i=0; i<LENGTH(blockSizes); ++i) {
+        for (Size k=0; k<LENGTH(threads); ++k) {
+            option.setPricingEngine(
+                MakeMCEuropeanEngine<PseudoRandom>(process)
+                .withSteps(10)
+                .withSamples(samples)
+                .withSeed(42)
+                .withAntitheticVariate()
+                .withThreads(threads[k])
+                .withBlockSize(blockSizes[i]));
+            Real calculated = option.NPV();
+            if (std::fabs(calculated-pseudoRandomValue) > tolerance)
+                BOOST_ERROR("failed to reproduce pseudo-random result "
+                            "with paths drawn in blocks"
+                            << "\n    block size: " << blockSizes[i]
+                            << "\n    calculated: " << calculated
+                            << "\n    expected:   " << pseudoRandomValue);
+
+            option.setPricingEngine(
+                MakeMCEuropeanEngine<LowDiscrepancy>(process)
+                .withSteps(10)
+                .withBrownianBridge()
+                .withSamples(samples)
+                .withThreads(threads[k])
+                .withBlockSize(blockSizes[i]));
+            calculated = option.NPV();
+            if (std::fabs(calculated-lowDiscrepancyValue) > tolerance)
+                BOOST_ERROR("failed to reproduce low-discrepancy result "
+                            "with paths drawn in blocks"
+                            << "\n    block size: " << blockSizes[i]
+                            << "\n    calculated: " << calculated
+                            << "\n    expected:   " << lowDiscrepancyValue);
+        }
+    }
+}
+
 void EuropeanOptionTest::testFFTEngines() {
 
     BOOST_TEST_MESSAGE("Testing FFT European engines "
@@ -1514,6 +1752,143 @@ void EuropeanOptionTest::testLocalVolatility() {
 }
 
 
+void EuropeanOptionTest::testFdMultipleStrikesEngine() {
+
+    BOOST_TEST_MESSAGE("Testing multiple-strikes FD Black-Scholes engine...");
+
+    SavedSettings backup;
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    boost::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.02, dc);
+    boost::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.05, dc);
+    boost::shared_ptr<BlackVolTermStructure> volTS = flatVol(today, 0.25, dc);
+    boost::shared_ptr<BlackScholesMertonProcess> process(new
+        BlackScholesMertonProcess(Handle<Quote>(spot),
+                                  Handle<YieldTermStructure>(qTS),
+                                  Handle<YieldTermStructure>(rTS),
+                                  Handle<BlackVolTermStructure>(volTS)));
+
+    std::vector<Real> strikes;
+    strikes.push_back(100.0); strikes.push_back(80.0);
+    strikes.push_back(90.0);  strikes.push_back(110.0);
+    strikes.push_back(120.0);
+
+    // all strikes and exercises go through the same engine, so
+    // that results cached for a maturity must survive the
+    // calculations for the other ones.
+    std::vector<boost::shared_ptr<Exercise> > exercises;
+    exercises.push_back(boost::shared_ptr<Exercise>(
+                          new EuropeanExercise(today + Period(6, Months))));
+    exercises.push_back(boost::shared_ptr<Exercise>(
+                          new EuropeanExercise(today + Period(1, Years))));
+    exercises.push_back(boost::shared_ptr<Exercise>(
+                   new AmericanExercise(today, today + Period(1, Years))));
+
+    boost::shared_ptr<FdBlackScholesVanillaEngine> singleStrikeEngine(
+                        new FdBlackScholesVanillaEngine(process, 100, 400));
+    boost::shared_ptr<FdBlackScholesVanillaEngine> multiStrikeEngine(
+                        new FdBlackScholesVanillaEngine(process, 100, 400));
+    multiStrikeEngine->enableMultipleStrikesCaching(strikes);
+
+    std::vector<Real> cached;
+    for (Size pass=0; pass<2; ++pass) {
+        Size hits = multiStrikeEngine->multipleStrikesCacheHits();
+        Size k = 0;
+        for (Size i=0; i<exercises.size(); ++i) {
+            for (Size j=0; j<strikes.size(); ++j, ++k) {
+                boost::shared_ptr<StrikedTypePayoff> payoff(
+                               new PlainVanillaPayoff(Option::Put, strikes[j]));
+                VanillaOption option(payoff, exercises[i]);
+
+                option.setPricingEngine(multiStrikeEngine);
+                Real calculated = option.NPV();
+                Real calculatedDelta = option.delta();
+
+                if (pass == 1) {
+                    if (calculated != cached[k])
+                        BOOST_FAIL("cached result not reused for "
+                                   << "\n    strike:     " << strikes[j]
+                                   << "\n    maturity:   "
+                                   << exercises[i]->lastDate()
+                                   << "\n    first pass: " << cached[k]
+                                   << "\n    second:     " << calculated);
+                    continue;
+                }
+                cached.push_back(calculated);
+
+                option.setPricingEngine(singleStrikeEngine);
+                Real expected = option.NPV();
+                Real expectedDelta = option.delta();
+
+                Real relTol = 5e-3;
+                if (std::fabs(calculated-expected) > relTol*expected)
+                    BOOST_FAIL("failed to reproduce price with FD multi "
+                               "strike engine"
+                               << "\n    strike:     " << strikes[j]
+                               << "\n    maturity:   "
+                               << exercises[i]->lastDate()
+                               << "\n    calculated: " << calculated
+                               << "\n    expected:   " << expected);
+                if (std::fabs(calculatedDelta-expectedDelta)
+                                            > relTol*std::fabs(expectedDelta))
+                    BOOST_FAIL("failed to reproduce delta with FD multi "
+                               "strike engine"
+                               << "\n    strike:     " << strikes[j]
+                               << "\n    maturity:   "
+                               << exercises[i]->lastDate()
+                               << "\n    calculated: " << calculatedDelta
+                               << "\n    expected:   " << expectedDelta);
+            }
+        }
+
+        // on the first pass, only the first strike of each maturity
+        // needs a rollback; on the second, none does.
+        Size expectedHits = (pass == 0 ?
+                             exercises.size()*(strikes.size()-1) :
+                             exercises.size()*strikes.size());
+        hits = multiStrikeEngine->multipleStrikesCacheHits() - hits;
+        if (hits != expectedHits)
+            BOOST_FAIL("unexpected number of cached results used"
+                       << "\n    pass:       " << pass
+                       << "\n    calculated: " << hits
+                       << "\n    expected:   " << expectedHits);
+    }
+
+    // digitals can't be rescaled across strikes; pricing one must
+    // not leave results behind for plain vanillas with its strike.
+    multiStrikeEngine->enableMultipleStrikesCaching(strikes);
+    Size hits = multiStrikeEngine->multipleStrikesCacheHits();
+
+    boost::shared_ptr<StrikedTypePayoff> digitalPayoff(
+                  new CashOrNothingPayoff(Option::Put, strikes[0], 10.0));
+    VanillaOption digital(digitalPayoff, exercises[1]);
+    digital.setPricingEngine(multiStrikeEngine);
+    digital.NPV();
+
+    boost::shared_ptr<StrikedTypePayoff> payoff(
+                         new PlainVanillaPayoff(Option::Put, strikes[0]));
+    VanillaOption option(payoff, exercises[1]);
+    option.setPricingEngine(multiStrikeEngine);
+    Real calculated = option.NPV();
+    option.setPricingEngine(singleStrikeEngine);
+    Real expected = option.NPV();
+
+    if (multiStrikeEngine->multipleStrikesCacheHits() != hits)
+        BOOST_FAIL("digital results returned from the cache "
+                   "for a plain-vanilla option");
+    if (std::fabs(calculated-expected) > 5e-3*expected)
+        BOOST_FAIL("failed to reproduce price with FD multi strike engine "
+                   "after pricing a digital"
+                   << "\n    strike:     " << strikes[0]
+                   << "\n    calculated: " << calculated
+                   << "\n    expected:   " << expected);
+}
+
+
 test_suite* EuropeanOptionTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("European option tests");
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testValues));
@@ -1534,9 +1909,16 @@ test_suite* EuropeanOptionTest::suite() {
                               &EuropeanOptionTest::testJOSHIBinomialEngines));
     // FLOATING_POINT_EXCEPTION
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testFdEngines));
+    suite->add(QUANTLIB_TEST_CASE(
+                            &EuropeanOptionTest::testFdMultipleStrikesEngine));
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testIntegralEngines));
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testMcEngines));
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testQmcEngines));
+    suite->add(QUANTLIB_TEST_CASE(
+                             &EuropeanOptionTest::testMultiThreadedMcEngines));
+    suite->add(QUANTLIB_TEST_CASE(
+               &EuropeanOptionTest::testMultiThreadedMcEnginesOnFreshProcess));
+    suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testMcEnginesInBlocks));
 
     // FLOATING_POINT_EXCEPTION
     suite->add(QUANTLIB_TEST_CASE(&EuropeanOptionTest::testPriceCurve));
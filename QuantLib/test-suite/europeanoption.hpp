@@ -41,9 +41,13 @@ class EuropeanOptionTest {
     static void testLRBinomialEngines();
     static void testJOSHIBinomialEngines();
     static void testFdEngines();
+    static void testFdMultipleStrikesEngine();
     static void testIntegralEngines();
     static void testQmcEngines();
     static void testMcEngines();
+    static void testMultiThreadedMcEngines();
+    static void testMultiThreadedMcEnginesOnFreshProcess();
+    static void testMcEnginesInBlocks();
     static void testFFTEngines();
     static void testPriceCurve();
     static void testLocalVolatility();
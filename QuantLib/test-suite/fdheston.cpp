@@ -1282,6 +1282,63 @@ void FdHestonTest::testHestonFokkerPlanckFwdEquation() {
     }
 }
 
+void FdHestonTest::testFdmHestonMultiThreaded() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded FDM Heston schemes...");
+
+    SavedSettings backup;
+
+    Settings::instance().evaluationDate() = Date(28, March, 2004);
+    Date exerciseDate(28, March, 2005);
+
+    Handle<Quote> s0(boost::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> rTS(flatRate(0.05, Actual365Fixed()));
+    Handle<YieldTermStructure> qTS(flatRate(0.02, Actual365Fixed()));
+
+    boost::shared_ptr<HestonModel> model(new HestonModel(
+        boost::shared_ptr<HestonProcess>(
+           new HestonProcess(rTS, qTS, s0, 0.04, 2.5, 0.04, 0.66, -0.8))));
+
+    boost::shared_ptr<Exercise> exercise(new AmericanExercise(exerciseDate));
+    boost::shared_ptr<StrikedTypePayoff> payoff(new
+                                      PlainVanillaPayoff(Option::Put, 100));
+    VanillaOption option(payoff, exercise);
+
+    const FdmSchemeDesc serial[] = {
+        FdmSchemeDesc::Douglas(1), FdmSchemeDesc::CraigSneyd(1),
+        FdmSchemeDesc::ModifiedCraigSneyd(1), FdmSchemeDesc::Hundsdorfer(1)
+    };
+    const FdmSchemeDesc parallel[] = {
+        FdmSchemeDesc::Douglas(4), FdmSchemeDesc::CraigSneyd(4),
+        FdmSchemeDesc::ModifiedCraigSneyd(4), FdmSchemeDesc::Hundsdorfer(4)
+    };
+
+    for (Size i=0; i < LENGTH(serial); ++i) {
+        option.setPricingEngine(boost::shared_ptr<PricingEngine>(
+            new FdHestonVanillaEngine(model, 50, 100, 51, 1, serial[i])));
+        const Real npv = option.NPV();
+        const Real delta = option.delta();
+        const Real gamma = option.gamma();
+
+        option.setPricingEngine(boost::shared_ptr<PricingEngine>(
+            new FdHestonVanillaEngine(model, 50, 100, 51, 1, parallel[i])));
+
+        // results must be the same to the last bit
+        if (option.NPV() != npv
+            || option.delta() != delta
+            || option.gamma() != gamma) {
+            BOOST_ERROR("multi-threaded rollback doesn't reproduce "
+                        "single-threaded results"
+                        << std::setprecision(16)
+                        << "\n    scheme:            " << i
+                        << "\n    single-threaded:   "
+                        << npv << ", " << delta << ", " << gamma
+                        << "\n    multi-threaded:    " << option.NPV()
+                        << ", " << option.delta() << ", " << option.gamma());
+        }
+    }
+}
+
 test_suite* FdHestonTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Finite Difference Heston tests");
     suite->add(QUANTLIB_TEST_CASE(&FdHestonTest::testFdmHestonBarrier));
@@ -1294,6 +1351,7 @@ test_suite* FdHestonTest::suite() {
                     &FdHestonTest::testFdmHestonEuropeanWithDividends));
 
     suite->add(QUANTLIB_TEST_CASE(&FdHestonTest::testFdmHestonConvergence));
+    suite->add(QUANTLIB_TEST_CASE(&FdHestonTest::testFdmHestonMultiThreaded));
     return suite;
 }
 
@@ -33,6 +33,7 @@ public:
     static void testFdmHestonIkonenToivanen();
     static void testFdmHestonEuropeanWithDividends();
     static void testFdmHestonConvergence();
+    static void testFdmHestonMultiThreaded();
     static void testFdmHestonBlackScholes();
     static void testBlackScholesFokkerPlanckFwdEquation();
     static void testSquareRootZeroFlowBC();
@@ -1311,6 +1311,199 @@ void FdmLinearOpTest::testSparseMatrixZeroAssignment() {
 #endif
 }
 
+namespace {
+
+    bool sameArrays(const Array& a, const Array& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(),
+                                                  b.begin());
+    }
+
+    void checkInPlaceOperator(const std::string& name,
+                              FdmLinearOpComposite& op, Size size) {
+        op.setTime(0.4, 0.5);
+
+        Array r(size);
+        for (Size i=0; i < size; ++i)
+            r[i] = std::sin(0.01*i) + 0.001*i;
+
+        Array out, workspace;
+        op.apply(r, out);
+        if (!sameArrays(out, op.apply(r)))
+            BOOST_ERROR(name << ": in-place apply failed");
+
+        op.apply_mixed(r, out);
+        if (!sameArrays(out, op.apply_mixed(r)))
+            BOOST_ERROR(name << ": in-place apply_mixed failed");
+
+        for (Size i=0; i < op.size(); ++i) {
+            op.apply_direction(i, r, out);
+            if (!sameArrays(out, op.apply_direction(i, r)))
+                BOOST_ERROR(name << ": in-place apply_direction failed"
+                            << "\n    direction: " << i);
+
+            const Array expected = op.solve_splitting(i, r, -0.01);
+            op.solve_splitting(i, r, -0.01, out, workspace);
+            if (!sameArrays(out, expected))
+                BOOST_ERROR(name << ": in-place solve_splitting failed"
+                            << "\n    direction: " << i);
+
+            // input and output can be the same array
+            out = r;
+            op.solve_splitting(i, out, -0.01, out, workspace);
+            if (!sameArrays(out, expected))
+                BOOST_ERROR(name << ": aliased solve_splitting failed"
+                            << "\n    direction: " << i);
+        }
+    }
+
+}
+
+void FdmLinearOpTest::testInPlaceOperators() {
+    BOOST_TEST_MESSAGE("Testing in-place application of FDM operators...");
+
+    SavedSettings backup;
+
+    const Date today = Date(28, March, 2004);
+    Settings::instance().evaluationDate() = today;
+
+    Size dims[] = {21, 11, 9};
+    const std::vector<Size> dim(dims, dims+LENGTH(dims));
+
+    boost::shared_ptr<HybridHestonHullWhiteProcess> jointProcess
+                                                = createHestonHullWhite(2.0);
+    FdmSolverDesc desc = createSolverDesc(dim, jointProcess);
+    boost::shared_ptr<FdmMesher> mesher = desc.mesher;
+
+    boost::shared_ptr<HullWhiteForwardProcess> hwFwdProcess
+                                            = jointProcess->hullWhiteProcess();
+    boost::shared_ptr<HullWhiteProcess> hwProcess(
+        new HullWhiteProcess(jointProcess->hestonProcess()->riskFreeRate(),
+                             hwFwdProcess->a(), hwFwdProcess->sigma()));
+
+    FdmHestonHullWhiteOp hestonHullWhiteOp(mesher,
+                                           jointProcess->hestonProcess(),
+                                           hwProcess, jointProcess->eta());
+    checkInPlaceOperator("Heston Hull-White operator", hestonHullWhiteOp,
+                         mesher->layout()->size());
+
+    const std::vector<Size> dim2(dims, dims+2);
+    std::vector<std::pair<Real, Real> > boundaries;
+    boundaries.push_back(std::pair<Real, Real>(3.8, 4.905274778));
+    boundaries.push_back(std::pair<Real, Real>(0.0, 1.0));
+    boost::shared_ptr<FdmMesher> mesher2(new UniformGridMesher(
+        boost::shared_ptr<FdmLinearOpLayout>(new FdmLinearOpLayout(dim2)),
+        boundaries));
+
+    FdmHestonOp hestonOp(mesher2, jointProcess->hestonProcess());
+    checkInPlaceOperator("Heston operator", hestonOp,
+                         mesher2->layout()->size());
+}
+
+void FdmLinearOpTest::testStencilKernels() {
+    BOOST_TEST_MESSAGE("Testing FDM stencil kernels on a 3-D grid...");
+
+    /* The same grid is used for all directions, so that both the
+       contiguous and the strided lines are exercised. */
+    Size dims[] = {100, 50, 30};
+    const std::vector<Size> dim(dims, dims+LENGTH(dims));
+
+    boost::shared_ptr<FdmLinearOpLayout> layout(new FdmLinearOpLayout(dim));
+
+    std::vector<std::pair<Real, Real> > boundaries;
+    boundaries.push_back(std::pair<Real, Real>(-1.0, 1.0));
+    boundaries.push_back(std::pair<Real, Real>( 0.0, 2.0));
+    boundaries.push_back(std::pair<Real, Real>( 0.5, 1.0));
+
+    boost::shared_ptr<FdmMesher> mesher(
+        new UniformGridMesher(layout, boundaries));
+
+    const Size n = layout->size();
+    Array r(n), c(n);
+    std::vector<Array> inner(dim.size(), Array(n, 1.0));
+    const FdmLinearOpIterator endIter = layout->end();
+    for (FdmLinearOpIterator iter = layout->begin();
+         iter != endIter; ++iter) {
+        const Size i = iter.index();
+        const Real x = mesher->location(iter, 0);
+        const Real y = mesher->location(iter, 1);
+        const Real z = mesher->location(iter, 2);
+        r[i] = std::sin(3*x)*std::cos(y) + z;
+        c[i] = 1.0 + 0.5*x*y*z;
+        for (Size d=0; d < dim.size(); ++d) {
+            const Size k = iter.coordinates()[d];
+            if (k == 0 || k == dim[d]-1)
+                inner[d][i] = 0.0;
+        }
+    }
+
+    const Real tol = 1e-10;
+    Array out(n);
+
+    for (Size d=0; d < dim.size(); ++d) {
+        // rows on the boundary are removed, so that the lines are
+        // proper tridiagonal systems
+        const TripleBandLinearOp op =
+            SecondDerivativeOp(d, mesher).mult(c).mult(inner[d]);
+        const Real a = -0.01;
+
+        op.apply(r, out);
+        #if !defined(QL_NO_UBLAS_SUPPORT)
+        const Array expected = prod(op.toMatrix(), r);
+        for (Size i=0; i < n; ++i) {
+            if (std::fabs(out[i]-expected[i]) > tol*(1.0+std::fabs(out[i])))
+                BOOST_FAIL("triple-band operator application failed"
+                           << "\n    direction:  " << d
+                           << "\n    index:      " << i
+                           << "\n    calculated: " << out[i]
+                           << "\n    expected:   " << expected[i]);
+        }
+        #endif
+
+        const Array x = op.solve_splitting(r, a);
+        const Array residual = a*op.apply(x) + x - r;
+        for (Size i=0; i < n; ++i) {
+            if (std::fabs(residual[i]) > tol)
+                BOOST_FAIL("triple-band splitting solve failed"
+                           << "\n    direction:  " << d
+                           << "\n    index:      " << i
+                           << "\n    residual:   " << residual[i]);
+        }
+
+        // in place, as done by the schemes
+        out = r;
+        op.solve_splitting(out, a, 1.0, out);
+        for (Size i=0; i < n; ++i) {
+            if (std::fabs(out[i]-x[i]) > tol*(1.0+std::fabs(x[i])))
+                BOOST_FAIL("in-place triple-band splitting solve failed"
+                           << "\n    direction:  " << d
+                           << "\n    index:      " << i
+                           << "\n    calculated: " << out[i]
+                           << "\n    expected:   " << x[i]);
+        }
+    }
+
+    const Size mixed[][2] = { {0, 1}, {0, 2}, {1, 2}, {2, 0} };
+    for (Size j=0; j < LENGTH(mixed); ++j) {
+        const NinePointLinearOp op =
+            SecondOrderMixedDerivativeOp(mixed[j][0], mixed[j][1],
+                                         mesher).mult(c);
+        op.apply(r, out);
+
+        #if !defined(QL_NO_UBLAS_SUPPORT)
+        const Array expected = prod(op.toMatrix(), r);
+        for (Size i=0; i < n; ++i) {
+            if (std::fabs(out[i]-expected[i]) > tol*(1.0+std::fabs(out[i])))
+                BOOST_FAIL("nine-point operator application failed"
+                           << "\n    directions: " << mixed[j][0]
+                           << ", " << mixed[j][1]
+                           << "\n    index:      " << i
+                           << "\n    calculated: " << out[i]
+                           << "\n    expected:   " << expected[i]);
+        }
+        #endif
+    }
+}
+
 test_suite* FdmLinearOpTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("linear operator tests");
 
@@ -1330,6 +1523,8 @@ test_suite* FdmLinearOpTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testFdmHestonAmerican));
     suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testFdmHestonExpress));
     suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testFdmHestonHullWhiteOp));
+    suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testInPlaceOperators));
+    suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testStencilKernels));
     suite->add(QUANTLIB_TEST_CASE(&FdmLinearOpTest::testBiCGstab));
     suite->add(
         QUANTLIB_TEST_CASE(&FdmLinearOpTest::testCrankNicolsonWithDamping));
@@ -39,6 +39,8 @@ public:
     static void testFdmHestonAmerican();
     static void testFdmHestonExpress();
     static void testFdmHestonHullWhiteOp();
+    static void testInPlaceOperators();
+    static void testStencilKernels();
     static void testBiCGstab();
     static void testCrankNicolsonWithDamping();
     static void testSpareMatrixReference();
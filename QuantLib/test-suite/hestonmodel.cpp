@@ -28,6 +28,7 @@
 #include <ql/models/equity/piecewisetimedependenthestonmodel.hpp>
 #include <ql/pricingengines/vanilla/analyticdividendeuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/analytichestonengine.hpp>
+#include <ql/pricingengines/vanilla/batesengine.hpp>
 #include <ql/pricingengines/vanilla/fdamericanengine.hpp>
 #include <ql/pricingengines/vanilla/fddividendeuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/fdeuropeanengine.hpp>
@@ -38,6 +39,7 @@
 #include <ql/pricingengines/vanilla/fdhestonvanillaengine.hpp>
 #include <ql/pricingengines/vanilla/mceuropeanhestonengine.hpp>
 #include <ql/experimental/exoticoptions/analyticpdfhestonengine.hpp>
+#include <ql/experimental/variancegamma/ffthestonengine.hpp>
 #include <ql/pricingengines/blackformula.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/calendars/nullcalendar.hpp>
@@ -1017,6 +1019,140 @@ void HestonModelTest::testMultipleStrikesEngine() {
 
 
 
+void HestonModelTest::testCachedIntegrands() {
+    BOOST_TEST_MESSAGE("Testing Heston engines with cached integrands...");
+
+    SavedSettings backup;
+
+    const Date settlementDate(5, July, 2002);
+    Settings::instance().evaluationDate() = settlementDate;
+    const DayCounter dayCounter = Actual365Fixed();
+
+    boost::shared_ptr<SimpleQuote> r(new SimpleQuote(0.03));
+    const Handle<YieldTermStructure> riskFreeTS(
+        flatRate(settlementDate, r, dayCounter));
+    const Handle<YieldTermStructure> dividendTS(
+        flatRate(settlementDate, 0.01, dayCounter));
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    const Handle<Quote> s0(spot);
+
+    const Real v0 = 0.04, kappa = 1.5, theta = 0.05, sigma = 0.5, rho = -0.7;
+    boost::shared_ptr<HestonModel> hestonModel(new HestonModel(
+        boost::shared_ptr<HestonProcess>(new HestonProcess(
+            riskFreeTS, dividendTS, s0, v0, kappa, theta, sigma, rho))));
+    boost::shared_ptr<BatesModel> batesModel(new BatesModel(
+        boost::shared_ptr<BatesProcess>(new BatesProcess(
+            riskFreeTS, dividendTS, s0, v0, kappa, theta, sigma, rho,
+            0.2, -0.1, 0.15))));
+    boost::shared_ptr<PiecewiseTimeDependentHestonModel> ptdModel(
+        new PiecewiseTimeDependentHestonModel(
+            riskFreeTS, dividendTS, s0, v0,
+            ConstantParameter(theta, PositiveConstraint()),
+            ConstantParameter(kappa, PositiveConstraint()),
+            ConstantParameter(sigma, PositiveConstraint()),
+            ConstantParameter(rho, BoundaryConstraint(-1.0, 1.0)),
+            TimeGrid(5.0, 4)));
+
+    const AnalyticHestonEngine::Integration legendre =
+        AnalyticHestonEngine::Integration::gaussLegendre(128);
+    std::vector<boost::shared_ptr<AnalyticHestonEngine> > engines;
+    engines.push_back(boost::shared_ptr<AnalyticHestonEngine>(
+                                new AnalyticHestonEngine(hestonModel, 144)));
+    engines.push_back(boost::shared_ptr<AnalyticHestonEngine>(
+        new AnalyticHestonEngine(hestonModel, AnalyticHestonEngine::Gatheral,
+                                 legendre)));
+    engines.push_back(boost::shared_ptr<AnalyticHestonEngine>(
+                                        new BatesEngine(batesModel, 144)));
+    boost::shared_ptr<PricingEngine> ptdEngine(
+                                        new AnalyticPTDHestonEngine(ptdModel));
+
+    const Integer days[] = { 30, 91, 365, 730, 1460 };
+    const Real strikes[] = { 60.0, 80.0, 95.0, 100.0, 105.0, 120.0, 150.0 };
+    const Option::Type types[] = { Option::Call, Option::Put };
+
+    // the model is modified between the two passes; the cached
+    // values must be discarded.
+    for (Size pass=0; pass<2; ++pass) {
+        for (Size i=0; i<LENGTH(days); ++i) {
+            const Date exerciseDate = settlementDate + days[i];
+            const boost::shared_ptr<Exercise> exercise(
+                                           new EuropeanExercise(exerciseDate));
+            const Time term = hestonModel->process()->time(exerciseDate);
+            const Real riskFreeDiscount = riskFreeTS->discount(exerciseDate);
+            const Real dividendDiscount = dividendTS->discount(exerciseDate);
+            for (Size j=0; j<LENGTH(strikes); ++j) {
+                for (Size k=0; k<LENGTH(types); ++k) {
+                    const boost::shared_ptr<StrikedTypePayoff> payoff(
+                              new PlainVanillaPayoff(types[k], strikes[j]));
+                    VanillaOption option(payoff, exercise);
+
+                    for (Size l=0; l<engines.size(); ++l) {
+                        option.setPricingEngine(engines[l]);
+                        const Real calculated = option.NPV();
+
+                        // same calculation without cached integrands
+                        const boost::shared_ptr<HestonModel> model =
+                            (l == 2) ? batesModel : hestonModel;
+                        Real expected;
+                        Size evaluations;
+                        AnalyticHestonEngine::doCalculation(
+                            riskFreeDiscount, dividendDiscount,
+                            spot->value(), strikes[j], term,
+                            model->kappa(), model->theta(), model->sigma(),
+                            model->v0(), model->rho(), *payoff,
+                            (l == 1) ? legendre
+                                : AnalyticHestonEngine::Integration
+                                                      ::gaussLaguerre(144),
+                            AnalyticHestonEngine::Gatheral,
+                            engines[l].get(), expected, evaluations);
+
+                        if (std::fabs(calculated-expected) > 1e-12) {
+                            BOOST_ERROR("failed to reproduce price with "
+                                        "cached integrands"
+                                        << "\n    engine:     " << l
+                                        << "\n    pass:       " << pass
+                                        << "\n    type:       " << types[k]
+                                        << "\n    strike:     " << strikes[j]
+                                        << "\n    maturity:   " << exerciseDate
+                                        << "\n    calculated: " << calculated
+                                        << "\n    expected:   " << expected);
+                        }
+                    }
+
+                    // piecewise time-dependent engine with constant
+                    // parameters vs. the cached Heston price
+                    option.setPricingEngine(engines[0]);
+                    const Real expected = option.NPV();
+                    option.setPricingEngine(ptdEngine);
+                    const Real calculated = option.NPV();
+                    if (std::fabs(calculated-expected) > 1e-10) {
+                        BOOST_ERROR("failed to reproduce Heston price with "
+                                    "piecewise time-dependent engine"
+                                    << "\n    pass:       " << pass
+                                    << "\n    type:       " << types[k]
+                                    << "\n    strike:     " << strikes[j]
+                                    << "\n    maturity:   " << exerciseDate
+                                    << "\n    calculated: " << calculated
+                                    << "\n    expected:   " << expected);
+                    }
+                }
+            }
+        }
+
+        Array params = hestonModel->params();
+        params[3] = -0.3;
+        hestonModel->setParams(params);
+        params = batesModel->params();
+        params[3] = -0.3;
+        batesModel->setParams(params);
+        params = ptdModel->params();
+        params[3] = -0.3;
+        ptdModel->setParams(params);
+        r->setValue(0.05);
+        spot->setValue(110.0);
+    }
+}
+
 void HestonModelTest::testAnalyticPiecewiseTimeDependent() {
     BOOST_TEST_MESSAGE("Testing analytic piecewise time dependent Heston prices...");
 
@@ -1330,6 +1466,113 @@ void HestonModelTest::testAnalyticPDFHestonEngine() {
     }
 }
 
+void HestonModelTest::testFFTEngines() {
+    BOOST_TEST_MESSAGE("Testing FFT engines for Heston-type models "
+                       "against analytic engines...");
+
+    SavedSettings backup;
+
+    const Date settlementDate(5, July, 2002);
+    Settings::instance().evaluationDate() = settlementDate;
+    const DayCounter dayCounter = Actual365Fixed();
+
+    const Handle<YieldTermStructure> riskFreeTS(
+        flatRate(settlementDate, 0.03, dayCounter));
+    const Handle<YieldTermStructure> dividendTS(
+        flatRate(settlementDate, 0.01, dayCounter));
+    const Handle<Quote> s0(boost::shared_ptr<Quote>(new SimpleQuote(100.0)));
+
+    const Real v0 = 0.04, kappa = 1.5, theta = 0.05, sigma = 0.5, rho = -0.7;
+    boost::shared_ptr<HestonModel> hestonModel(new HestonModel(
+        boost::shared_ptr<HestonProcess>(new HestonProcess(
+            riskFreeTS, dividendTS, s0, v0, kappa, theta, sigma, rho))));
+    boost::shared_ptr<BatesModel> batesModel(new BatesModel(
+        boost::shared_ptr<BatesProcess>(new BatesProcess(
+            riskFreeTS, dividendTS, s0, v0, kappa, theta, sigma, rho,
+            0.2, -0.1, 0.15))));
+
+    std::vector<Time> times(1, 1.0), gridTimes(times);
+    gridTimes.push_back(5.0);
+    PiecewiseConstantParameter ptdTheta(times, PositiveConstraint());
+    ptdTheta.setParam(0, 0.04);
+    ptdTheta.setParam(1, 0.06);
+    PiecewiseConstantParameter ptdSigma(times, PositiveConstraint());
+    ptdSigma.setParam(0, 0.6);
+    ptdSigma.setParam(1, 0.4);
+    boost::shared_ptr<PiecewiseTimeDependentHestonModel> ptdModel(
+        new PiecewiseTimeDependentHestonModel(
+            riskFreeTS, dividendTS, s0, v0, ptdTheta,
+            ConstantParameter(kappa, PositiveConstraint()), ptdSigma,
+            ConstantParameter(rho, BoundaryConstraint(-1.0, 1.0)),
+            TimeGrid(gridTimes.begin(), gridTimes.end())));
+
+    std::vector<boost::shared_ptr<PricingEngine> > analyticEngines;
+    std::vector<boost::shared_ptr<FFTEngine> > fftEngines;
+    analyticEngines.push_back(boost::shared_ptr<PricingEngine>(
+                                        new AnalyticHestonEngine(hestonModel)));
+    fftEngines.push_back(boost::shared_ptr<FFTEngine>(
+                                        new FFTHestonEngine(hestonModel)));
+    analyticEngines.push_back(boost::shared_ptr<PricingEngine>(
+                                        new BatesEngine(batesModel)));
+    fftEngines.push_back(boost::shared_ptr<FFTEngine>(
+                                        new FFTBatesEngine(batesModel)));
+    analyticEngines.push_back(boost::shared_ptr<PricingEngine>(
+                                        new AnalyticPTDHestonEngine(ptdModel)));
+    fftEngines.push_back(boost::shared_ptr<FFTEngine>(
+                                        new FFTPTDHestonEngine(ptdModel)));
+
+    // a whole strip of strikes for each maturity
+    const Integer days[] = { 30, 182, 365, 730, 1460 };
+    std::vector<boost::shared_ptr<Instrument> > options;
+    for (Size i=0; i<LENGTH(days); ++i) {
+        const boost::shared_ptr<Exercise> exercise(
+                               new EuropeanExercise(settlementDate + days[i]));
+        for (Real strike=50.0; strike<=200.0; strike+=0.5) {
+            const Option::Type type =
+                strike < 100.0 ? Option::Put : Option::Call;
+            options.push_back(boost::shared_ptr<Instrument>(new VanillaOption(
+                boost::shared_ptr<StrikedTypePayoff>(
+                                       new PlainVanillaPayoff(type, strike)),
+                exercise)));
+        }
+    }
+
+    // the grid chosen by the FFT engines leaves a small aliasing
+    // error, roughly constant across strikes; it stays below 1.2e-3
+    // for all three models.
+    const Real tol = 2.0e-3;
+    for (Size l=0; l<fftEngines.size(); ++l) {
+        std::vector<Real> expected(options.size());
+        for (Size i=0; i<options.size(); ++i) {
+            options[i]->setPricingEngine(analyticEngines[l]);
+            expected[i] = options[i]->NPV();
+        }
+
+        fftEngines[l]->precalculate(options);
+        for (Size i=0; i<options.size(); ++i) {
+            options[i]->setPricingEngine(fftEngines[l]);
+            const Real calculated = options[i]->NPV();
+            if (std::fabs(calculated-expected[i]) > tol) {
+                const boost::shared_ptr<VanillaOption> option =
+                    boost::dynamic_pointer_cast<VanillaOption>(options[i]);
+                const boost::shared_ptr<StrikedTypePayoff> payoff =
+                    boost::dynamic_pointer_cast<StrikedTypePayoff>(
+                                                            option->payoff());
+                BOOST_ERROR("failed to reproduce analytic price "
+                            "with FFT engine"
+                            << "\n    engine:     " << l
+                            << "\n    type:       " << payoff->optionType()
+                            << "\n    strike:     " << payoff->strike()
+                            << "\n    maturity:   "
+                            << option->exercise()->lastDate()
+                            << "\n    calculated: " << calculated
+                            << "\n    expected:   " << expected[i]
+                            << "\n    tolerance:  " << tol);
+            }
+        }
+    }
+}
+
 test_suite* HestonModelTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Heston model tests");
 
@@ -1345,6 +1588,7 @@ test_suite* HestonModelTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testFdBarrierVsCached));
     suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testFdVanillaVsCached));
     suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testMultipleStrikesEngine));
+    suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testCachedIntegrands));
     suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testMcVsCached));
     suite->add(QUANTLIB_TEST_CASE(
                     &HestonModelTest::testAnalyticPiecewiseTimeDependent));
@@ -1360,5 +1604,6 @@ test_suite* HestonModelTest::experimental() {
     test_suite* suite = BOOST_TEST_SUITE("Heston model tests");
     suite->add(QUANTLIB_TEST_CASE(
         &HestonModelTest::testAnalyticPDFHestonEngine));
+    suite->add(QUANTLIB_TEST_CASE(&HestonModelTest::testFFTEngines));
     return suite;
 }
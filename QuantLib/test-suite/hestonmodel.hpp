@@ -37,10 +37,12 @@ class HestonModelTest {
     static void testFdVanillaVsCached();    
     static void testDifferentIntegrals();
     static void testMultipleStrikesEngine();
+    static void testCachedIntegrands();
     static void testAnalyticPiecewiseTimeDependent();
     static void testDAXCalibrationOfTimeDependentModel();
     static void testAlanLewisReferencePrices();
     static void testAnalyticPDFHestonEngine();
+    static void testFFTEngines();
     static boost::unit_test_framework::test_suite* suite();
     static boost::unit_test_framework::test_suite* experimental();
 };
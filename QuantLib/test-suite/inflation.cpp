@@ -25,6 +25,8 @@
 #include <ql/indexes/inflation/euhicp.hpp>
 #include <ql/termstructures/inflation/piecewisezeroinflationcurve.hpp>
 #include <ql/termstructures/inflation/piecewiseyoyinflationcurve.hpp>
+#include <ql/termstructures/globalbootstrap.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/time/daycounters/actual360.hpp>
 #include <ql/time/daycounters/thirty360.hpp>
@@ -60,9 +62,70 @@ namespace {
             new FlatForward(evaluationDate, 0.05, Actual360()));
     }
 
+    // UK RPI fixings available on the evaluation date of the
+    // term-structure tests (13 August 2007)
+    const Real ukrpiFixings[] = { 189.9, 189.9, 189.6, 190.5, 191.6, 192.0,
+        192.2, 192.2, 192.6, 193.1, 193.3, 193.6,
+        194.1, 193.4, 194.2, 195.0, 196.5, 197.7,
+        198.5, 198.5, 199.2, 200.1, 200.4, 201.1,
+        202.7, 201.6, 203.1, 204.4, 205.4, 206.2,
+        207.3 };
+
+    Schedule ukrpiFixingSchedule() {
+        return MakeSchedule().from(Date(1, January, 2005))
+                             .to(Date(13, August, 2007))
+                             .withTenor(1*Months)
+                             .withCalendar(UnitedKingdom())
+                             .withConvention(ModifiedFollowing);
+    }
+
+    template <class I>
+    void addUKRPIFixings(const boost::shared_ptr<I>& index) {
+        Schedule rpiSchedule = ukrpiFixingSchedule();
+        for (Size i=0; i<LENGTH(ukrpiFixings); i++)
+            index->addFixing(rpiSchedule[i], ukrpiFixings[i]);
+    }
+
+    // zero-coupon swap quotes on the same date
+    const Datum zcData[] = {
+        { Date(13, August, 2008), 2.93 },
+        { Date(13, August, 2009), 2.95 },
+        { Date(13, August, 2010), 2.965 },
+        { Date(15, August, 2011), 2.98 },
+        { Date(13, August, 2012), 3.0 },
+        { Date(13, August, 2014), 3.06 },
+        { Date(13, August, 2017), 3.175 },
+        { Date(13, August, 2019), 3.243 },
+        { Date(15, August, 2022), 3.293 },
+        { Date(14, August, 2027), 3.338 },
+        { Date(13, August, 2032), 3.348 },
+        { Date(15, August, 2037), 3.348 },
+        { Date(13, August, 2047), 3.308 },
+        { Date(13, August, 2057), 3.228 }
+    };
+
+    // year-on-year swap quotes on the same date
+    const Datum yyData[] = {
+        { Date(13, August, 2008), 2.95 },
+        { Date(13, August, 2009), 2.95 },
+        { Date(13, August, 2010), 2.93 },
+        { Date(15, August, 2011), 2.955 },
+        { Date(13, August, 2012), 2.945 },
+        { Date(13, August, 2013), 2.985 },
+        { Date(13, August, 2014), 3.01 },
+        { Date(13, August, 2015), 3.035 },
+        { Date(13, August, 2016), 3.055 },  // note that
+        { Date(13, August, 2017), 3.075 },  // some dates will be on
+        { Date(13, August, 2019), 3.105 },  // holidays but the payment
+        { Date(15, August, 2022), 3.135 },  // calendar will roll them
+        { Date(13, August, 2027), 3.155 },
+        { Date(13, August, 2032), 3.145 },
+        { Date(13, August, 2037), 3.145 }
+    };
+
     template <class T, class U, class I>
     std::vector<boost::shared_ptr<BootstrapHelper<T> > > makeHelpers(
-            Datum iiData[], Size N,
+            const Datum iiData[], Size N,
             const boost::shared_ptr<I> &ii, const Period &observationLag,
             const Calendar &calendar,
             const BusinessDayConvention &bdc,
@@ -189,49 +252,15 @@ void InflationTest::testZeroTermStructure() {
     evaluationDate = calendar.adjust(evaluationDate);
     Settings::instance().evaluationDate() = evaluationDate;
 
-    // fixing data
-    Date from(1, January, 2005);
-    Date to(13, August, 2007);
-    Schedule rpiSchedule = MakeSchedule().from(from).to(to)
-    .withTenor(1*Months)
-    .withCalendar(UnitedKingdom())
-    .withConvention(ModifiedFollowing);
-
-    Real fixData[] = { 189.9, 189.9, 189.6, 190.5, 191.6, 192.0,
-        192.2, 192.2, 192.6, 193.1, 193.3, 193.6,
-        194.1, 193.4, 194.2, 195.0, 196.5, 197.7,
-        198.5, 198.5, 199.2, 200.1, 200.4, 201.1,
-        202.7, 201.6, 203.1, 204.4, 205.4, 206.2,
-        207.3};
-
     RelinkableHandle<ZeroInflationTermStructure> hz;
     bool interp = false;
     boost::shared_ptr<UKRPI> iiUKRPI(new UKRPI(interp, hz));
-    for (Size i=0; i<LENGTH(fixData); i++) {
-        iiUKRPI->addFixing(rpiSchedule[i], fixData[i]);
-    }
+    addUKRPIFixings(iiUKRPI);
 
     boost::shared_ptr<ZeroInflationIndex> ii = boost::dynamic_pointer_cast<ZeroInflationIndex>(iiUKRPI);
     boost::shared_ptr<YieldTermStructure> nominalTS = nominalTermStructure();
 
     // now build the zero inflation curve
-    Datum zcData[] = {
-        { Date(13, August, 2008), 2.93 },
-        { Date(13, August, 2009), 2.95 },
-        { Date(13, August, 2010), 2.965 },
-        { Date(15, August, 2011), 2.98 },
-        { Date(13, August, 2012), 3.0 },
-        { Date(13, August, 2014), 3.06 },
-        { Date(13, August, 2017), 3.175 },
-        { Date(13, August, 2019), 3.243 },
-        { Date(15, August, 2022), 3.293 },
-        { Date(14, August, 2027), 3.338 },
-        { Date(13, August, 2032), 3.348 },
-        { Date(15, August, 2037), 3.348 },
-        { Date(13, August, 2047), 3.308 },
-        { Date(13, August, 2057), 3.228 }
-    };
-
     Period observationLag = Period(2,Months);
     DayCounter dc = Thirty360();
     Frequency frequency = Monthly;
@@ -271,8 +300,8 @@ void InflationTest::testZeroTermStructure() {
 
     // now test the forecasting capability of the index.
     hz.linkTo(pZITS);
-    from = hz->baseDate();
-    to = hz->maxDate()-1*Months; // a bit of margin for adjustments
+    Date from = hz->baseDate();
+    Date to = hz->maxDate()-1*Months; // a bit of margin for adjustments
     Schedule testIndex = MakeSchedule().from(from).to(to)
                             .withTenor(1*Months)
                             .withCalendar(UnitedKingdom())
@@ -503,9 +532,7 @@ void InflationTest::testZeroTermStructure() {
 
     bool interpYES = true;
     boost::shared_ptr<UKRPI> iiUKRPIyes(new UKRPI(interpYES, hz));
-    for (Size i=0; i<LENGTH(fixData);i++) {
-        iiUKRPIyes->addFixing(rpiSchedule[i], fixData[i]);
-    }
+    addUKRPIFixings(iiUKRPIyes);
 
     boost::shared_ptr<ZeroInflationIndex> iiyes
         = boost::dynamic_pointer_cast<ZeroInflationIndex>(iiUKRPIyes);
@@ -607,6 +634,63 @@ void InflationTest::testZeroTermStructure() {
     hz.linkTo(boost::shared_ptr<ZeroInflationTermStructure>());
 }
 
+void InflationTest::testZeroTermStructureGlobalBootstrap() {
+    BOOST_TEST_MESSAGE(
+        "Testing global bootstrap of zero inflation term structure...");
+
+    SavedSettings backup;
+    IndexHistoryCleaner cleaner;
+
+    Calendar calendar = UnitedKingdom();
+    BusinessDayConvention bdc = ModifiedFollowing;
+    Date evaluationDate(13, August, 2007);
+    evaluationDate = calendar.adjust(evaluationDate);
+    Settings::instance().evaluationDate() = evaluationDate;
+
+    bool interp = false;
+    boost::shared_ptr<UKRPI> ii(new UKRPI(interp));
+    addUKRPIFixings(ii);
+
+    boost::shared_ptr<YieldTermStructure> nominalTS = nominalTermStructure();
+
+    Period observationLag = Period(2,Months);
+    DayCounter dc = Thirty360();
+    Frequency frequency = Monthly;
+    std::vector<boost::shared_ptr<BootstrapHelper<ZeroInflationTermStructure> > > helpers =
+    makeHelpers<ZeroInflationTermStructure,ZeroCouponInflationSwapHelper,
+                ZeroInflationIndex>(zcData, LENGTH(zcData), ii,
+                                    observationLag,
+                                    calendar, bdc, dc);
+
+    Rate baseZeroRate = zcData[0].rate/100.0;
+    PiecewiseZeroInflationCurve<Cubic,GlobalBootstrap> zeroCurve(
+                        evaluationDate, calendar, dc, observationLag,
+                        frequency, ii->interpolated(), baseZeroRate,
+                        Handle<YieldTermStructure>(nominalTS), helpers,
+                        1.0e-12,
+                        Cubic(CubicInterpolation::Spline, true,
+                              CubicInterpolation::SecondDerivative, 0.0,
+                              CubicInterpolation::SecondDerivative, 0.0));
+
+    const Real eps = 1.0e-8;
+    for (Size i=0; i<LENGTH(zcData); i++) {
+        Rate expected = zcData[i].rate/100.0;
+        Rate calculated = zeroCurve.zeroRate(zcData[i].date, observationLag);
+        if (std::fabs(calculated - expected) > eps)
+            BOOST_ERROR("zero rate doesn't match instrument quote:"
+                        << "\n    maturity:   " << zcData[i].date
+                        << "\n    calculated: " << calculated
+                        << "\n    expected:   " << expected);
+        Rate implied = helpers[i]->impliedQuote();
+        if (std::fabs(implied - expected) > eps)
+            BOOST_ERROR("implied quote doesn't match instrument quote:"
+                        << "\n    maturity:   " << zcData[i].date
+                        << "\n    calculated: " << implied
+                        << "\n    expected:   " << expected);
+    }
+}
+
+
 void InflationTest::testZeroIndexFutureFixing() {
     BOOST_MESSAGE("Testing that zero inflation indices forecast future fixings...");
 
@@ -817,50 +901,15 @@ void InflationTest::testYYTermStructure() {
     Settings::instance().evaluationDate() = evaluationDate;
 
 
-    // fixing data
-    Date from(1, January, 2005);
-    Date to(13, August, 2007);
-    Schedule rpiSchedule = MakeSchedule().from(from).to(to)
-    .withTenor(1*Months)
-    .withCalendar(UnitedKingdom())
-    .withConvention(ModifiedFollowing);
-    Real fixData[] = { 189.9, 189.9, 189.6, 190.5, 191.6, 192.0,
-        192.2, 192.2, 192.6, 193.1, 193.3, 193.6,
-        194.1, 193.4, 194.2, 195.0, 196.5, 197.7,
-        198.5, 198.5, 199.2, 200.1, 200.4, 201.1,
-        202.7, 201.6, 203.1, 204.4, 205.4, 206.2,
-        207.3 };
-
     RelinkableHandle<YoYInflationTermStructure> hy;
     bool interp = false;
     boost::shared_ptr<YYUKRPIr> iir(new YYUKRPIr(interp, hy));
-    for (Size i=0; i<LENGTH(fixData); i++) {
-        iir->addFixing(rpiSchedule[i], fixData[i]);
-    }
+    addUKRPIFixings(iir);
 
 
 
     boost::shared_ptr<YieldTermStructure> nominalTS = nominalTermStructure();
 
-    // now build the YoY inflation curve
-    Datum yyData[] = {
-        { Date(13, August, 2008), 2.95 },
-        { Date(13, August, 2009), 2.95 },
-        { Date(13, August, 2010), 2.93 },
-        { Date(15, August, 2011), 2.955 },
-        { Date(13, August, 2012), 2.945 },
-        { Date(13, August, 2013), 2.985 },
-        { Date(13, August, 2014), 3.01 },
-        { Date(13, August, 2015), 3.035 },
-        { Date(13, August, 2016), 3.055 },  // note that
-        { Date(13, August, 2017), 3.075 },  // some dates will be on
-        { Date(13, August, 2019), 3.105 },  // holidays but the payment
-        { Date(15, August, 2022), 3.135 },  // calendar will roll them
-        { Date(13, August, 2027), 3.155 },
-        { Date(13, August, 2032), 3.145 },
-        { Date(13, August, 2037), 3.145 }
-    };
-
     Period observationLag = Period(2,Months);
     DayCounter dc = Thirty360();
 
@@ -890,6 +939,7 @@ void InflationTest::testYYTermStructure() {
     // make sure that the index has the latest yoy term structure
     hy.linkTo(pYYTS);
 
+    Date from, to;
     for (Size j = 1; j < LENGTH(yyData); j++) {
 
         from = nominalTS->referenceDate();
@@ -963,6 +1013,56 @@ void InflationTest::testYYTermStructure() {
     hy.linkTo(boost::shared_ptr<YoYInflationTermStructure>());
 }
 
+void InflationTest::testYYTermStructureGlobalBootstrap() {
+    BOOST_TEST_MESSAGE(
+        "Testing global bootstrap of year-on-year inflation term structure...");
+
+    SavedSettings backup;
+    IndexHistoryCleaner cleaner;
+
+    Calendar calendar = UnitedKingdom();
+    BusinessDayConvention bdc = ModifiedFollowing;
+    Date evaluationDate(13, August, 2007);
+    evaluationDate = calendar.adjust(evaluationDate);
+    Settings::instance().evaluationDate() = evaluationDate;
+
+    bool interp = false;
+    boost::shared_ptr<YYUKRPIr> iir(new YYUKRPIr(interp));
+    addUKRPIFixings(iir);
+
+    boost::shared_ptr<YieldTermStructure> nominalTS = nominalTermStructure();
+
+    Period observationLag = Period(2,Months);
+    DayCounter dc = Thirty360();
+    std::vector<boost::shared_ptr<BootstrapHelper<YoYInflationTermStructure> > > helpers =
+    makeHelpers<YoYInflationTermStructure,YearOnYearInflationSwapHelper,
+                YoYInflationIndex>(yyData, LENGTH(yyData), iir,
+                                   observationLag,
+                                   calendar, bdc, dc);
+
+    Rate baseYYRate = yyData[0].rate/100.0;
+    PiecewiseYoYInflationCurve<Cubic,GlobalBootstrap> yoyCurve(
+                        evaluationDate, calendar, dc, observationLag,
+                        iir->frequency(), iir->interpolated(), baseYYRate,
+                        Handle<YieldTermStructure>(nominalTS), helpers,
+                        1.0e-12,
+                        Cubic(CubicInterpolation::Spline, true,
+                              CubicInterpolation::SecondDerivative, 0.0,
+                              CubicInterpolation::SecondDerivative, 0.0));
+    yoyCurve.recalculate();
+
+    const Real eps = 1.0e-8;
+    for (Size i=0; i<LENGTH(yyData); i++) {
+        Rate expected = yyData[i].rate/100.0;
+        Rate implied = helpers[i]->impliedQuote();
+        if (std::fabs(implied - expected) > eps)
+            BOOST_ERROR("implied quote doesn't match instrument quote:"
+                        << "\n    maturity:   " << yyData[i].date
+                        << "\n    calculated: " << implied
+                        << "\n    expected:   " << expected);
+    }
+}
+
 void InflationTest::testPeriod() {
     BOOST_TEST_MESSAGE("Testing inflation period...");
 
@@ -996,10 +1096,14 @@ test_suite* InflationTest::suite() {
 
     suite->add(QUANTLIB_TEST_CASE(&InflationTest::testZeroIndex));
     suite->add(QUANTLIB_TEST_CASE(&InflationTest::testZeroTermStructure));
+    suite->add(QUANTLIB_TEST_CASE(
+                     &InflationTest::testZeroTermStructureGlobalBootstrap));
     suite->add(QUANTLIB_TEST_CASE(&InflationTest::testZeroIndexFutureFixing));
 
     suite->add(QUANTLIB_TEST_CASE(&InflationTest::testYYIndex));
     suite->add(QUANTLIB_TEST_CASE(&InflationTest::testYYTermStructure));
+    suite->add(QUANTLIB_TEST_CASE(
+                     &InflationTest::testYYTermStructureGlobalBootstrap));
 
     return suite;
 }
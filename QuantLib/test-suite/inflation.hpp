@@ -30,9 +30,11 @@ public:
     static void testPeriod();
     static void testZeroIndex();
     static void testZeroTermStructure();
+    static void testZeroTermStructureGlobalBootstrap();
     static void testZeroIndexFutureFixing();
     static void testYYIndex();
     static void testYYTermStructure();
+    static void testYYTermStructureGlobalBootstrap();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -25,6 +25,7 @@
 #include <ql/pricingengines/vanilla/analyticeuropeanengine.hpp>
 #include <ql/pricingengines/vanilla/jumpdiffusionengine.hpp>
 #include <ql/processes/merton76process.hpp>
+#include <ql/experimental/variancegamma/fftmerton76engine.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
 #include <ql/utilities/dataformatters.hpp>
@@ -532,9 +533,90 @@ void JumpDiffusionTest::testGreeks() {
 }
 
 
+void JumpDiffusionTest::testFFTEngine() {
+
+    BOOST_TEST_MESSAGE("Testing FFT engine for Merton 76 jump-diffusion "
+                       "model...");
+
+    SavedSettings backup;
+
+    DayCounter dc = Actual360();
+    Date today = Date::todaysDate();
+    Settings::instance().evaluationDate() = today;
+
+    boost::shared_ptr<SimpleQuote> spot(new SimpleQuote(100.0));
+    boost::shared_ptr<YieldTermStructure> qTS = flatRate(today, 0.02, dc);
+    boost::shared_ptr<YieldTermStructure> rTS = flatRate(today, 0.05, dc);
+    boost::shared_ptr<BlackVolTermStructure> volTS =
+        flatVol(today, 0.20, dc);
+
+    boost::shared_ptr<Merton76Process> process(
+        new Merton76Process(Handle<Quote>(spot),
+                            Handle<YieldTermStructure>(qTS),
+                            Handle<YieldTermStructure>(rTS),
+                            Handle<BlackVolTermStructure>(volTS),
+                            Handle<Quote>(boost::shared_ptr<Quote>(
+                                                    new SimpleQuote(1.0))),
+                            Handle<Quote>(boost::shared_ptr<Quote>(
+                                                    new SimpleQuote(-0.1))),
+                            Handle<Quote>(boost::shared_ptr<Quote>(
+                                                    new SimpleQuote(0.15)))));
+
+    boost::shared_ptr<PricingEngine> analyticEngine(
+                                          new JumpDiffusionEngine(process));
+    boost::shared_ptr<FFTEngine> fftEngine(new FFTMerton76Engine(process));
+
+    Integer days[] = { 30, 180, 360, 720 };
+    std::vector<boost::shared_ptr<Instrument> > options;
+    for (Size i=0; i<LENGTH(days); ++i) {
+        boost::shared_ptr<Exercise> exercise(
+                                     new EuropeanExercise(today + days[i]));
+        for (Real strike=50.0; strike<=200.0; strike+=1.0) {
+            Option::Type type = strike < 100.0 ? Option::Put : Option::Call;
+            options.push_back(boost::shared_ptr<Instrument>(
+                new EuropeanOption(boost::shared_ptr<StrikedTypePayoff>(
+                                       new PlainVanillaPayoff(type, strike)),
+                                   exercise)));
+        }
+    }
+
+    std::vector<Real> expected(options.size());
+    for (Size i=0; i<options.size(); ++i) {
+        options[i]->setPricingEngine(analyticEngine);
+        expected[i] = options[i]->NPV();
+    }
+
+    // the FFT grid leaves a small aliasing error
+    Real tol = 5.0e-3;
+    fftEngine->precalculate(options);
+    for (Size i=0; i<options.size(); ++i) {
+        options[i]->setPricingEngine(fftEngine);
+        Real calculated = options[i]->NPV();
+        Real error = std::fabs(calculated-expected[i]);
+        if (error > tol) {
+            boost::shared_ptr<EuropeanOption> option =
+                boost::dynamic_pointer_cast<EuropeanOption>(options[i]);
+            boost::shared_ptr<StrikedTypePayoff> payoff =
+                boost::dynamic_pointer_cast<StrikedTypePayoff>(
+                                                            option->payoff());
+            REPORT_FAILURE_1("value", payoff, option->exercise(),
+                             spot->value(), 0.02, 0.05, today, 0.20,
+                             1.0, -0.1, 0.15, expected[i], calculated,
+                             error, tol);
+        }
+    }
+}
+
 test_suite* JumpDiffusionTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Jump-diffusion tests");
     suite->add(QUANTLIB_TEST_CASE(&JumpDiffusionTest::testMerton76));
     suite->add(QUANTLIB_TEST_CASE(&JumpDiffusionTest::testGreeks));
     return suite;
 }
+
+test_suite* JumpDiffusionTest::experimental() {
+    test_suite* suite = BOOST_TEST_SUITE("Jump-diffusion tests");
+    suite->add(QUANTLIB_TEST_CASE(&JumpDiffusionTest::testFFTEngine));
+    return suite;
+}
+
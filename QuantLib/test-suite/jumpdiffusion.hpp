@@ -29,7 +29,9 @@ class JumpDiffusionTest {
   public:
     static void testMerton76();
     static void testGreeks();
+    static void testFFTEngine();
     static boost::unit_test_framework::test_suite* suite();
+    static boost::unit_test_framework::test_suite* experimental();
 };
 
 
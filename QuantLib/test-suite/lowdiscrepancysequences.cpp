@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2003, 2004 Ferdinando Ametrano
  Copyright (C) 2007 Mark Joshi
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -1092,6 +1093,52 @@ void LowDiscrepancyTest::testSobolSkipping() {
 }
 
 
+void LowDiscrepancyTest::testHaltonFaureSkipping() {
+
+    BOOST_TEST_MESSAGE("Testing Halton and Faure sequence skipping...");
+
+    Size dimensionality[] = { 1, 5, 11 };
+    unsigned long skip[] = { 0, 1, 4, 5, 42, 121, 512, 100000 };
+
+    for (Size j=0; j<LENGTH(dimensionality); j++) {
+        for (Size k=0; k<LENGTH(skip); k++) {
+            HaltonRsg halton1(dimensionality[j], 42), halton2 = halton1;
+            FaureRsg faure1(dimensionality[j]), faure2 = faure1;
+            for (Size l=0; l<skip[k]; l++) {
+                halton1.nextSequence();
+                faure1.nextSequence();
+            }
+            halton2.skipTo(skip[k]);
+            faure2.skipTo(skip[k]);
+
+            // compare next 100 samples
+            for (Size m=0; m<100; m++) {
+                std::vector<Real> h1 = halton1.nextSequence().value;
+                std::vector<Real> h2 = halton2.nextSequence().value;
+                std::vector<long int> f1 = faure1.nextIntSequence();
+                std::vector<long int> f2 = faure2.nextIntSequence();
+                for (Size n=0; n<h1.size(); n++) {
+                    if (h1[n] != h2[n])
+                        BOOST_FAIL("Halton mismatch after skipping:"
+                                   << "\n  size:     " << dimensionality[j]
+                                   << "\n  skipped:  " << skip[k]
+                                   << "\n  at index: " << n
+                                   << "\n  expected: " << h1[n]
+                                   << "\n  found:    " << h2[n]);
+                    if (f1[n] != f2[n])
+                        BOOST_FAIL("Faure mismatch after skipping:"
+                                   << "\n  size:     " << dimensionality[j]
+                                   << "\n  skipped:  " << skip[k]
+                                   << "\n  at index: " << n
+                                   << "\n  expected: " << f1[n]
+                                   << "\n  found:    " << f2[n]);
+                }
+            }
+        }
+    }
+}
+
+
 test_suite* LowDiscrepancyTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Low-discrepancy sequence tests");
 
@@ -1129,6 +1176,8 @@ test_suite* LowDiscrepancyTest::suite() {
            &LowDiscrepancyTest::testSobolLevitanLemieuxSobolDiscrepancy));
 
     suite->add(QUANTLIB_TEST_CASE(&LowDiscrepancyTest::testSobolSkipping));
+    suite->add(QUANTLIB_TEST_CASE(
+                          &LowDiscrepancyTest::testHaltonFaureSkipping));
 
     suite->add(QUANTLIB_TEST_CASE(
            &LowDiscrepancyTest::testRandomizedLowDiscrepancySequence));
@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003, 2004 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -48,6 +49,7 @@ class LowDiscrepancyTest {
     static void testRandomizedLowDiscrepancySequence();
 
     static void testSobolSkipping();
+    static void testHaltonFaureSkipping();
 
     static void testRandomizedLattices();
 
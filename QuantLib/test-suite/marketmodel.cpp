@@ -4,7 +4,7 @@
 Copyright (C) 2006 Ferdinando Ametrano
 Copyright (C) 2006 Marco Bianchetti
 Copyright (C) 2006 Cristina Duminuco
-Copyright (C) 2006 StatPro Italia srl
+Copyright (C) 2006, 2014 StatPro Italia srl
 Copyright (C) 2008 Mark Joshi
 Copyright (C) 2012 Peter Caspers
 
@@ -36,12 +36,15 @@ FOR A PARTICULAR PURPOSE.  See the license for more details.
 #include <ql/models/marketmodels/callability/triggeredswapexercise.hpp>
 #include <ql/models/marketmodels/callability/upperboundengine.hpp>
 #include <ql/models/marketmodels/curvestates/lmmcurvestate.hpp>
+#include <ql/models/marketmodels/curvestates/coterminalswapcurvestate.hpp>
 #include <ql/models/marketmodels/driftcomputation/lmmdriftcalculator.hpp>
+#include <ql/models/marketmodels/driftcomputation/smmdriftcalculator.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdrateeuler.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdrateeulerconstrained.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdrateipc.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdrateballand.hpp>
 #include <ql/models/marketmodels/evolvers/lognormalfwdratepc.hpp>
+#include <ql/models/marketmodels/evolvers/lognormalcmswapratepc.hpp>
 #include <ql/models/marketmodels/evolvers/normalfwdratepc.hpp>
 #include <ql/models/marketmodels/discounter.hpp>
 #include <ql/models/marketmodels/models/abcdvol.hpp>
@@ -4789,6 +4792,502 @@ void MarketModelTest::testAbcdDegenerateCases() {
                    << "actual value is " << cov2);
 }
 
+void MarketModelTest::testMultiThreadedSimulation() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded market-model simulation...");
+
+    setup();
+
+    std::vector<boost::shared_ptr<Payoff> > payoffs(todaysForwards.size());
+    for (Size i=0; i<todaysForwards.size(); ++i)
+        payoffs[i] = boost::shared_ptr<Payoff>(new
+            PlainVanillaPayoff(Option::Call, todaysForwards[i]));
+
+    MultiStepOptionlets product(rateTimes, accruals,
+                                paymentTimes, payoffs);
+    EvolutionDescription evolution = product.evolution();
+    std::vector<Size> numeraires = makeMeasure(product, MoneyMarket);
+    Size factors = 4;
+    bool logNormal = true;
+    boost::shared_ptr<MarketModel> marketModel =
+        makeMarketModel(logNormal, evolution, factors,
+                        ExponentialCorrelationAbcdVolatility);
+    Size initialNumeraire = numeraires.front();
+    Real initialNumeraireValue = todaysDiscounts[initialNumeraire];
+
+    // not a multiple of the chunk size
+    Size paths = 5000;
+    Real tolerance = 1.0e-12;
+
+    MTBrownianGeneratorFactory mtFactory(seed_);
+    SobolBrownianGeneratorFactory sobolFactory(
+                                     SobolBrownianGenerator::Diagonal, seed_);
+    const BrownianGeneratorFactory* factories[] = {
+        &mtFactory, &sobolFactory };
+    std::string factoryNames[] = { "MT BGF", "Sobol BGF" };
+    EvolverType evolvers[] = { Pc, Balland };
+    Size threads[] = { 1, 2, 3 };
+
+    for (Size f=0; f<LENGTH(factories); ++f) {
+        for (Size i=0; i<LENGTH(evolvers); ++i) {
+            boost::shared_ptr<MarketModelEvolver> evolver =
+                makeMarketModelEvolver(marketModel, numeraires,
+                                       *factories[f], evolvers[i]);
+            AccountingEngine engine(evolver, product,
+                                    initialNumeraireValue);
+            SequenceStatisticsInc stats(product.numberOfProducts());
+            // two batches, to check that the second resumes the paths
+            engine.multiplePathValues(stats, paths/2);
+            engine.multiplePathValues(stats, paths-paths/2);
+            std::vector<Real> expected = stats.mean();
+
+            for (Size t=0; t<LENGTH(threads); ++t) {
+                evolver = makeMarketModelEvolver(marketModel, numeraires,
+                                                 *factories[f], evolvers[i]);
+                AccountingEngine threadedEngine(evolver, product,
+                                                initialNumeraireValue,
+                                                threads[t]);
+                SequenceStatisticsInc threadedStats(
+                                               product.numberOfProducts());
+                threadedEngine.multiplePathValues(threadedStats, paths/2);
+                threadedEngine.multiplePathValues(threadedStats,
+                                                  paths-paths/2);
+                std::vector<Real> calculated = threadedStats.mean();
+
+                if (threadedStats.samples() != paths)
+                    BOOST_ERROR(evolverTypeToString(evolvers[i]) << ", "
+                                << factoryNames[f] << ", "
+                                << threads[t] << " thread(s): "
+                                << threadedStats.samples()
+                                << " samples instead of " << paths);
+                for (Size j=0; j<expected.size(); ++j) {
+                    if (std::fabs(calculated[j]-expected[j]) > tolerance)
+                        BOOST_ERROR(evolverTypeToString(evolvers[i]) << ", "
+                                    << factoryNames[f] << ", "
+                                    << threads[t] << " thread(s), "
+                                    << io::ordinal(j+1) << " caplet:"
+                                    << "\n    single-threaded: "
+                                    << expected[j]
+                                    << "\n    multi-threaded:  "
+                                    << calculated[j]);
+                }
+            }
+        }
+    }
+
+    // pathwise Greeks; the engine clones its Euler evolver for each
+    // thread
+    MarketModelPathwiseMultiCaplet pathwiseProduct(rateTimes, accruals,
+                                                   paymentTimes,
+                                                   todaysForwards);
+    Size pathwiseValues =
+        pathwiseProduct.numberOfProducts()*(todaysForwards.size()+1);
+    for (Size f=0; f<LENGTH(factories); ++f) {
+        std::vector<Real> expected;
+        for (Size t=0; t<LENGTH(threads)+1; ++t) {
+            boost::shared_ptr<LogNormalFwdRateEuler> evolver(new
+                LogNormalFwdRateEuler(marketModel, *factories[f],
+                                      numeraires));
+            // the first run is single-threaded
+            Size n = (t == 0 ? Null<Size>() : threads[t-1]);
+            PathwiseAccountingEngine engine(evolver, pathwiseProduct,
+                                            marketModel,
+                                            initialNumeraireValue, n);
+            SequenceStatisticsInc stats(pathwiseValues);
+            engine.multiplePathValues(stats, paths/2);
+            engine.multiplePathValues(stats, paths-paths/2);
+
+            if (t == 0) {
+                expected = stats.mean();
+                continue;
+            }
+
+            if (stats.samples() != paths)
+                BOOST_ERROR("pathwise Greeks, " << factoryNames[f] << ", "
+                            << n << " thread(s): " << stats.samples()
+                            << " samples instead of " << paths);
+            std::vector<Real> calculated = stats.mean();
+            for (Size j=0; j<expected.size(); ++j) {
+                if (std::fabs(calculated[j]-expected[j]) > tolerance)
+                    BOOST_ERROR("pathwise Greeks, " << factoryNames[f]
+                                << ", " << n << " thread(s), "
+                                << io::ordinal(j+1) << " result:"
+                                << "\n    single-threaded: " << expected[j]
+                                << "\n    multi-threaded:  "
+                                << calculated[j]);
+            }
+        }
+    }
+
+    // proxy Greeks
+    std::vector<Size> startIndexOfConstraint, endIndexOfConstraint;
+    for (Size i=0; i<evolution.evolutionTimes().size(); ++i) {
+        startIndexOfConstraint.push_back(i);
+        endIndexOfConstraint.push_back(i+1);
+    }
+    Spread forwardBump = 1.0e-6;
+    std::vector<std::vector<Real> > deltaWeights(1, std::vector<Real>(3));
+    deltaWeights[0][0] = 0.0;
+    deltaWeights[0][1] = -1.0/(2.0*forwardBump);
+    deltaWeights[0][2] = 1.0/(2.0*forwardBump);
+    std::vector<std::vector<std::vector<Real> > > diffWeights(
+                                                         1, deltaWeights);
+
+    std::vector<Real> expected, expectedDeltas;
+    for (Size t=0; t<LENGTH(threads)+1; ++t) {
+        boost::shared_ptr<MarketModelEvolver> evolver(new
+            LogNormalFwdRateEuler(marketModel, sobolFactory, numeraires));
+        std::vector<std::vector<boost::shared_ptr<ConstrainedEvolver> > >
+            constrainedEvolvers(1);
+        for (Size i=0; i<2; ++i) {
+            Spread bump = (i == 0 ? -forwardBump : forwardBump);
+            constrainedEvolvers[0].push_back(
+                boost::shared_ptr<ConstrainedEvolver>(new
+                    LogNormalFwdRateEulerConstrained(
+                        makeMarketModel(logNormal, evolution, factors,
+                                        ExponentialCorrelationAbcdVolatility,
+                                        bump),
+                        sobolFactory, numeraires)));
+            constrainedEvolvers[0].back()->setConstraintType(
+                                 startIndexOfConstraint, endIndexOfConstraint);
+        }
+
+        // the first run is single-threaded
+        Size n = (t == 0 ? Null<Size>() : threads[t-1]);
+        ProxyGreekEngine engine(evolver, constrainedEvolvers, diffWeights,
+                                startIndexOfConstraint, endIndexOfConstraint,
+                                product, initialNumeraireValue, n);
+        SequenceStatisticsInc stats(product.numberOfProducts());
+        std::vector<std::vector<SequenceStatisticsInc> > greekStats(
+                               1, std::vector<SequenceStatisticsInc>(1, stats));
+        engine.multiplePathValues(stats, greekStats, paths);
+
+        if (t == 0) {
+            expected = stats.mean();
+            expectedDeltas = greekStats[0][0].mean();
+            continue;
+        }
+
+        std::vector<Real> calculated = stats.mean();
+        std::vector<Real> calculatedDeltas = greekStats[0][0].mean();
+        for (Size j=0; j<expected.size(); ++j) {
+            if (std::fabs(calculated[j]-expected[j]) > tolerance)
+                BOOST_ERROR("proxy Greeks, " << n << " thread(s), "
+                            << io::ordinal(j+1) << " caplet:"
+                            << "\n    single-threaded value: " << expected[j]
+                            << "\n    multi-threaded value:  "
+                            << calculated[j]);
+            // deltas are divided by the bump
+            if (std::fabs(calculatedDeltas[j]-expectedDeltas[j])
+                > tolerance/forwardBump)
+                BOOST_ERROR("proxy Greeks, " << n << " thread(s), "
+                            << io::ordinal(j+1) << " caplet:"
+                            << "\n    single-threaded delta: "
+                            << expectedDeltas[j]
+                            << "\n    multi-threaded delta:  "
+                            << calculatedDeltas[j]);
+        }
+    }
+}
+
+void MarketModelTest::testBrownianGeneratorCloning() {
+
+    BOOST_TEST_MESSAGE("Testing cloning of Brownian generators "
+                       "after drawing...");
+
+    setup();
+
+    const Size factors = 3, steps = 5, paths = 100, drawn = 40;
+    const Size starts[] = { 0, 1, 7, 33, 60 };
+
+    std::vector<boost::shared_ptr<BrownianGeneratorFactory> > factories;
+    factories.push_back(boost::shared_ptr<BrownianGeneratorFactory>(
+                                    new MTBrownianGeneratorFactory(seed_)));
+    factories.push_back(boost::shared_ptr<BrownianGeneratorFactory>(
+        new SobolBrownianGeneratorFactory(SobolBrownianGenerator::Diagonal,
+                                          seed_)));
+    const char* names[] = { "Mersenne Twister", "Sobol" };
+
+    std::vector<Real> variates(factors);
+    for (Size f=0; f<factories.size(); ++f) {
+
+        // reference paths, drawn from a fresh generator
+        std::vector<std::vector<Real> > expected(paths);
+        boost::shared_ptr<BrownianGenerator> reference =
+            factories[f]->create(factors, steps);
+        for (Size i=0; i<paths; ++i) {
+            reference->nextPath();
+            for (Size j=0; j<steps; ++j) {
+                reference->nextStep(variates);
+                expected[i].insert(expected[i].end(),
+                                   variates.begin(), variates.end());
+            }
+        }
+
+        // clones must not depend on what the source already drew
+        boost::shared_ptr<BrownianGenerator> generator =
+            factories[f]->create(factors, steps);
+        for (Size i=0; i<drawn; ++i) {
+            generator->nextPath();
+            for (Size j=0; j<steps; ++j)
+                generator->nextStep(variates);
+        }
+
+        for (Size k=0; k<LENGTH(starts); ++k) {
+            boost::shared_ptr<BrownianGenerator> clone =
+                generator->clone(starts[k]);
+            for (Size i=starts[k]; i<starts[k]+10; ++i) {
+                clone->nextPath();
+                for (Size j=0; j<steps; ++j) {
+                    clone->nextStep(variates);
+                    for (Size l=0; l<factors; ++l) {
+                        if (variates[l] != expected[i][j*factors+l])
+                            BOOST_FAIL(names[f] << " generator cloned at "
+                                       << io::ordinal(starts[k]+1)
+                                       << " path after drawing " << drawn
+                                       << " paths:"
+                                       << "\n    " << io::ordinal(i+1)
+                                       << " path, " << io::ordinal(j+1)
+                                       << " step, " << io::ordinal(l+1)
+                                       << " factor"
+                                       << "\n    expected:   "
+                                       << expected[i][j*factors+l]
+                                       << "\n    calculated: "
+                                       << variates[l]);
+                    }
+                }
+            }
+        }
+
+        // the source is not affected by cloning
+        for (Size i=drawn; i<drawn+10; ++i) {
+            generator->nextPath();
+            for (Size j=0; j<steps; ++j) {
+                generator->nextStep(variates);
+                for (Size l=0; l<factors; ++l) {
+                    if (variates[l] != expected[i][j*factors+l])
+                        BOOST_FAIL(names[f] << " generator altered "
+                                   "by cloning:"
+                                   << "\n    " << io::ordinal(i+1)
+                                   << " path, " << io::ordinal(j+1)
+                                   << " step, " << io::ordinal(l+1)
+                                   << " factor"
+                                   << "\n    expected:   "
+                                   << expected[i][j*factors+l]
+                                   << "\n    calculated: " << variates[l]);
+                }
+            }
+        }
+    }
+}
+
+void MarketModelTest::testBlockEvolution() {
+
+    BOOST_TEST_MESSAGE("Testing market-model evolution in blocks of paths...");
+
+    setup();
+
+    std::vector<Time> evolutionTimes(rateTimes.size()-1);
+    std::copy(rateTimes.begin(), rateTimes.end()-1, evolutionTimes.begin());
+    EvolutionDescription evolution(rateTimes, evolutionTimes);
+    Size steps = evolution.numberOfSteps();
+    Size rates = todaysForwards.size();
+    std::vector<Size> moneyMarket = moneyMarketMeasure(evolution);
+    std::vector<Size> terminal = terminalMeasure(evolution);
+
+    // the blocks are smaller than the Sobol generator's buffer and
+    // not aligned with it
+    Size blocks = 3, paths = 45;
+    Real tolerance = 1.0e-12;
+
+    Size testedFactors[] = { 4, rates };
+    std::string evolverNames[] = {
+        "lognormal PC", "lognormal iterative PC",
+        "normal PC", "lognormal CM swap-rate PC" };
+
+    for (Size m=0; m<LENGTH(testedFactors); ++m) {
+        Size factors = testedFactors[m];
+        for (Size g=0; g<2; ++g) {
+            MTBrownianGeneratorFactory mtFactory(seed_);
+            SobolBrownianGeneratorFactory sobolFactory(
+                                     SobolBrownianGenerator::Diagonal, seed_);
+            const BrownianGeneratorFactory& factory =
+                g == 0 ? static_cast<const BrownianGeneratorFactory&>(mtFactory)
+                       : sobolFactory;
+
+            for (Size e=0; e<LENGTH(evolverNames); ++e) {
+                boost::shared_ptr<MarketModelEvolver> evolver, blockEvolver;
+                switch (e) {
+                  case 0:
+                  case 1:
+                  case 2:
+                    {
+                        bool logNormal = (e != 2);
+                        boost::shared_ptr<MarketModel> marketModel =
+                            makeMarketModel(logNormal, evolution, factors,
+                                         ExponentialCorrelationAbcdVolatility);
+                        EvolverType type =
+                            e == 0 ? Pc : (e == 1 ? Ipc : NormalPc);
+                        const std::vector<Size>& numeraires =
+                            e == 1 ? terminal : moneyMarket;
+                        evolver = makeMarketModelEvolver(marketModel,
+                                                         numeraires,
+                                                         factory, type);
+                        blockEvolver = makeMarketModelEvolver(marketModel,
+                                                              numeraires,
+                                                              factory, type);
+                    }
+                    break;
+                  case 3:
+                    {
+                        // the initial rates are used as swap rates
+                        boost::shared_ptr<MarketModel> marketModel =
+                            makeMarketModel(true, evolution, factors,
+                                         ExponentialCorrelationAbcdVolatility);
+                        Size spanningForwards = 2;
+                        evolver = boost::shared_ptr<MarketModelEvolver>(new
+                            LogNormalCmSwapRatePc(spanningForwards,
+                                                  marketModel, factory,
+                                                  moneyMarket));
+                        blockEvolver = boost::shared_ptr<MarketModelEvolver>(new
+                            LogNormalCmSwapRatePc(spanningForwards,
+                                                  marketModel, factory,
+                                                  moneyMarket));
+                    }
+                    break;
+                  default:
+                    BOOST_FAIL("unknown evolver");
+                }
+
+                std::vector<Matrix> block(steps, Matrix(rates, paths));
+                for (Size b=0; b<blocks; ++b) {
+                    blockEvolver->evolveBlock(block);
+                    for (Size j=0; j<paths; ++j) {
+                        evolver->startNewPath();
+                        for (Size i=0; i<steps; ++i) {
+                            evolver->advanceStep();
+                            const std::vector<Rate>& expected =
+                                evolver->currentState().forwardRates();
+                            for (Size k=0; k<rates; ++k) {
+                                Real error =
+                                    std::fabs(block[i][k][j] - expected[k]);
+                                if (error > tolerance)
+                                    BOOST_FAIL(evolverNames[e] << ", "
+                                        << factors << " factors, "
+                                        << (g == 0 ? "MT" : "Sobol")
+                                        << " generator, "
+                                        << io::ordinal(b*paths+j+1)
+                                        << " path, "
+                                        << io::ordinal(i+1) << " step, "
+                                        << io::ordinal(k+1) << " rate:"
+                                        << "\n    single path: "
+                                        << expected[k]
+                                        << "\n    block:       "
+                                        << block[i][k][j]
+                                        << "\n    error:       " << error);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // accounting engine collecting cash flows from blocks of paths
+    std::vector<boost::shared_ptr<Payoff> > payoffs(rates);
+    for (Size i=0; i<rates; ++i)
+        payoffs[i] = boost::shared_ptr<Payoff>(new
+            PlainVanillaPayoff(Option::Call, todaysForwards[i]));
+    MultiStepOptionlets product(rateTimes, accruals,
+                                paymentTimes, payoffs);
+    std::vector<Size> numeraires = makeMeasure(product, MoneyMarket);
+    Real initialNumeraireValue = todaysDiscounts[numeraires.front()];
+    boost::shared_ptr<MarketModel> marketModel =
+        makeMarketModel(true, product.evolution(), 4,
+                        ExponentialCorrelationAbcdVolatility);
+    MTBrownianGeneratorFactory mtFactory(seed_);
+    // not a multiple of the block size
+    Size totalPaths = blocks*paths+7;
+    Size threads[] = { Null<Size>(), 2 };
+
+    for (Size e=0; e<2; ++e) {
+        EvolverType type = (e == 0 ? Pc : Balland);
+        boost::shared_ptr<MarketModelEvolver> evolver =
+            makeMarketModelEvolver(marketModel, numeraires, mtFactory, type);
+        AccountingEngine engine(evolver, product, initialNumeraireValue);
+        SequenceStatisticsInc stats(product.numberOfProducts());
+        engine.multiplePathValues(stats, totalPaths);
+        std::vector<Real> expected = stats.mean();
+
+        for (Size t=0; t<LENGTH(threads); ++t) {
+            evolver = makeMarketModelEvolver(marketModel, numeraires,
+                                             mtFactory, type);
+            AccountingEngine blockEngine(evolver, product,
+                                         initialNumeraireValue,
+                                         threads[t], paths);
+            SequenceStatisticsInc blockStats(product.numberOfProducts());
+            blockEngine.multiplePathValues(blockStats, totalPaths);
+            std::vector<Real> calculated = blockStats.mean();
+
+            if (blockStats.samples() != totalPaths)
+                BOOST_FAIL(evolverTypeToString(type)
+                           << " accounting engine in blocks: "
+                           << blockStats.samples()
+                           << " samples instead of " << totalPaths);
+            for (Size j=0; j<expected.size(); ++j) {
+                if (std::fabs(calculated[j]-expected[j]) > tolerance)
+                    BOOST_FAIL(evolverTypeToString(type)
+                               << " accounting engine in blocks, "
+                               << io::ordinal(j+1) << " caplet:"
+                               << "\n    single path: " << expected[j]
+                               << "\n    block:       " << calculated[j]);
+            }
+        }
+    }
+
+    // coterminal swap-market model drifts, which are not used by
+    // the above evolvers
+    for (Size m=0; m<LENGTH(testedFactors); ++m) {
+        Size factors = testedFactors[m];
+        boost::shared_ptr<MarketModel> marketModel =
+            makeMarketModel(true, evolution, factors,
+                            ExponentialCorrelationAbcdVolatility);
+        std::vector<CoterminalSwapCurveState> states(
+                               paths, CoterminalSwapCurveState(rateTimes));
+        for (Size j=0; j<paths; ++j) {
+            std::vector<Rate> swapRates(todaysCoterminalSwapRates);
+            for (Size k=0; k<rates; ++k)
+                swapRates[k] *= 1.0 + 0.01*((j+3*k) % 7);
+            states[j].setOnCoterminalSwapRates(swapRates);
+        }
+        for (Size i=0; i<steps; ++i) {
+            SMMDriftCalculator calculator(marketModel->pseudoRoot(i),
+                                          marketModel->displacements(),
+                                          evolution.rateTaus(),
+                                          moneyMarket[i],
+                                          evolution.firstAliveRate()[i]);
+            Matrix drifts(rates, paths);
+            calculator.compute(states, drifts);
+            std::vector<Real> expected(rates);
+            for (Size j=0; j<paths; ++j) {
+                calculator.compute(states[j], expected);
+                for (Size k=evolution.firstAliveRate()[i]; k<rates; ++k) {
+                    Real error = std::fabs(drifts[k][j] - expected[k]);
+                    if (error > tolerance)
+                        BOOST_FAIL("coterminal swap-rate drifts, "
+                                   << factors << " factors, "
+                                   << io::ordinal(i+1) << " step, "
+                                   << io::ordinal(j+1) << " path, "
+                                   << io::ordinal(k+1) << " rate:"
+                                   << "\n    single path: " << expected[k]
+                                   << "\n    block:       " << drifts[k][j]
+                                   << "\n    error:       " << error);
+                }
+            }
+        }
+    }
+}
+
 void MarketModelTest::testCovariance() {
     BOOST_TEST_MESSAGE("Testing market models covariance...");
 
@@ -4909,5 +5408,11 @@ test_suite* MarketModelTest::suite() {
     suite->add(QUANTLIB_TEST_CASE(&MarketModelTest::testAbcdDegenerateCases));
     suite->add(QUANTLIB_TEST_CASE(&MarketModelTest::testCovariance));
 
+    suite->add(QUANTLIB_TEST_CASE(
+                           &MarketModelTest::testMultiThreadedSimulation));
+    suite->add(QUANTLIB_TEST_CASE(
+                         &MarketModelTest::testBrownianGeneratorCloning));
+    suite->add(QUANTLIB_TEST_CASE(&MarketModelTest::testBlockEvolution));
+
     return suite;
 }
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2006 Ferdinando Ametrano
- Copyright (C) 2006 StatPro Italia srl
+ Copyright (C) 2006, 2014 StatPro Italia srl
  Copyright (C) 2012 Peter Caspers
 
  This file is part of QuantLib, a free-software/open-source library
@@ -50,6 +50,9 @@ class MarketModelTest {
     static void testIsInSubset();
     static void testAbcdDegenerateCases();
     static void testCovariance();
+    static void testMultiThreadedSimulation();
+    static void testBrownianGeneratorCloning();
+    static void testBlockEvolution();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -2,7 +2,7 @@
 
 /*
  Copyright (C) 2006 Klaus Spanderen
- Copyright (C) 2007 StatPro Italia srl
+ Copyright (C) 2007, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -25,6 +25,9 @@
 #include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
 #include <ql/processes/stochasticprocessarray.hpp>
 #include <ql/methods/montecarlo/lsmbasissystem.hpp>
+#include <ql/methods/montecarlo/lsmregression.hpp>
+#include <ql/math/generallinearleastsquares.hpp>
+#include <ql/math/randomnumbers/rngtraits.hpp>
 #include <ql/pricingengines/mclongstaffschwartzengine.hpp>
 #include <ql/pricingengines/vanilla/fdamericanengine.hpp>
 #include <ql/pricingengines/vanilla/mcamericanengine.hpp>
@@ -294,6 +297,132 @@ void MCLongstaffSchwartzEngineTest::testAmericanMaxOption() {
     }
 }
 
+void MCLongstaffSchwartzEngineTest::testBasisValues() {
+
+    BOOST_TEST_MESSAGE("Testing batched evaluation of LSM basis systems...");
+
+    LsmBasisSystem::PolynomType types[] = {
+        LsmBasisSystem::Monomial, LsmBasisSystem::Laguerre,
+        LsmBasisSystem::Hermite, LsmBasisSystem::Hyperbolic,
+        LsmBasisSystem::Legendre, LsmBasisSystem::Chebyshev,
+        LsmBasisSystem::Chebyshev2nd
+    };
+    const Size order = 5, dim = 3, n = 50;
+    const Real tolerance = 1.0e-12;
+
+    PseudoRandom::urng_type rng(42);
+    std::vector<Real> x(n);
+    std::vector<Array> xs(n, Array(dim));
+    for (Size j=0; j<n; ++j) {
+        // inside (-1,1) for the Jacobi polynomials
+        x[j] = 1.8*rng.nextReal() - 0.9;
+        for (Size k=0; k<dim; ++k)
+            xs[j][k] = 1.8*rng.nextReal() - 0.9;
+    }
+
+    for (Size i=0; i<LENGTH(types); ++i) {
+        std::vector<boost::function1<Real, Real> > v =
+            LsmBasisSystem::pathBasisSystem(order, types[i]);
+        Matrix values(n, v.size());
+        LsmBasisSystem::pathBasisValues(order, types[i], x, values);
+        for (Size j=0; j<n; ++j) {
+            for (Size l=0; l<v.size(); ++l) {
+                Real expected = v[l](x[j]);
+                if (std::fabs(values[j][l]-expected)
+                                     > tolerance*std::max(1.0, std::fabs(expected)))
+                    BOOST_FAIL("failed to reproduce path basis function "
+                               << l << " of type " << types[i]
+                               << " at x = " << x[j] << ":"
+                               << QL_FIXED << std::setprecision(14)
+                               << "\n    calculated: " << values[j][l]
+                               << "\n    expected:   " << expected);
+            }
+        }
+
+        std::vector<boost::function1<Real, Array> > vs =
+            LsmBasisSystem::multiPathBasisSystem(dim, order, types[i]);
+        Matrix multiValues(n, vs.size());
+        LsmBasisSystem::multiPathBasisValues(dim, order, types[i],
+                                             xs, multiValues);
+        for (Size j=0; j<n; ++j) {
+            for (Size l=0; l<vs.size(); ++l) {
+                Real expected = vs[l](xs[j]);
+                if (std::fabs(multiValues[j][l]-expected)
+                                     > tolerance*std::max(1.0, std::fabs(expected)))
+                    BOOST_FAIL("failed to reproduce multi-path basis function "
+                               << l << " of type " << types[i]
+                               << " at point #" << j << ":"
+                               << QL_FIXED << std::setprecision(14)
+                               << "\n    calculated: " << multiValues[j][l]
+                               << "\n    expected:   " << expected);
+            }
+        }
+    }
+}
+
+
+void MCLongstaffSchwartzEngineTest::testRegression() {
+
+    BOOST_TEST_MESSAGE("Testing least-squares regression for LSM...");
+
+    const Size n = 1000, order = 3;
+    const Real tolerance = 1.0e-8;
+
+    PseudoRandom::urng_type rng(42);
+    std::vector<Real> x(n), y(n);
+    for (Size j=0; j<n; ++j) {
+        x[j] = 0.5 + rng.nextReal();
+        y[j] = std::exp(x[j]) + 0.1*rng.nextReal();
+    }
+
+    std::vector<boost::function1<Real, Real> > v =
+        LsmBasisSystem::pathBasisSystem(order, LsmBasisSystem::Laguerre);
+    Array expected = GeneralLinearLeastSquares(x, y, v).coefficients();
+
+    Matrix values(n, v.size());
+    LsmBasisSystem::pathBasisValues(order, LsmBasisSystem::Laguerre,
+                                    x, values);
+    LsmRegression regression(v.size());
+    for (Size j=0; j<n; ++j)
+        regression.add(values.row_begin(j), y[j]);
+    Array calculated = regression.coefficients();
+
+    for (Size l=0; l<v.size(); ++l) {
+        if (std::fabs(calculated[l]-expected[l]) > tolerance)
+            BOOST_ERROR("failed to reproduce regression coefficient " << l
+                        << ":" << std::setprecision(12)
+                        << "\n    calculated: " << calculated[l]
+                        << "\n    expected:   " << expected[l]);
+    }
+
+    // a duplicated basis function is handled by the fallback on
+    // the design matrix
+    Matrix degenerate(n, v.size()+1);
+    for (Size j=0; j<n; ++j) {
+        std::copy(values.row_begin(j), values.row_end(j),
+                  degenerate.row_begin(j));
+        degenerate[j][v.size()] = values[j][1];
+    }
+    LsmRegression degenerateRegression(v.size()+1);
+    degenerateRegression.add(degenerate, y);
+    Array coefficients = degenerateRegression.coefficients(degenerate, y);
+    for (Size j=0; j<n; ++j) {
+        Real fitted = std::inner_product(values.row_begin(j),
+                                         values.row_end(j),
+                                         expected.begin(), 0.0);
+        Real calculated = std::inner_product(degenerate.row_begin(j),
+                                             degenerate.row_end(j),
+                                             coefficients.begin(), 0.0);
+        if (std::fabs(calculated-fitted) > 1.0e-6)
+            BOOST_FAIL("failed to reproduce fitted value with "
+                       "degenerate basis at x = " << x[j] << ":"
+                       << std::setprecision(12)
+                       << "\n    calculated: " << calculated
+                       << "\n    expected:   " << fitted);
+    }
+}
+
+
 test_suite* MCLongstaffSchwartzEngineTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Longstaff Schwartz MC engine tests");
     // FLOATING_POINT_EXCEPTION
@@ -301,6 +430,10 @@ test_suite* MCLongstaffSchwartzEngineTest::suite() {
          &MCLongstaffSchwartzEngineTest::testAmericanOption));
     suite->add(QUANTLIB_TEST_CASE(
          &MCLongstaffSchwartzEngineTest::testAmericanMaxOption));
+    suite->add(QUANTLIB_TEST_CASE(
+         &MCLongstaffSchwartzEngineTest::testBasisValues));
+    suite->add(QUANTLIB_TEST_CASE(
+         &MCLongstaffSchwartzEngineTest::testRegression));
     return suite;
 }
 
@@ -29,6 +29,8 @@ class MCLongstaffSchwartzEngineTest {
   public:
     static void testAmericanOption();
     static void testAmericanMaxOption();
+    static void testBasisValues();
+    static void testRegression();
     static boost::unit_test_framework::test_suite* suite();
 };
 
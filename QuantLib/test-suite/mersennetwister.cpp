@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -482,9 +483,58 @@ void MersenneTwisterTest::testValues() {
 }
 
 
+void MersenneTwisterTest::testDiscard() {
+
+    BOOST_TEST_MESSAGE("Testing Mersenne twister jump-ahead...");
+
+    // the last ones jump instead of drawing the skipped numbers
+    unsigned long skips[] = { 0, 1, 623, 624, 625, 100000,
+                              (1UL << 24) + 1, (1UL << 24) + 1000 };
+    Size drawn[] = { 0, 5, 624 };
+
+    for (Size i=0; i<LENGTH(skips); i++) {
+        for (Size j=0; j<LENGTH(drawn); j++) {
+            MersenneTwisterUniformRng mt1(42), mt2(42);
+            for (Size k=0; k<drawn[j]; k++) {
+                mt1.nextInt32();
+                mt2.nextInt32();
+            }
+            for (unsigned long k=0; k<skips[i]; k++)
+                mt1.nextInt32();
+            mt2.discard(skips[i]);
+            for (Size k=0; k<1000; k++) {
+                unsigned long x1 = mt1.nextInt32(), x2 = mt2.nextInt32();
+                if (x1 != x2)
+                    BOOST_FAIL("mismatch after skipping " << skips[i]
+                               << " numbers (" << drawn[j] << " drawn "
+                               << "before) at index " << k << ":\n"
+                               << "    expected: " << x1 << "\n"
+                               << "    found:    " << x2);
+            }
+        }
+    }
+
+    // larger jumps can only be checked for consistency
+    unsigned long n1 = 1000000000UL, n2 = 123456789UL;
+    MersenneTwisterUniformRng mt1(42), mt2(42);
+    mt1.discard(n1);
+    mt1.discard(n2);
+    mt2.discard(n1+n2);
+    for (Size k=0; k<1000; k++) {
+        unsigned long x1 = mt1.nextInt32(), x2 = mt2.nextInt32();
+        if (x1 != x2)
+            BOOST_FAIL("mismatch between single and double jump "
+                       "at index " << k << ":\n"
+                       << "    double jump: " << x1 << "\n"
+                       << "    single jump: " << x2);
+    }
+}
+
+
 test_suite* MersenneTwisterTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Mersenne twister tests");
     suite->add(QUANTLIB_TEST_CASE(&MersenneTwisterTest::testValues));
+    suite->add(QUANTLIB_TEST_CASE(&MersenneTwisterTest::testDiscard));
     return suite;
 }
 
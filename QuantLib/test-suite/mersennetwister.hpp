@@ -2,6 +2,7 @@
 
 /*
  Copyright (C) 2003 Ferdinando Ametrano
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -28,6 +29,7 @@
 class MersenneTwisterTest {
   public:
     static void testValues();
+    static void testDiscard();
     static boost::unit_test_framework::test_suite* suite();
 };
 
@@ -0,0 +1,716 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include "observable.hpp"
+#include "utilities.hpp"
+#include <ql/quotes/simplequote.hpp>
+#include <ql/patterns/lazyobject.hpp>
+#if defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#endif
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    class Counter : public Observer {
+      public:
+        Counter() : count_(0) {}
+        void update() { ++count_; }
+        Size count() const { return count_; }
+        void reset() { count_ = 0; }
+      private:
+        Size count_;
+    };
+
+    // unregisters a number of observers (possibly including itself)
+    // from the observable when notified
+    class Unregisterer : public Counter {
+      public:
+        explicit Unregisterer(const boost::shared_ptr<Observable>& o)
+        : observable_(o) {}
+        void add(Observer* o) { targets_.push_back(o); }
+        void update() {
+            Counter::update();
+            for (Size i=0; i<targets_.size(); ++i)
+                targets_[i]->unregisterWith(observable_);
+            targets_.clear();
+        }
+      private:
+        boost::shared_ptr<Observable> observable_;
+        std::vector<Observer*> targets_;
+    };
+
+    // registers a number of observers with the observable when
+    // notified
+    class Registerer : public Counter {
+      public:
+        explicit Registerer(const boost::shared_ptr<Observable>& o)
+        : observable_(o) {}
+        void add(Observer* o) { targets_.push_back(o); }
+        void update() {
+            Counter::update();
+            for (Size i=0; i<targets_.size(); ++i)
+                targets_[i]->registerWith(observable_);
+            targets_.clear();
+        }
+      private:
+        boost::shared_ptr<Observable> observable_;
+        std::vector<Observer*> targets_;
+    };
+
+    // forwards notifications and records the order of its updates
+    class Forwarder : public virtual Observable, public Counter {
+      public:
+        Forwarder(Size id, std::vector<Size>& log)
+        : id_(id), log_(log) {}
+        void update() {
+            Counter::update();
+            log_.push_back(id_);
+            notifyObservers();
+        }
+      private:
+        Size id_;
+        std::vector<Size>& log_;
+    };
+
+    // destroys the given observer when notified
+    class Killer : public Observer {
+      public:
+        explicit Killer(boost::shared_ptr<Counter>& victim)
+        : victim_(victim) {}
+        void update() { victim_.reset(); }
+      private:
+        boost::shared_ptr<Counter>& victim_;
+    };
+
+    class Thrower : public Observer {
+      public:
+        void update() { QL_FAIL("update failed"); }
+    };
+
+    class Lazy : public LazyObject {
+      public:
+        Lazy() : calculations_(0) {}
+        Size calculations() const { return calculations_; }
+        void use() const { calculate(); }
+      private:
+        void performCalculations() const { ++calculations_; }
+        mutable Size calculations_;
+    };
+
+    void checkCounts(const std::vector<boost::shared_ptr<Counter> >& c,
+                     const std::vector<Size>& expected,
+                     const std::string& tag) {
+        for (Size i=0; i<c.size(); ++i) {
+            if (c[i]->count() != expected[i])
+                BOOST_ERROR(tag << ": observer #" << i << " notified "
+                            << c[i]->count() << " times"
+                            << "\n    expected: " << expected[i]);
+        }
+    }
+
+}
+
+
+void ObservableTest::testRegistration() {
+
+    BOOST_TEST_MESSAGE("Testing observer registration...");
+
+    boost::shared_ptr<SimpleQuote> q1(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+
+    Counter c;
+    if (!c.registerWith(q1).second)
+        BOOST_ERROR("first registration not reported as such");
+    if (c.registerWith(q1).second)
+        BOOST_ERROR("repeated registration not reported as such");
+    if (c.registerWith(boost::shared_ptr<Observable>()).second)
+        BOOST_ERROR("registration with null observable reported "
+                    "as successful");
+    c.registerWith(q2);
+
+    q1->setValue(1.0);
+    if (c.count() != 1)
+        BOOST_ERROR("observer notified " << c.count() << " times "
+                    "after single change\n    expected: 1");
+    q2->setValue(1.0);
+    if (c.count() != 2)
+        BOOST_ERROR("observer notified " << c.count() << " times "
+                    "after two changes\n    expected: 2");
+
+    if (c.unregisterWith(q1) != 1)
+        BOOST_ERROR("unregistration not reported as such");
+    if (c.unregisterWith(q1) != 0)
+        BOOST_ERROR("repeated unregistration not reported as such");
+    q1->setValue(2.0);
+    q2->setValue(2.0);
+    if (c.count() != 3)
+        BOOST_ERROR("observer notified " << c.count() << " times "
+                    "after unregistration\n    expected: 3");
+
+    // many observers, unregistered out of order
+    const Size n = 20;
+    std::vector<boost::shared_ptr<Counter> > counters(n);
+    std::vector<Size> expected(n, 0);
+    for (Size i=0; i<n; ++i) {
+        counters[i] = boost::shared_ptr<Counter>(new Counter);
+        counters[i]->registerWith(q1);
+        counters[i]->registerWith(q2);
+    }
+    q1->setValue(3.0);
+    for (Size i=0; i<n; ++i)
+        ++expected[i];
+    checkCounts(counters, expected, "all registered");
+
+    for (Size i=0; i<n; i+=3) {
+        counters[i]->unregisterWith(q1);
+        counters[n-1-i]->unregisterWith(q2);
+    }
+    q1->setValue(4.0);
+    q2->setValue(4.0);
+    for (Size i=0; i<n; ++i) {
+        if (i % 3 != 0)
+            ++expected[i];
+        if ((n-1-i) % 3 != 0)
+            ++expected[i];
+    }
+    checkCounts(counters, expected, "partially unregistered");
+
+    // destroying observers unregisters them
+    for (Size i=0; i<n; i+=2)
+        counters[i].reset();
+    q1->setValue(5.0);
+    for (Size i=1; i<n; i+=2) {
+        if (i % 3 != 0)
+            ++expected[i];
+        if (counters[i]->count() != expected[i])
+            BOOST_ERROR("observer #" << i << " notified "
+                        << counters[i]->count() << " times "
+                        "after destruction of other observers"
+                        "\n    expected: " << expected[i]);
+    }
+
+    c.unregisterWithAll();
+    q2->setValue(5.0);
+    if (c.count() != 4)
+        BOOST_ERROR("observer notified after unregistering with all");
+
+    // a single observer registered with many observables, which
+    // are then looked up through an index
+    const Size m = 100;
+    std::vector<boost::shared_ptr<SimpleQuote> > quotes(m);
+    for (Size i=0; i<m; ++i) {
+        quotes[i] = boost::shared_ptr<SimpleQuote>(new SimpleQuote(0.0));
+        if (!c.registerWith(quotes[i]).second)
+            BOOST_ERROR("registration #" << i << " not reported as such");
+    }
+    for (Size i=0; i<m; ++i) {
+        if (c.registerWith(quotes[i]).second)
+            BOOST_ERROR("repeated registration #" << i
+                        << " not reported as such");
+    }
+    for (Size i=0; i<m; i+=3) {
+        if (c.unregisterWith(quotes[i]) != 1)
+            BOOST_ERROR("unregistration #" << i << " not reported as such");
+    }
+    for (Size i=0; i<m; i+=3) {
+        if (c.unregisterWith(quotes[i]) != 0)
+            BOOST_ERROR("repeated unregistration #" << i
+                        << " not reported as such");
+    }
+    c.reset();
+    for (Size i=0; i<m; ++i)
+        quotes[i]->setValue(1.0);
+    Size expectedCount = m - (m+2)/3;
+    if (c.count() != expectedCount)
+        BOOST_ERROR("observer notified " << c.count() << " times "
+                    "by many observables\n    expected: " << expectedCount);
+
+    Counter copy(c);
+    c.reset();
+    copy.reset();
+    for (Size i=0; i<m; i+=2)
+        quotes[i]->setValue(2.0);
+    Size expectedEven = 0;
+    for (Size i=0; i<m; i+=2)
+        if (i % 3 != 0)
+            ++expectedEven;
+    if (c.count() != expectedEven || copy.count() != expectedEven)
+        BOOST_ERROR("observer and its copy notified " << c.count()
+                    << " and " << copy.count() << " times "
+                    "\n    expected: " << expectedEven);
+}
+
+
+void ObservableTest::testCopyAndAssignment() {
+
+    BOOST_TEST_MESSAGE("Testing copy and assignment of observers...");
+
+    boost::shared_ptr<SimpleQuote> q1(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+
+    Counter c1;
+    c1.registerWith(q1);
+
+    Counter c2(c1);
+    q1->setValue(1.0);
+    if (c2.count() != 1)
+        BOOST_ERROR("copied observer notified " << c2.count() << " times"
+                    "\n    expected: 1");
+
+    Counter c3;
+    c3.registerWith(q2);
+    c3 = c1;
+    c3.reset();
+    q2->setValue(1.0);
+    if (c3.count() != 0)
+        BOOST_ERROR("assigned observer notified by former observable");
+    q1->setValue(2.0);
+    if (c3.count() != 1)
+        BOOST_ERROR("assigned observer notified " << c3.count() << " times"
+                    "\n    expected: 1");
+
+    c3 = c3;
+    q1->setValue(3.0);
+    if (c3.count() != 2)
+        BOOST_ERROR("self-assigned observer notified " << c3.count()
+                    << " times\n    expected: 2");
+
+    // copying an observable doesn't copy its observers
+    Flag f;
+    f.registerWith(q1);
+    SimpleQuote q4(*q1);
+    q4.setValue(4.0);
+    if (f.isUp())
+        BOOST_ERROR("observer notified by copy of its observable");
+}
+
+
+void ObservableTest::testUnregistrationDuringNotification() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing unregistration of observers during notification...");
+
+    boost::shared_ptr<SimpleQuote> q(new SimpleQuote(0.0));
+
+    const Size n = 10;
+    std::vector<boost::shared_ptr<Counter> > counters(n);
+    for (Size i=0; i<n; ++i) {
+        counters[i] = boost::shared_ptr<Counter>(new Counter);
+        counters[i]->registerWith(q);
+    }
+    // registered in the middle of the list; it removes itself, an
+    // observer already notified and one not yet notified
+    boost::shared_ptr<Unregisterer> u(new Unregisterer(q));
+    u->registerWith(q);
+    for (Size i=0; i<n; ++i) {
+        boost::shared_ptr<Counter> c(new Counter);
+        c->registerWith(q);
+        counters.push_back(c);
+    }
+    u->add(u.get());
+    u->add(counters[2].get());
+    u->add(counters[n+3].get());
+
+    std::vector<Size> expected(2*n, 1);
+    expected[n+3] = 0;
+
+    q->setValue(1.0);
+    if (u->count() != 1)
+        BOOST_ERROR("unregistering observer notified " << u->count()
+                    << " times\n    expected: 1");
+    checkCounts(counters, expected, "first notification");
+
+    q->setValue(2.0);
+    for (Size i=0; i<2*n; ++i)
+        ++expected[i];
+    expected[2] = 1;
+    expected[n+3] = 0;
+    if (u->count() != 1)
+        BOOST_ERROR("unregistered observer notified " << u->count()
+                    << " times\n    expected: 1");
+    checkCounts(counters, expected, "second notification");
+
+    // the remaining observers can still unregister in any order
+    for (Size i=0; i<2*n; i+=2)
+        counters[i]->unregisterWith(q);
+    q->setValue(3.0);
+    for (Size i=1; i<2*n; i+=2)
+        if (i != n+3)
+            ++expected[i];
+    checkCounts(counters, expected, "third notification");
+}
+
+
+void ObservableTest::testRegistrationDuringNotification() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing registration of observers during notification...");
+
+    boost::shared_ptr<SimpleQuote> q(new SimpleQuote(0.0));
+
+    boost::shared_ptr<Registerer> r(new Registerer(q));
+    r->registerWith(q);
+
+    const Size n = 5;
+    std::vector<boost::shared_ptr<Counter> > counters(n);
+    for (Size i=0; i<n; ++i) {
+        counters[i] = boost::shared_ptr<Counter>(new Counter);
+        if (i % 2 == 0)
+            counters[i]->registerWith(q);
+        else
+            r->add(counters[i].get());
+    }
+    // already registered; must not be notified twice
+    r->add(counters[0].get());
+
+    std::vector<Size> expected(n, 0);
+    for (Size i=0; i<n; i+=2)
+        expected[i] = 1;
+
+    q->setValue(1.0);
+    checkCounts(counters, expected, "first notification");
+
+    q->setValue(2.0);
+    for (Size i=0; i<n; ++i)
+        ++expected[i];
+    checkCounts(counters, expected, "second notification");
+
+    if (r->count() != 2)
+        BOOST_ERROR("registering observer notified " << r->count()
+                    << " times\n    expected: 2");
+}
+
+
+void ObservableTest::testNotificationBatch() {
+
+    BOOST_TEST_MESSAGE("Testing notification batches...");
+
+    // q1, q2, q3 -> curve -> instrument; q1 -> instrument as well
+    boost::shared_ptr<SimpleQuote> q1(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q3(new SimpleQuote(0.0));
+    std::vector<Size> log;
+    boost::shared_ptr<Forwarder> instrument(new Forwarder(2, log));
+    instrument->registerWith(q1);
+    boost::shared_ptr<Forwarder> curve(new Forwarder(1, log));
+    curve->registerWith(q1);
+    curve->registerWith(q2);
+    curve->registerWith(q3);
+    instrument->registerWith(curve);
+
+    // without a batch, each change reaches the instrument
+    q1->setValue(1.0);
+    q2->setValue(1.0);
+    q3->setValue(1.0);
+    if (curve->count() != 3 || instrument->count() != 4)
+        BOOST_FAIL("unexpected notifications without batch:"
+                   << "\n    curve:      " << curve->count()
+                   << "\n    instrument: " << instrument->count()
+                   << "\n    expected:   3 and 4");
+    curve->reset();
+    instrument->reset();
+    log.clear();
+
+    ObservableSettings& settings = ObservableSettings::instance();
+    settings.resetCounters();
+    {
+        NotificationBatch batch;
+        if (!settings.batching())
+            BOOST_ERROR("batch not reported as open");
+        q1->setValue(2.0);
+        q2->setValue(2.0);
+        q3->setValue(2.0);
+        q1->setValue(3.0);
+        if (curve->count() != 0 || instrument->count() != 0)
+            BOOST_ERROR("observers notified while batch is open");
+    }
+    if (settings.batching())
+        BOOST_ERROR("batch still reported as open");
+
+    if (curve->count() != 1 || instrument->count() != 1)
+        BOOST_ERROR("unexpected notifications with batch:"
+                    << "\n    curve:      " << curve->count()
+                    << "\n    instrument: " << instrument->count()
+                    << "\n    expected:   1 and 1");
+    if (log.size() != 2 || log[0] != 1 || log[1] != 2)
+        BOOST_ERROR("instrument not notified after curve");
+
+    // 4 deferred calls, requesting 2+1+1+2 updates from the quotes
+    // and 1 from the curve; 2 updates delivered.
+    if (settings.deferredNotifications() != 4)
+        BOOST_ERROR(settings.deferredNotifications()
+                    << " deferred notifications\n    expected: 4");
+    if (settings.requestedUpdates() != 7)
+        BOOST_ERROR(settings.requestedUpdates()
+                    << " requested updates\n    expected: 7");
+    if (settings.deliveredUpdates() != 2)
+        BOOST_ERROR(settings.deliveredUpdates()
+                    << " delivered updates\n    expected: 2");
+    if (settings.coalescedUpdates() != 5)
+        BOOST_ERROR(settings.coalescedUpdates()
+                    << " coalesced updates\n    expected: 5");
+
+    // an empty batch sends no notifications
+    {
+        NotificationBatch batch;
+    }
+    if (curve->count() != 1 || instrument->count() != 1)
+        BOOST_ERROR("observers notified by empty batch");
+
+    // observers not reached by the batch are not notified
+    {
+        NotificationBatch batch;
+        q2->setValue(4.0);
+        boost::shared_ptr<SimpleQuote> q4(new SimpleQuote(0.0));
+        Counter c;
+        c.registerWith(q4);
+        batch.close();
+        if (c.count() != 0)
+            BOOST_ERROR("unrelated observer notified by batch");
+        // notifications are immediate after closing
+        q4->setValue(1.0);
+        if (c.count() != 1)
+            BOOST_ERROR("observer not notified after closing batch");
+    }
+    if (curve->count() != 2 || instrument->count() != 2)
+        BOOST_ERROR("unexpected notifications with second batch:"
+                    << "\n    curve:      " << curve->count()
+                    << "\n    instrument: " << instrument->count()
+                    << "\n    expected:   2 and 2");
+}
+
+
+void ObservableTest::testNestedNotificationBatches() {
+
+    BOOST_TEST_MESSAGE("Testing nested notification batches...");
+
+    boost::shared_ptr<SimpleQuote> q1(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+    Counter c;
+    c.registerWith(q1);
+    c.registerWith(q2);
+
+    {
+        NotificationBatch outer;
+        q1->setValue(1.0);
+        {
+            NotificationBatch inner;
+            q2->setValue(1.0);
+        }
+        if (c.count() != 0)
+            BOOST_ERROR("observer notified when closing inner batch");
+        q1->setValue(2.0);
+    }
+    if (c.count() != 1)
+        BOOST_ERROR("observer notified " << c.count() << " times "
+                    "by nested batches\n    expected: 1");
+
+    // a chain of observers is notified in order in spite of having
+    // registered in the opposite one
+    std::vector<Size> log;
+    const Size n = 10;
+    std::vector<boost::shared_ptr<Forwarder> > chain(n);
+    for (Size i=n; i>0; --i) {
+        chain[i-1] = boost::shared_ptr<Forwarder>(new Forwarder(i-1, log));
+        chain[i-1]->registerWith(q1);
+        if (i < n)
+            chain[i]->registerWith(chain[i-1]);
+    }
+    {
+        NotificationBatch batch;
+        q1->setValue(3.0);
+    }
+    if (log.size() != n)
+        BOOST_FAIL(log.size() << " updates in chain\n    expected: " << n);
+    for (Size i=0; i<n; ++i)
+        if (log[i] != i)
+            BOOST_ERROR("link #" << log[i] << " updated "
+                        << "in position " << i);
+}
+
+
+void ObservableTest::testNotificationBatchWithLazyObjects() {
+
+    BOOST_TEST_MESSAGE("Testing notification batches with lazy objects...");
+
+    boost::shared_ptr<SimpleQuote> q1(new SimpleQuote(0.0));
+    boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+    boost::shared_ptr<Lazy> lazy(new Lazy);
+    lazy->registerWith(q1);
+    lazy->registerWith(q2);
+    Counter c;
+    c.registerWith(lazy);
+
+    lazy->use();
+    {
+        NotificationBatch batch;
+        q1->setValue(1.0);
+        q2->setValue(1.0);
+    }
+    if (c.count() != 1)
+        BOOST_ERROR("observer of lazy object notified " << c.count()
+                    << " times\n    expected: 1");
+    lazy->use();
+    if (lazy->calculations() != 2)
+        BOOST_ERROR("lazy object calculated " << lazy->calculations()
+                    << " times\n    expected: 2");
+
+    // frozen lazy objects don't forward notifications
+    lazy->freeze();
+    {
+        NotificationBatch batch;
+        q1->setValue(2.0);
+    }
+    if (c.count() != 1)
+        BOOST_ERROR("observer of frozen lazy object notified");
+    lazy->unfreeze();
+    if (c.count() != 2)
+        BOOST_ERROR("observer of lazy object not notified "
+                    "when unfreezing");
+}
+
+
+void ObservableTest::testNotificationBatchCornerCases() {
+
+    BOOST_TEST_MESSAGE("Testing corner cases of notification batches...");
+
+    boost::shared_ptr<SimpleQuote> q(new SimpleQuote(0.0));
+
+    // observables and observers destroyed while the batch is open
+    {
+        NotificationBatch batch;
+        boost::shared_ptr<SimpleQuote> q2(new SimpleQuote(0.0));
+        boost::shared_ptr<Counter> c(new Counter);
+        c->registerWith(q2);
+        q2->setValue(1.0);
+        c.reset();
+        q2->setValue(2.0);
+    }
+
+    // an observer destroyed during delivery is skipped
+    std::vector<Size> log;
+    boost::shared_ptr<Forwarder> f(new Forwarder(0, log));
+    f->registerWith(q);
+    boost::shared_ptr<Counter> victim(new Counter);
+    victim->registerWith(f);
+    Killer killer(victim);
+    killer.registerWith(q);
+    Counter survivor;
+    survivor.registerWith(f);
+    {
+        NotificationBatch batch;
+        q->setValue(1.0);
+    }
+    if (victim)
+        BOOST_ERROR("observer not destroyed");
+    if (f->count() != 1 || survivor.count() != 1)
+        BOOST_ERROR("unexpected notifications after observer destruction:"
+                    << "\n    forwarder: " << f->count()
+                    << "\n    observer:  " << survivor.count()
+                    << "\n    expected:  1 and 1");
+
+    // exceptions are reported when closing the batch, after all
+    // observers were notified
+    Thrower thrower;
+    thrower.registerWith(q);
+    Counter c;
+    c.registerWith(q);
+    NotificationBatch batch;
+    q->setValue(2.0);
+    BOOST_CHECK_THROW(batch.close(), Error);
+    if (c.count() != 1)
+        BOOST_ERROR("observer not notified after exception");
+    if (ObservableSettings::instance().batching())
+        BOOST_ERROR("batch still reported as open after exception");
+}
+
+
+#if defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+
+namespace {
+
+    void churn(const std::vector<boost::shared_ptr<SimpleQuote> >& quotes,
+               Size iterations, Size offset) {
+        for (Size i=0; i<iterations; ++i) {
+            Counter c;
+            for (Size j=0; j<quotes.size(); ++j)
+                c.registerWith(quotes[(j+offset+i) % quotes.size()]);
+            if (i % 2 == 0)
+                c.unregisterWith(quotes[(offset+i) % quotes.size()]);
+        }
+    }
+
+}
+
+void ObservableTest::testMultiThreadedRegistration() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing registration of observers from multiple threads...");
+
+    const Size nQuotes = 10, nThreads = 4, iterations = 2000;
+    std::vector<boost::shared_ptr<SimpleQuote> > quotes(nQuotes);
+    for (Size j=0; j<nQuotes; ++j)
+        quotes[j] = boost::shared_ptr<SimpleQuote>(new SimpleQuote(0.0));
+
+    Counter c;
+    for (Size j=0; j<nQuotes; ++j)
+        c.registerWith(quotes[j]);
+
+    boost::thread_group threads;
+    for (Size k=0; k<nThreads; ++k)
+        threads.create_thread(boost::bind(churn, boost::cref(quotes),
+                                          iterations, k));
+    for (Size i=0; i<iterations; ++i)
+        quotes[i % nQuotes]->setValue(Real(i+1));
+    threads.join_all();
+
+    if (c.count() != iterations)
+        BOOST_ERROR("observer notified " << c.count() << " times"
+                    "\n    expected: " << iterations);
+}
+
+#endif
+
+
+test_suite* ObservableTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Observer tests");
+    suite->add(QUANTLIB_TEST_CASE(&ObservableTest::testRegistration));
+    suite->add(QUANTLIB_TEST_CASE(&ObservableTest::testCopyAndAssignment));
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testUnregistrationDuringNotification));
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testRegistrationDuringNotification));
+    suite->add(QUANTLIB_TEST_CASE(&ObservableTest::testNotificationBatch));
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testNestedNotificationBatches));
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testNotificationBatchWithLazyObjects));
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testNotificationBatchCornerCases));
+    #if defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+    suite->add(QUANTLIB_TEST_CASE(
+               &ObservableTest::testMultiThreadedRegistration));
+    #endif
+    return suite;
+}
+
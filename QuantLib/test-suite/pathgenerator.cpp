@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2005 StatPro Italia srl
+ Copyright (C) 2005, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -20,11 +20,15 @@
 #include "pathgenerator.hpp"
 #include "utilities.hpp"
 #include <ql/methods/montecarlo/mctraits.hpp>
+#include <ql/math/randomnumbers/sobolbrownianbridgersg.hpp>
 #include <ql/processes/blackscholesprocess.hpp>
 #include <ql/processes/geometricbrownianprocess.hpp>
 #include <ql/processes/ornsteinuhlenbeckprocess.hpp>
 #include <ql/processes/squarerootprocess.hpp>
 #include <ql/processes/stochasticprocessarray.hpp>
+#include <ql/processes/hestonprocess.hpp>
+#include <ql/pricingengines/vanilla/mceuropeanengine.hpp>
+#include <ql/pricingengines/asian/mc_discr_arith_av_price.hpp>
 #include <ql/time/daycounters/actual360.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/utilities/dataformatters.hpp>
@@ -138,6 +142,140 @@ namespace {
         }
     }
 
+    void testSingleBlock(
+                      const boost::shared_ptr<StochasticProcess1D>& process,
+                      const std::string& tag, bool brownianBridge) {
+        typedef PseudoRandom::rsg_type rsg_type;
+        typedef PathGenerator<rsg_type>::sample_type sample_type;
+
+        BigNatural seed = 42;
+        Time length = 10;
+        Size timeSteps = 12;
+        Size paths = 50;
+        PathGenerator<rsg_type> generator(
+            process, length, timeSteps,
+            PseudoRandom::make_sequence_generator(timeSteps, seed),
+            brownianBridge);
+        PathGenerator<rsg_type> blockGenerator(
+            process, length, timeSteps,
+            PseudoRandom::make_sequence_generator(timeSteps, seed),
+            brownianBridge);
+
+        PathBlock block(blockGenerator.timeGrid(), paths),
+                  antitheticBlock(blockGenerator.timeGrid(), paths);
+        blockGenerator.next(block);
+        blockGenerator.antithetic(antitheticBlock);
+
+        Path path(generator.timeGrid());
+        for (Size j=0; j<paths; j++) {
+            sample_type sample = generator.next();
+            sample_type antithetic = generator.antithetic();
+            block.extract(j, path);
+            for (Size i=0; i<path.length(); i++) {
+                if (path[i] != sample.value[i])
+                    BOOST_FAIL("using " << tag << " process "
+                               << (brownianBridge ? "with " : "without ")
+                               << "brownian bridge:\n"
+                               << "block path #" << j << ", node #" << i
+                               << " differs from path generator\n"
+                               << std::setprecision(16)
+                               << "    block:     " << path[i] << "\n"
+                               << "    generator: " << sample.value[i]);
+            }
+            antitheticBlock.extract(j, path);
+            for (Size i=0; i<path.length(); i++) {
+                if (path[i] != antithetic.value[i])
+                    BOOST_FAIL("using " << tag << " process "
+                               << (brownianBridge ? "with " : "without ")
+                               << "brownian bridge:\n"
+                               << "antithetic block path #" << j
+                               << ", node #" << i
+                               << " differs from path generator\n"
+                               << std::setprecision(16)
+                               << "    block:     " << path[i] << "\n"
+                               << "    generator: "
+                               << antithetic.value[i]);
+            }
+            if (block.weights()[j] != sample.weight)
+                BOOST_FAIL("using " << tag << " process:\n"
+                           << "block weight #" << j
+                           << " differs from path generator");
+        }
+
+        // batched path pricers must agree with the single-path ones
+        std::vector<boost::shared_ptr<PathPricer<Path> > > pricers;
+        pricers.push_back(boost::shared_ptr<PathPricer<Path> >(
+                         new EuropeanPathPricer(Option::Call, 100.0, 0.95)));
+        pricers.push_back(boost::shared_ptr<PathPricer<Path> >(
+                    new ArithmeticAPOPathPricer(Option::Put, 100.0, 0.95)));
+        std::vector<Real> values;
+        for (Size k=0; k<pricers.size(); k++) {
+            const PathPricer<Path>& pricer = *pricers[k];
+            pricer(block, values);
+            if (values.size() != paths)
+                BOOST_FAIL("wrong number of values from batched pricer");
+            for (Size j=0; j<paths; j++) {
+                block.extract(j, path);
+                Real expected = pricer(path);
+                if (std::fabs(values[j]-expected) > 1.0e-12)
+                    BOOST_FAIL("using " << tag << " process:\n"
+                               << "batched pricer #" << k
+                               << " differs on path #" << j << "\n"
+                               << std::setprecision(16)
+                               << "    batched:     " << values[j] << "\n"
+                               << "    single path: " << expected);
+            }
+        }
+    }
+
+    template <class RSG>
+    void testMultipleBlock(const boost::shared_ptr<StochasticProcess>& process,
+                           const std::string& tag,
+                           const RSG& rsg) {
+        typedef typename MultiPathGenerator<RSG>::sample_type sample_type;
+
+        Time length = 10;
+        Size timeSteps = 12;
+        Size paths = 50;
+        Size assets = process->size();
+        TimeGrid grid(length, timeSteps);
+        MultiPathGenerator<RSG> generator(process, grid, rsg, false);
+        MultiPathGenerator<RSG> blockGenerator(process, grid, rsg, false);
+
+        MultiPathBlock block(assets, grid, paths),
+                       antitheticBlock(assets, grid, paths);
+        blockGenerator.next(block);
+        blockGenerator.antithetic(antitheticBlock);
+
+        MultiPath path(assets, grid);
+        for (Size j=0; j<paths; j++) {
+            sample_type sample = generator.next();
+            sample_type antithetic = generator.antithetic();
+            for (Size l=0; l<2; l++) {
+                const MultiPathBlock& b = (l == 0 ? block : antitheticBlock);
+                const MultiPath& expected =
+                    (l == 0 ? sample.value : antithetic.value);
+                b.extract(j, path);
+                for (Size k=0; k<assets; k++) {
+                    for (Size i=0; i<grid.size(); i++) {
+                        if (path[k][i] != expected[k][i])
+                            BOOST_FAIL("using " << tag << " process:\n"
+                                       << (l == 0 ? "" : "antithetic ")
+                                       << "block path #" << j << ", "
+                                       << io::ordinal(k+1) << " asset, "
+                                       << "node #" << i
+                                       << " differs from path generator\n"
+                                       << std::setprecision(16)
+                                       << "    block:     " << path[k][i]
+                                       << "\n"
+                                       << "    generator: "
+                                       << expected[k][i]);
+                    }
+                }
+            }
+        }
+    }
+
 }
 
 
@@ -290,11 +428,159 @@ void PathGeneratorTest::testMultiPathGenerator() {
 }
 
 
+void PathGeneratorTest::testPathBlocks() {
+
+    BOOST_TEST_MESSAGE("Testing block path generation...");
+
+    SavedSettings backup;
+
+    Settings::instance().evaluationDate() = Date(26,April,2005);
+
+    Handle<Quote> x0(boost::shared_ptr<Quote>(new SimpleQuote(100.0)));
+    Handle<YieldTermStructure> r(flatRate(0.05, Actual360()));
+    Handle<YieldTermStructure> q(flatRate(0.02, Actual360()));
+    Handle<BlackVolTermStructure> sigma(flatVol(0.20, Actual360()));
+
+    boost::shared_ptr<StochasticProcess1D> bsm(
+                                 new BlackScholesMertonProcess(x0,q,r,sigma));
+    testSingleBlock(bsm, "Black-Scholes", false);
+    testSingleBlock(bsm, "Black-Scholes", true);
+    testSingleBlock(boost::shared_ptr<StochasticProcess1D>(
+                       new GeometricBrownianMotionProcess(100.0, 0.03, 0.20)),
+                    "geometric Brownian", false);
+    testSingleBlock(boost::shared_ptr<StochasticProcess1D>(
+                                     new OrnsteinUhlenbeckProcess(0.1, 0.20)),
+                    "Ornstein-Uhlenbeck", false);
+
+    BigNatural seed = 42;
+    HestonProcess::Discretization schemes[] = {
+        HestonProcess::PartialTruncation,
+        HestonProcess::FullTruncation,
+        HestonProcess::Reflection,
+        HestonProcess::QuadraticExponentialMartingale
+    };
+    for (Size i=0; i<LENGTH(schemes); i++) {
+        boost::shared_ptr<StochasticProcess> heston(
+                 new HestonProcess(r, q, x0, 0.04, 1.5, 0.04, 0.5, -0.7,
+                                   schemes[i]));
+        testMultipleBlock(heston, "Heston",
+                          PseudoRandom::make_sequence_generator(
+                                        12*heston->factors(), seed));
+    }
+    boost::shared_ptr<StochasticProcess> heston(
+                 new HestonProcess(r, q, x0, 0.04, 1.5, 0.04, 0.5, -0.7));
+    testMultipleBlock(heston, "Heston",
+                      SobolBrownianBridgeRsg(heston->factors(), 12));
+
+    Matrix correlation(2,2);
+    correlation[0][0] = 1.0; correlation[0][1] = 0.6;
+    correlation[1][0] = 0.6; correlation[1][1] = 1.0;
+    std::vector<boost::shared_ptr<StochasticProcess1D> > processes(2, bsm);
+    testMultipleBlock(boost::shared_ptr<StochasticProcess>(
+                           new StochasticProcessArray(processes,correlation)),
+                      "Black-Scholes",
+                      PseudoRandom::make_sequence_generator(24, seed));
+}
+
+
+void PathGeneratorTest::testSobolBrownianBlocks() {
+
+    BOOST_TEST_MESSAGE("Testing block generation of Sobol Brownian variates...");
+
+    Size factors = 3, steps = 7, paths = 100;
+    SobolBrownianGenerator::Ordering orderings[] = {
+        SobolBrownianGenerator::Factors,
+        SobolBrownianGenerator::Steps,
+        SobolBrownianGenerator::Diagonal
+    };
+    const char* tags[] = { "factors", "steps", "diagonal" };
+
+    for (Size l=0; l<LENGTH(orderings); l++) {
+        SobolBrownianGenerator generator(factors, steps, orderings[l]),
+                               blockGenerator(factors, steps, orderings[l]);
+
+        // reference: each Sobol point is mapped to Gaussian variates
+        // and bridged separately
+        InverseCumulativeRsg<SobolRsg,InverseCumulativeNormal>
+            rsg(SobolRsg(factors*steps), InverseCumulativeNormal());
+        BrownianBridge bridge(steps);
+        const std::vector<std::vector<Size> >& indices =
+            generator.orderedIndices();
+        std::vector<std::vector<Real> > expected(paths*factors,
+                                                 std::vector<Real>(steps));
+        for (Size j=0; j<paths; j++) {
+            const std::vector<Real>& sample = rsg.nextSequence().value;
+            for (Size k=0; k<factors; k++) {
+                std::vector<Real> variates(steps);
+                for (Size i=0; i<steps; i++)
+                    variates[i] = sample[indices[k][i]];
+                bridge.transform(variates.begin(), variates.end(),
+                                 expected[j*factors+k].begin());
+            }
+        }
+
+        // blocks of different sizes, after a few single paths
+        Size sizes[] = { 5, 1, 40, 33, 17 };
+        std::vector<std::vector<Real> > calculated;
+        std::vector<Real> output(factors);
+        for (Size j=0; j<4; j++) {
+            blockGenerator.nextPath();
+            calculated.resize(calculated.size()+factors,
+                              std::vector<Real>(steps));
+            for (Size i=0; i<steps; i++) {
+                blockGenerator.nextStep(output);
+                for (Size k=0; k<factors; k++)
+                    calculated[calculated.size()-factors+k][i] = output[k];
+            }
+        }
+        for (Size m=0; m<LENGTH(sizes); m++) {
+            std::vector<Matrix> block(steps, Matrix(factors, sizes[m]));
+            blockGenerator.nextBlock(block);
+            for (Size j=0; j<sizes[m]; j++) {
+                calculated.resize(calculated.size()+factors,
+                                  std::vector<Real>(steps));
+                for (Size i=0; i<steps; i++)
+                    for (Size k=0; k<factors; k++)
+                        calculated[calculated.size()-factors+k][i] =
+                            block[i][k][j];
+            }
+        }
+
+        Real tolerance = 1.0e-12;
+        for (Size j=0; j<paths; j++) {
+            generator.nextPath();
+            for (Size i=0; i<steps; i++) {
+                generator.nextStep(output);
+                for (Size k=0; k<factors; k++) {
+                    Real x = expected[j*factors+k][i];
+                    if (std::fabs(output[k]-x) > tolerance
+                        || std::fabs(calculated[j*factors+k][i]-x)
+                                                              > tolerance)
+                        BOOST_FAIL("using " << tags[l] << " ordering:\n"
+                                   << "path #" << j << ", "
+                                   << io::ordinal(k+1) << " factor, "
+                                   << io::ordinal(i+1) << " step:\n"
+                                   << std::setprecision(16)
+                                   << "    single path: " << output[k]
+                                   << "\n"
+                                   << "    block:       "
+                                   << calculated[j*factors+k][i] << "\n"
+                                   << "    expected:    " << x);
+                }
+            }
+        }
+    }
+}
+
+
 test_suite* PathGeneratorTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Path generation tests");
     suite->add(QUANTLIB_TEST_CASE(&PathGeneratorTest::testPathGenerator));
     // FLOATING_POINT_EXCEPTION
     suite->add(QUANTLIB_TEST_CASE(&PathGeneratorTest::testMultiPathGenerator));
+    suite->add(QUANTLIB_TEST_CASE(&PathGeneratorTest::testPathBlocks));
+    suite->add(QUANTLIB_TEST_CASE(
+                            &PathGeneratorTest::testSobolBrownianBlocks));
     return suite;
 }
 
@@ -1,7 +1,7 @@
 /* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
 
 /*
- Copyright (C) 2005, 2006, 2007, 2008, 2009 StatPro Italia srl
+ Copyright (C) 2005, 2006, 2007, 2008, 2009, 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -20,6 +20,8 @@
 #include "piecewiseyieldcurve.hpp"
 #include "utilities.hpp"
 #include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/jacobianbootstrap.hpp>
+#include <ql/termstructures/globalbootstrap.hpp>
 #include <ql/termstructures/yield/ratehelpers.hpp>
 #include <ql/termstructures/yield/bondhelpers.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
@@ -361,9 +363,9 @@ namespace {
 
         // check FRA
         vars.termStructure = boost::shared_ptr<YieldTermStructure>(new
-            PiecewiseYieldCurve<T,I>(vars.settlement, vars.fraHelpers,
-                                     Actual360(),
-                                     interpolator));
+            PiecewiseYieldCurve<T,I,B>(vars.settlement, vars.fraHelpers,
+                                       Actual360(),
+                                       interpolator));
         curveHandle.linkTo(vars.termStructure);
 
         boost::shared_ptr<IborIndex> euribor3m(new Euribor3M(curveHandle));
@@ -638,6 +640,206 @@ void PiecewiseYieldCurveTest::testLocalBootstrapConsistency() {
 }
 
 
+void PiecewiseYieldCurveTest::testJacobianBootstrapConsistency() {
+    BOOST_TEST_MESSAGE(
+        "Testing consistency of Jacobian-bootstrap algorithm...");
+
+    CommonVars vars;
+    testCurveConsistency<Discount,LogLinear,JacobianBootstrap>(vars);
+    testCurveConsistency<ZeroYield,Linear,JacobianBootstrap>(vars);
+    testCurveConsistency<ForwardRate,BackwardFlat,JacobianBootstrap>(vars);
+    testCurveConsistency<ZeroYield,Cubic,JacobianBootstrap>(
+                   vars,
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0));
+    testBMACurveConsistency<Discount,LogLinear,JacobianBootstrap>(vars);
+}
+
+
+namespace {
+
+    template <class T, class I>
+    void testCurveIncrementalBootstrap(const I& interpolator = I()) {
+
+        CommonVars vars;
+
+        boost::shared_ptr<PiecewiseYieldCurve<T,I,JacobianBootstrap> > curve(
+            new PiecewiseYieldCurve<T,I,JacobianBootstrap>(vars.settlement,
+                                                           vars.instruments,
+                                                           Actual360(),
+                                                           interpolator));
+        curve->nodes();
+
+        Size n = vars.deposits+vars.swaps;
+        for (Size i=0; i<n; i+=3) {
+            vars.rates[i]->setValue(vars.rates[i]->value() + 0.0010);
+            std::vector<Real> data = curve->data();
+
+            // the expected pillar for the local interpolators
+            Size expected = I::global ? 1 : i+1;
+            Size calculated = curve->bootstrap().firstSolvedPillar();
+            if (calculated != expected)
+                BOOST_ERROR("failed to skip unchanged pillars "
+                            "after change of " << io::ordinal(i+1) <<
+                            " quote:"
+                            << "\n    first pillar solved: " << calculated
+                            << "\n    expected:            " << expected);
+
+            PiecewiseYieldCurve<T,I> fullCurve(vars.settlement,
+                                               vars.instruments,
+                                               Actual360(),
+                                               interpolator);
+            std::vector<Real> expectedData = fullCurve.data();
+            for (Size j=0; j<data.size(); ++j) {
+                if (std::fabs(data[j]-expectedData[j]) > 1.0e-9)
+                    BOOST_ERROR("failed to reproduce full bootstrap "
+                                "after change of " << io::ordinal(i+1) <<
+                                " quote:"
+                                << std::setprecision(12)
+                                << "\n    node:       " << j
+                                << "\n    calculated: " << data[j]
+                                << "\n    expected:   " << expectedData[j]);
+            }
+        }
+    }
+
+    template <class T, class I>
+    void testCurveJacobian(const I& interpolator = I()) {
+
+        CommonVars vars;
+
+        PiecewiseYieldCurve<T,I,JacobianBootstrap> curve(vars.settlement,
+                                                         vars.instruments,
+                                                         Actual360(),
+                                                         interpolator);
+        Matrix jacobian = curve.bootstrap().jacobian();
+
+        Size n = vars.deposits+vars.swaps;
+        if (jacobian.rows() != n || jacobian.columns() != n)
+            BOOST_FAIL("wrong Jacobian size:"
+                       << "\n    calculated: "
+                       << jacobian.rows() << "x" << jacobian.columns()
+                       << "\n    expected:   " << n << "x" << n);
+
+        Real h = 1.0e-6;
+        for (Size j=0; j<n; ++j) {
+            Real r = vars.rates[j]->value();
+            vars.rates[j]->setValue(r+h);
+            std::vector<Real> up = curve.data();
+            vars.rates[j]->setValue(r-h);
+            std::vector<Real> down = curve.data();
+            vars.rates[j]->setValue(r);
+
+            for (Size i=0; i<n; ++i) {
+                Real expected = (up[i+1]-down[i+1])/(2*h);
+                Real calculated = jacobian[i][j];
+                if (std::fabs(calculated-expected) >
+                    1.0e-4 * std::max(1.0, std::fabs(expected)))
+                    BOOST_ERROR("failed to reproduce node sensitivity:"
+                                << std::setprecision(8)
+                                << "\n    node:       " << i+1
+                                << "\n    quote:      " << j
+                                << "\n    calculated: " << calculated
+                                << "\n    expected:   " << expected);
+            }
+        }
+    }
+
+}
+
+
+void PiecewiseYieldCurveTest::testIncrementalBootstrap() {
+    BOOST_TEST_MESSAGE(
+        "Testing incremental re-bootstrap after quote changes...");
+
+    testCurveIncrementalBootstrap<Discount,LogLinear>();
+    testCurveIncrementalBootstrap<ZeroYield,Linear>();
+    testCurveIncrementalBootstrap<ForwardRate,BackwardFlat>();
+    testCurveIncrementalBootstrap<ZeroYield,Cubic>(
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0));
+}
+
+
+void PiecewiseYieldCurveTest::testBootstrapJacobian() {
+    BOOST_TEST_MESSAGE(
+        "Testing Jacobian of bootstrapped nodes with respect to quotes...");
+
+    testCurveJacobian<Discount,LogLinear>();
+    testCurveJacobian<ZeroYield,Linear>();
+    testCurveJacobian<ForwardRate,BackwardFlat>();
+}
+
+
+void PiecewiseYieldCurveTest::testGlobalBootstrapConsistency() {
+    BOOST_TEST_MESSAGE(
+        "Testing consistency of global-bootstrap algorithm...");
+
+    CommonVars vars;
+    testCurveConsistency<Discount,LogLinear,GlobalBootstrap>(vars);
+    testCurveConsistency<ZeroYield,Cubic,GlobalBootstrap>(
+                   vars,
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0));
+    testCurveConsistency<Discount,LogCubic,GlobalBootstrap>(
+                   vars,
+                   LogCubic(CubicInterpolation::Spline, true,
+                            CubicInterpolation::SecondDerivative, 0.0,
+                            CubicInterpolation::SecondDerivative, 0.0));
+    testCurveConsistency<ForwardRate,ConvexMonotone,GlobalBootstrap>(vars);
+    testBMACurveConsistency<ZeroYield,Cubic,GlobalBootstrap>(
+                   vars,
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0));
+}
+
+
+void PiecewiseYieldCurveTest::testGlobalBootstrapAfterLargeMove() {
+    BOOST_TEST_MESSAGE(
+        "Testing global bootstrap after a large move in the quotes...");
+
+    CommonVars vars;
+
+    boost::shared_ptr<YieldTermStructure> curve(new
+        PiecewiseYieldCurve<ZeroYield,Cubic,GlobalBootstrap>(
+                   vars.settlement, vars.instruments, Actual360(),
+                   Cubic(CubicInterpolation::Spline, true,
+                         CubicInterpolation::SecondDerivative, 0.0,
+                         CubicInterpolation::SecondDerivative, 0.0)));
+
+    std::vector<Rate> original(vars.rates.size());
+    for (Size i=0; i<vars.rates.size(); ++i)
+        original[i] = vars.rates[i]->value();
+
+    // the previous solution is used as a guess; a move this large
+    // might require the curve to be bootstrapped again from scratch.
+    curve->discount(1.0);
+    for (Size k=0; k<2; ++k) {
+        // first move away, then back
+        for (Size i=0; i<vars.rates.size(); ++i) {
+            Rate r = (k == 0 ? 0.30 - 4.0*original[i] : original[i]);
+            vars.rates[i]->setValue(r);
+        }
+
+        curve->discount(1.0);
+        for (Size i=0; i<vars.instruments.size(); ++i) {
+            Real error = std::fabs(vars.instruments[i]->quoteError());
+            if (error > 1.0e-9)
+                BOOST_ERROR("failed to reprice " << io::ordinal(i+1)
+                            << " instrument after quotes moved:"
+                            << std::setprecision(8)
+                            << "\n    quote: "
+                            << vars.instruments[i]->quote()->value()
+                            << "\n    error: " << error);
+        }
+    }
+}
+
+
 void PiecewiseYieldCurveTest::testObservability() {
 
     BOOST_TEST_MESSAGE("Testing observability of piecewise yield curve...");
@@ -945,6 +1147,16 @@ test_suite* PiecewiseYieldCurveTest::suite() {
              &PiecewiseYieldCurveTest::testConvexMonotoneForwardConsistency));
     suite->add(QUANTLIB_TEST_CASE(
              &PiecewiseYieldCurveTest::testLocalBootstrapConsistency));
+    suite->add(QUANTLIB_TEST_CASE(
+             &PiecewiseYieldCurveTest::testJacobianBootstrapConsistency));
+    suite->add(QUANTLIB_TEST_CASE(
+             &PiecewiseYieldCurveTest::testIncrementalBootstrap));
+    suite->add(QUANTLIB_TEST_CASE(
+             &PiecewiseYieldCurveTest::testBootstrapJacobian));
+    suite->add(QUANTLIB_TEST_CASE(
+             &PiecewiseYieldCurveTest::testGlobalBootstrapConsistency));
+    suite->add(QUANTLIB_TEST_CASE(
+             &PiecewiseYieldCurveTest::testGlobalBootstrapAfterLargeMove));
 
     suite->add(QUANTLIB_TEST_CASE(&PiecewiseYieldCurveTest::testObservability));
     suite->add(QUANTLIB_TEST_CASE(&PiecewiseYieldCurveTest::testLiborFixing));
@@ -41,6 +41,11 @@ class PiecewiseYieldCurveTest {
 
     static void testConvexMonotoneForwardConsistency();
     static void testLocalBootstrapConsistency();
+    static void testJacobianBootstrapConsistency();
+    static void testIncrementalBootstrap();
+    static void testBootstrapJacobian();
+    static void testGlobalBootstrapConsistency();
+    static void testGlobalBootstrapAfterLargeMove();
 
     static void testObservability();
     static void testLiborFixing();
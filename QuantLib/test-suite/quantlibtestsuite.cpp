@@ -124,6 +124,7 @@
 #include "mersennetwister.hpp"
 #include "money.hpp"
 #include "nthtodefault.hpp"
+#include "observable.hpp"
 #include "ode.hpp"
 #include "operators.hpp"
 #include "optimizers.hpp"
@@ -141,7 +142,9 @@
 #include "rounding.hpp"
 #include "sampledcurve.hpp"
 #include "schedule.hpp"
+#include "sensitivityanalysis.hpp"
 #include "shortratemodels.hpp"
+#include "singleton.hpp"
 #include "solvers.hpp"
 #include "spreadoption.hpp"
 #include "swingoption.hpp"
@@ -314,6 +317,7 @@ test_suite* init_unit_test_suite(int, char* []) {
     test->add(MCLongstaffSchwartzEngineTest::suite());
     test->add(MersenneTwisterTest::suite());
     test->add(MoneyTest::suite());
+    test->add(ObservableTest::suite());
     test->add(OperatorTest::suite());
     test->add(OptimizersTest::suite());
     test->add(OptionletStripperTest::suite());
@@ -330,6 +334,7 @@ test_suite* init_unit_test_suite(int, char* []) {
     test->add(SampledCurveTest::suite());
     test->add(ScheduleTest::suite());
     test->add(ShortRateModelTest::suite()); // fails with QL_USE_INDEXED_COUPON
+    test->add(SingletonTest::suite());
     test->add(Solver1DTest::suite());
     test->add(StatisticsTest::suite());
     test->add(SurfaceTest::suite());
@@ -366,11 +371,13 @@ test_suite* init_unit_test_suite(int, char* []) {
     test->add(HimalayaOptionTest::suite());
     test->add(InflationCPICapFloorTest::suite());
     test->add(InflationVolTest::suite());
+    test->add(JumpDiffusionTest::experimental());
     test->add(MargrabeOptionTest::suite());
     test->add(MarkovFunctionalTest::suite());
     test->add(NthToDefaultTest::suite());
     test->add(OdeTest::suite());
     test->add(PagodaOptionTest::suite());
+    test->add(SensitivityAnalysisTest::suite());
     test->add(SpreadOptionTest::suite());
     test->add(SwingOptionTest::suite());
     test->add(TwoAssetBarrierOptionTest::suite());
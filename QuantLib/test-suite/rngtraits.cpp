@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2004 StatPro Italia srl
  Copyright (C) 2004 Walter Penschke
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -21,6 +22,11 @@
 #include "rngtraits.hpp"
 #include "utilities.hpp"
 #include <ql/math/randomnumbers/rngtraits.hpp>
+#include <ql/math/randomnumbers/knuthuniformrng.hpp>
+#include <ql/math/randomnumbers/lecuyeruniformrng.hpp>
+#include <ql/math/randomnumbers/ranluxuniformrng.hpp>
+#include <ql/math/randomnumbers/philoxuniformrng.hpp>
+#include <ql/math/randomnumbers/haltonrsg.hpp>
 #include <ql/math/comparison.hpp>
 
 using namespace QuantLib;
@@ -92,11 +98,129 @@ void RngTraitsTest::testCustomPoisson() {
 }
 
 
+namespace {
+
+    template <class Traits>
+    void checkSubstreams(const std::string& tag) {
+        Size dimension = 12, samples = 250, substreams = 4;
+        BigNatural seed = 42;
+
+        typename Traits::rsg_type rsg =
+            Traits::make_sequence_generator(dimension, seed);
+        for (Size i=0; i<substreams; i++) {
+            typename Traits::rsg_type substream =
+                Traits::make_sequence_generator(dimension, seed,
+                                                i, samples);
+            for (Size j=0; j<samples; j++) {
+                std::vector<Real> x1 = rsg.nextSequence().value;
+                std::vector<Real> x2 = substream.nextSequence().value;
+                for (Size k=0; k<dimension; k++) {
+                    if (x1[k] != x2[k])
+                        BOOST_FAIL(tag << ": mismatch in substream #" << i
+                                   << ", sample #" << j << ", index " << k
+                                   << ":\n"
+                                   << "    single stream: " << x1[k] << "\n"
+                                   << "    substream:     " << x2[k]);
+                }
+            }
+        }
+    }
+
+}
+
+
+void RngTraitsTest::testSubstreams() {
+
+    BOOST_TEST_MESSAGE("Testing substreams of random-number generators...");
+
+    checkSubstreams<PseudoRandom>("Mersenne twister");
+    checkSubstreams<GenericPseudoRandom<KnuthUniformRng,
+                                       InverseCumulativeNormal> >("Knuth");
+    checkSubstreams<GenericPseudoRandom<LecuyerUniformRng,
+                                       InverseCumulativeNormal> >("L'Ecuyer");
+    checkSubstreams<GenericPseudoRandom<Ranlux3UniformRng,
+                                       InverseCumulativeNormal> >("Ranlux");
+    checkSubstreams<GenericPseudoRandom<PhiloxUniformRng,
+                                       InverseCumulativeNormal> >("Philox");
+    checkSubstreams<LowDiscrepancy>("Sobol");
+    checkSubstreams<GenericLowDiscrepancy<HaltonRsg,
+                                         InverseCumulativeNormal> >("Halton");
+}
+
+
+void RngTraitsTest::testPhilox() {
+
+    BOOST_TEST_MESSAGE("Testing Philox counter-based generator...");
+
+    // known-answer tests from the reference implementation
+    unsigned long counters[3][4] = {
+        { 0x00000000UL, 0x00000000UL, 0x00000000UL, 0x00000000UL },
+        { 0xffffffffUL, 0xffffffffUL, 0xffffffffUL, 0xffffffffUL },
+        { 0x243f6a88UL, 0x85a308d3UL, 0x13198a2eUL, 0x03707344UL }
+    };
+    unsigned long keys[3][2] = {
+        { 0x00000000UL, 0x00000000UL },
+        { 0xffffffffUL, 0xffffffffUL },
+        { 0xa4093822UL, 0x299f31d0UL }
+    };
+    unsigned long expected[3][4] = {
+        { 0x6627e8d5UL, 0xe169c58dUL, 0xbc57ac4cUL, 0x9b00dbd8UL },
+        { 0x408f276dUL, 0x41c83b0eUL, 0xa20bc7c6UL, 0x6d5451fdUL },
+        { 0xd16cfe09UL, 0x94fdccebUL, 0x5001e420UL, 0x24126ea1UL }
+    };
+
+    for (Size i=0; i<3; i++) {
+        unsigned long result[4];
+        PhiloxUniformRng::generate(counters[i], keys[i], result);
+        for (Size j=0; j<4; j++) {
+            if (result[j] != expected[i][j])
+                BOOST_FAIL("known-answer test #" << i << " failed "
+                           << "at index " << j << ":\n"
+                           << std::hex
+                           << "    calculated: " << result[j] << "\n"
+                           << "    expected:   " << expected[i][j]);
+        }
+    }
+
+    // skipping ahead must give the same numbers as drawing
+    unsigned long skips[] = { 0, 1, 3, 4, 5, 1001 };
+    Size drawn[] = { 0, 1, 4, 7 };
+    for (Size i=0; i<LENGTH(skips); i++) {
+        for (Size j=0; j<LENGTH(drawn); j++) {
+            PhiloxUniformRng rng1(42, 3), rng2(42, 3);
+            for (Size k=0; k<drawn[j]; k++) {
+                rng1.nextInt32();
+                rng2.nextInt32();
+            }
+            for (unsigned long k=0; k<skips[i]; k++)
+                rng1.nextInt32();
+            rng2.discard(skips[i]);
+            for (Size k=0; k<100; k++) {
+                unsigned long x1 = rng1.nextInt32(), x2 = rng2.nextInt32();
+                if (x1 != x2)
+                    BOOST_FAIL("mismatch after skipping " << skips[i]
+                               << " numbers (" << drawn[j] << " drawn "
+                               << "before) at index " << k << ":\n"
+                               << "    expected: " << x1 << "\n"
+                               << "    found:    " << x2);
+            }
+        }
+    }
+
+    // different streams must give different numbers
+    PhiloxUniformRng stream1(42, 0), stream2(42, 1);
+    if (stream1.nextInt32() == stream2.nextInt32())
+        BOOST_FAIL("same number drawn from different streams");
+}
+
+
 test_suite* RngTraitsTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("RNG traits tests");
     suite->add(QUANTLIB_TEST_CASE(&RngTraitsTest::testGaussian));
     suite->add(QUANTLIB_TEST_CASE(&RngTraitsTest::testDefaultPoisson));
     suite->add(QUANTLIB_TEST_CASE(&RngTraitsTest::testCustomPoisson));
+    suite->add(QUANTLIB_TEST_CASE(&RngTraitsTest::testSubstreams));
+    suite->add(QUANTLIB_TEST_CASE(&RngTraitsTest::testPhilox));
     return suite;
 }
 
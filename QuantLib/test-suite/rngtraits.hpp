@@ -3,6 +3,7 @@
 /*
  Copyright (C) 2004 StatPro Italia srl
  Copyright (C) 2004 Walter Penschke
+ Copyright (C) 2014 StatPro Italia srl
 
  This file is part of QuantLib, a free-software/open-source library
  for financial quantitative analysts and developers - http://quantlib.org/
@@ -31,6 +32,8 @@ class RngTraitsTest {
     static void testGaussian();
     static void testDefaultPoisson();
     static void testCustomPoisson();
+    static void testSubstreams();
+    static void testPhilox();
     static boost::unit_test_framework::test_suite* suite();
 };
 
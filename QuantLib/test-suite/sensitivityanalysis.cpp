@@ -0,0 +1,459 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include "sensitivityanalysis.hpp"
+#include "utilities.hpp"
+#include <ql/experimental/risk/sensitivityanalysis.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
+#include <ql/instruments/europeanoption.hpp>
+#include <ql/instruments/compositeinstrument.hpp>
+#include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <ql/pricingengines/vanilla/analyticeuropeanengine.hpp>
+#include <ql/processes/blackscholesprocess.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/math/interpolations/loginterpolation.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    struct CommonVars {
+        // global data
+        Date today;
+        RelinkableHandle<YieldTermStructure> curve;
+        boost::shared_ptr<IborIndex> index;
+        boost::shared_ptr<PricingEngine> swapEngine;
+        boost::shared_ptr<GeneralizedBlackScholesProcess> process;
+        std::vector<boost::shared_ptr<Instrument> > instruments;
+
+        // cleanup
+        SavedSettings backup;
+
+        // setup
+        CommonVars() {
+            today = TARGET().adjust(Date(17, March, 2014));
+            Settings::instance().evaluationDate() = today;
+            DayCounter dc = Actual365Fixed();
+
+            curve.linkTo(flatRate(today, 0.03, dc));
+            index = boost::shared_ptr<IborIndex>(new Euribor6M(curve));
+            swapEngine = boost::shared_ptr<PricingEngine>(
+                                           new DiscountingSwapEngine(curve));
+
+            Handle<Quote> spot(
+                       boost::shared_ptr<Quote>(new SimpleQuote(100.0)));
+            Handle<YieldTermStructure> dividends(flatRate(today, 0.01, dc));
+            Handle<BlackVolTermStructure> vol(flatVol(today, 0.20, dc));
+            process = boost::shared_ptr<GeneralizedBlackScholesProcess>(
+                    new BlackScholesMertonProcess(spot, dividends,
+                                                  curve, vol));
+
+            // swaps sharing the same engine...
+            for (Integer i=0; i<120; ++i) {
+                boost::shared_ptr<VanillaSwap> swap =
+                    MakeVanillaSwap((1+i%30)*Years, index,
+                                    0.02 + 0.0001*i, 1*Months)
+                    .withPricingEngine(swapEngine);
+                instruments.push_back(swap);
+            }
+            // ...options with an engine each...
+            for (Integer i=0; i<20; ++i) {
+                boost::shared_ptr<Instrument> option(
+                    new EuropeanOption(
+                        boost::shared_ptr<StrikedTypePayoff>(
+                              new PlainVanillaPayoff(Option::Call,
+                                                     80.0 + 2.0*i)),
+                        boost::shared_ptr<Exercise>(
+                              new EuropeanExercise(today + (i+1)*Months))));
+                option->setPricingEngine(boost::shared_ptr<PricingEngine>(
+                                       new AnalyticEuropeanEngine(process)));
+                instruments.push_back(option);
+            }
+            // ...and an instrument without engine.
+            boost::shared_ptr<CompositeInstrument> composite(
+                                                  new CompositeInstrument);
+            composite->add(instruments[0]);
+            composite->subtract(instruments[130], 2.0);
+            instruments.push_back(composite);
+        }
+    };
+
+    boost::shared_ptr<PricingEngine> copyEngine(
+                             const boost::shared_ptr<PricingEngine>& engine) {
+        boost::shared_ptr<DiscountingSwapEngine> swapEngine =
+            boost::dynamic_pointer_cast<DiscountingSwapEngine>(engine);
+        if (swapEngine)
+            return boost::shared_ptr<PricingEngine>(
+                                    new DiscountingSwapEngine(*swapEngine));
+        boost::shared_ptr<AnalyticEuropeanEngine> optionEngine =
+            boost::dynamic_pointer_cast<AnalyticEuropeanEngine>(engine);
+        if (optionEngine)
+            return boost::shared_ptr<PricingEngine>(
+                                   new AnalyticEuropeanEngine(*optionEngine));
+        QL_FAIL("unknown engine type");
+    }
+
+    // a swap portfolio on a bootstrapped curve; each call returns
+    // a new, independent copy.
+    struct SwapPortfolio {
+        Size swaps;
+        explicit SwapPortfolio(Size swaps) : swaps(swaps) {}
+        PortfolioCopy operator()() const {
+            PortfolioCopy portfolio;
+            std::vector<boost::shared_ptr<RateHelper> > helpers;
+
+            Integer depositMonths[] = { 3, 6 };
+            for (Size i=0; i<LENGTH(depositMonths); ++i) {
+                boost::shared_ptr<SimpleQuote> q(
+                                       new SimpleQuote(0.02+0.0005*i));
+                portfolio.quotes.push_back(q);
+                helpers.push_back(boost::shared_ptr<RateHelper>(
+                    new DepositRateHelper(Handle<Quote>(q),
+                                          depositMonths[i]*Months, 2,
+                                          TARGET(), ModifiedFollowing,
+                                          false, Actual360())));
+            }
+            Integer swapYears[] = { 1, 2, 3, 4, 5, 7, 10, 12, 15, 20 };
+            for (Size i=0; i<LENGTH(swapYears); ++i) {
+                boost::shared_ptr<SimpleQuote> q(
+                                       new SimpleQuote(0.022+0.001*i));
+                portfolio.quotes.push_back(q);
+                helpers.push_back(boost::shared_ptr<RateHelper>(
+                    new SwapRateHelper(Handle<Quote>(q),
+                                       swapYears[i]*Years, TARGET(),
+                                       Annual, Unadjusted,
+                                       Thirty360(Thirty360::European),
+                                       boost::shared_ptr<IborIndex>(
+                                                       new Euribor6M))));
+            }
+
+            Handle<YieldTermStructure> curve(
+                boost::shared_ptr<YieldTermStructure>(
+                    new PiecewiseYieldCurve<Discount,LogLinear>(
+                                      0, TARGET(), helpers, Actual365Fixed(),
+                                      1.0e-14)));
+            boost::shared_ptr<IborIndex> index(new Euribor6M(curve));
+            boost::shared_ptr<PricingEngine> engine(
+                                           new DiscountingSwapEngine(curve));
+
+            for (Size i=0; i<swaps; ++i) {
+                boost::shared_ptr<VanillaSwap> swap =
+                    MakeVanillaSwap((1+i%19)*Years, index,
+                                    0.02 + 0.0001*i, (i%6)*Months)
+                    .withNominal(1000000.0)
+                    .withPricingEngine(engine);
+                portfolio.instruments.push_back(swap);
+            }
+            return portfolio;
+        }
+    };
+
+    void checkResults(const std::vector<boost::shared_ptr<Instrument> >&
+                                                                 instruments,
+                      const PortfolioResults& results,
+                      const std::vector<Real>& expected,
+                      Size threads) {
+        if (results.NPVs.size() != instruments.size())
+            BOOST_FAIL("wrong number of results with " << threads
+                       << " threads"
+                       << "\n    expected: " << instruments.size()
+                       << "\n    found:    " << results.NPVs.size());
+        for (Size i=0; i<instruments.size(); ++i) {
+            if (std::fabs(results.NPVs[i] - expected[i]) > 1.0e-10)
+                BOOST_ERROR("wrong NPV for instrument #" << i
+                            << " with " << threads << " threads"
+                            << std::setprecision(12)
+                            << "\n    expected: " << expected[i]
+                            << "\n    found:    " << results.NPVs[i]);
+        }
+    }
+
+}
+
+
+void SensitivityAnalysisTest::testPortfolioValuation() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded portfolio valuation...");
+
+    CommonVars vars;
+
+    std::vector<Real> expected(vars.instruments.size());
+    for (Size i=0; i<vars.instruments.size(); ++i)
+        expected[i] = vars.instruments[i]->NPV();
+
+    const Size threads[] = { 1, 2, 4, 8 };
+    for (Size j=0; j<LENGTH(threads); ++j) {
+        // force recalculation
+        for (Size i=0; i<vars.instruments.size(); ++i)
+            vars.instruments[i]->update();
+
+        PortfolioResults results =
+            valuePortfolio(vars.instruments, threads[j], true);
+        checkResults(vars.instruments, results, expected, threads[j]);
+
+        if (results.additionalResults.size() != vars.instruments.size())
+            BOOST_ERROR("additional results not returned");
+    }
+}
+
+
+void SensitivityAnalysisTest::testPortfolioValuationWithEngineCopies() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing multi-threaded portfolio valuation with engine copies...");
+
+    CommonVars vars;
+
+    std::vector<Real> expected(vars.instruments.size());
+    for (Size i=0; i<vars.instruments.size(); ++i)
+        expected[i] = vars.instruments[i]->NPV();
+
+    const Size threads[] = { 1, 2, 4, 8 };
+    for (Size j=0; j<LENGTH(threads); ++j) {
+        PortfolioResults results =
+            valuePortfolio(vars.instruments, threads[j], false, copyEngine);
+        checkResults(vars.instruments, results, expected, threads[j]);
+    }
+
+    // a change in the market data must be seen by the copies
+    vars.curve.linkTo(flatRate(vars.today, 0.04, Actual365Fixed()));
+    for (Size i=0; i<vars.instruments.size(); ++i)
+        expected[i] = vars.instruments[i]->NPV();
+    PortfolioResults results =
+        valuePortfolio(vars.instruments, 4, false, copyEngine);
+    checkResults(vars.instruments, results, expected, 4);
+}
+
+
+void SensitivityAnalysisTest::testParallelAggregateNPV() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded aggregate NPV...");
+
+    CommonVars vars;
+
+    std::vector<Real> quantities(vars.instruments.size());
+    for (Size i=0; i<quantities.size(); ++i)
+        quantities[i] = 1.0 + 0.5*(i%3);
+
+    Real expected = aggregateNPV(vars.instruments, quantities);
+    Real unitExpected = aggregateNPV(vars.instruments, std::vector<Real>());
+
+    Real calculated = aggregateNPV(vars.instruments, quantities, 4);
+    if (std::fabs(calculated - expected) > 1.0e-8)
+        BOOST_ERROR("wrong multi-threaded aggregate NPV"
+                    << std::setprecision(12)
+                    << "\n    expected:   " << expected
+                    << "\n    calculated: " << calculated);
+
+    calculated = aggregateNPV(vars.instruments, std::vector<Real>(), 4,
+                              copyEngine);
+    if (std::fabs(calculated - unitExpected) > 1.0e-8)
+        BOOST_ERROR("wrong multi-threaded aggregate NPV with engine copies"
+                    << std::setprecision(12)
+                    << "\n    expected:   " << unitExpected
+                    << "\n    calculated: " << calculated);
+}
+
+
+void SensitivityAnalysisTest::testMultiThreadedBucketAnalysis() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded bucket analysis...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(17, March, 2014);
+
+    SwapPortfolio factory(25);
+    PortfolioCopy portfolio = factory();
+    Size n = portfolio.quotes.size(), m = portfolio.instruments.size();
+
+    std::vector<Handle<SimpleQuote> > quotes;
+    for (Size i=0; i<n; ++i)
+        quotes.push_back(Handle<SimpleQuote>(portfolio.quotes[i]));
+
+    SensitivityAnalysis types[] = { Centered, OneSide };
+    for (Size k=0; k<LENGTH(types); ++k) {
+        // the existing serial function, one instrument at a time
+        Matrix delta(n, m), gamma(n, m);
+        for (Size j=0; j<m; ++j) {
+            std::vector<boost::shared_ptr<Instrument> > instrument(
+                                           1, portfolio.instruments[j]);
+            std::pair<std::vector<Real>, std::vector<Real> > expected =
+                bucketAnalysis(quotes, instrument, std::vector<Real>(),
+                               0.0001, types[k]);
+            for (Size i=0; i<n; ++i) {
+                delta[i][j] = expected.first[i];
+                gamma[i][j] = expected.second[i];
+            }
+        }
+
+        const Size threads[] = { 1, 3, 8 };
+        for (Size t=0; t<LENGTH(threads); ++t) {
+            std::pair<Matrix, Matrix> calculated =
+                bucketAnalysis(factory, threads[t], 0.0001, types[k]);
+            if (calculated.first.rows() != n ||
+                calculated.first.columns() != m)
+                BOOST_FAIL("wrong size of sensitivity matrix"
+                           << "\n    expected: " << n << "x" << m
+                           << "\n    found:    " << calculated.first.rows()
+                           << "x" << calculated.first.columns());
+            for (Size i=0; i<n; ++i) {
+                for (Size j=0; j<m; ++j) {
+                    // NPVs are only as accurate as the bootstrap,
+                    // which depends on the sequence of bumps
+                    Real tolerance = 1.0e-2;
+                    if (std::fabs(calculated.first[i][j]-delta[i][j])
+                                                              > tolerance)
+                        BOOST_ERROR("wrong delta of instrument #" << j
+                                    << " to quote #" << i
+                                    << " (" << types[k] << ", "
+                                    << threads[t] << " threads)"
+                                    << std::setprecision(10)
+                                    << "\n    expected:   " << delta[i][j]
+                                    << "\n    calculated: "
+                                    << calculated.first[i][j]);
+                    if (types[k] == OneSide) {
+                        if (calculated.second[i][j] != Null<Real>())
+                            BOOST_ERROR("one-side gamma available");
+                        continue;
+                    }
+                    tolerance = 1.0e2;
+                    if (std::fabs(calculated.second[i][j]-gamma[i][j])
+                                                              > tolerance)
+                        BOOST_ERROR("wrong gamma of instrument #" << j
+                                    << " to quote #" << i
+                                    << " (" << threads[t] << " threads)"
+                                    << std::setprecision(10)
+                                    << "\n    expected:   " << gamma[i][j]
+                                    << "\n    calculated: "
+                                    << calculated.second[i][j]);
+                }
+            }
+        }
+    }
+}
+
+
+void SensitivityAnalysisTest::testMultiThreadedParallelAnalysis() {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded parallel-shift analysis...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(17, March, 2014);
+
+    SwapPortfolio factory(10);
+    PortfolioCopy portfolio = factory();
+    Size m = portfolio.instruments.size();
+
+    std::vector<Handle<SimpleQuote> > quotes;
+    for (Size i=0; i<portfolio.quotes.size(); ++i)
+        quotes.push_back(Handle<SimpleQuote>(portfolio.quotes[i]));
+
+    std::pair<std::vector<Real>, std::vector<Real> > calculated =
+        parallelAnalysis(factory, 2);
+    if (calculated.first.size() != m)
+        BOOST_FAIL("wrong number of sensitivities"
+                   << "\n    expected: " << m
+                   << "\n    found:    " << calculated.first.size());
+
+    for (Size j=0; j<m; ++j) {
+        std::vector<boost::shared_ptr<Instrument> > instrument(
+                                           1, portfolio.instruments[j]);
+        std::pair<Real, Real> expected =
+            parallelAnalysis(quotes, instrument, std::vector<Real>());
+        Real tolerance = 1.0e-2;
+        if (std::fabs(calculated.first[j]-expected.first) > tolerance)
+            BOOST_ERROR("wrong parallel delta of instrument #" << j
+                        << std::setprecision(10)
+                        << "\n    expected:   " << expected.first
+                        << "\n    calculated: " << calculated.first[j]);
+        tolerance = 1.0e2;
+        if (std::fabs(calculated.second[j]-expected.second) > tolerance)
+            BOOST_ERROR("wrong parallel gamma of instrument #" << j
+                        << std::setprecision(10)
+                        << "\n    expected:   " << expected.second
+                        << "\n    calculated: " << calculated.second[j]);
+    }
+}
+
+
+void SensitivityAnalysisTest::testAggregatedBucketAnalysis() {
+
+    BOOST_TEST_MESSAGE(
+        "Testing aggregation of multi-threaded bucket analysis...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(17, March, 2014);
+
+    SwapPortfolio factory(50);
+    PortfolioCopy portfolio = factory();
+
+    std::vector<Handle<SimpleQuote> > quotes;
+    for (Size i=0; i<portfolio.quotes.size(); ++i)
+        quotes.push_back(Handle<SimpleQuote>(portfolio.quotes[i]));
+
+    std::pair<std::vector<Real>, std::vector<Real> > expected =
+        bucketAnalysis(quotes, portfolio.instruments, std::vector<Real>());
+
+    const Size threads = 4;
+    std::pair<Matrix, Matrix> calculated =
+        bucketAnalysis(factory, threads);
+
+    // the serial function returns the aggregated sensitivities.  The
+    // deltas are of the order of 1e7 and the sum of the single-swap
+    // deltas differs from the portfolio delta by round-off in the
+    // repricing, below 1e-3.
+    const Real tolerance = 1.0e-2;
+    for (Size i=0; i<quotes.size(); ++i) {
+        Real delta = 0.0;
+        for (Size j=0; j<calculated.first.columns(); ++j)
+            delta += calculated.first[i][j];
+        if (std::fabs(delta-expected.first[i]) > tolerance)
+            BOOST_ERROR("wrong aggregated delta to quote #" << i
+                        << std::setprecision(10)
+                        << "\n    expected:   " << expected.first[i]
+                        << "\n    calculated: " << delta);
+    }
+}
+
+
+test_suite* SensitivityAnalysisTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Sensitivity analysis tests");
+    suite->add(QUANTLIB_TEST_CASE(
+                           &SensitivityAnalysisTest::testPortfolioValuation));
+    suite->add(QUANTLIB_TEST_CASE(
+           &SensitivityAnalysisTest::testPortfolioValuationWithEngineCopies));
+    suite->add(QUANTLIB_TEST_CASE(
+                         &SensitivityAnalysisTest::testParallelAggregateNPV));
+    suite->add(QUANTLIB_TEST_CASE(
+                  &SensitivityAnalysisTest::testMultiThreadedBucketAnalysis));
+    suite->add(QUANTLIB_TEST_CASE(
+                &SensitivityAnalysisTest::testMultiThreadedParallelAnalysis));
+    suite->add(QUANTLIB_TEST_CASE(
+                     &SensitivityAnalysisTest::testAggregatedBucketAnalysis));
+    return suite;
+}
+
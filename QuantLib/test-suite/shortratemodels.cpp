@@ -26,6 +26,7 @@
 #include <ql/models/shortrate/onefactormodels/hullwhite.hpp>
 #include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
 #include <ql/pricingengines/swaption/jamshidianswaptionengine.hpp>
+#include <ql/pricingengines/swaption/treeswaptionengine.hpp>
 #include <ql/pricingengines/swap/treeswapengine.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
@@ -427,11 +428,78 @@ void ShortRateModelTest::testFuturesConvexityBias() {
     }
 }
 
+void ShortRateModelTest::testMultiThreadedCalibration() {
+    BOOST_TEST_MESSAGE("Testing multi-threaded Hull-White calibration...");
+
+    SavedSettings backup;
+    IndexHistoryCleaner cleaner;
+
+    Date today(15, February, 2002);
+    Date settlement(19, February, 2002);
+    Settings::instance().evaluationDate() = today;
+    Handle<YieldTermStructure> termStructure(flatRate(settlement,0.04875825,
+                                                      Actual365Fixed()));
+    CalibrationData data[] = {{ 1, 5, 0.1148 },
+                              { 2, 4, 0.1108 },
+                              { 3, 3, 0.1070 },
+                              { 4, 2, 0.1021 },
+                              { 5, 1, 0.1000 }};
+    boost::shared_ptr<IborIndex> index(new Euribor6M(termStructure));
+
+    const Size threads[] = { Null<Size>(), 1, 2, 3, 8 };
+
+    Array expected;
+    for (Size k=0; k<LENGTH(threads); ++k) {
+        boost::shared_ptr<HullWhite> model(new HullWhite(termStructure));
+
+        // each helper has its own engine, so that all of them can
+        // be evaluated concurrently
+        std::vector<boost::shared_ptr<CalibrationHelper> > swaptions;
+        for (Size i=0; i<LENGTH(data); i++) {
+            boost::shared_ptr<Quote> vol(new SimpleQuote(data[i].volatility));
+            boost::shared_ptr<CalibrationHelper> helper(
+                             new SwaptionHelper(Period(data[i].start, Years),
+                                                Period(data[i].length, Years),
+                                                Handle<Quote>(vol),
+                                                index,
+                                                Period(1, Years), Thirty360(),
+                                                Actual360(), termStructure));
+            helper->setPricingEngine(boost::shared_ptr<PricingEngine>(
+                                       new TreeSwaptionEngine(model, 40)));
+            swaptions.push_back(helper);
+        }
+
+        LevenbergMarquardt optimizationMethod(1.0e-8,1.0e-8,1.0e-8);
+        EndCriteria endCriteria(10000, 100, 1e-6, 1e-8, 1e-8);
+        model->calibrate(swaptions, optimizationMethod, endCriteria,
+                         Constraint(), std::vector<Real>(),
+                         std::vector<bool>(), threads[k]);
+
+        // the helpers are evaluated in the same way regardless of
+        // the threads, so the results must be exactly the same
+        Array calculated = model->params();
+        if (k == 0) {
+            expected = calculated;
+        } else if (calculated[0] != expected[0]
+                   || calculated[1] != expected[1]) {
+            BOOST_ERROR("Failed to reproduce single-threaded calibration:"
+                        << "\n    threads:    " << threads[k]
+                        << QL_SCIENTIFIC
+                        << "\n    calculated: a = " << calculated[0]
+                        << ", sigma = " << calculated[1]
+                        << "\n    expected:   a = " << expected[0]
+                        << ", sigma = " << expected[1]);
+        }
+    }
+}
+
 test_suite* ShortRateModelTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Short-rate model tests");
     suite->add(QUANTLIB_TEST_CASE(&ShortRateModelTest::testCachedHullWhite));
     suite->add(QUANTLIB_TEST_CASE(&ShortRateModelTest::testCachedHullWhiteFixedReversion));
     suite->add(QUANTLIB_TEST_CASE(&ShortRateModelTest::testCachedHullWhite2));
+    suite->add(QUANTLIB_TEST_CASE(
+                            &ShortRateModelTest::testMultiThreadedCalibration));
     suite->add(QUANTLIB_TEST_CASE(&ShortRateModelTest::testSwaps));
     suite->add(QUANTLIB_TEST_CASE(&ShortRateModelTest::testFuturesConvexityBias));
     return suite;
@@ -31,6 +31,7 @@ class ShortRateModelTest {
     static void testCachedHullWhite();
     static void testCachedHullWhiteFixedReversion();
     static void testCachedHullWhite2();
+    static void testMultiThreadedCalibration();
     static void testSwaps();
     static boost::unit_test_framework::test_suite* suite();
 };
@@ -0,0 +1,314 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ Copyright (C) 2014 StatPro Italia srl
+
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#include "singleton.hpp"
+#include "utilities.hpp"
+#include <ql/settings.hpp>
+#include <ql/indexes/indexmanager.hpp>
+#include <ql/currencies/exchangeratemanager.hpp>
+#include <ql/currencies/europe.hpp>
+#include <ql/currencies/america.hpp>
+#include <ql/math/randomnumbers/seedgenerator.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+#if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+
+namespace {
+
+    template <int N>
+    class Dependency : public Singleton<Dependency<N> > {
+        friend class Singleton<Dependency<N> >;
+      private:
+        Dependency() : value(0) {}
+      public:
+        void forkFrom(Dependency& source) { value = source.value; }
+        Integer value;
+    };
+
+    template <int N>
+    class Dependent : public Singleton<Dependent<N> > {
+        friend class Singleton<Dependent<N> >;
+      private:
+        Dependent() : dependency(Dependency<N>::instance()) {}
+      public:
+        Dependency<N>& dependency;
+    };
+
+    template <int N>
+    void checkForkedDependency() {
+        Dependency<N>::instance().value = 42;
+
+        SingletonContext forked = SingletonContext::current().fork();
+        {
+            SingletonContextGuard guard(forked);
+
+            if (&Dependent<N>::instance().dependency
+                != &Dependency<N>::instance())
+                BOOST_ERROR("forked singleton refers to a different "
+                            "instance than the one in its context");
+            if (Dependency<N>::instance().value != 42)
+                BOOST_ERROR("singleton used by a forked constructor "
+                            "not forked"
+                            << "\n    expected: " << 42
+                            << "\n    found:    "
+                            << Dependency<N>::instance().value);
+        }
+
+        Dependency<N>::instance().value = 0;
+    }
+
+}
+
+void SingletonTest::testContextSwitching() {
+
+    BOOST_TEST_MESSAGE("Testing switching of singleton contexts...");
+
+    SavedSettings backup;
+
+    Date today(15, March, 2014);
+    Settings::instance().evaluationDate() = today;
+
+    SingletonContext global = SingletonContext::current();
+    if (global != SingletonContext::global())
+        BOOST_FAIL("global context not current at start");
+
+    SingletonContext context;
+    {
+        SingletonContextGuard guard(context);
+
+        if (SingletonContext::current() != context)
+            BOOST_FAIL("new context not current");
+        Date other(15, April, 2014);
+        Settings::instance().evaluationDate() = other;
+        if (Settings::instance().evaluationDate() != other)
+            BOOST_ERROR("failed to set evaluation date in new context"
+                        << "\n    expected: " << other
+                        << "\n    found:    "
+                        << Settings::instance().evaluationDate());
+    }
+
+    if (SingletonContext::current() != global)
+        BOOST_FAIL("global context not restored");
+    if (Settings::instance().evaluationDate() != today)
+        BOOST_ERROR("global evaluation date modified in new context"
+                    << "\n    expected: " << today
+                    << "\n    found:    "
+                    << Settings::instance().evaluationDate());
+
+    // switching back to the same context finds the same instances
+    {
+        SingletonContextGuard guard(context);
+        if (Settings::instance().evaluationDate() != Date(15, April, 2014))
+            BOOST_ERROR("evaluation date not kept in context"
+                        << "\n    expected: " << Date(15, April, 2014)
+                        << "\n    found:    "
+                        << Settings::instance().evaluationDate());
+    }
+}
+
+
+void SingletonTest::testNestedGuards() {
+
+    BOOST_TEST_MESSAGE("Testing nested singleton-context guards...");
+
+    SingletonContext c1, c2;
+    Settings* s0 = &Settings::instance();
+    {
+        SingletonContextGuard g1(c1);
+        Settings* s1 = &Settings::instance();
+        {
+            SingletonContextGuard g2(c2);
+            Settings* s2 = &Settings::instance();
+            if (s2 == s1 || s2 == s0)
+                BOOST_ERROR("contexts share Settings instance");
+            {
+                SingletonContextGuard g3(c1);
+                if (&Settings::instance() != s1)
+                    BOOST_ERROR("reentering context returned different "
+                                "instance");
+            }
+            if (&Settings::instance() != s2)
+                BOOST_ERROR("inner context not restored");
+        }
+        if (&Settings::instance() != s1)
+            BOOST_ERROR("outer context not restored");
+        if (SingletonContext::current() != c1)
+            BOOST_ERROR("outer context not current");
+    }
+    if (&Settings::instance() != s0)
+        BOOST_ERROR("global context not restored");
+}
+
+
+void SingletonTest::testFork() {
+
+    BOOST_TEST_MESSAGE("Testing forking of singleton contexts...");
+
+    SavedSettings backup;
+    IndexHistoryCleaner cleaner;
+
+    Date today(15, March, 2014);
+    Settings::instance().evaluationDate() = today;
+    Settings::instance().includeReferenceDateEvents() = true;
+
+    std::string name = "FAKE INDEX";
+    TimeSeries<Real> fixings;
+    fixings[Date(14, March, 2014)] = 0.01;
+    IndexManager::instance().setHistory(name, fixings);
+
+    ExchangeRate rate(EURCurrency(), USDCurrency(), 1.3);
+    ExchangeRateManager::instance().add(rate);
+
+    SingletonContext forked = SingletonContext::current().fork();
+    {
+        SingletonContextGuard guard(forked);
+
+        if (Settings::instance().evaluationDate() != today)
+            BOOST_ERROR("evaluation date not copied"
+                        << "\n    expected: " << today
+                        << "\n    found:    "
+                        << Settings::instance().evaluationDate());
+        if (!Settings::instance().includeReferenceDateEvents())
+            BOOST_ERROR("settings flags not copied");
+        if (!IndexManager::instance().hasHistory(name))
+            BOOST_ERROR("index fixings not copied");
+        Real found = ExchangeRateManager::instance().lookup(
+                                 EURCurrency(), USDCurrency()).rate();
+        if (std::fabs(found - 1.3) > 1.0e-12)
+            BOOST_ERROR("exchange rate not copied"
+                        << "\n    expected: " << 1.3
+                        << "\n    found:    " << found);
+
+        // changes in the fork don't affect the parent
+        Settings::instance().evaluationDate() = today + 1;
+        IndexManager::instance().clearHistory(name);
+        ExchangeRateManager::instance().clear();
+    }
+
+    if (Settings::instance().evaluationDate() != today)
+        BOOST_ERROR("evaluation date modified from fork");
+    if (!IndexManager::instance().hasHistory(name))
+        BOOST_ERROR("index fixings cleared from fork");
+    Real found = ExchangeRateManager::instance().lookup(
+                                 EURCurrency(), USDCurrency()).rate();
+    if (std::fabs(found - 1.3) > 1.0e-12)
+        BOOST_ERROR("exchange rate cleared from fork");
+
+    ExchangeRateManager::instance().clear();
+}
+
+
+void SingletonTest::testForkedDependencies() {
+
+    BOOST_TEST_MESSAGE("Testing forking of singletons using each other...");
+
+    // the forked instances must refer to each other and keep their
+    // data regardless of the order in which the two are created
+    Dependency<1>::instance();
+    Dependent<1>::instance();
+    checkForkedDependency<1>();
+
+    Dependent<2>::instance();
+    checkForkedDependency<2>();
+}
+
+
+void SingletonTest::testForkedSeeds() {
+
+    BOOST_TEST_MESSAGE("Testing seed generators in forked contexts...");
+
+    SingletonContext c1 = SingletonContext::current().fork();
+    SingletonContext c2 = SingletonContext::current().fork();
+
+    std::vector<unsigned long> s1, s2;
+    {
+        SingletonContextGuard guard(c1);
+        for (Size i=0; i<10; ++i)
+            s1.push_back(SeedGenerator::instance().get());
+    }
+    {
+        SingletonContextGuard guard(c2);
+        for (Size i=0; i<10; ++i)
+            s2.push_back(SeedGenerator::instance().get());
+    }
+
+    if (s1 == s2)
+        BOOST_ERROR("forked contexts return the same seeds");
+}
+
+
+void SingletonTest::testContextsInThreads() {
+
+    BOOST_TEST_MESSAGE("Testing singleton contexts in multiple threads...");
+
+    SavedSettings backup;
+
+    Date today(15, March, 2014);
+    Settings::instance().evaluationDate() = today;
+
+    const Integer n = 16;
+    std::vector<SingletonContext> contexts(n);
+    for (Integer i=0; i<n; ++i)
+        contexts[i] = SingletonContext::current().fork();
+
+    std::vector<Date> referenceDates(n);
+
+    #pragma omp parallel for
+    for (Integer i=0; i<n; ++i) {
+        SingletonContextGuard guard(contexts[i]);
+        for (Integer j=0; j<100; ++j) {
+            Settings::instance().evaluationDate() = today + i + j;
+            FlatForward curve(0, TARGET(), 0.03, Actual360());
+            referenceDates[i] = curve.referenceDate();
+        }
+    }
+
+    for (Integer i=0; i<n; ++i) {
+        Date expected = TARGET().adjust(today + i + 99);
+        if (referenceDates[i] != expected)
+            BOOST_ERROR("wrong reference date in context #" << i
+                        << "\n    expected: " << expected
+                        << "\n    found:    " << referenceDates[i]);
+    }
+
+    if (Settings::instance().evaluationDate() != today)
+        BOOST_ERROR("global evaluation date modified by threads");
+}
+
+#endif
+
+
+test_suite* SingletonTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Singleton tests");
+    #if defined(QL_ENABLE_SINGLETON_CONTEXTS)
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testContextSwitching));
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testNestedGuards));
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testFork));
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testForkedDependencies));
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testForkedSeeds));
+    suite->add(QUANTLIB_TEST_CASE(&SingletonTest::testContextsInThreads));
+    #endif
+    return suite;
+}
+
@@ -322,12 +322,59 @@ void StatisticsTest::testConvergenceStatistics() {
 }
 
 
+namespace {
+
+    template <class S>
+    void checkMerge(const std::string& name) {
+
+        S whole, first, second;
+        for (Size i=0; i<LENGTH(data); i++) {
+            whole.add(data[i],weights[i]);
+            if (i < LENGTH(data)/3)
+                first.add(data[i],weights[i]);
+            else
+                second.add(data[i],weights[i]);
+        }
+        first.merge(second);
+
+        if (first.samples() != whole.samples())
+            BOOST_FAIL(name << ": wrong number of merged samples\n"
+                       << "    calculated: " << first.samples() << "\n"
+                       << "    expected:   " << whole.samples());
+
+        Real tolerance = 1.0e-9;
+        Real calculated[] = { first.weightSum(), first.mean(),
+                              first.variance(), first.skewness(),
+                              first.kurtosis(), first.min(), first.max() };
+        Real expected[] = { whole.weightSum(), whole.mean(),
+                            whole.variance(), whole.skewness(),
+                            whole.kurtosis(), whole.min(), whole.max() };
+        for (Size i=0; i<LENGTH(expected); ++i) {
+            if (std::fabs(calculated[i]-expected[i]) > tolerance)
+                BOOST_FAIL(name << ": wrong merged statistic #" << i
+                           << "\n    calculated: " << calculated[i]
+                           << "\n    expected:   " << expected[i]);
+        }
+    }
+
+}
+
+
+void StatisticsTest::testMergedStatistics() {
+
+    BOOST_TEST_MESSAGE("Testing merged statistics...");
+
+    checkMerge<IncrementalStatistics>(std::string("IncrementalStatistics"));
+    checkMerge<Statistics>(std::string("Statistics"));
+}
+
 
 test_suite* StatisticsTest::suite() {
     test_suite* suite = BOOST_TEST_SUITE("Statistics tests");
     suite->add(QUANTLIB_TEST_CASE(&StatisticsTest::testStatistics));
     suite->add(QUANTLIB_TEST_CASE(&StatisticsTest::testSequenceStatistics));
     suite->add(QUANTLIB_TEST_CASE(&StatisticsTest::testConvergenceStatistics));
+    suite->add(QUANTLIB_TEST_CASE(&StatisticsTest::testMergedStatistics));
     return suite;
 }
 